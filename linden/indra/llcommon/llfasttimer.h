@@ -134,6 +134,8 @@ public:
 		FTM_CULL,
 		FTM_CULL_REBOUND,
 		FTM_FRUSTUM_CULL,
+		FTM_CULL_PRECULL,
+		FTM_CULL_OCCLUDERS,
 		FTM_GEO_UPDATE,
 		FTM_GEO_RESERVE,
 		FTM_GEO_LIGHT,
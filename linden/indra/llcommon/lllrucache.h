@@ -0,0 +1,132 @@
+/** 
+ * @file lllrucache.h
+ * @brief A bounded map that evicts its least recently used entries.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLRUCACHE_H
+#define LL_LLLRUCACHE_H
+
+#include <list>
+#include <map>
+
+// A map holding at most mMaxSize entries.  Looking an entry up with
+// find() marks it as most recently used; inserting into a full cache
+// drops the least recently used entry.  Not thread safe.
+template <typename KEY, typename VALUE>
+class LLLRUCache
+{
+protected:
+	typedef std::list<std::pair<KEY, VALUE> > entry_list_t;
+	typedef std::map<KEY, typename entry_list_t::iterator> index_map_t;
+
+public:
+	LLLRUCache(U32 max_size) : mMaxSize(max_size), mHits(0), mMisses(0) {}
+	virtual ~LLLRUCache() {}
+
+	// Returns NULL if the key is not cached.  The pointer is valid
+	// until the next insert(), erase() or clear().
+	VALUE* find(const KEY& key)
+	{
+		typename index_map_t::iterator it = mIndex.find(key);
+		if (it == mIndex.end())
+		{
+			mMisses++;
+			return NULL;
+		}
+		mHits++;
+		// Move to the front without copying the entry.
+		mEntries.splice(mEntries.begin(), mEntries, it->second);
+		return &(it->second->second);
+	}
+
+	// Replaces any existing entry for key.
+	VALUE& insert(const KEY& key, const VALUE& value)
+	{
+		erase(key);
+		while (!mEntries.empty() && mEntries.size() >= mMaxSize)
+		{
+			evictOldest();
+		}
+		mEntries.push_front(std::make_pair(key, value));
+		mIndex[key] = mEntries.begin();
+		return mEntries.front().second;
+	}
+
+	void erase(const KEY& key)
+	{
+		typename index_map_t::iterator it = mIndex.find(key);
+		if (it != mIndex.end())
+		{
+			mEntries.erase(it->second);
+			mIndex.erase(it);
+		}
+	}
+
+	void clear()
+	{
+		mEntries.clear();
+		mIndex.clear();
+	}
+
+	void setMaxSize(U32 max_size)
+	{
+		mMaxSize = max_size;
+		while (mEntries.size() > mMaxSize)
+		{
+			evictOldest();
+		}
+	}
+
+	U32 getMaxSize() const	{ return mMaxSize; }
+	U32 size() const		{ return mIndex.size(); }
+	bool empty() const		{ return mIndex.empty(); }
+	U32 getHits() const		{ return mHits; }
+	U32 getMisses() const	{ return mMisses; }
+
+protected:
+	// Called for each entry dropped to make room, just before it goes.
+	// erase() and clear() do not call it.
+	virtual void evicted(const KEY& key, VALUE& value) {}
+
+	void evictOldest()
+	{
+		evicted(mEntries.back().first, mEntries.back().second);
+		mIndex.erase(mEntries.back().first);
+		mEntries.pop_back();
+	}
+
+	entry_list_t mEntries;	// most recently used first
+	index_map_t mIndex;
+	U32 mMaxSize;
+	U32 mHits;
+	U32 mMisses;
+};
+
+#endif // LL_LLLRUCACHE_H
@@ -36,13 +36,22 @@
 //============================================================================
 
 // MAIN THREAD
-LLQueuedThread::LLQueuedThread(const std::string& name, bool threaded) :
+LLQueuedThread::LLQueuedThread(const std::string& name, bool threaded, bool dedicated_thread) :
 	LLThread(name),
 	mThreaded(threaded),
 	mIdleThread(TRUE),
-	mNextHandle(0)
+	mNextHandle(0),
+	mUseScheduler(threaded && !dedicated_thread && LLTaskScheduler::getInstance() != NULL),
+	mDrainScheduled(false),
+	mSchedulerStarted(false)
 {
-	if (mThreaded)
+	if (mUseScheduler)
+	{
+		// No thread of our own, but we behave like a running one so that
+		// pause() and checkPause() keep working.
+		mStatus = RUNNING;
+	}
+	else if (mThreaded)
 	{
 		start();
 	}
@@ -60,7 +69,25 @@ void LLQueuedThread::shutdown()
 	setQuitting();
 
 	unpause(); // MAIN THREAD
-	if (mThreaded)
+	if (mUseScheduler)
+	{
+		// A running or queued drain task holds a pointer to us, so wait for
+		// it to notice we are quitting however long that takes.  The task
+		// broadcasts mRunCondition when it clears the flag.
+		lockData();
+		while (mDrainScheduled)
+		{
+			mRunCondition->wait();
+		}
+		unlockData();
+		if (mSchedulerStarted)
+		{
+			endThread();
+			mSchedulerStarted = false;
+		}
+		mStatus = STOPPED;
+	}
+	else if (mThreaded)
 	{
 		S32 timeout = 100;
 		for ( ; timeout>0; timeout--)
@@ -118,6 +145,10 @@ S32 LLQueuedThread::updateQueue(U32 max_time_ms)
 	{
 		pending = getPending();
 		unpause();
+		if (mUseScheduler && pending > 0)
+		{
+			scheduleDrain();
+		}
 	}
 	else
 	{
@@ -136,13 +167,122 @@ void LLQueuedThread::incQueue()
 	// Something has been added to the queue
 	if (!isPaused())
 	{
-		if (mThreaded)
+		if (mUseScheduler)
+		{
+			scheduleDrain();
+		}
+		else if (mThreaded)
 		{
 			wake(); // Wake the thread up if necessary.
 		}
 	}
 }
 
+// mRunCondition must be locked here
+LLTaskScheduler::lane_t LLQueuedThread::getDrainLane()
+{
+	// Run at the priority of the most important pending request
+	U32 priority = (*mRequestQueue.begin())->getPriority();
+	if (priority >= PRIORITY_URGENT)
+	{
+		return LLTaskScheduler::LANE_URGENT;
+	}
+	else if (priority >= PRIORITY_HIGH)
+	{
+		return LLTaskScheduler::LANE_HIGH;
+	}
+	else if (priority >= PRIORITY_NORMAL)
+	{
+		return LLTaskScheduler::LANE_NORMAL;
+	}
+	return LLTaskScheduler::LANE_LOW;
+}
+
+// May be called from any thread
+void LLQueuedThread::scheduleDrain()
+{
+	LLTaskScheduler* scheduler = LLTaskScheduler::getInstance();
+	if (!scheduler)
+	{
+		return;
+	}
+
+	lockData();
+	if (mDrainScheduled || mRequestQueue.empty() || isQuitting())
+	{
+		unlockData();
+		return;
+	}
+	mDrainScheduled = true;
+	LLTaskScheduler::lane_t lane = getDrainLane();
+	unlockData();
+
+	scheduler->schedule(new DrainTask(this), lane);
+}
+
+// SCHEDULER WORKER THREAD
+void LLQueuedThread::drainQueue()
+{
+	// Give the pool back after a short slice so other queues get a turn
+	const F64 DRAIN_TIME_SLICE = 0.005;
+	LLTimer timer;
+
+	if (!mSchedulerStarted && !isQuitting())
+	{
+		startThread();
+		mSchedulerStarted = true;
+	}
+
+	while (!isQuitting() && !isPaused())
+	{
+		mIdleThread = FALSE;
+
+		threadedUpdate();
+
+		S32 res = processNextRequest();
+		if (res == 0)
+		{
+			mIdleThread = TRUE;
+			break;
+		}
+		if (timer.getElapsedTimeF64() > DRAIN_TIME_SLICE)
+		{
+			break;
+		}
+	}
+
+	// Either hand the queue straight to a new drain task, or clear the
+	// flag so the next request schedules one.  Once the flag is clear,
+	// shutdown() may delete us, so nothing below may touch this.
+	lockData();
+	bool reschedule = !isQuitting() && !isPaused() && !mRequestQueue.empty();
+	LLTaskScheduler::lane_t lane = LLTaskScheduler::LANE_NORMAL;
+	if (reschedule)
+	{
+		lane = getDrainLane();
+	}
+	else
+	{
+		mDrainScheduled = false;
+		mRunCondition->broadcast();
+	}
+	unlockData();
+
+	if (reschedule)
+	{
+		LLTaskScheduler::getInstance()->schedule(new DrainTask(this), lane);
+	}
+}
+
+// SCHEDULER WORKER THREAD
+void LLQueuedThread::drainCancelled()
+{
+	lockData();
+	mDrainScheduled = false;
+	mRunCondition->broadcast();
+	unlockData();
+}
+
 //virtual
 // May be called from any thread
 S32 LLQueuedThread::getPending()
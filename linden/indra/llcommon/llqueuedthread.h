@@ -42,10 +42,18 @@
 
 #include "llthread.h"
 #include "llsimplehash.h"
+#include "lltaskscheduler.h"
 
 //============================================================================
 // Note: ~LLQueuedThread is O(N) N=# of queued threads, assumed to be small
 //   It is assumed that LLQueuedThreads are rarely created/destroyed.
+//
+// If the shared LLTaskScheduler exists when a threaded LLQueuedThread is
+// constructed, no thread is started.  Instead a drain task is scheduled on
+// the shared pool whenever requests are pending.  At most one drain task per
+// queue is scheduled at any time, so requests are still processed one at a
+// time and processRequest() keeps its single threaded guarantees.
+// Subclasses that need thread affinity pass dedicated_thread = true.
 
 class LLQueuedThread : public LLThread
 {
@@ -154,7 +162,7 @@ public:
 	static handle_t nullHandle() { return handle_t(0); }
 	
 public:
-	LLQueuedThread(const std::string& name, bool threaded = true);
+	LLQueuedThread(const std::string& name, bool threaded = true, bool dedicated_thread = false);
 	virtual ~LLQueuedThread();	
 	virtual void shutdown();
 	
@@ -175,6 +183,21 @@ protected:
 	S32  processNextRequest(void);
 	void incQueue();
 
+	// Shared scheduler support
+	class DrainTask : public LLTaskScheduler::Task
+	{
+	public:
+		DrainTask(LLQueuedThread* queue) : mQueue(queue) {}
+		/*virtual*/ void run() { mQueue->drainQueue(); }
+		/*virtual*/ void cancelled() { mQueue->drainCancelled(); }
+	private:
+		LLQueuedThread* mQueue;
+	};
+	void scheduleDrain();
+	LLTaskScheduler::lane_t getDrainLane();
+	void drainQueue();
+	void drainCancelled();
+
 public:
 	bool waitForResult(handle_t handle, bool auto_complete = true);
 
@@ -186,6 +209,7 @@ public:
 
 	S32 getPending();
 	bool getThreaded() { return mThreaded ? true : false; }
+	bool getUsesScheduler() { return mUseScheduler; }
 
 	// Request accessors
 	status_t getRequestStatus(handle_t handle);
@@ -212,6 +236,10 @@ protected:
 	request_hash_t mRequestHash;
 
 	handle_t mNextHandle;
+
+	bool mUseScheduler;			// requests are processed by drain tasks on the shared scheduler
+	bool mDrainScheduled;		// protected by lockData()
+	bool mSchedulerStarted;		// startThread() has been called from a drain task
 };
 
 #endif // LL_LLQUEUEDTHREAD_H
@@ -74,11 +74,16 @@ protected:
 	Impl(StaticAllocationMarker);
 		///< This constructor is used for static objects and causes the
 		//   suppresses adjusting the debugging counters when they are
-		//	 finally initialized.
+		//	 finally initialized.  Static objects are also pinned: they
+		//	 are never reference counted, and always appear shared, so
+		//	 any mutation goes through copy-on-write.
 		
 	virtual ~Impl();
 	
 	bool shared() const							{ return mUseCount > 1; }
+	bool pinned() const							{ return mUseCount == PINNED; }
+
+	enum { PINNED = 0xFFFFFFFF };
 	
 public:
 	static void reset(Impl*& var, Impl* impl);
@@ -135,6 +140,12 @@ public:
 	virtual LLSD::array_const_iterator endArray() const { static const std::vector<LLSD> empty; return empty.end(); }
 
 	static const LLSD& undef();
+
+	static const Impl* sharedBoolean(LLSD::Boolean);
+	static const Impl* sharedEmptyMap();
+	static const Impl* sharedEmptyArray();
+		///< immutable, pinned instances of the most common values, so
+		//   that they can be assigned without allocating
 	
 	static U32 sAllocationCount;
 	static U32 sOutstandingCount;
@@ -159,6 +170,8 @@ namespace
 
 	public:
 		ImplBase(DataRef value) : mValue(value) { }
+		ImplBase(DataRef value, StaticAllocationMarker)
+			: Impl(STATIC), mValue(value) { }
 		
 		virtual LLSD::Type type() const { return T; }
 
@@ -180,6 +193,8 @@ namespace
 	{
 	public:
 		ImplBoolean(LLSD::Boolean v) : Base(v) { }
+		ImplBoolean(LLSD::Boolean v, StaticAllocationMarker)
+			: Base(v, STATIC) { }
 		
 		virtual LLSD::Boolean	asBoolean() const	{ return mValue; }
 		virtual LLSD::Integer	asInteger() const	{ return mValue ? 1 : 0; }
@@ -341,6 +356,7 @@ namespace
 		
 	public:
 		ImplMap() { }
+		ImplMap(StaticAllocationMarker) : Impl(STATIC) { }
 		
 		virtual ImplMap& makeMap(LLSD::Impl*&);
 
@@ -432,6 +448,7 @@ namespace
 		
 	public:
 		ImplArray() { }
+		ImplArray(StaticAllocationMarker) : Impl(STATIC) { }
 		
 		virtual ImplArray& makeArray(Impl*&);
 
@@ -565,19 +582,20 @@ LLSD::Impl::Impl()
 }
 
 LLSD::Impl::Impl(StaticAllocationMarker)
-	: mUseCount(0)
+	: mUseCount(PINNED)
 {
 }
 
 LLSD::Impl::~Impl()
 {
-	--sOutstandingCount;
+	if (!pinned()) --sOutstandingCount;
 }
 
 void LLSD::Impl::reset(Impl*& var, Impl* impl)
 {
-	if (impl) ++impl->mUseCount;
-	if (var  &&  --var->mUseCount == 0)
+	// Pinned impls are never counted, so they are never deleted.
+	if (impl  &&  !impl->pinned()) ++impl->mUseCount;
+	if (var  &&  !var->pinned()  &&  --var->mUseCount == 0)
 	{
 		delete var;
 	}
@@ -623,7 +641,7 @@ void LLSD::Impl::assignUndefined(Impl*& var)
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Boolean v)
 {
-	reset(var, new ImplBoolean(v));
+	assign(var, sharedBoolean(v));
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Integer v)
@@ -668,6 +686,42 @@ const LLSD& LLSD::Impl::undef()
 	return immutableUndefined;
 }
 
+const LLSD::Impl* LLSD::Impl::sharedBoolean(LLSD::Boolean v)
+{
+	static const ImplBoolean sTrue(true, STATIC);
+	static const ImplBoolean sFalse(false, STATIC);
+	return v ? &sTrue : &sFalse;
+}
+
+const LLSD::Impl* LLSD::Impl::sharedEmptyMap()
+{
+	static const ImplMap sEmptyMap(STATIC);
+	return &sEmptyMap;
+}
+
+const LLSD::Impl* LLSD::Impl::sharedEmptyArray()
+{
+	static const ImplArray sEmptyArray(STATIC);
+	return &sEmptyArray;
+}
+
+namespace
+{
+	// Construct the shared impls during static initialization, before any
+	// other thread exists, rather than on first use: function local statics
+	// are not initialized thread safely by every compiler we build with.
+	struct SharedImplInit
+	{
+		SharedImplInit()
+		{
+			LLSD::Impl::sharedBoolean(true);
+			LLSD::Impl::sharedEmptyMap();
+			LLSD::Impl::sharedEmptyArray();
+		}
+	};
+	SharedImplInit sSharedImplInit;
+}
+
 U32 LLSD::Impl::sAllocationCount = 0;
 U32 LLSD::Impl::sOutstandingCount = 0;
 
@@ -749,7 +803,7 @@ void LLSD::assign(const char* v)
 LLSD LLSD::emptyMap()
 {
 	LLSD v;
-	makeMap(v.impl);
+	Impl::assign(v.impl, Impl::sharedEmptyMap());
 	return v;
 }
 
@@ -759,7 +813,7 @@ LLSD LLSD::get(const String& k) const	{ return safe(impl).get(k); }
 LLSD& LLSD::insert(const String& k, const LLSD& v)
 										{ 
 											makeMap(impl).insert(k, v); 
-											return *dynamic_cast<LLSD*>(this);
+											return *this;
 										}
 void LLSD::erase(const String& k)		{ makeMap(impl).erase(k); }
 
@@ -772,7 +826,7 @@ const LLSD& LLSD::operator[](const String& k) const
 LLSD LLSD::emptyArray()
 {
 	LLSD v;
-	makeArray(v.impl);
+	Impl::assign(v.impl, Impl::sharedEmptyArray());
 	return v;
 }
 
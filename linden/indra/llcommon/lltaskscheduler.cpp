@@ -0,0 +1,315 @@
+/** 
+ * @file lltaskscheduler.cpp
+ * @brief Shared pool of worker threads with per-worker queues and work stealing
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "lltaskscheduler.h"
+
+#if LL_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <winsock2.h>
+#	include <windows.h>
+#elif LL_DARWIN
+#	include <sys/types.h>
+#	include <sys/sysctl.h>
+#else
+#	include <unistd.h>
+#endif
+
+#include "llstl.h"
+#include "llstring.h"
+
+LLTaskScheduler* LLTaskScheduler::sInstance = NULL;
+
+//============================================================================
+// MAIN THREAD
+
+//static
+void LLTaskScheduler::initClass(U32 num_workers)
+{
+	llassert(sInstance == NULL);
+	if (num_workers == 0)
+	{
+		num_workers = getDefaultWorkerCount();
+	}
+	sInstance = new LLTaskScheduler("TaskScheduler", num_workers);
+	llinfos << "LLTaskScheduler started " << num_workers << " workers" << llendl;
+}
+
+//static
+void LLTaskScheduler::cleanupClass()
+{
+	delete sInstance;
+	sInstance = NULL;
+}
+
+//static
+U32 LLTaskScheduler::getDefaultWorkerCount()
+{
+	S32 num_cpus = 1;
+#if LL_WINDOWS
+	SYSTEM_INFO sys_info;
+	GetSystemInfo(&sys_info);
+	num_cpus = (S32)sys_info.dwNumberOfProcessors;
+#elif LL_DARWIN
+	int mib[2] = { CTL_HW, HW_NCPU };
+	int count = 1;
+	size_t len = sizeof(count);
+	if (sysctl(mib, 2, &count, &len, NULL, 0) == 0)
+	{
+		num_cpus = count;
+	}
+#else
+	num_cpus = (S32)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	// Leave a core for the main thread, but always have at least two
+	// workers so one long task cannot block every subsystem.
+	return (U32)llclamp(num_cpus - 1, 2, 16);
+}
+
+LLTaskScheduler::LLTaskScheduler(const std::string& name, U32 num_workers) :
+	mName(name),
+	mWorkCondition(NULL),
+	mQuitting(false),
+	mPending(0),
+	mNextWorker(0),
+	mStealCount(0)
+{
+	num_workers = llmax(num_workers, 1U);
+	for (U32 i = 0; i < num_workers; ++i)
+	{
+		mWorkers.push_back(new Worker(this, i, llformat("%s %d", name.c_str(), i)));
+	}
+	// Start them only once the vector is complete, since workers walk it
+	// when stealing.
+	for (U32 i = 0; i < num_workers; ++i)
+	{
+		mWorkers[i]->start();
+	}
+}
+
+LLTaskScheduler::~LLTaskScheduler()
+{
+	shutdown();
+}
+
+void LLTaskScheduler::shutdown()
+{
+	mWorkCondition.lock();
+	mQuitting = true;
+	mWorkCondition.broadcast();
+	mWorkCondition.unlock();
+
+	// Workers finish the task they are running before they notice, and a
+	// task can't be interrupted, so wait for every one of them however long
+	// it takes.  Deleting the lanes or ourselves under a live worker would
+	// be far worse than a slow exit.
+	for (std::vector<Worker*>::iterator iter = mWorkers.begin();
+		 iter != mWorkers.end(); ++iter)
+	{
+		Worker* worker = *iter;
+		S32 waited = 0;
+		while (!worker->isStopped())
+		{
+			ms_sleep(10);
+			LLThread::yield();
+			if (++waited == 100)
+			{
+				llwarns << "~LLTaskScheduler (" << mName << ") still waiting for a worker to finish its task" << llendl;
+			}
+		}
+	}
+
+	// Anything still queued never ran.  schedule() pushes under
+	// mWorkCondition and refuses work once mQuitting is set, so after this
+	// nothing new can arrive.
+	std::vector<Task*> dropped;
+	mWorkCondition.lock();
+	for (std::vector<Worker*>::iterator iter = mWorkers.begin();
+		 iter != mWorkers.end(); ++iter)
+	{
+		Worker* worker = *iter;
+		worker->mQueueMutex.lock();
+		for (S32 lane = 0; lane < LANE_COUNT; ++lane)
+		{
+			dropped.insert(dropped.end(), worker->mLanes[lane].begin(), worker->mLanes[lane].end());
+			worker->mLanes[lane].clear();
+		}
+		worker->mQueueMutex.unlock();
+	}
+	mWorkCondition.unlock();
+
+	// outside the locks, cancelled() may well try to schedule again
+	for (std::vector<Task*>::iterator iter = dropped.begin();
+		 iter != dropped.end(); ++iter)
+	{
+		(*iter)->cancelled();
+		delete *iter;
+	}
+	if (!dropped.empty())
+	{
+		llwarns << "~LLTaskScheduler() dropped " << dropped.size() << " pending tasks" << llendl;
+	}
+
+	for_each(mWorkers.begin(), mWorkers.end(), DeletePointer());
+	mWorkers.clear();
+}
+
+//============================================================================
+// ANY THREAD
+
+void LLTaskScheduler::schedule(Task* task, lane_t lane)
+{
+	llassert(lane >= 0 && lane < LANE_COUNT);
+
+	// Holding mWorkCondition across the push keeps shutdown() from
+	// draining the lanes between our check of mQuitting and the push.
+	mWorkCondition.lock();
+	if (mQuitting)
+	{
+		// nothing scheduled once shutdown starts would ever run
+		mWorkCondition.unlock();
+		task->cancelled();
+		delete task;
+		return;
+	}
+
+	U32 index = mNextWorker++ % mWorkers.size();
+	Worker* worker = mWorkers[index];
+
+	// Count the task before it becomes visible, so a worker that takes it
+	// straight away never sees the counter go negative.
+	mPending++;
+
+	worker->mQueueMutex.lock();
+	worker->mLanes[lane].push_back(task);
+	worker->mQueueMutex.unlock();
+
+	mWorkCondition.signal();
+	mWorkCondition.unlock();
+}
+
+//============================================================================
+// WORKER THREADS
+
+LLTaskScheduler::Task* LLTaskScheduler::popTask(U32 worker_index)
+{
+	const U32 num_workers = mWorkers.size();
+	for (S32 lane = 0; lane < LANE_COUNT; ++lane)
+	{
+		// Own queue first, oldest task first
+		Worker* self = mWorkers[worker_index];
+		self->mQueueMutex.lock();
+		if (!self->mLanes[lane].empty())
+		{
+			Task* task = self->mLanes[lane].front();
+			self->mLanes[lane].pop_front();
+			self->mQueueMutex.unlock();
+			mPending -= 1;
+			return task;
+		}
+		self->mQueueMutex.unlock();
+
+		// Then steal from the back of the other workers' queues
+		for (U32 i = 1; i < num_workers; ++i)
+		{
+			Worker* victim = mWorkers[(worker_index + i) % num_workers];
+			if (!victim->mQueueMutex.tryLock())
+			{
+				// busy, the owner will get to it
+				continue;
+			}
+			if (!victim->mLanes[lane].empty())
+			{
+				Task* task = victim->mLanes[lane].back();
+				victim->mLanes[lane].pop_back();
+				victim->mQueueMutex.unlock();
+				mPending -= 1;
+				mStealCount++;
+				return task;
+			}
+			victim->mQueueMutex.unlock();
+		}
+	}
+	return NULL;
+}
+
+void LLTaskScheduler::waitForWork()
+{
+	mWorkCondition.lock();
+	if (!mQuitting && mPending == 0)
+	{
+		mWorkCondition.wait();
+	}
+	mWorkCondition.unlock();
+}
+
+LLTaskScheduler::Worker::Worker(LLTaskScheduler* scheduler, U32 index, const std::string& name) :
+	LLThread(name),
+	mQueueMutex(NULL),
+	mScheduler(scheduler),
+	mIndex(index)
+{
+}
+
+// virtual
+void LLTaskScheduler::Worker::run()
+{
+	while (1)
+	{
+		mScheduler->mWorkCondition.lock();
+		bool quitting = mScheduler->mQuitting;
+		mScheduler->mWorkCondition.unlock();
+		if (quitting)
+		{
+			break;
+		}
+
+		Task* task = mScheduler->popTask(mIndex);
+		if (!task)
+		{
+			// A task whose victim queue was locked may have been skipped,
+			// so this only sleeps once nothing at all is pending.
+			mScheduler->waitForWork();
+			continue;
+		}
+
+		if (task->isCancelled())
+		{
+			task->cancelled();
+		}
+		else
+		{
+			task->run();
+		}
+		delete task;
+	}
+}
@@ -0,0 +1,153 @@
+/** 
+ * @file lltaskscheduler.h
+ * @brief Shared pool of worker threads with per-worker queues and work stealing
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTASKSCHEDULER_H
+#define LL_LLTASKSCHEDULER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "llapr.h"
+#include "llthread.h"
+
+//============================================================================
+// LLTaskScheduler runs small tasks on a pool of worker threads that is
+// shared by every background subsystem, instead of each subsystem owning
+// a thread of its own.
+//
+// Each worker keeps one queue per priority lane.  A worker takes work from
+// the highest non-empty lane, preferring its own queue and otherwise
+// stealing from the other end of another worker's queue, so a busy worker
+// never starves the rest of the pool.
+//
+// Tasks may carry a CancelToken.  A task whose token has been cancelled
+// before it starts has cancelled() called instead of run().
+
+class LLTaskScheduler
+{
+public:
+	enum lane_t {
+		LANE_URGENT = 0,
+		LANE_HIGH,
+		LANE_NORMAL,
+		LANE_LOW,
+		LANE_COUNT
+	};
+
+	class CancelToken : public LLThreadSafeRefCount
+	{
+	public:
+		CancelToken() : mCancelled(0) {}
+
+		void cancel() { mCancelled = 1; }
+		bool isCancelled() { return mCancelled != 0; }
+
+	private:
+		LLAtomicU32 mCancelled;
+	};
+	typedef LLPointer<CancelToken> cancel_token_t;
+
+	class Task
+	{
+	public:
+		Task(CancelToken* token = NULL) : mToken(token) {}
+		virtual ~Task() {}
+
+		virtual void run() = 0; // WORKER THREAD
+		virtual void cancelled() {} // WORKER THREAD, called instead of run() once cancelled
+
+		bool isCancelled() { return mToken.notNull() && mToken->isCancelled(); }
+
+	private:
+		cancel_token_t mToken;
+	};
+
+public:
+	// The shared scheduler.  num_workers == 0 sizes the pool to the number
+	// of CPUs, leaving one for the main thread.
+	static void initClass(U32 num_workers = 0);
+	static void cleanupClass();
+	static LLTaskScheduler* getInstance() { return sInstance; }
+
+	static U32 getDefaultWorkerCount();
+
+	LLTaskScheduler(const std::string& name, U32 num_workers);
+	~LLTaskScheduler();
+
+	// Takes ownership of task, which is deleted once it has run.
+	// May be called from any thread.
+	void schedule(Task* task, lane_t lane = LANE_NORMAL);
+
+	S32 getPending() { return (S32)(U32)mPending; }
+	U32 getNumWorkers() const { return (U32)mWorkers.size(); }
+	U32 getStealCount() { return mStealCount; }
+
+private:
+	// No copy constructor or copy assignment
+	LLTaskScheduler(const LLTaskScheduler&);
+	LLTaskScheduler& operator=(const LLTaskScheduler&);
+
+	class Worker : public LLThread
+	{
+	public:
+		Worker(LLTaskScheduler* scheduler, U32 index, const std::string& name);
+
+		/*virtual*/ void run(void);
+
+		LLMutex mQueueMutex;
+		std::deque<Task*> mLanes[LANE_COUNT];
+
+	private:
+		LLTaskScheduler* mScheduler;
+		U32 mIndex;
+	};
+
+	Task* popTask(U32 worker_index);
+	void waitForWork();
+	void shutdown();
+
+private:
+	std::string mName;
+	std::vector<Worker*> mWorkers;
+
+	LLCondition mWorkCondition;	// guards mQuitting, signalled when work is added
+	bool mQuitting;
+
+	LLAtomicU32 mPending;		// scheduled tasks not yet taken by a worker
+	LLAtomicU32 mNextWorker;	// round robin placement of new tasks
+	LLAtomicU32 mStealCount;
+
+	static LLTaskScheduler* sInstance;
+};
+
+#endif // LL_LLTASKSCHEDULER_H
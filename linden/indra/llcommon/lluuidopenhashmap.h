@@ -0,0 +1,282 @@
+/** 
+ * @file lluuidopenhashmap.h
+ * @brief Open addressing hash map keyed by LLUUID
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLUUIDOPENHASHMAP_H
+#define LL_LLUUIDOPENHASHMAP_H
+
+#include <utility>
+#include <vector>
+
+#include "lluuid.h"
+
+// LLUUIDOpenHashMap is a drop-in replacement for std::map<LLUUID, T>
+// where iteration order does not matter.  The entries live in one
+// contiguous array, so walking the whole map touches memory in order,
+// and a separate linear-probed slot table maps each key hash to its
+// entry.  Lookups compare the cached 32 bit hash before the key.
+//
+// Unlike std::map, inserting may invalidate every iterator, and erasing
+// invalidates iterators to the erased entry and to the last entry
+// (which is moved into the hole).  Do not modify ->first.
+template <class T>
+class LLUUIDOpenHashMap
+{
+public:
+	typedef LLUUID key_type;
+	typedef T mapped_type;
+	typedef std::pair<LLUUID, T> value_type;
+	typedef std::vector<value_type> entry_list_t;
+	typedef typename entry_list_t::iterator iterator;
+	typedef typename entry_list_t::const_iterator const_iterator;
+	typedef typename entry_list_t::size_type size_type;
+
+	LLUUIDOpenHashMap() : mMask(0) {}
+
+	iterator begin() { return mEntries.begin(); }
+	iterator end() { return mEntries.end(); }
+	const_iterator begin() const { return mEntries.begin(); }
+	const_iterator end() const { return mEntries.end(); }
+
+	size_type size() const { return mEntries.size(); }
+	bool empty() const { return mEntries.empty(); }
+
+	iterator find(const LLUUID& key)
+	{
+		S32 index = findIndex(key);
+		return (index < 0) ? mEntries.end() : mEntries.begin() + index;
+	}
+
+	const_iterator find(const LLUUID& key) const
+	{
+		S32 index = findIndex(key);
+		return (index < 0) ? mEntries.end() : mEntries.begin() + index;
+	}
+
+	size_type count(const LLUUID& key) const
+	{
+		return (findIndex(key) < 0) ? 0 : 1;
+	}
+
+	T& operator[](const LLUUID& key)
+	{
+		return insert(value_type(key, T())).first->second;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		U32 hash = hashKey(value.first);
+		S32 index = findIndex(value.first, hash);
+		if (index >= 0)
+		{
+			return std::make_pair(mEntries.begin() + index, false);
+		}
+		if ((mEntries.size() + 1) * 4 > mSlots.size() * 3)
+		{
+			rehash(mSlots.empty() ? MIN_SLOTS : mSlots.size() * 2);
+		}
+		mEntries.push_back(value);
+		insertSlot(hash, (U32)mEntries.size());
+		return std::make_pair(mEntries.end() - 1, true);
+	}
+
+	size_type erase(const LLUUID& key)
+	{
+		if (mEntries.empty())
+		{
+			return 0;
+		}
+		U32 hash = hashKey(key);
+		U32 pos = findSlot(key, hash);
+		if (!mSlots[pos].mIndex)
+		{
+			return 0;
+		}
+		U32 hole = mSlots[pos].mIndex - 1;
+		removeSlot(pos);
+
+		// Keep the entries dense by moving the last one into the hole.
+		U32 last = (U32)mEntries.size() - 1;
+		if (hole != last)
+		{
+			U32 last_pos = findSlot(mEntries[last].first, hashKey(mEntries[last].first));
+			mSlots[last_pos].mIndex = hole + 1;
+			std::swap(mEntries[hole], mEntries[last]);
+		}
+		mEntries.pop_back();
+		return 1;
+	}
+
+	void erase(iterator iter)
+	{
+		LLUUID key = iter->first;
+		erase(key);
+	}
+
+	void clear()
+	{
+		mEntries.clear();
+		mSlots.clear();
+		mMask = 0;
+	}
+
+	// Make room for count entries without growing the slot table.
+	void reserve(size_type count)
+	{
+		mEntries.reserve(count);
+		size_type slots = mSlots.empty() ? MIN_SLOTS : mSlots.size();
+		while (count * 4 > slots * 3)
+		{
+			slots *= 2;
+		}
+		if (slots != mSlots.size())
+		{
+			rehash(slots);
+		}
+	}
+
+	void swap(LLUUIDOpenHashMap& other)
+	{
+		mEntries.swap(other.mEntries);
+		mSlots.swap(other.mSlots);
+		std::swap(mMask, other.mMask);
+	}
+
+	// UUIDs are already random, so one multiplicative mix of the four
+	// words is enough to spread them over the low bits.
+	static U32 hashKey(const LLUUID& key)
+	{
+		U32 words[4];
+		memcpy(words, key.mData, sizeof(words));
+		U32 hash = words[0] ^ (words[1] * 0x9e3779b1) ^ words[2] ^ (words[3] * 0x85ebca6b);
+		return hash ^ (hash >> 16);
+	}
+
+private:
+	enum { MIN_SLOTS = 16 };
+
+	struct slot_t
+	{
+		U32 mHash;
+		U32 mIndex;		// entry index + 1, 0 if the slot is empty
+	};
+
+	S32 findIndex(const LLUUID& key) const
+	{
+		return mEntries.empty() ? -1 : findIndex(key, hashKey(key));
+	}
+
+	S32 findIndex(const LLUUID& key, U32 hash) const
+	{
+		if (mSlots.empty())
+		{
+			return -1;
+		}
+		return (S32)mSlots[findSlot(key, hash)].mIndex - 1;
+	}
+
+	// Returns the slot holding key, or the empty slot ending its probe.
+	U32 findSlot(const LLUUID& key, U32 hash) const
+	{
+		U32 pos = hash & mMask;
+		while (mSlots[pos].mIndex)
+		{
+			if (mSlots[pos].mHash == hash
+				&& mEntries[mSlots[pos].mIndex - 1].first == key)
+			{
+				break;
+			}
+			pos = (pos + 1) & mMask;
+		}
+		return pos;
+	}
+
+	void insertSlot(U32 hash, U32 index)
+	{
+		U32 pos = hash & mMask;
+		while (mSlots[pos].mIndex)
+		{
+			pos = (pos + 1) & mMask;
+		}
+		mSlots[pos].mHash = hash;
+		mSlots[pos].mIndex = index;
+	}
+
+	// Backward shift deletion: pull later members of the probe run
+	// into the hole so no tombstones are needed.
+	void removeSlot(U32 hole)
+	{
+		U32 pos = (hole + 1) & mMask;
+		while (mSlots[pos].mIndex)
+		{
+			U32 home = mSlots[pos].mHash & mMask;
+			if (((pos - home) & mMask) >= ((pos - hole) & mMask))
+			{
+				mSlots[hole] = mSlots[pos];
+				hole = pos;
+			}
+			pos = (pos + 1) & mMask;
+		}
+		mSlots[hole].mIndex = 0;
+	}
+
+	void rehash(size_type slots)
+	{
+		slot_t empty_slot = { 0, 0 };
+		mSlots.assign(slots, empty_slot);
+		mMask = (U32)slots - 1;
+		for (U32 i = 0; i < (U32)mEntries.size(); ++i)
+		{
+			insertSlot(hashKey(mEntries[i].first), i + 1);
+		}
+	}
+
+	entry_list_t mEntries;
+	std::vector<slot_t> mSlots;
+	U32 mMask;
+};
+
+// Overloads of the llstl.h helpers so callers can switch container
+// without touching every lookup.
+template <typename T>
+inline T* get_ptr_in_map(const LLUUIDOpenHashMap<T*>& inmap, const LLUUID& key)
+{
+	typename LLUUIDOpenHashMap<T*>::const_iterator iter = inmap.find(key);
+	return (iter == inmap.end()) ? NULL : iter->second;
+}
+
+template <typename T>
+inline bool is_in_map(const LLUUIDOpenHashMap<T>& inmap, const LLUUID& key)
+{
+	return inmap.find(key) != inmap.end();
+}
+
+#endif // LL_LLUUIDOPENHASHMAP_H
@@ -40,8 +40,8 @@
 //============================================================================
 // Run on MAIN thread
 
-LLWorkerThread::LLWorkerThread(const std::string& name, bool threaded) :
-	LLQueuedThread(name, threaded)
+LLWorkerThread::LLWorkerThread(const std::string& name, bool threaded, bool dedicated_thread) :
+	LLQueuedThread(name, threaded, dedicated_thread)
 {
 	mDeleteMutex = new LLMutex(NULL);
 }
@@ -260,7 +260,13 @@ void LLWorkerClass::setWorking(bool working)
 bool LLWorkerClass::yield()
 {
 	LLThread::yield();
-	mWorkerThread->checkPause();
+	if (!mWorkerThread->getUsesScheduler())
+	{
+		// On the shared scheduler this would park a pool worker for as
+		// long as the queue is paused.  Drain tasks stop between requests
+		// while paused instead.
+		mWorkerThread->checkPause();
+	}
 	bool res;
 	mMutex.lock();
 	res = (getFlags() & WCF_ABORT_REQUESTED) ? true : false;
@@ -86,7 +86,7 @@ private:
 	LLMutex* mDeleteMutex;
 	
 public:
-	LLWorkerThread(const std::string& name, bool threaded = true);
+	LLWorkerThread(const std::string& name, bool threaded = true, bool dedicated_thread = false);
 	~LLWorkerThread();
 
 	/*virtual*/ S32 update(U32 max_time_ms);
@@ -161,7 +161,8 @@ protected:
 	
 	// Call from doWork only to avoid eating up cpu time.
 	// Returns true if work has been aborted
-	// yields the current thread and calls mWorkerThread->checkPause()
+	// yields the current thread and calls mWorkerThread->checkPause(),
+	// except on the shared scheduler where pausing never blocks a worker
 	bool yield();
 	
 	void setWorkerThread(LLWorkerThread* workerthread);
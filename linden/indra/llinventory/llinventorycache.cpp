@@ -0,0 +1,435 @@
+/** 
+ * @file llinventorycache.cpp
+ * @brief Binary inventory cache file format.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llinventorycache.h"
+
+#include "llfile.h"
+#include "llinventory.h"
+#include "llpermissions.h"
+#include "llsaleinfo.h"
+
+#if !LL_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const U32 LLInventoryCacheFile::MAGIC = 0x43564e49;	// "INVC"
+const U32 LLInventoryCacheFile::VERSION = 1;
+
+static const U32 BYTE_ORDER_MARK = 0x01020304;
+
+///----------------------------------------------------------------------------
+/// LLInventoryCacheWriter
+///----------------------------------------------------------------------------
+
+LLInventoryCacheWriter::LLInventoryCacheWriter()
+{
+}
+
+LLInventoryCacheFile::string_ref_t LLInventoryCacheWriter::addString(const std::string& str)
+{
+	LLInventoryCacheFile::string_ref_t ref;
+	ref.mOffset = mStringPool.size();
+	ref.mLength = str.size();
+	mStringPool.append(str);
+	return ref;
+}
+
+void LLInventoryCacheWriter::addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version, S32 descendents)
+{
+	LLInventoryCacheFile::category_record_t record;
+	memset(&record, 0, sizeof(record));
+	memcpy(record.mID, cat->getUUID().mData, UUID_BYTES);
+	memcpy(record.mParentID, cat->getParentUUID().mData, UUID_BYTES);
+	memcpy(record.mOwnerID, owner_id.mData, UUID_BYTES);
+	record.mVersion = version;
+	record.mDescendents = descendents;
+	record.mName = addString(cat->getName());
+	record.mType = (S8)cat->getType();
+	record.mPreferredType = (S8)cat->getPreferredType();
+	mCategories.push_back(record);
+}
+
+void LLInventoryCacheWriter::addItem(const LLInventoryItem* item)
+{
+	const LLPermissions& perm = item->getPermissions();
+	const LLSaleInfo& sale_info = item->getSaleInfo();
+
+	LLInventoryCacheFile::item_record_t record;
+	memset(&record, 0, sizeof(record));
+	memcpy(record.mID, item->getUUID().mData, UUID_BYTES);
+	memcpy(record.mParentID, item->getParentUUID().mData, UUID_BYTES);
+	memcpy(record.mAssetID, item->getAssetUUID().mData, UUID_BYTES);
+	memcpy(record.mCreatorID, perm.getCreator().mData, UUID_BYTES);
+	memcpy(record.mOwnerID, perm.getOwner().mData, UUID_BYTES);
+	memcpy(record.mLastOwnerID, perm.getLastOwner().mData, UUID_BYTES);
+	memcpy(record.mGroupID, perm.getGroup().mData, UUID_BYTES);
+	record.mMaskBase = perm.getMaskBase();
+	record.mMaskOwner = perm.getMaskOwner();
+	record.mMaskGroup = perm.getMaskGroup();
+	record.mMaskEveryone = perm.getMaskEveryone();
+	record.mMaskNextOwner = perm.getMaskNextOwner();
+	record.mFlags = item->getFlags();
+	record.mSalePrice = sale_info.getSalePrice();
+	record.mCreationDate = (S32)item->getCreationDate();
+	record.mName = addString(item->getName());
+	record.mDescription = addString(item->getDescription());
+	record.mType = (S8)item->getType();
+	record.mInventoryType = (S8)item->getInventoryType();
+	record.mSaleType = (S8)sale_info.getSaleType();
+	mItems.push_back(record);
+}
+
+void LLInventoryCacheWriter::finish(std::vector<U8>& buffer)
+{
+	LLInventoryCacheFile::header_t header;
+	header.mMagic = LLInventoryCacheFile::MAGIC;
+	header.mVersion = LLInventoryCacheFile::VERSION;
+	header.mByteOrder = BYTE_ORDER_MARK;
+	header.mCategoryCount = mCategories.size();
+	header.mItemCount = mItems.size();
+	header.mStringPoolSize = mStringPool.size();
+
+	size_t categories_size = mCategories.size() * sizeof(LLInventoryCacheFile::category_record_t);
+	size_t items_size = mItems.size() * sizeof(LLInventoryCacheFile::item_record_t);
+	buffer.resize(sizeof(header) + categories_size + items_size + mStringPool.size());
+
+	U8* out = &buffer[0];
+	memcpy(out, &header, sizeof(header));
+	out += sizeof(header);
+	if (categories_size)
+	{
+		memcpy(out, &mCategories[0], categories_size);
+		out += categories_size;
+	}
+	if (items_size)
+	{
+		memcpy(out, &mItems[0], items_size);
+		out += items_size;
+	}
+	if (!mStringPool.empty())
+	{
+		memcpy(out, mStringPool.data(), mStringPool.size());
+	}
+
+	mCategories.clear();
+	mItems.clear();
+	mStringPool.clear();
+}
+
+// static
+bool LLInventoryCacheWriter::writeFile(const std::string& filename, const std::vector<U8>& buffer)
+{
+	std::string temp_filename = filename + ".tmp";
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");		/*Flawfinder: ignore*/
+	if (!fp)
+	{
+		llwarns << "Unable to open " << temp_filename << " for writing" << llendl;
+		return false;
+	}
+	size_t written = buffer.empty() ? 0 : fwrite(&buffer[0], 1, buffer.size(), fp);
+	bool ok = (written == buffer.size());
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok)
+	{
+		llwarns << "Unable to write " << temp_filename << llendl;
+		LLFile::remove(temp_filename);
+		return false;
+	}
+
+#if LL_WINDOWS
+	// rename() won't replace an existing file here
+	LLFile::remove(filename);
+#endif
+	if (LLFile::rename(temp_filename, filename) != 0)
+	{
+		llwarns << "Unable to rename " << temp_filename << " to " << filename << llendl;
+		LLFile::remove(temp_filename);
+		return false;
+	}
+	return true;
+}
+
+///----------------------------------------------------------------------------
+/// LLInventoryCacheReader
+///----------------------------------------------------------------------------
+
+LLInventoryCacheReader::LLInventoryCacheReader()
+:	mData(NULL),
+	mSize(0),
+	mMapped(false),
+	mHeader(NULL),
+	mCategories(NULL),
+	mItems(NULL),
+	mStringPool(NULL)
+{
+}
+
+LLInventoryCacheReader::~LLInventoryCacheReader()
+{
+	close();
+}
+
+bool LLInventoryCacheReader::open(const std::string& filename)
+{
+	close();
+
+#if LL_WINDOWS
+	// no mapping wrapper here, so read the whole file in one go
+	LLFILE* fp = LLFile::fopen(filename, "rb");		/*Flawfinder: ignore*/
+	if (!fp)
+	{
+		return false;
+	}
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size > 0)
+	{
+		mBuffer.resize(size);
+		if (fread(&mBuffer[0], 1, size, fp) != (size_t)size)
+		{
+			mBuffer.clear();
+		}
+	}
+	fclose(fp);
+	if (mBuffer.empty())
+	{
+		return false;
+	}
+	mData = &mBuffer[0];
+	mSize = mBuffer.size();
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+	{
+		::close(fd);
+		return false;
+	}
+	void* data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping holds its own reference to the file
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		llwarns << "Unable to map " << filename << llendl;
+		return false;
+	}
+	mData = (const U8*)data;
+	mSize = file_stat.st_size;
+	mMapped = true;
+#endif
+
+	if (!validate())
+	{
+		llwarns << "Ignoring invalid inventory cache " << filename << llendl;
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool LLInventoryCacheReader::open(const U8* data, size_t size)
+{
+	close();
+	if (!data || !size)
+	{
+		return false;
+	}
+	mBuffer.assign(data, data + size);
+	mData = &mBuffer[0];
+	mSize = size;
+	if (!validate())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void LLInventoryCacheReader::close()
+{
+#if !LL_WINDOWS
+	if (mMapped)
+	{
+		munmap((void*)mData, mSize);
+	}
+#endif
+	mMapped = false;
+	mBuffer.clear();
+	mData = NULL;
+	mSize = 0;
+	mHeader = NULL;
+	mCategories = NULL;
+	mItems = NULL;
+	mStringPool = NULL;
+}
+
+bool LLInventoryCacheReader::validate()
+{
+	if (mSize < sizeof(LLInventoryCacheFile::header_t))
+	{
+		return false;
+	}
+	mHeader = (const LLInventoryCacheFile::header_t*)mData;
+	if (mHeader->mMagic != LLInventoryCacheFile::MAGIC
+		|| mHeader->mVersion != LLInventoryCacheFile::VERSION
+		|| mHeader->mByteOrder != BYTE_ORDER_MARK)
+	{
+		return false;
+	}
+
+	// sizes are checked in 64 bits so a corrupt count can't wrap
+	U64 categories_size = (U64)mHeader->mCategoryCount * sizeof(LLInventoryCacheFile::category_record_t);
+	U64 items_size = (U64)mHeader->mItemCount * sizeof(LLInventoryCacheFile::item_record_t);
+	U64 expected = sizeof(LLInventoryCacheFile::header_t) + categories_size + items_size + mHeader->mStringPoolSize;
+	if (expected != (U64)mSize)
+	{
+		return false;
+	}
+
+	const U8* data = mData + sizeof(LLInventoryCacheFile::header_t);
+	mCategories = (const LLInventoryCacheFile::category_record_t*)data;
+	data += categories_size;
+	mItems = (const LLInventoryCacheFile::item_record_t*)data;
+	data += items_size;
+	mStringPool = (const char*)data;
+	return true;
+}
+
+S32 LLInventoryCacheReader::getCategoryCount() const
+{
+	return mHeader ? (S32)mHeader->mCategoryCount : 0;
+}
+
+S32 LLInventoryCacheReader::getItemCount() const
+{
+	return mHeader ? (S32)mHeader->mItemCount : 0;
+}
+
+bool LLInventoryCacheReader::getString(const LLInventoryCacheFile::string_ref_t& ref, std::string& str) const
+{
+	if ((U64)ref.mOffset + ref.mLength > mHeader->mStringPoolSize)
+	{
+		return false;
+	}
+	str.assign(mStringPool + ref.mOffset, ref.mLength);
+	return true;
+}
+
+bool LLInventoryCacheReader::readCategory(S32 index, LLInventoryCategory* cat, LLUUID& owner_id, S32& version, S32& descendents) const
+{
+	if (index < 0 || index >= getCategoryCount())
+	{
+		return false;
+	}
+	// records may not be aligned in the mapping, so copy out first
+	LLInventoryCacheFile::category_record_t record;
+	memcpy(&record, mCategories + index, sizeof(record));
+
+	std::string name;
+	if (!getString(record.mName, name))
+	{
+		return false;
+	}
+
+	LLUUID id;
+	memcpy(id.mData, record.mID, UUID_BYTES);
+	cat->setUUID(id);
+	memcpy(id.mData, record.mParentID, UUID_BYTES);
+	cat->setParent(id);
+	memcpy(owner_id.mData, record.mOwnerID, UUID_BYTES);
+	cat->setType((LLAssetType::EType)record.mType);
+	cat->setPreferredType((LLAssetType::EType)record.mPreferredType);
+	cat->rename(name);
+	version = record.mVersion;
+	descendents = record.mDescendents;
+	return true;
+}
+
+bool LLInventoryCacheReader::readItem(S32 index, LLInventoryItem* item) const
+{
+	if (index < 0 || index >= getItemCount())
+	{
+		return false;
+	}
+	LLInventoryCacheFile::item_record_t record;
+	memcpy(&record, mItems + index, sizeof(record));
+
+	std::string name;
+	std::string desc;
+	if (!getString(record.mName, name) || !getString(record.mDescription, desc))
+	{
+		return false;
+	}
+
+	LLUUID id;
+	memcpy(id.mData, record.mID, UUID_BYTES);
+	item->setUUID(id);
+	memcpy(id.mData, record.mParentID, UUID_BYTES);
+	item->setParent(id);
+	memcpy(id.mData, record.mAssetID, UUID_BYTES);
+	item->setAssetUUID(id);
+
+	LLUUID creator_id, owner_id, last_owner_id, group_id;
+	memcpy(creator_id.mData, record.mCreatorID, UUID_BYTES);
+	memcpy(owner_id.mData, record.mOwnerID, UUID_BYTES);
+	memcpy(last_owner_id.mData, record.mLastOwnerID, UUID_BYTES);
+	memcpy(group_id.mData, record.mGroupID, UUID_BYTES);
+	LLPermissions perm;
+	perm.init(creator_id, owner_id, last_owner_id, group_id);
+	// as importFile() does, without initMasks()' fair use changes
+	perm.setMaskBase(record.mMaskBase);
+	perm.setMaskOwner(record.mMaskOwner);
+	perm.setMaskGroup(record.mMaskGroup);
+	perm.setMaskEveryone(record.mMaskEveryone);
+	perm.setMaskNext(record.mMaskNextOwner);
+	perm.fix();
+	item->setPermissions(perm);
+
+	item->setSaleInfo(LLSaleInfo((LLSaleInfo::EForSale)record.mSaleType, record.mSalePrice));
+	item->setFlags(record.mFlags);
+	item->setType((LLAssetType::EType)record.mType);
+	item->setInventoryType((LLInventoryType::EType)record.mInventoryType);
+	item->setCreationDate((time_t)record.mCreationDate);
+	item->rename(name);
+	item->setDescription(desc);
+	return true;
+}
@@ -0,0 +1,177 @@
+/** 
+ * @file llinventorycache.h
+ * @brief Binary inventory cache file format.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYCACHE_H
+#define LL_LLINVENTORYCACHE_H
+
+#include <string>
+#include <vector>
+
+#include "lluuid.h"
+
+class LLInventoryCategory;
+class LLInventoryItem;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Binary inventory cache
+//
+// A header, an array of fixed size category records, an array of fixed
+// size item records, then a pool holding every name and description.
+// Records can be decoded independently, so a reader can hand out ranges
+// of them to several threads.  The file is written in native byte order
+// and a reader rejects a file from a machine with another, along with
+// any other version.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class LLInventoryCacheFile
+{
+public:
+	static const U32 MAGIC;
+	static const U32 VERSION;
+
+	struct header_t
+	{
+		U32 mMagic;
+		U32 mVersion;
+		U32 mByteOrder;
+		U32 mCategoryCount;
+		U32 mItemCount;
+		U32 mStringPoolSize;
+	};
+
+	struct string_ref_t
+	{
+		U32 mOffset;
+		U32 mLength;
+	};
+
+	struct category_record_t
+	{
+		U8 mID[UUID_BYTES];
+		U8 mParentID[UUID_BYTES];
+		U8 mOwnerID[UUID_BYTES];
+		S32 mVersion;
+		S32 mDescendents;
+		string_ref_t mName;
+		S8 mType;
+		S8 mPreferredType;
+		U8 mPad[2];
+	};
+
+	struct item_record_t
+	{
+		U8 mID[UUID_BYTES];
+		U8 mParentID[UUID_BYTES];
+		U8 mAssetID[UUID_BYTES];
+		U8 mCreatorID[UUID_BYTES];
+		U8 mOwnerID[UUID_BYTES];
+		U8 mLastOwnerID[UUID_BYTES];
+		U8 mGroupID[UUID_BYTES];
+		U32 mMaskBase;
+		U32 mMaskOwner;
+		U32 mMaskGroup;
+		U32 mMaskEveryone;
+		U32 mMaskNextOwner;
+		U32 mFlags;
+		S32 mSalePrice;
+		S32 mCreationDate;
+		string_ref_t mName;
+		string_ref_t mDescription;
+		S8 mType;
+		S8 mInventoryType;
+		S8 mSaleType;
+		U8 mPad;
+	};
+};
+
+// Builds a cache file in memory.  Encoding is cheap, so it can be done
+// on the main thread and the buffer handed to another thread to write.
+class LLInventoryCacheWriter
+{
+public:
+	LLInventoryCacheWriter();
+
+	// version and descendents are those of the viewer side category,
+	// checked against the server's on the next load.
+	void addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version, S32 descendents);
+	void addItem(const LLInventoryItem* item);
+
+	// Assembles the file contents, leaving the writer empty.
+	void finish(std::vector<U8>& buffer);
+
+	// Writes buffer to a temporary file and renames it over filename, so
+	// an interrupted write never leaves a truncated cache behind.
+	static bool writeFile(const std::string& filename, const std::vector<U8>& buffer);
+
+private:
+	LLInventoryCacheFile::string_ref_t addString(const std::string& str);
+
+	std::vector<LLInventoryCacheFile::category_record_t> mCategories;
+	std::vector<LLInventoryCacheFile::item_record_t> mItems;
+	std::string mStringPool;
+};
+
+// Maps a cache file and decodes records on request.  Decoding only reads
+// the mapping, so several threads may decode different records at once.
+class LLInventoryCacheReader
+{
+public:
+	LLInventoryCacheReader();
+	~LLInventoryCacheReader();
+
+	// Maps filename and checks its header and sizes.
+	bool open(const std::string& filename);
+	// Uses a copy of an in-memory file, for the same checks.
+	bool open(const U8* data, size_t size);
+	void close();
+
+	S32 getCategoryCount() const;
+	S32 getItemCount() const;
+
+	bool readCategory(S32 index, LLInventoryCategory* cat, LLUUID& owner_id, S32& version, S32& descendents) const;
+	bool readItem(S32 index, LLInventoryItem* item) const;
+
+private:
+	bool validate();
+	bool getString(const LLInventoryCacheFile::string_ref_t& ref, std::string& str) const;
+
+	const U8* mData;
+	size_t mSize;
+	bool mMapped;
+	std::vector<U8> mBuffer;	// file contents where there is no mapping
+	const LLInventoryCacheFile::header_t* mHeader;
+	const LLInventoryCacheFile::category_record_t* mCategories;
+	const LLInventoryCacheFile::item_record_t* mItems;
+	const char* mStringPool;
+};
+
+#endif // LL_LLINVENTORYCACHE_H
@@ -0,0 +1,290 @@
+/** 
+ * @file llinventorysearchindex.cpp
+ * @brief N-gram index over inventory object names
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llinventorysearchindex.h"
+
+#include <algorithm>
+
+#include "llinventorytype.h"
+#include "llstring.h"
+
+// Needles shorter than this cannot use the index and scan every name.
+static const U32 TRIGRAM_LENGTH = 3;
+
+// Do not bother rebuilding postings over a handful of stale entries.
+static const U32 MIN_STALE_POSTINGS = 4096;
+
+LLInventorySearchIndex::LLInventorySearchIndex() :
+	mPostingCount(0),
+	mStalePostings(0),
+	mVersion(0)
+{
+}
+
+// static
+void LLInventorySearchIndex::getTrigrams(const std::string& name, std::vector<U32>& trigrams)
+{
+	trigrams.clear();
+	if (name.size() < TRIGRAM_LENGTH)
+	{
+		return;
+	}
+	for (U32 i = 0; i + TRIGRAM_LENGTH <= name.size(); ++i)
+	{
+		trigrams.push_back(((U32)(U8)name[i] << 16)
+						   | ((U32)(U8)name[i + 1] << 8)
+						   | (U32)(U8)name[i + 2]);
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void LLInventorySearchIndex::addPostings(U32 slot)
+{
+	std::vector<U32> trigrams;
+	getTrigrams(mEntries[slot].mName, trigrams);
+	for (U32 i = 0; i < trigrams.size(); ++i)
+	{
+		mPostings[trigrams[i]].push_back(slot);
+	}
+	mPostingCount += trigrams.size();
+}
+
+// The postings themselves stay put until the next rebuild; find()
+// weeds them out by checking the name.  The caller re-adds the slot
+// afterwards if it is still live.
+void LLInventorySearchIndex::dropPostings(U32 slot)
+{
+	std::vector<U32> trigrams;
+	getTrigrams(mEntries[slot].mName, trigrams);
+	mStalePostings += trigrams.size();
+
+	if (mStalePostings > MIN_STALE_POSTINGS
+		&& mStalePostings > mPostingCount - mStalePostings)
+	{
+		mPostings.clear();
+		mPostingCount = 0;
+		mStalePostings = 0;
+		for (U32 i = 0; i < mEntries.size(); ++i)
+		{
+			if (mEntries[i].mLive && i != slot)
+			{
+				addPostings(i);
+			}
+		}
+	}
+}
+
+void LLInventorySearchIndex::update(const LLUUID& id, const LLUUID& parent_id,
+									const std::string& name, U32 ntype)
+{
+	std::string upper_name(name);
+	LLStringUtil::toUpper(upper_name);
+
+	U32 slot;
+	LLUUIDOpenHashMap<U32>::iterator it = mSlots.find(id);
+	if (it != mSlots.end())
+	{
+		slot = it->second;
+		entry_t& entry = mEntries[slot];
+		if (entry.mParentID == parent_id
+			&& entry.mNType == ntype
+			&& entry.mName == upper_name)
+		{
+			return;
+		}
+		entry.mParentID = parent_id;
+		entry.mNType = ntype;
+		if (entry.mName != upper_name)
+		{
+			dropPostings(slot);
+			mEntries[slot].mName = upper_name;
+			addPostings(slot);
+		}
+		++mVersion;
+		return;
+	}
+
+	if (mFreeSlots.empty())
+	{
+		slot = mEntries.size();
+		mEntries.push_back(entry_t());
+	}
+	else
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	entry_t& entry = mEntries[slot];
+	entry.mID = id;
+	entry.mParentID = parent_id;
+	entry.mName = upper_name;
+	entry.mNType = ntype;
+	entry.mLive = true;
+	mSlots[id] = slot;
+	addPostings(slot);
+	++mVersion;
+}
+
+void LLInventorySearchIndex::remove(const LLUUID& id)
+{
+	LLUUIDOpenHashMap<U32>::iterator it = mSlots.find(id);
+	if (it == mSlots.end())
+	{
+		return;
+	}
+	U32 slot = it->second;
+	mSlots.erase(id);
+	mEntries[slot].mLive = false;
+	dropPostings(slot);
+	mEntries[slot].mName.clear();
+	mFreeSlots.push_back(slot);
+	++mVersion;
+}
+
+void LLInventorySearchIndex::clear()
+{
+	mEntries.clear();
+	mFreeSlots.clear();
+	mSlots.clear();
+	mPostings.clear();
+	mPostingCount = 0;
+	mStalePostings = 0;
+	++mVersion;
+}
+
+void LLInventorySearchIndex::find(const std::string& substring, U32 ntypes,
+								  match_map_t& matches) const
+{
+	matches.clear();
+	std::string needle(substring);
+	LLStringUtil::toUpper(needle);
+	if (needle.empty())
+	{
+		return;
+	}
+
+	// Pick the candidates: the shortest posting list of any trigram in
+	// the needle, or everything if the needle is too short to have one.
+	std::vector<U32> candidates;
+	if (needle.size() < TRIGRAM_LENGTH)
+	{
+		candidates.reserve(mSlots.size());
+		for (U32 i = 0; i < mEntries.size(); ++i)
+		{
+			if (mEntries[i].mLive)
+			{
+				candidates.push_back(i);
+			}
+		}
+	}
+	else
+	{
+		std::vector<U32> trigrams;
+		getTrigrams(needle, trigrams);
+		const posting_list_t* shortest = NULL;
+		for (U32 i = 0; i < trigrams.size(); ++i)
+		{
+			posting_map_t::const_iterator pit = mPostings.find(trigrams[i]);
+			if (pit == mPostings.end())
+			{
+				// Nothing contains this trigram, so nothing matches.
+				return;
+			}
+			if (!shortest || pit->second.size() < shortest->size())
+			{
+				shortest = &pit->second;
+			}
+		}
+		candidates = *shortest;
+		// Slots can be listed twice after a rename or reuse.
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+
+	std::vector<U32> matched;
+	for (U32 i = 0; i < candidates.size(); ++i)
+	{
+		const entry_t& entry = mEntries[candidates[i]];
+		if (entry.mLive
+			&& ((entry.mNType & ntypes) || entry.mNType == LLInventoryType::NIT_NONE)
+			&& entry.mName.find(needle) != std::string::npos)
+		{
+			matched.push_back(candidates[i]);
+		}
+	}
+
+	matches.reserve(matched.size() * 2);
+	for (U32 i = 0; i < matched.size(); ++i)
+	{
+		matches[mEntries[matched[i]].mID] = true;
+	}
+
+	for (U32 i = 0; i < matched.size(); ++i)
+	{
+		addAncestors(mEntries[matched[i]].mParentID, matches);
+	}
+}
+
+void LLInventorySearchIndex::addMatch(const LLUUID& id, match_map_t& matches) const
+{
+	matches[id] = true;
+	LLUUIDOpenHashMap<U32>::const_iterator it = mSlots.find(id);
+	if (it != mSlots.end())
+	{
+		addAncestors(mEntries[it->second].mParentID, matches);
+	}
+}
+
+// Marks parent_id and everything above it, stopping at the first one
+// already marked.  Matches are walked up from separately, so meeting
+// one on the way is also a stopping point.
+void LLInventorySearchIndex::addAncestors(const LLUUID& parent_id, match_map_t& matches) const
+{
+	LLUUID id = parent_id;
+	while (id.notNull())
+	{
+		if (matches.find(id) != matches.end())
+		{
+			break;
+		}
+		matches[id] = false;
+		LLUUIDOpenHashMap<U32>::const_iterator it = mSlots.find(id);
+		if (it == mSlots.end())
+		{
+			break;
+		}
+		id = mEntries[it->second].mParentID;
+	}
+}
@@ -0,0 +1,118 @@
+/** 
+ * @file llinventorysearchindex.h
+ * @brief N-gram index over inventory object names
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYSEARCHINDEX_H
+#define LL_LLINVENTORYSEARCHINDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "lluuid.h"
+#include "lluuidopenhashmap.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Inventory search index
+//
+// Maps every trigram of an upper cased object name to the objects whose
+// name contains it.  A substring query looks up the rarest trigram of
+// the needle and only checks the names on that list, so typing into an
+// inventory search box costs in proportion to the matches rather than
+// the size of the inventory.  Objects also record their parent and
+// LLInventoryType::NType so a query can hand back the ancestors of each
+// match, which is what a folder view needs to know which subtrees to
+// walk.
+//
+// Removed and renamed entries leave stale postings behind; queries
+// verify every candidate against its current name, and the postings are
+// rebuilt once the stale ones outnumber the live ones.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class LLInventorySearchIndex
+{
+public:
+	// true for objects whose name matched, false for ancestors that
+	// are only present because something below them matched.
+	typedef LLUUIDOpenHashMap<bool> match_map_t;
+
+	LLInventorySearchIndex();
+
+	// Adds the object, or updates it if it is already indexed.
+	void update(const LLUUID& id, const LLUUID& parent_id,
+				const std::string& name, U32 ntype);
+	void remove(const LLUUID& id);
+	void clear();
+
+	S32 size() const { return (S32)mSlots.size(); }
+	bool contains(const LLUUID& id) const { return mSlots.count(id) != 0; }
+
+	// Bumped on every change, so callers can tell when a query result
+	// they are holding has gone stale.
+	U32 getVersion() const { return mVersion; }
+
+	// Fills matches with every object whose name contains substring
+	// (compared case insensitively) and whose type intersects ntypes or
+	// is NIT_NONE, plus the ancestors of each one.
+	void find(const std::string& substring, U32 ntypes, match_map_t& matches) const;
+
+	// Marks id as a match in matches, along with its ancestors.  For
+	// callers that match on text this index does not hold.
+	void addMatch(const LLUUID& id, match_map_t& matches) const;
+
+private:
+	struct entry_t
+	{
+		LLUUID		mID;
+		LLUUID		mParentID;
+		std::string	mName;
+		U32			mNType;
+		bool		mLive;
+	};
+
+	typedef std::vector<U32> posting_list_t;
+	typedef std::map<U32, posting_list_t> posting_map_t;
+
+	static void getTrigrams(const std::string& name, std::vector<U32>& trigrams);
+	void addPostings(U32 slot);
+	void dropPostings(U32 slot);
+	void addAncestors(const LLUUID& parent_id, match_map_t& matches) const;
+
+	std::vector<entry_t> mEntries;
+	std::vector<U32> mFreeSlots;
+	LLUUIDOpenHashMap<U32> mSlots;
+	posting_map_t mPostings;
+	U32 mPostingCount;
+	U32 mStalePostings;
+	U32 mVersion;
+};
+
+#endif // LL_LLINVENTORYSEARCHINDEX_H
@@ -40,7 +40,7 @@ class VertexCache
 	
 public:
 	
-	VertexCache(int size)
+	VertexCache(int size = 16)
 	{
 		numEntries = size;
 		
@@ -50,7 +50,6 @@ public:
 			entries[i] = -1;
 	}
 		
-	VertexCache() { VertexCache(16); }
 	~VertexCache() { delete[] entries; entries = 0; }
 	
 	bool InCache(int entry)
@@ -101,7 +100,11 @@ public:
 	int At(int index) { return entries[index]; }
 	void Set(int index, int value) { entries[index] = value; }
 
+	int Size() { return numEntries; }
+
 private:
+	VertexCache(const VertexCache&);  // Don't implement
+	VertexCache& operator=(const VertexCache&);  // Don't implement
 
   int *entries;
   int numEntries;
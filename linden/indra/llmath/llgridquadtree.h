@@ -0,0 +1,282 @@
+/** 
+ * @file llgridquadtree.h
+ * @brief A point quadtree over 2D grid coordinates.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLGRIDQUADTREE_H
+#define LL_LLGRIDQUADTREE_H
+
+#include <vector>
+
+// A point quadtree over unsigned grid coordinates below 2^bits, for
+// range queries such as "every region inside this rectangle".  Leaves
+// split once they hold more than MAX_LEAF_ENTRIES values, and four
+// sibling leaves are merged back into their parent once removals leave
+// them holding MAX_LEAF_ENTRIES / 2 or fewer, so emptied areas do not
+// keep their nodes.  Several values may share a position.
+template <class T>
+class LLGridQuadTree
+{
+public:
+	LLGridQuadTree(U32 bits = 24)
+	:	mBits(bits > 31 ? 31 : bits),
+		mRoot(new Node(0, 0, mBits)),
+		mSize(0)
+	{
+	}
+
+	~LLGridQuadTree()
+	{
+		delete mRoot;
+	}
+
+	// Returns false if the position is out of range.
+	bool insert(U32 x, U32 y, const T& value)
+	{
+		if ((x >> mBits) || (y >> mBits))
+		{
+			return false;
+		}
+		Node* node = mRoot;
+		while (!node->isLeaf())
+		{
+			node = node->mChildren[node->childIndex(x, y)];
+		}
+		node->mEntries.push_back(Entry(x, y, value));
+		if (node->mEntries.size() > MAX_LEAF_ENTRIES)
+		{
+			node->split();
+		}
+		++mSize;
+		return true;
+	}
+
+	// Removes one value at the position.  Returns false if absent.
+	bool remove(U32 x, U32 y, const T& value)
+	{
+		if ((x >> mBits) || (y >> mBits))
+		{
+			return false;
+		}
+		Node* path[32];
+		S32 depth = 0;
+		Node* node = mRoot;
+		while (!node->isLeaf())
+		{
+			path[depth++] = node;
+			node = node->mChildren[node->childIndex(x, y)];
+		}
+		for (size_t i = 0; i < node->mEntries.size(); ++i)
+		{
+			const Entry& entry = node->mEntries[i];
+			if (entry.mX == x && entry.mY == y && entry.mValue == value)
+			{
+				node->mEntries[i] = node->mEntries.back();
+				node->mEntries.pop_back();
+				--mSize;
+				// merge upwards while the parent's leaves have thinned out
+				while (depth > 0 && path[depth - 1]->merge())
+				{
+					--depth;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void clear()
+	{
+		delete mRoot;
+		mRoot = new Node(0, 0, mBits);
+		mSize = 0;
+	}
+
+	size_t size() const { return mSize; }
+
+	// Nodes allocated, leaves and branches, for memory accounting.
+	size_t getNodeCount() const { return mRoot->countNodes(); }
+
+	// Appends every value with min_x <= x <= max_x and min_y <= y <= max_y.
+	void query(U32 min_x, U32 min_y, U32 max_x, U32 max_y, std::vector<T>& out) const
+	{
+		if (min_x <= max_x && min_y <= max_y)
+		{
+			mRoot->query(min_x, min_y, max_x, max_y, out);
+		}
+	}
+
+private:
+	enum { MAX_LEAF_ENTRIES = 8 };
+
+	struct Entry
+	{
+		Entry(U32 x, U32 y, const T& value) : mX(x), mY(y), mValue(value) { }
+		U32 mX;
+		U32 mY;
+		T mValue;
+	};
+
+	struct Node
+	{
+		// Covers [x, x + 2^shift) by [y, y + 2^shift).
+		Node(U32 x, U32 y, U32 shift)
+		:	mX(x), mY(y), mShift(shift)
+		{
+			mChildren[0] = mChildren[1] = mChildren[2] = mChildren[3] = NULL;
+		}
+
+		~Node()
+		{
+			for (S32 i = 0; i < 4; ++i)
+			{
+				delete mChildren[i];
+			}
+		}
+
+		bool isLeaf() const { return mChildren[0] == NULL; }
+
+		size_t countNodes() const
+		{
+			size_t count = 1;
+			for (S32 i = 0; !isLeaf() && i < 4; ++i)
+			{
+				count += mChildren[i]->countNodes();
+			}
+			return count;
+		}
+
+		S32 childIndex(U32 x, U32 y) const
+		{
+			U32 half = 1U << (mShift - 1);
+			return (x >= mX + half ? 1 : 0) | (y >= mY + half ? 2 : 0);
+		}
+
+		void split()
+		{
+			if (!mShift)
+			{
+				// A single cell; everything here shares one position.
+				return;
+			}
+			U32 half = 1U << (mShift - 1);
+			for (S32 i = 0; i < 4; ++i)
+			{
+				mChildren[i] = new Node(mX + ((i & 1) ? half : 0),
+										mY + ((i & 2) ? half : 0),
+										mShift - 1);
+			}
+			for (size_t i = 0; i < mEntries.size(); ++i)
+			{
+				const Entry& entry = mEntries[i];
+				mChildren[childIndex(entry.mX, entry.mY)]->mEntries.push_back(entry);
+			}
+			std::vector<Entry>().swap(mEntries);
+			for (S32 i = 0; i < 4; ++i)
+			{
+				if (mChildren[i]->mEntries.size() > MAX_LEAF_ENTRIES)
+				{
+					mChildren[i]->split();
+				}
+			}
+		}
+
+		// Folds four leaf children back into this node if they hold few
+		// enough entries.  Half the split threshold, so a node does not
+		// split and merge again on every insert and remove.
+		bool merge()
+		{
+			size_t count = 0;
+			for (S32 i = 0; i < 4; ++i)
+			{
+				if (!mChildren[i]->isLeaf())
+				{
+					return false;
+				}
+				count += mChildren[i]->mEntries.size();
+			}
+			if (count > MAX_LEAF_ENTRIES / 2)
+			{
+				return false;
+			}
+			mEntries.reserve(count);
+			for (S32 i = 0; i < 4; ++i)
+			{
+				mEntries.insert(mEntries.end(), mChildren[i]->mEntries.begin(), mChildren[i]->mEntries.end());
+				delete mChildren[i];
+				mChildren[i] = NULL;
+			}
+			return true;
+		}
+
+		void query(U32 min_x, U32 min_y, U32 max_x, U32 max_y, std::vector<T>& out) const
+		{
+			U64 end_x = (U64)mX + (1ULL << mShift);
+			U64 end_y = (U64)mY + (1ULL << mShift);
+			if (max_x < mX || max_y < mY || (U64)min_x >= end_x || (U64)min_y >= end_y)
+			{
+				return;
+			}
+			if (isLeaf())
+			{
+				for (size_t i = 0; i < mEntries.size(); ++i)
+				{
+					const Entry& entry = mEntries[i];
+					if (entry.mX >= min_x && entry.mX <= max_x
+						&& entry.mY >= min_y && entry.mY <= max_y)
+					{
+						out.push_back(entry.mValue);
+					}
+				}
+				return;
+			}
+			for (S32 i = 0; i < 4; ++i)
+			{
+				mChildren[i]->query(min_x, min_y, max_x, max_y, out);
+			}
+		}
+
+		U32 mX;
+		U32 mY;
+		U32 mShift;
+		Node* mChildren[4];
+		std::vector<Entry> mEntries;
+	};
+
+	// Not copyable.
+	LLGridQuadTree(const LLGridQuadTree&);
+	LLGridQuadTree& operator=(const LLGridQuadTree&);
+
+	U32 mBits;
+	Node* mRoot;
+	size_t mSize;
+};
+
+#endif // LL_LLGRIDQUADTREE_H
@@ -0,0 +1,460 @@
+/** 
+ * @file llocclusionbuffer.cpp
+ * @brief Low resolution software depth buffer for occlusion culling
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llocclusionbuffer.h"
+
+#include <algorithm>
+
+#include "llcamera.h"
+#include "llmath.h"
+#include "lltaskscheduler.h"
+#include "llv4math.h"
+
+// below this many triangles banding costs more than it saves
+static const S32 MIN_PARALLEL_TRIANGLES = 256;
+
+//=============================================================================
+// LLOcclusionRasterJob
+
+// The row bands of one rasterize().  The calling thread and any workers that
+// get to it claim bands until none are left, so a busy pool only costs the
+// bands its workers actually started.
+class LLOcclusionRasterJob : public LLThreadSafeRefCount
+{
+public:
+	LLOcclusionRasterJob(LLOcclusionBuffer* buffer, S32 rows_per_band)
+		: mBuffer(buffer), mRowsPerBand(rows_per_band), mNext(0), mActive(0)
+	{
+		mCount = (LLOcclusionBuffer::HEIGHT + rows_per_band - 1) / rows_per_band;
+	}
+
+	// ANY THREAD, draws bands until none are left unclaimed
+	void work()
+	{
+		while (1)
+		{
+			// announce ourselves before claiming, so finish() can't miss us
+			mActive++;
+			U32 index = mNext++;
+			if (index >= mCount)
+			{
+				mActive -= 1;
+				return;
+			}
+			S32 y = (S32) index * mRowsPerBand;
+			mBuffer->rasterizeRows(y, llmin(y + mRowsPerBand, (S32) LLOcclusionBuffer::HEIGHT));
+			mActive -= 1;
+		}
+	}
+
+	// CALLING THREAD, helps until every band is claimed, then waits for the
+	// ones still being drawn
+	void finish()
+	{
+		work();
+		while (mActive > 0)
+		{
+			LLThread::yield();
+		}
+	}
+
+private:
+	LLOcclusionBuffer* mBuffer;
+	S32 mRowsPerBand;
+	U32 mCount;
+	LLAtomicU32 mNext;
+	LLAtomicU32 mActive;
+};
+
+class LLOcclusionRasterTask : public LLTaskScheduler::Task
+{
+public:
+	LLOcclusionRasterTask(LLOcclusionRasterJob* job) : mJob(job) { }
+
+	// A helper that starts after rasterize() returned finds nothing left to
+	// claim and never touches the buffer.
+	/*virtual*/ void run()
+	{
+		mJob->work();
+	}
+
+private:
+	LLPointer<LLOcclusionRasterJob> mJob;
+};
+
+//=============================================================================
+// LLOcclusionBuffer
+
+LLOcclusionBuffer::LLOcclusionBuffer()
+:	mNear(0.1f),
+	mScaleX(1.f),
+	mScaleY(1.f),
+	mReady(FALSE)
+{
+	mDepth.resize(WIDTH * HEIGHT, 0.f);
+	mTileMin.resize(TILES_X * TILES_Y, 0.f);
+}
+
+void LLOcclusionBuffer::begin(const LLCamera& camera)
+{
+	mOrigin = camera.getOrigin();
+	mAt = camera.getAtAxis();
+	mLeft = camera.getLeftAxis();
+	mUp = camera.getUpAxis();
+	mNear = llmax(camera.getNear(), 0.01f);
+
+	F32 tan_y = tanf(camera.getView() * 0.5f);
+	F32 tan_x = tan_y * camera.getAspect();
+	mScaleX = (WIDTH * 0.5f) / tan_x;
+	mScaleY = (HEIGHT * 0.5f) / tan_y;
+
+	mTriangles.clear();
+	mReady = FALSE;
+}
+
+LLVector3 LLOcclusionBuffer::toView(const LLVector3& p) const
+{
+	LLVector3 d = p - mOrigin;
+	return LLVector3(d * mLeft, d * mUp, d * mAt);
+}
+
+void LLOcclusionBuffer::project(const LLVector3& v, Vertex& out) const
+{
+	F32 rz = 1.f / v.mV[VZ];
+	out.mX = WIDTH * 0.5f - v.mV[VX] * rz * mScaleX;
+	out.mY = HEIGHT * 0.5f + v.mV[VY] * rz * mScaleY;
+	out.mZ = rz;
+}
+
+void LLOcclusionBuffer::addTriangle(const LLVector3& a, const LLVector3& b, const LLVector3& c)
+{
+	addViewTriangle(toView(a), toView(b), toView(c));
+}
+
+void LLOcclusionBuffer::addQuad(const LLVector3& a, const LLVector3& b, const LLVector3& c, const LLVector3& d)
+{
+	LLVector3 va = toView(a);
+	LLVector3 vc = toView(c);
+	addViewTriangle(va, toView(b), vc);
+	addViewTriangle(va, vc, toView(d));
+}
+
+void LLOcclusionBuffer::addViewTriangle(const LLVector3& a, const LLVector3& b, const LLVector3& c)
+{
+	const LLVector3* in[3] = { &a, &b, &c };
+
+	// clip against the near plane, a triangle becomes at most a quad
+	LLVector3 poly[4];
+	S32 count = 0;
+	for (S32 i = 0; i < 3; i++)
+	{
+		const LLVector3& p = *in[i];
+		const LLVector3& q = *in[(i + 1) % 3];
+		BOOL p_in = p.mV[VZ] >= mNear;
+		BOOL q_in = q.mV[VZ] >= mNear;
+
+		if (p_in)
+		{
+			poly[count++] = p;
+		}
+		if (p_in != q_in)
+		{
+			F32 t = (mNear - p.mV[VZ]) / (q.mV[VZ] - p.mV[VZ]);
+			poly[count++] = p + (q - p) * t;
+		}
+	}
+
+	if (count < 3)
+	{
+		return;
+	}
+
+	Vertex verts[4];
+	for (S32 i = 0; i < count; i++)
+	{
+		project(poly[i], verts[i]);
+	}
+
+	for (S32 i = 1; i + 1 < count; i++)
+	{
+		Triangle tri;
+		tri.mV[0] = verts[0];
+		tri.mV[1] = verts[i];
+		tri.mV[2] = verts[i + 1];
+
+		F32 min_x = llmin(tri.mV[0].mX, llmin(tri.mV[1].mX, tri.mV[2].mX));
+		F32 max_x = llmax(tri.mV[0].mX, llmax(tri.mV[1].mX, tri.mV[2].mX));
+		tri.mMinY = llmin(tri.mV[0].mY, llmin(tri.mV[1].mY, tri.mV[2].mY));
+		tri.mMaxY = llmax(tri.mV[0].mY, llmax(tri.mV[1].mY, tri.mV[2].mY));
+
+		if (max_x < 0.f || min_x > (F32) WIDTH ||
+			tri.mMaxY < 0.f || tri.mMinY > (F32) HEIGHT)
+		{ //off screen
+			continue;
+		}
+
+		mTriangles.push_back(tri);
+	}
+}
+
+void LLOcclusionBuffer::rasterize(LLTaskScheduler* scheduler)
+{
+	std::fill(mDepth.begin(), mDepth.end(), 0.f);
+
+	if (scheduler && scheduler->getNumWorkers() > 0 &&
+		(S32) mTriangles.size() >= MIN_PARALLEL_TRIANGLES)
+	{
+		// one band per worker plus one for this thread, in whole tiles
+		S32 bands = llmin((S32) scheduler->getNumWorkers() + 1, (S32) TILES_Y);
+		S32 tiles_per_band = (TILES_Y + bands - 1) / bands;
+
+		LLPointer<LLOcclusionRasterJob> job = new LLOcclusionRasterJob(this, tiles_per_band * TILE_SIZE);
+		for (S32 i = 1; i < bands; i++)
+		{
+			scheduler->schedule(new LLOcclusionRasterTask(job), LLTaskScheduler::LANE_URGENT);
+		}
+		job->finish();
+	}
+	else
+	{
+		rasterizeRows(0, HEIGHT);
+	}
+
+	buildTiles();
+	mReady = TRUE;
+}
+
+void LLOcclusionBuffer::rasterizeRows(S32 y_begin, S32 y_end)
+{
+	for (std::vector<Triangle>::const_iterator iter = mTriangles.begin(); iter != mTriangles.end(); ++iter)
+	{
+		const Triangle& tri = *iter;
+		if (tri.mMaxY < (F32) y_begin || tri.mMinY > (F32) y_end)
+		{
+			continue;
+		}
+		drawTriangle(tri, y_begin, y_end);
+	}
+}
+
+void LLOcclusionBuffer::drawTriangle(const Triangle& tri, S32 y_begin, S32 y_end)
+{
+	const Vertex* v0 = &tri.mV[0];
+	const Vertex* v1 = &tri.mV[1];
+	const Vertex* v2 = &tri.mV[2];
+
+	F32 area = (v1->mX - v0->mX) * (v2->mY - v0->mY) - (v1->mY - v0->mY) * (v2->mX - v0->mX);
+	if (fabsf(area) < 1.0e-6f)
+	{
+		return;
+	}
+	if (area < 0.f)
+	{ //make the winding counter clockwise so inside is non negative
+		std::swap(v1, v2);
+		area = -area;
+	}
+
+	S32 min_x = llmax((S32) floorf(llmin(v0->mX, llmin(v1->mX, v2->mX))), 0);
+	S32 max_x = llmin((S32) ceilf(llmax(v0->mX, llmax(v1->mX, v2->mX))), (S32) WIDTH - 1);
+	S32 min_y = llmax((S32) floorf(tri.mMinY), y_begin);
+	S32 max_y = llmin((S32) ceilf(tri.mMaxY), y_end - 1);
+	if (min_x > max_x || min_y > max_y)
+	{
+		return;
+	}
+
+	// edge functions opposite each vertex, as a + b*x + c*y
+	F32 b0 = v1->mY - v2->mY, c0 = v2->mX - v1->mX;
+	F32 b1 = v2->mY - v0->mY, c1 = v0->mX - v2->mX;
+	F32 b2 = v0->mY - v1->mY, c2 = v1->mX - v0->mX;
+	F32 a0 = -(b0 * v1->mX + c0 * v1->mY);
+	F32 a1 = -(b1 * v2->mX + c1 * v2->mY);
+	F32 a2 = -(b2 * v0->mX + c2 * v0->mY);
+
+	// reciprocal depth is affine in screen space
+	F32 inv_area = 1.f / area;
+	F32 zb = (b0 * v0->mZ + b1 * v1->mZ + b2 * v2->mZ) * inv_area;
+	F32 zc = (c0 * v0->mZ + c1 * v1->mZ + c2 * v2->mZ) * inv_area;
+	F32 za = (a0 * v0->mZ + a1 * v1->mZ + a2 * v2->mZ) * inv_area;
+
+	// start on a 4 pixel boundary, pixels outside the triangle fail the edge tests
+	S32 start_x = min_x & ~3;
+
+	for (S32 y = min_y; y <= max_y; y++)
+	{
+		F32 py = (F32) y + 0.5f;
+		F32 px = (F32) start_x + 0.5f;
+		F32 e0 = a0 + b0 * px + c0 * py;
+		F32 e1 = a1 + b1 * px + c1 * py;
+		F32 e2 = a2 + b2 * px + c2 * py;
+		F32 z = za + zb * px + zc * py;
+		F32* row = &mDepth[y * WIDTH];
+
+#if LL_VECTORIZE
+		const __m128 steps = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+		const __m128 zero = _mm_setzero_ps();
+		__m128 ve0 = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(b0), steps));
+		__m128 ve1 = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(_mm_set1_ps(b1), steps));
+		__m128 ve2 = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(_mm_set1_ps(b2), steps));
+		__m128 vz = _mm_add_ps(_mm_set1_ps(z), _mm_mul_ps(_mm_set1_ps(zb), steps));
+		const __m128 de0 = _mm_set1_ps(b0 * 4.f);
+		const __m128 de1 = _mm_set1_ps(b1 * 4.f);
+		const __m128 de2 = _mm_set1_ps(b2 * 4.f);
+		const __m128 dz = _mm_set1_ps(zb * 4.f);
+
+		for (S32 x = start_x; x <= max_x; x += 4)
+		{
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(ve0, zero), _mm_cmpge_ps(ve1, zero)),
+									   _mm_cmpge_ps(ve2, zero));
+			// depth is positive, so masking outside pixels to 0 leaves them unchanged
+			__m128 depth = _mm_max_ps(_mm_loadu_ps(row + x), _mm_and_ps(inside, vz));
+			_mm_storeu_ps(row + x, depth);
+
+			ve0 = _mm_add_ps(ve0, de0);
+			ve1 = _mm_add_ps(ve1, de1);
+			ve2 = _mm_add_ps(ve2, de2);
+			vz = _mm_add_ps(vz, dz);
+		}
+#else
+		for (S32 x = start_x; x <= max_x; x++)
+		{
+			if (e0 >= 0.f && e1 >= 0.f && e2 >= 0.f && z > row[x])
+			{
+				row[x] = z;
+			}
+			e0 += b0;
+			e1 += b1;
+			e2 += b2;
+			z += zb;
+		}
+#endif
+	}
+}
+
+void LLOcclusionBuffer::buildTiles()
+{
+	for (S32 ty = 0; ty < TILES_Y; ty++)
+	{
+		for (S32 tx = 0; tx < TILES_X; tx++)
+		{
+			F32 tile_min = F32_MAX;
+			for (S32 y = ty * TILE_SIZE; y < (ty + 1) * TILE_SIZE; y++)
+			{
+				const F32* row = &mDepth[y * WIDTH + tx * TILE_SIZE];
+				for (S32 x = 0; x < TILE_SIZE; x++)
+				{
+					tile_min = llmin(tile_min, row[x]);
+				}
+			}
+			mTileMin[ty * TILES_X + tx] = tile_min;
+		}
+	}
+}
+
+BOOL LLOcclusionBuffer::isOccluded(const LLVector3& center, const LLVector3& size) const
+{
+	if (!mReady)
+	{
+		return FALSE;
+	}
+
+	F32 min_x = F32_MAX, min_y = F32_MAX;
+	F32 max_x = -F32_MAX, max_y = -F32_MAX;
+	F32 nearest = 0.f;
+
+	for (S32 i = 0; i < 8; i++)
+	{
+		LLVector3 corner(center.mV[VX] + ((i & 1) ? size.mV[VX] : -size.mV[VX]),
+						 center.mV[VY] + ((i & 2) ? size.mV[VY] : -size.mV[VY]),
+						 center.mV[VZ] + ((i & 4) ? size.mV[VZ] : -size.mV[VZ]));
+		LLVector3 v = toView(corner);
+		if (v.mV[VZ] < mNear)
+		{ //box reaches the near plane, can't be behind anything
+			return FALSE;
+		}
+
+		Vertex p;
+		project(v, p);
+		min_x = llmin(min_x, p.mX);
+		max_x = llmax(max_x, p.mX);
+		min_y = llmin(min_y, p.mY);
+		max_y = llmax(max_y, p.mY);
+		nearest = llmax(nearest, p.mZ);
+	}
+
+	// grow by a pixel to cover occluder edges sampled at pixel centers
+	S32 x0 = llmax((S32) floorf(min_x) - 1, 0);
+	S32 x1 = llmin((S32) floorf(max_x) + 1, (S32) WIDTH - 1);
+	S32 y0 = llmax((S32) floorf(min_y) - 1, 0);
+	S32 y1 = llmin((S32) floorf(max_y) + 1, (S32) HEIGHT - 1);
+	if (x0 > x1 || y0 > y1)
+	{ //off screen, leave it to the frustum cull
+		return FALSE;
+	}
+
+	for (S32 ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ty++)
+	{
+		for (S32 tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; tx++)
+		{
+			S32 tile = ty * TILES_X + tx;
+			if (mTileMin[tile] > nearest)
+			{ //every pixel of the tile is in front of the box
+				continue;
+			}
+
+			// the tile's farthest pixel isn't in front of the box, if the box
+			// covers the whole tile that pixel is inside it
+			S32 tile_x0 = tx * TILE_SIZE, tile_y0 = ty * TILE_SIZE;
+			S32 tile_x1 = tile_x0 + TILE_SIZE - 1, tile_y1 = tile_y0 + TILE_SIZE - 1;
+			if (x0 <= tile_x0 && x1 >= tile_x1 && y0 <= tile_y0 && y1 >= tile_y1)
+			{
+				return FALSE;
+			}
+
+			for (S32 y = llmax(y0, tile_y0); y <= llmin(y1, tile_y1); y++)
+			{
+				const F32* row = &mDepth[y * WIDTH];
+				for (S32 x = llmax(x0, tile_x0); x <= llmin(x1, tile_x1); x++)
+				{
+					if (row[x] <= nearest)
+					{
+						return FALSE;
+					}
+				}
+			}
+		}
+	}
+
+	return TRUE;
+}
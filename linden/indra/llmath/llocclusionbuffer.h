@@ -0,0 +1,125 @@
+/** 
+ * @file llocclusionbuffer.h
+ * @brief Low resolution software depth buffer for occlusion culling
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLOCCLUSIONBUFFER_H
+#define LL_LLOCCLUSIONBUFFER_H
+
+#include <vector>
+
+#include "v3math.h"
+
+class LLCamera;
+class LLTaskScheduler;
+
+// Rasterizes occluder triangles into a small reciprocal depth buffer on
+// the CPU and tests bounding boxes against it, so occlusion culling has no
+// frame of latency and never waits on the GPU.  Occluders must lie inside
+// solid geometry; a box is only reported occluded if every pixel it covers
+// has an occluder in front of it.
+//
+// Usage per frame: begin(camera), addTriangle()/addQuad() for each
+// occluder, rasterize(), then isOccluded() for as many boxes as needed.
+
+class LLOcclusionBuffer
+{
+public:
+	enum
+	{
+		WIDTH = 256,		// must be a multiple of TILE_SIZE and of 4
+		HEIGHT = 128,
+		TILE_SIZE = 8,
+		TILES_X = WIDTH / TILE_SIZE,
+		TILES_Y = HEIGHT / TILE_SIZE
+	};
+
+	LLOcclusionBuffer();
+
+	// Sets up the projection for camera and drops all queued occluders.
+	void begin(const LLCamera& camera);
+
+	// Queues an occluder triangle or planar quad, in the camera's space.
+	void addTriangle(const LLVector3& a, const LLVector3& b, const LLVector3& c);
+	void addQuad(const LLVector3& a, const LLVector3& b, const LLVector3& c, const LLVector3& d);
+
+	// Clears the buffer and draws the queued occluders.  Rows are split
+	// into bands across scheduler's workers when one is given.
+	void rasterize(LLTaskScheduler* scheduler = NULL);
+
+	// TRUE if the axis aligned box (center, half size) is hidden.
+	BOOL isOccluded(const LLVector3& center, const LLVector3& size) const;
+
+	BOOL isReady() const					{ return mReady; }
+	void invalidate()						{ mReady = FALSE; }
+	S32 getTriangleCount() const			{ return (S32) mTriangles.size(); }
+
+	// Reciprocal view depth at a pixel, 0 where nothing was drawn.
+	F32 getDepth(S32 x, S32 y) const		{ return mDepth[y * WIDTH + x]; }
+
+	// Draws the triangles that overlap rows [y_begin, y_end), safe to run
+	// for disjoint bands in parallel.
+	void rasterizeRows(S32 y_begin, S32 y_end);
+
+private:
+	// screen space vertex, z holds reciprocal view depth
+	struct Vertex
+	{
+		F32 mX, mY, mZ;
+	};
+
+	struct Triangle
+	{
+		Vertex mV[3];
+		F32 mMinY, mMaxY;
+	};
+
+	LLVector3 toView(const LLVector3& p) const;
+	void addViewTriangle(const LLVector3& a, const LLVector3& b, const LLVector3& c);
+	void project(const LLVector3& v, Vertex& out) const;
+	void drawTriangle(const Triangle& tri, S32 y_begin, S32 y_end);
+	void buildTiles();
+
+	LLVector3 mOrigin;
+	LLVector3 mAt;
+	LLVector3 mLeft;
+	LLVector3 mUp;
+	F32 mNear;
+	F32 mScaleX;	// pixels per unit of x/z
+	F32 mScaleY;
+
+	BOOL mReady;
+
+	std::vector<Triangle> mTriangles;
+	std::vector<F32> mDepth;		// WIDTH * HEIGHT
+	std::vector<F32> mTileMin;		// farthest depth per tile
+};
+
+#endif // LL_LLOCCLUSIONBUFFER_H
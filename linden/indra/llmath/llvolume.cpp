@@ -46,6 +46,7 @@
 #include "lldarray.h"
 #include "llvolume.h"
 #include "llstl.h"
+#include "VertexCache.h"
 
 #define DEBUG_SILHOUETTE_BINORMALS 0
 #define DEBUG_SILHOUETTE_NORMALS 0 // TomY: Use this to display normals using the silhouette
@@ -4393,21 +4394,39 @@ std::ostream& operator<<(std::ostream &s, const LLVolume *volumep)
 }
 
 
+BOOL LLVolumeFace::sOptimizeVertexCache = TRUE;
+
 BOOL LLVolumeFace::create(LLVolume* volume, BOOL partial_build)
 {
+	if (mCacheOptimized)
+	{ //partial builds assume vertices are in S/T grid order
+		partial_build = FALSE;
+		mCacheOptimized = FALSE;
+	}
+
+	BOOL ret = FALSE;
 	if (mTypeMask & CAP_MASK)
 	{
-		return createCap(volume, partial_build);
+		ret = createCap(volume, partial_build);
 	}
 	else if ((mTypeMask & END_MASK) || (mTypeMask & SIDE_MASK))
 	{
-		return createSide(volume, partial_build);
+		ret = createSide(volume, partial_build);
 	}
 	else
 	{
 		llerrs << "Unknown/uninitialized face type!" << llendl;
 		return FALSE;
 	}
+
+	// flexible volumes are partially rebuilt every update, keep them in grid order
+	if (ret && !partial_build && sOptimizeVertexCache &&
+		volume->getPathType() != LL_PCODE_PATH_FLEXIBLE)
+	{
+		optimizeVertexCache();
+	}
+
+	return ret;
 }
 
 void	LerpPlanarVertex(LLVolumeFace::VertexData& v0,
@@ -4975,6 +4994,290 @@ void LLVolumeFace::createBinormals()
 	}
 }
 
+//============================================================================
+// Vertex cache optimization
+//
+// Triangle order follows Tom Forsyth's "Linear-Speed Vertex Cache
+// Optimisation": each vertex is scored by its position in a modelled LRU
+// cache and by how many unemitted triangles still use it, and the triangle
+// with the highest score sum among those touching the cache goes next.
+
+const S32 FORSYTH_CACHE_SIZE = 32;
+const F32 FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const F32 FORSYTH_LAST_TRI_SCORE = 0.75f;
+const F32 FORSYTH_VALENCE_BOOST_SCALE = 2.f;
+const F32 FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+static F32 forsyth_vertex_score(S32 cache_pos, S32 remaining)
+{
+	if (remaining <= 0)
+	{ //no triangles left to emit
+		return -1.f;
+	}
+
+	F32 score = 0.f;
+	if (cache_pos >= 0)
+	{
+		if (cache_pos < 3)
+		{ //used by the last triangle, fixed score so it isn't picked again at once
+			score = FORSYTH_LAST_TRI_SCORE;
+		}
+		else
+		{
+			const F32 scaler = 1.f/(FORSYTH_CACHE_SIZE-3);
+			score = powf(1.f - (cache_pos-3)*scaler, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+
+	//boost vertices with few triangles left so they get finished off
+	score += FORSYTH_VALENCE_BOOST_SCALE * powf((F32) remaining, -FORSYTH_VALENCE_BOOST_POWER);
+	return score;
+}
+
+static F32 calc_acmr(const std::vector<U16>& indices, S32 cache_size = 16)
+{
+	S32 num_tris = indices.size()/3;
+	if (num_tris == 0)
+	{
+		return 0.f;
+	}
+
+	VertexCache cache(cache_size);
+	S32 misses = 0;
+	for (U32 i = 0; i < indices.size(); i++)
+	{
+		if (!cache.InCache(indices[i]))
+		{
+			cache.AddEntry(indices[i]);
+			misses++;
+		}
+	}
+
+	return (F32) misses/num_tris;
+}
+
+void LLVolumeFace::optimizeVertexCache()
+{
+	LLMemType m1(LLMemType::MTYPE_VOLUME);
+
+	const S32 num_indices = (S32) mIndices.size();
+	const S32 num_tris = num_indices/3;
+	const S32 num_verts = (S32) mVertices.size();
+
+	if (num_tris < 2 || num_tris*3 != num_indices)
+	{
+		return;
+	}
+
+	F32 acmr_before = calc_acmr(mIndices);
+
+	//list of triangles using each vertex, unemitted ones first
+	std::vector<S32> tri_start(num_verts+1, 0);
+	for (S32 i = 0; i < num_indices; i++)
+	{
+		tri_start[mIndices[i]+1]++;
+	}
+	for (S32 v = 0; v < num_verts; v++)
+	{
+		tri_start[v+1] += tri_start[v];
+	}
+
+	std::vector<S32> vert_tris(num_indices);
+	std::vector<S32> remaining(num_verts, 0);
+	for (S32 t = 0; t < num_tris; t++)
+	{
+		for (S32 k = 0; k < 3; k++)
+		{
+			S32 v = mIndices[t*3+k];
+			vert_tris[tri_start[v] + remaining[v]++] = t;
+		}
+	}
+
+	std::vector<S32> cache_pos(num_verts, -1);
+	std::vector<F32> vert_score(num_verts);
+	for (S32 v = 0; v < num_verts; v++)
+	{
+		vert_score[v] = forsyth_vertex_score(-1, remaining[v]);
+	}
+
+	std::vector<F32> tri_score(num_tris);
+	std::vector<U8> tri_added(num_tris, 0);
+	S32 best_tri = -1;
+	F32 best_score = -1.f;
+	for (S32 t = 0; t < num_tris; t++)
+	{
+		tri_score[t] = vert_score[mIndices[t*3+0]] + vert_score[mIndices[t*3+1]] + vert_score[mIndices[t*3+2]];
+		if (tri_score[t] > best_score)
+		{
+			best_score = tri_score[t];
+			best_tri = t;
+		}
+	}
+
+	std::vector<S32> tri_order;
+	tri_order.reserve(num_tris);
+
+	S32 cache[FORSYTH_CACHE_SIZE+3];
+	S32 new_cache[FORSYTH_CACHE_SIZE+3];
+	S32 cache_count = 0;
+	S32 scan_pos = 0;
+
+	while ((S32) tri_order.size() < num_tris)
+	{
+		if (best_tri < 0)
+		{ //nothing in the cache leads anywhere, restart from the next unemitted triangle
+			while (tri_added[scan_pos])
+			{
+				scan_pos++;
+			}
+			best_tri = scan_pos;
+		}
+
+		tri_added[best_tri] = 1;
+		tri_order.push_back(best_tri);
+
+		//take the triangle off its vertices' lists and put them at the front of the cache
+		S32 new_count = 0;
+		for (S32 k = 0; k < 3; k++)
+		{
+			S32 v = mIndices[best_tri*3+k];
+			S32* tris = &vert_tris[tri_start[v]];
+			for (S32 j = 0; j < remaining[v]; j++)
+			{
+				if (tris[j] == best_tri)
+				{
+					tris[j] = tris[remaining[v]-1];
+					tris[remaining[v]-1] = best_tri;
+					break;
+				}
+			}
+			remaining[v]--;
+
+			BOOL found = FALSE;
+			for (S32 j = 0; j < new_count; j++)
+			{
+				found = found || new_cache[j] == v;
+			}
+			if (!found)
+			{
+				new_cache[new_count++] = v;
+			}
+		}
+
+		S32 front_count = new_count;
+		for (S32 i = 0; i < cache_count; i++)
+		{
+			S32 v = cache[i];
+			BOOL found = FALSE;
+			for (S32 j = 0; j < front_count; j++)
+			{
+				found = found || new_cache[j] == v;
+			}
+			if (!found)
+			{
+				new_cache[new_count++] = v;
+			}
+		}
+
+		//rescore everything whose cache position changed, including vertices pushed out
+		for (S32 i = 0; i < new_count; i++)
+		{
+			S32 v = new_cache[i];
+			cache_pos[v] = i < FORSYTH_CACHE_SIZE ? i : -1;
+			vert_score[v] = forsyth_vertex_score(cache_pos[v], remaining[v]);
+		}
+
+		best_tri = -1;
+		best_score = -1.f;
+		for (S32 i = 0; i < new_count; i++)
+		{
+			S32 v = new_cache[i];
+			const S32* tris = &vert_tris[tri_start[v]];
+			for (S32 j = 0; j < remaining[v]; j++)
+			{
+				S32 t = tris[j];
+				tri_score[t] = vert_score[mIndices[t*3+0]] + vert_score[mIndices[t*3+1]] + vert_score[mIndices[t*3+2]];
+				if (tri_score[t] > best_score)
+				{
+					best_score = tri_score[t];
+					best_tri = t;
+				}
+			}
+		}
+
+		cache_count = llmin(new_count, FORSYTH_CACHE_SIZE);
+		memcpy(cache, new_cache, sizeof(S32)*cache_count);
+	}
+
+	//write out triangles in the new order, numbering vertices by first use
+	std::vector<S32> new_tri(num_tris);
+	std::vector<S32> vert_map(num_verts, -1);
+	std::vector<U16> indices(num_indices);
+	S32 next_vert = 0;
+
+	for (S32 n = 0; n < num_tris; n++)
+	{
+		new_tri[tri_order[n]] = n;
+		for (S32 k = 0; k < 3; k++)
+		{
+			S32 v = mIndices[tri_order[n]*3+k];
+			if (vert_map[v] < 0)
+			{
+				vert_map[v] = next_vert++;
+			}
+			indices[n*3+k] = (U16) vert_map[v];
+		}
+	}
+
+	F32 acmr_after = calc_acmr(indices);
+	if (acmr_after >= acmr_before)
+	{ //narrow grids are already near ideal in strip order, keep the faster partial builds
+		LL_DEBUGS("VertexCache") << "Face " << mID << " (" << num_tris << " triangles) ACMR "
+			<< acmr_before << ", reordering gave " << acmr_after << ", kept" << LL_ENDL;
+		return;
+	}
+
+	for (S32 v = 0; v < num_verts; v++)
+	{ //unreferenced vertices go at the end
+		if (vert_map[v] < 0)
+		{
+			vert_map[v] = next_vert++;
+		}
+	}
+
+	if ((S32) mEdge.size() == num_indices)
+	{ //edges hold neighboring triangle indices
+		std::vector<S32> edge(num_indices);
+		for (S32 n = 0; n < num_tris; n++)
+		{
+			for (S32 k = 0; k < 3; k++)
+			{
+				S32 neighbor = mEdge[tri_order[n]*3+k];
+				edge[n*3+k] = (neighbor >= 0 && neighbor < num_tris) ? new_tri[neighbor] : neighbor;
+			}
+		}
+		mEdge.swap(edge);
+	}
+
+	std::vector<VertexData> vertices(num_verts);
+	for (S32 v = 0; v < num_verts; v++)
+	{
+		vertices[vert_map[v]] = mVertices[v];
+	}
+
+	mVertices.swap(vertices);
+	mIndices.swap(indices);
+	mCacheOptimized = TRUE;
+
+	LL_DEBUGS("VertexCache") << "Face " << mID << " (" << num_tris << " triangles) ACMR "
+		<< acmr_before << " -> " << acmr_after << LL_ENDL;
+}
+
+F32 LLVolumeFace::calcACMR(S32 cache_size) const
+{
+	return calc_acmr(mIndices, cache_size);
+}
+
 BOOL LLVolumeFace::createSide(LLVolume* volume, BOOL partial_build)
 {
 	LLMemType m1(LLMemType::MTYPE_VOLUME);
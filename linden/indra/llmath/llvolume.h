@@ -792,13 +792,26 @@ public:
 		mBeginS(0),
 		mBeginT(0),
 		mNumS(0),
-		mNumT(0)
+		mNumT(0),
+		mCacheOptimized(FALSE)
 	{
 	}
 
 	BOOL create(LLVolume* volume, BOOL partial_build = FALSE);
 	void createBinormals();
 
+	// Reorder triangles for the post-transform vertex cache, then renumber
+	// vertices in the order they are first referenced.  Faces that don't
+	// get a lower cache miss ratio are left alone.
+	void optimizeVertexCache();
+
+	// Average cache miss ratio (transformed vertices per triangle) of the
+	// current index order on a FIFO cache of the given size.
+	F32 calcACMR(S32 cache_size = 16) const;
+
+	// Reorder geometry of newly built faces for the vertex cache.
+	static BOOL sOptimizeVertexCache;
+
 	class VertexData
 	{
 	public:
@@ -841,6 +854,9 @@ public:
 	std::vector<U16>	mIndices;
 	std::vector<S32>	mEdge;
 
+	// vertices are no longer in S/T grid order, so partial builds can't reuse the indices
+	BOOL mCacheOptimized;
+
 private:
 	BOOL createUnCutCubeCap(LLVolume* volume, BOOL partial_build = FALSE);
 	BOOL createCap(LLVolume* volume, BOOL partial_build = FALSE);
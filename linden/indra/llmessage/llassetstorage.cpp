@@ -64,6 +64,10 @@ const LLUUID CATEGORIZE_LOST_AND_FOUND_ID(std::string("00000000-0000-0000-0000-0
 
 const U64 TOXIC_ASSET_LIFETIME = (120 * 1000000);		// microseconds
 
+// Prefetch defaults, the budget can be changed with setPrefetchBudget()
+const S32 DEFAULT_PREFETCH_BUDGET = 32 * 1024;		// bytes per second
+const S32 MAX_PREFETCHES_IN_FLIGHT = 4;
+
 LLTempAssetStorage::~LLTempAssetStorage()
 {
 }
@@ -306,14 +310,31 @@ void LLAssetStorage::_init(LLMessageSystem *msg,
 	mXferManager = xfer;
 	mVFS = vfs;
 
+	mPrefetchBudget = DEFAULT_PREFETCH_BUDGET;
+	mPrefetchCredit = 0.f;
+	mPrefetchUpdateTime = LLMessageSystem::getMessageTimeSeconds();
+	mPrefetchesInFlight = 0;
+
+	mCacheHits = 0;
+	mCacheMisses = 0;
+	mCoalescedRequests = 0;
+	mQueueTimeSamples = 0;
+	mTotalQueueTime = 0.0;
+
 	setUpstream(upstream_host);
-	msg->setHandlerFuncFast(_PREHASH_AssetUploadComplete, processUploadComplete, (void **)this);
+	if (msg)
+	{
+		// NULL in unit tests, which never upload
+		msg->setHandlerFuncFast(_PREHASH_AssetUploadComplete, processUploadComplete, (void **)this);
+	}
 }
 
 LLAssetStorage::~LLAssetStorage()
 {
 	mShutDown = TRUE;
 	
+	dumpStats();
+	mPrefetchQueue.clear();
 	_cleanupRequests(TRUE, LL_ERR_CIRCUIT_GONE);
 
 	if (gMessageSystem)
@@ -337,6 +358,7 @@ void LLAssetStorage::setUpstream(const LLHost &upstream_host)
 void LLAssetStorage::checkForTimeouts()
 {
 	_cleanupRequests(FALSE, LL_ERR_TCP_TIMEOUT);
+	updatePrefetches();
 }
 
 void LLAssetStorage::_cleanupRequests(BOOL all, S32 error)
@@ -366,7 +388,7 @@ void LLAssetStorage::_cleanupRequests(BOOL all, S32 error)
 						<< LLAssetType::lookup(tmp->getType()) << llendl;
 
 				timed_out.push_front(tmp);
-				iter = requests->erase(curiter);
+				iter = erasePendingRequest(requests, curiter);
 			}
 		}
 	}
@@ -438,11 +460,11 @@ void LLAssetStorage::getAssetData(const LLUUID uuid, LLAssetType::EType type, vo
 		BOOL duplicate = FALSE;
 		
 		// check to see if there's a pending download of this uuid already
-		for (request_list_t::iterator iter = mPendingDownloads.begin();
-			 iter != mPendingDownloads.end(); ++iter )
+		std::pair<request_index_t::iterator, request_index_t::iterator> range = mPendingDownloadIndex.equal_range(uuid);
+		for (request_index_t::iterator iter = range.first; iter != range.second; ++iter)
 		{
-			LLAssetRequest  *tmp = *iter;
-			if ((type == tmp->getType()) && (uuid == tmp->getUUID()))
+			LLAssetRequest  *tmp = *(iter->second);
+			if (type == tmp->getType())
 			{
 				if (callback == tmp->mDownCallback && user_data == tmp->mUserData)
 				{
@@ -461,6 +483,11 @@ void LLAssetStorage::getAssetData(const LLUUID uuid, LLAssetType::EType type, vo
 		{
 			llinfos << "Adding additional non-duplicate request for asset " << uuid 
 					<< "." << LLAssetType::lookup(type) << llendl;
+			mCoalescedRequests++;
+		}
+		else if (callback != prefetchCompleteCallback)
+		{
+			mCacheMisses++;
 		}
 		
 		// This can be overridden by subclasses
@@ -471,6 +498,10 @@ void LLAssetStorage::getAssetData(const LLUUID uuid, LLAssetType::EType type, vo
 		// we've already got the file
 		// theoretically, partial files w/o a pending request shouldn't happen
 		// unless there's a weird error
+		if (callback != prefetchCompleteCallback)
+		{
+			mCacheHits++;
+		}
 		if (callback)
 		{
 			callback(mVFS, uuid, type, user_data, LL_ERR_NOERR, LL_EXSTAT_VFS_CACHED);
@@ -478,6 +509,48 @@ void LLAssetStorage::getAssetData(const LLUUID uuid, LLAssetType::EType type, vo
 	}
 }
 
+void LLAssetStorage::addPendingRequest(ERequestType rt, LLAssetRequest *req, bool at_front)
+{
+	request_list_t *requests = getRequestList(rt);
+	if (!requests)
+	{
+		return;
+	}
+
+	request_list_t::iterator iter;
+	if (at_front)
+	{
+		requests->push_front(req);
+		iter = requests->begin();
+	}
+	else
+	{
+		iter = requests->insert(requests->end(), req);
+	}
+
+	if (requests == &mPendingDownloads)
+	{
+		mPendingDownloadIndex.insert(std::make_pair(req->getUUID(), iter));
+	}
+}
+
+LLAssetStorage::request_list_t::iterator LLAssetStorage::erasePendingRequest(request_list_t *requests, request_list_t::iterator iter)
+{
+	if (requests == &mPendingDownloads)
+	{
+		std::pair<request_index_t::iterator, request_index_t::iterator> range = mPendingDownloadIndex.equal_range((*iter)->getUUID());
+		for (request_index_t::iterator index_iter = range.first; index_iter != range.second; ++index_iter)
+		{
+			if (index_iter->second == iter)
+			{
+				mPendingDownloadIndex.erase(index_iter);
+				break;
+			}
+		}
+	}
+	return requests->erase(iter);
+}
+
 void LLAssetStorage::_queueDataRequest(const LLUUID& uuid, LLAssetType::EType atype,
 									   LLGetAssetCallback callback,
 									   void *user_data, BOOL duplicate,
@@ -491,7 +564,7 @@ void LLAssetStorage::_queueDataRequest(const LLUUID& uuid, LLAssetType::EType at
 		req->mUserData = user_data;
 		req->mIsPriority = is_priority;
 	
-		mPendingDownloads.push_back(req);
+		addPendingRequest(RT_DOWNLOAD, req);
 	
 		if (!duplicate)
 		{
@@ -543,17 +616,17 @@ void LLAssetStorage::downloadCompleteCallback(
 		return;
 	}
 
-	// Inefficient since we're doing a find through a list that may have thousands of elements.
-	// This is due for refactoring; we will probably change mPendingDownloads into a set.
-	request_list_t::iterator download_iter = std::find(gAssetStorage->mPendingDownloads.begin(), 
-													   gAssetStorage->mPendingDownloads.end(),
-													   req);
 	// If the LLAssetRequest doesn't exist in the downloads queue, then it either has already been deleted
 	// by _cleanupRequests, or it's a transfer.
-	if (download_iter != gAssetStorage->mPendingDownloads.end())
+	std::pair<request_index_t::iterator, request_index_t::iterator> range =
+		gAssetStorage->mPendingDownloadIndex.equal_range(file_id);
+	for (request_index_t::iterator iter = range.first; iter != range.second; ++iter)
 	{
-		req->setUUID(file_id);
-		req->setType(file_type);
+		if (*(iter->second) == req)
+		{
+			req->setType(file_type);
+			break;
+		}
 	}
 
 	if (LL_ERR_NOERR == result)
@@ -573,22 +646,26 @@ void LLAssetStorage::downloadCompleteCallback(
 	// SJB: We process the callbacks in reverse order, I do not know if this is important,
 	//      but I didn't want to mess with it.
 	request_list_t requests;
-	for (request_list_t::iterator iter = gAssetStorage->mPendingDownloads.begin();
-		 iter != gAssetStorage->mPendingDownloads.end();  )
+	range = gAssetStorage->mPendingDownloadIndex.equal_range(file_id);
+	for (request_index_t::iterator iter = range.first; iter != range.second;  )
 	{
-		request_list_t::iterator curiter = iter++;
-		LLAssetRequest* tmp = *curiter;
-		if ((tmp->getUUID() == file_id) && (tmp->getType()== file_type))
+		request_index_t::iterator curiter = iter++;
+		LLAssetRequest* tmp = *(curiter->second);
+		if (tmp->getType() == file_type)
 		{
 			requests.push_front(tmp);
-			iter = gAssetStorage->mPendingDownloads.erase(curiter);
+			gAssetStorage->mPendingDownloads.erase(curiter->second);
+			gAssetStorage->mPendingDownloadIndex.erase(curiter);
 		}
 	}
+	F64 mt_secs = LLMessageSystem::getMessageTimeSeconds();
 	for (request_list_t::iterator iter = requests.begin();
 		 iter != requests.end();  )
 	{
 		request_list_t::iterator curiter = iter++;
 		LLAssetRequest* tmp = *curiter;
+		gAssetStorage->mTotalQueueTime += mt_secs - tmp->mTime;
+		gAssetStorage->mQueueTimeSamples++;
 		if (tmp->mDownCallback)
 		{
 			tmp->mDownCallback(gAssetStorage->mVFS, req->getUUID(), req->getType(), tmp->mUserData, result, ext_status);
@@ -597,6 +674,99 @@ void LLAssetStorage::downloadCompleteCallback(
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////
+// PREFETCH routines
+///////////////////////////////////////////////////////////////////////////
+
+void LLAssetStorage::prefetchAssets(const asset_prefetch_list_t &assets)
+{
+	if (mShutDown)
+	{
+		return;
+	}
+
+	for (asset_prefetch_list_t::const_iterator iter = assets.begin();
+		 iter != assets.end(); ++iter)
+	{
+		if (iter->mUUID.notNull())
+		{
+			mPrefetchQueue.insert(std::make_pair(iter->mPriority, std::make_pair(iter->mUUID, iter->mType)));
+		}
+	}
+	updatePrefetches();
+}
+
+void LLAssetStorage::updatePrefetches()
+{
+	F64 mt_secs = LLMessageSystem::getMessageTimeSeconds();
+	F32 elapsed = (F32)(mt_secs - mPrefetchUpdateTime);
+	mPrefetchUpdateTime = mt_secs;
+
+	// Credit refills at the budget rate, and never banks more than a second's worth.
+	mPrefetchCredit = llmin(mPrefetchCredit + elapsed * mPrefetchBudget, (F32)mPrefetchBudget);
+
+	while (!mShutDown
+		   && !mPrefetchQueue.empty()
+		   && (mPrefetchCredit > 0.f)
+		   && (mPrefetchesInFlight < MAX_PREFETCHES_IN_FLIGHT))
+	{
+		LLUUID uuid = mPrefetchQueue.begin()->second.first;
+		LLAssetType::EType type = mPrefetchQueue.begin()->second.second;
+		mPrefetchQueue.erase(mPrefetchQueue.begin());
+
+		if (mVFS->getExists(uuid, type))
+		{
+			// Already warm
+			continue;
+		}
+
+		BOOL pending = FALSE;
+		std::pair<request_index_t::iterator, request_index_t::iterator> range = mPendingDownloadIndex.equal_range(uuid);
+		for (request_index_t::iterator iter = range.first; iter != range.second; ++iter)
+		{
+			if ((*(iter->second))->getType() == type)
+			{
+				pending = TRUE;
+				break;
+			}
+		}
+		if (pending)
+		{
+			// Someone is already fetching it
+			continue;
+		}
+
+		mPrefetchesInFlight++;
+		getAssetData(uuid, type, prefetchCompleteCallback, this, FALSE);
+	}
+}
+
+// static
+void LLAssetStorage::prefetchCompleteCallback(LLVFS *vfs, const LLUUID &asset_id, LLAssetType::EType asset_type,
+											  void *user_data, S32 status, LLExtStat ext_status)
+{
+	LLAssetStorage *self = (LLAssetStorage *)user_data;
+	self->mPrefetchesInFlight--;
+	if ((LL_ERR_NOERR == status) && vfs)
+	{
+		self->mPrefetchCredit -= (F32)vfs->getSize(asset_id, asset_type);
+	}
+}
+
+F32 LLAssetStorage::getMeanQueueTime() const
+{
+	return mQueueTimeSamples ? (F32)(mTotalQueueTime / mQueueTimeSamples) : 0.f;
+}
+
+void LLAssetStorage::dumpStats() const
+{
+	U32 lookups = mCacheHits + mCacheMisses;
+	llinfos << "Asset downloads: " << mCacheHits << " of " << lookups << " from VFS ("
+			<< (lookups ? (100 * mCacheHits / lookups) : 0) << "%), "
+			<< mCoalescedRequests << " coalesced, mean queue time "
+			<< getMeanQueueTime() << "s" << llendl;
+}
+
 void LLAssetStorage::getEstateAsset(const LLHost &object_sim, const LLUUID &agent_id, const LLUUID &session_id,
 									const LLUUID &asset_id, LLAssetType::EType atype, EstateAssetType etype,
 									 LLGetAssetCallback callback, void *user_data, BOOL is_priority)
@@ -1158,7 +1328,7 @@ bool LLAssetStorage::deletePendingRequest(LLAssetStorage::request_list_t* reques
 	if (req)
 	{
 		// Remove the request from this list.
-		requests->remove(req);
+		erasePendingRequest(requests, std::find(requests->begin(), requests->end(), req));
 		S32 error = LL_ERR_TCP_TIMEOUT;
 		// Run callbacks.
 		if (req->mUpCallback)
@@ -1226,10 +1396,10 @@ const char* LLAssetStorage::getErrorString(S32 status)
 void LLAssetStorage::getAssetData(const LLUUID uuid, LLAssetType::EType type, void (*callback)(const char*, const LLUUID&, void *, S32, LLExtStat), void *user_data, BOOL is_priority)
 {
 	// check for duplicates here, since we're about to fool the normal duplicate checker
-	for (request_list_t::iterator iter = mPendingDownloads.begin();
-		 iter != mPendingDownloads.end();  )
+	std::pair<request_index_t::iterator, request_index_t::iterator> range = mPendingDownloadIndex.equal_range(uuid);
+	for (request_index_t::iterator iter = range.first; iter != range.second; ++iter)
 	{
-		LLAssetRequest* tmp = *iter++;
+		LLAssetRequest* tmp = *(iter->second);
 		if (type == tmp->getType() && 
 			uuid == tmp->getUUID() &&
 			legacyGetDataCallback == tmp->mDownCallback &&
@@ -34,7 +34,9 @@
 #ifndef LL_LLASSETSTORAGE_H
 #define LL_LLASSETSTORAGE_H
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "lluuid.h"
 #include "lltimer.h"
@@ -201,6 +203,18 @@ public:
 // Map of known bad assets
 typedef std::map<LLUUID,U64,lluuid_less> toxic_asset_map_t;
 
+// An asset to pull into the VFS ahead of need
+struct LLAssetPrefetch
+{
+	LLAssetPrefetch(const LLUUID &uuid, LLAssetType::EType type, F32 priority)
+		: mUUID(uuid), mType(type), mPriority(priority) {}
+
+	LLUUID				mUUID;
+	LLAssetType::EType	mType;
+	F32					mPriority;	// Higher is fetched first
+};
+typedef std::vector<LLAssetPrefetch> asset_prefetch_list_t;
+
 typedef void (*LLGetAssetCallback)(LLVFS *vfs, const LLUUID &asset_id,
 										 LLAssetType::EType asset_type, void *user_data, S32 status, LLExtStat ext_status);
 
@@ -241,6 +255,25 @@ protected:
 	request_list_t mPendingDownloads;
 	request_list_t mPendingUploads;
 	request_list_t mPendingLocalUploads;
+
+	// Every entry in mPendingDownloads, by asset id.  Keep it in step by
+	// going through addPendingRequest() and erasePendingRequest().
+	typedef std::multimap<LLUUID, request_list_t::iterator> request_index_t;
+	request_index_t mPendingDownloadIndex;
+
+	typedef std::multimap<F32, std::pair<LLUUID, LLAssetType::EType>, std::greater<F32> > prefetch_queue_t;
+	prefetch_queue_t mPrefetchQueue;
+	S32		mPrefetchBudget;		// Bytes per second
+	F32		mPrefetchCredit;		// Bytes prefetches may still pull this second
+	F64		mPrefetchUpdateTime;
+	S32		mPrefetchesInFlight;
+
+	// Download statistics
+	U32		mCacheHits;
+	U32		mCacheMisses;
+	U32		mCoalescedRequests;
+	U32		mQueueTimeSamples;
+	F64		mTotalQueueTime;
 	
 	// Map of toxic assets - these caused problems when recently rezzed, so avoid them
 	toxic_asset_map_t	mToxicAssetMap;		// Objects in this list are known to cause problems and are not loaded
@@ -262,6 +295,19 @@ public:
 
 	virtual void getAssetData(const LLUUID uuid, LLAssetType::EType atype, LLGetAssetCallback cb, void *user_data, BOOL is_priority = FALSE);
 
+	// Warm the VFS with assets that will be wanted soon.  No callbacks are
+	// made.  Queued assets are requested highest priority first, a few at a
+	// time, and only while prefetched data stays inside the byte budget.
+	void prefetchAssets(const asset_prefetch_list_t &assets);
+	void setPrefetchBudget(S32 bytes_per_sec)	{ mPrefetchBudget = bytes_per_sec; }
+	S32 getNumQueuedPrefetches() const			{ return (S32)mPrefetchQueue.size(); }
+
+	U32 getCacheHits() const					{ return mCacheHits; }
+	U32 getCacheMisses() const					{ return mCacheMisses; }
+	U32 getCoalescedRequests() const			{ return mCoalescedRequests; }
+	F32 getMeanQueueTime() const;				// Seconds from request to download callback
+	void dumpStats() const;
+
 	/*
 	 * TransactionID version
 	 * Viewer needs the store_local
@@ -438,6 +484,13 @@ protected:
 								   void *user_data, BOOL duplicate,
 								   BOOL is_priority);
 
+	void addPendingRequest(ERequestType rt, LLAssetRequest *req, bool at_front = false);
+	request_list_t::iterator erasePendingRequest(request_list_t *requests, request_list_t::iterator iter);
+
+	void updatePrefetches();
+	static void prefetchCompleteCallback(LLVFS *vfs, const LLUUID &asset_id, LLAssetType::EType asset_type,
+										 void *user_data, S32 status, LLExtStat ext_status);
+
 private:
 	void _init(LLMessageSystem *msg,
 			   LLXferManager *xfer,
@@ -41,8 +41,11 @@
 #include "llrand.h"
 #include "llsdserialize.h"
 #include "lluuid.h"
+#include "lluuidopenhashmap.h"
 #include "message.h"
 
+#include <iterator>
+
 // Constants
 static const std::string CN_WAITING("(Loading...)"); // *TODO: translate
 static const std::string CN_NOBODY("(nobody)"); // *TODO: translate
@@ -63,6 +66,28 @@ const U32 PENDING_TIMEOUT_SECS = 5 * 60;
 // File version number
 const S32 CN_FILE_VERSION = 2;
 
+// Packed name cache file.  After the magic and a header of version and
+// record count, each record is the raw id, the creation time, a flags
+// byte and two length prefixed strings (first and last name for agents,
+// the group name and an empty string for groups).  Integers are little
+// endian.
+static const char CN_BINARY_MAGIC[] = "LLNC";
+const S32 CN_BINARY_MAGIC_LEN = 4;
+const U32 CN_BINARY_VERSION = 1;
+const U32 CN_BINARY_HEADER_LEN = 8;
+const U8 CN_RECORD_GROUP = 0x01;
+// id, creation time, flags and two empty strings
+const U32 CN_MIN_RECORD_LEN = UUID_BYTES + 4 + 1 + 2;
+
+// Hold back a partly filled request packet for at most this long while
+// more ids are still being queued, so that a burst of lookups (a large
+// group member list, the active speakers) goes out in full packets.
+const F32 ASK_HOLD_SECS = 0.5f;
+
+// Upper bound on request packets sent per processPending(); the rest
+// stay queued for the next call.
+const S32 MAX_REQUEST_PACKETS_PER_PROCESS = 16;
+
 // Globals
 LLCacheName* gCacheName = NULL;
 
@@ -188,9 +213,69 @@ void ReplySender::flush()
 
 typedef std::set<LLUUID>					AskQueue;
 typedef std::vector<PendingReply>			ReplyQueue;
-typedef std::map<LLUUID,U32>				PendingQueue;
-typedef std::map<LLUUID, LLCacheNameEntry*> Cache;
+typedef LLUUIDOpenHashMap<U32>				PendingQueue;
+typedef LLUUIDOpenHashMap<LLCacheNameEntry*> Cache;
+typedef LLUUIDOpenHashMap<U32>				RecordIndex;
 typedef std::vector<LLCacheNameCallback>	Observers;
+typedef std::vector<LLCacheNameBatchCallback> BatchObservers;
+
+// Tracks how an ask queue has been filling between sends.
+class AskBatch
+{
+public:
+	AskBatch() : mLastSize(0) { }
+
+	size_t			mLastSize;	// queue size left after the last send
+	LLFrameTimer	mAge;		// time since the queue became non-empty
+};
+
+static void append_u32(std::string& out, U32 value)
+{
+	out += (char)(value & 0xff);
+	out += (char)((value >> 8) & 0xff);
+	out += (char)((value >> 16) & 0xff);
+	out += (char)((value >> 24) & 0xff);
+}
+
+static U32 read_u32(const std::string& data, U32 offset)
+{
+	return (U32)(U8)data[offset]
+		| ((U32)(U8)data[offset + 1] << 8)
+		| ((U32)(U8)data[offset + 2] << 16)
+		| ((U32)(U8)data[offset + 3] << 24);
+}
+
+static void append_string(std::string& out, const std::string& value)
+{
+	size_t length = llmin(value.size(), (size_t)255);
+	out += (char)length;
+	out.append(value, 0, length);
+}
+
+static std::string read_string(const std::string& data, U32& pos)
+{
+	U32 length = (U8)data[pos];
+	std::string value(data, pos + 1, length);
+	pos += 1 + length;
+	return value;
+}
+
+// Returns the length of the record at offset, or 0 if it runs past the
+// end of the data.
+static U32 record_length(const std::string& data, U32 offset)
+{
+	U32 size = (U32)data.size();
+	U32 pos = offset + UUID_BYTES + 4 + 1;
+	for (S32 i = 0; i < 2; ++i)
+	{
+		if (pos >= size)
+		{
+			return 0;
+		}
+		pos += 1 + (U8)data[pos];
+	}
+	return (pos > size) ? 0 : pos - offset;
+}
 
 class LLCacheName::Impl
 {
@@ -204,14 +289,28 @@ public:
 	AskQueue			mAskNameQueue;
 	AskQueue			mAskGroupQueue;
 		// UUIDs to ask our upstream host about
+	AskBatch			mAskNameBatch;
+	AskBatch			mAskGroupBatch;
+	S32					mRequestBlocksPerPacket;
+		// blocks that fit in a request packet, learned from the last full one
 	
 	PendingQueue		mPendingQueue;
 		// UUIDs that have been requested but are not in cache yet.
 
 	ReplyQueue			mReplyQueue;
 		// requests awaiting replies from us
+	bool				mRepliesDirty;
+		// names have arrived since mReplyQueue was last checked
+
+	std::string			mRecordData;
+	RecordIndex			mRecordIndex;
+		// packed records from the imported cache file that have not been
+		// decoded yet, by offset into mRecordData
 
 	Observers			mObservers;
+	BatchObservers		mBatchObservers;
+	std::vector<LLUUID>	mChangedIDs;
+		// names that arrived since the batch observers were last called
 
 	LLFrameTimer		mProcessTimer;
 
@@ -220,9 +319,13 @@ public:
 
 	void processPendingAsks();
 	void processPendingReplies();
-	void sendRequest(const char* msg_name, const AskQueue& queue);
+	void sendRequest(const char* msg_name, AskQueue& queue, AskBatch& batch);
 	bool isRequestPending(const LLUUID& id);
 
+	// Looks up id in the cache, decoding its packed record if needed.
+	LLCacheNameEntry* findEntry(const LLUUID& id);
+	bool importPacked(std::istream& istr);
+
 	// Message system callbacks.
 	void processUUIDRequest(LLMessageSystem* msg, bool isGroup);
 	void processUUIDReply(LLMessageSystem* msg, bool isGroup);
@@ -233,6 +336,7 @@ public:
 	static void handleUUIDGroupNameReply(LLMessageSystem* msg, void** userdata);
 
 	void notifyObservers(const LLUUID& id, const std::string& first, const std::string& last, BOOL group);
+	void notifyBatchObservers();
 };
 
 
@@ -256,8 +360,14 @@ LLCacheName::~LLCacheName()
 }
 
 LLCacheName::Impl::Impl(LLMessageSystem* msg)
-	: mMsg(msg), mUpstreamHost(LLHost::invalid)
+	: mMsg(msg), mUpstreamHost(LLHost::invalid),
+	  mRequestBlocksPerPacket(0), mRepliesDirty(false)
 {
+	// without a message system the cache only serves what it has loaded
+	if (!mMsg)
+	{
+		return;
+	}
 	mMsg->setHandlerFuncFast(
 		_PREHASH_UUIDNameRequest, handleUUIDNameRequest, (void**)this);
 	mMsg->setHandlerFuncFast(
@@ -301,6 +411,22 @@ void LLCacheName::removeObserver(LLCacheNameCallback callback)
 	}
 }
 
+void LLCacheName::addBatchObserver(LLCacheNameBatchCallback callback)
+{
+	impl.mBatchObservers.push_back(callback);
+}
+
+void LLCacheName::removeBatchObserver(LLCacheNameBatchCallback callback)
+{
+	BatchObservers::iterator it = std::find(impl.mBatchObservers.begin(),
+											impl.mBatchObservers.end(),
+											callback);
+	if (it != impl.mBatchObservers.end())
+	{
+		impl.mBatchObservers.erase(it);
+	}
+}
+
 void LLCacheName::cancelCallback(const LLUUID& id, LLCacheNameCallback callback, void* user_data)
 {
 	ReplyQueue::iterator it = impl.mReplyQueue.begin();
@@ -394,11 +520,23 @@ void LLCacheName::importFile(LLFILE* fp)
 		count++;
 	}
 
+	impl.mRepliesDirty = true;
 	llinfos << "LLCacheName loaded " << count << " names" << llendl;
 }
 
 bool LLCacheName::importFile(std::istream& istr)
 {
+	// Tell the packed format from the LLSD one by its magic.
+	char magic[CN_BINARY_MAGIC_LEN];	/*Flawfinder: ignore*/
+	istr.read(magic, CN_BINARY_MAGIC_LEN);
+	if (istr.gcount() == CN_BINARY_MAGIC_LEN
+		&& !memcmp(magic, CN_BINARY_MAGIC, CN_BINARY_MAGIC_LEN))
+	{
+		return impl.importPacked(istr);
+	}
+	istr.clear();
+	istr.seekg(0, std::ios::beg);
+
 	LLSD data;
 	if(LLSDSerialize::fromXML(data, istr) < 1)
 		return false;
@@ -449,12 +587,14 @@ bool LLCacheName::importFile(std::istream& istr)
 		++count;
 	}
 	llinfos << "LLCacheName loaded " << count << " group names" << llendl;
+	impl.mRepliesDirty = true;
 	return true;
 }
 
 void LLCacheName::exportFile(std::ostream& ostr)
 {
-	LLSD data;
+	std::string records;
+	U32 count = 0;
 	Cache::iterator iter = impl.mCache.begin();
 	Cache::iterator end = impl.mCache.end();
 	for( ; iter != end; ++iter)
@@ -469,22 +609,135 @@ void LLCacheName::exportFile(std::ostream& ostr)
 		}
 
 		// store it
-		LLUUID id = iter->first;
-		std::string id_str = id.asString();
+		const LLUUID& id = iter->first;
 		if(!entry->mFirstName.empty() && !entry->mLastName.empty())
 		{
-			data[AGENTS][id_str][FIRST] = entry->mFirstName;
-			data[AGENTS][id_str][LAST] = entry->mLastName;
-			data[AGENTS][id_str][CTIME] = (S32)entry->mCreateTime;
+			records.append((const char*)id.mData, UUID_BYTES);
+			append_u32(records, entry->mCreateTime);
+			records += (char)0;
+			append_string(records, entry->mFirstName);
+			append_string(records, entry->mLastName);
+			++count;
 		}
 		else if(entry->mIsGroup && !entry->mGroupName.empty())
 		{
-			data[GROUPS][id_str][NAME] = entry->mGroupName;
-			data[GROUPS][id_str][CTIME] = (S32)entry->mCreateTime;
+			records.append((const char*)id.mData, UUID_BYTES);
+			append_u32(records, entry->mCreateTime);
+			records += (char)CN_RECORD_GROUP;
+			append_string(records, entry->mGroupName);
+			append_string(records, LLStringUtil::null);
+			++count;
 		}
 	}
 
-	LLSDSerialize::toPrettyXML(data, ostr);
+	// Records nobody looked up this session are copied through as is.
+	for (RecordIndex::iterator rec_iter = impl.mRecordIndex.begin();
+		 rec_iter != impl.mRecordIndex.end(); ++rec_iter)
+	{
+		U32 offset = rec_iter->second;
+		records.append(impl.mRecordData, offset,
+					   record_length(impl.mRecordData, offset));
+		++count;
+	}
+
+	std::string header(CN_BINARY_MAGIC, CN_BINARY_MAGIC_LEN);
+	append_u32(header, CN_BINARY_VERSION);
+	append_u32(header, count);
+	ostr.write(header.data(), header.size());
+	ostr.write(records.data(), records.size());
+}
+
+bool LLCacheName::Impl::importPacked(std::istream& istr)
+{
+	// Read the rest of the file in one go; records are only indexed here
+	// and decoded by findEntry() the first time they are asked for.
+	std::string data((std::istreambuf_iterator<char>(istr)),
+					 std::istreambuf_iterator<char>());
+	if (data.size() < CN_BINARY_HEADER_LEN
+		|| read_u32(data, 0) != CN_BINARY_VERSION)
+	{
+		llwarns << "Ignoring unknown name cache version" << llendl;
+		return false;
+	}
+
+	// We'll expire entries more than a week old
+	U32 now = (U32)time(NULL);
+	const U32 SECS_PER_DAY = 60 * 60 * 24;
+	U32 delete_before_time = now - (7 * SECS_PER_DAY);
+
+	// Any records left from an earlier import are dropped with their data.
+	mRecordIndex.clear();
+	// the count is only a hint, and must not reserve more than the data can hold
+	mRecordIndex.reserve(llmin(read_u32(data, 4), (U32)(data.size() / CN_MIN_RECORD_LEN)));
+
+	S32 count = 0;
+	U32 offset = CN_BINARY_HEADER_LEN;
+	while (offset < data.size())
+	{
+		U32 length = record_length(data, offset);
+		if (!length)
+		{
+			llwarns << "LLCacheName name cache truncated after "
+					<< count << " names" << llendl;
+			break;
+		}
+
+		if (read_u32(data, offset + UUID_BYTES) >= delete_before_time)
+		{
+			LLUUID id;
+			memcpy(id.mData, data.data() + offset, UUID_BYTES);	/* Flawfinder: ignore */
+			if (!mCache.count(id))
+			{
+				mRecordIndex[id] = offset;
+				++count;
+			}
+		}
+		offset += length;
+	}
+	mRecordData.swap(data);
+	mRepliesDirty = true;
+
+	llinfos << "LLCacheName indexed " << count << " names" << llendl;
+	return true;
+}
+
+LLCacheNameEntry* LLCacheName::Impl::findEntry(const LLUUID& id)
+{
+	LLCacheNameEntry* entry = get_ptr_in_map(mCache, id);
+	if (entry || mRecordIndex.empty())
+	{
+		return entry;
+	}
+
+	RecordIndex::iterator iter = mRecordIndex.find(id);
+	if (iter == mRecordIndex.end())
+	{
+		return NULL;
+	}
+
+	U32 pos = iter->second + UUID_BYTES;
+	entry = new LLCacheNameEntry;
+	entry->mCreateTime = read_u32(mRecordData, pos);
+	pos += 4;
+	entry->mIsGroup = (mRecordData[pos++] & CN_RECORD_GROUP) != 0;
+	if (entry->mIsGroup)
+	{
+		entry->mGroupName = read_string(mRecordData, pos);
+	}
+	else
+	{
+		entry->mFirstName = read_string(mRecordData, pos);
+		entry->mLastName = read_string(mRecordData, pos);
+	}
+	mCache[id] = entry;
+
+	mRecordIndex.erase(iter);
+	if (mRecordIndex.empty())
+	{
+		// Everything has been decoded, so the raw data can go.
+		std::string().swap(mRecordData);
+	}
+	return entry;
 }
 
 
@@ -497,7 +750,7 @@ BOOL LLCacheName::getName(const LLUUID& id, std::string& first, std::string& las
 		return FALSE;
 	}
 
-	LLCacheNameEntry* entry = get_ptr_in_map(impl.mCache, id );
+	LLCacheNameEntry* entry = impl.findEntry(id);
 	if (entry)
 	{
 		first = entry->mFirstName;
@@ -533,7 +786,7 @@ BOOL LLCacheName::getGroupName(const LLUUID& id, std::string& group)
 		return FALSE;
 	}
 
-	LLCacheNameEntry* entry = get_ptr_in_map(impl.mCache,id);
+	LLCacheNameEntry* entry = impl.findEntry(id);
 	if (entry && entry->mGroupName.empty())
 	{
 		// COUNTER-HACK to combat James' HACK in exportFile()...
@@ -569,7 +822,7 @@ void LLCacheName::get(const LLUUID& id, BOOL is_group, LLCacheNameCallback callb
 		return;
 	}
 
-	LLCacheNameEntry* entry = get_ptr_in_map(impl.mCache, id );
+	LLCacheNameEntry* entry = impl.findEntry(id);
 	if (entry)
 	{
 		// id found in map therefore we can call the callback immediately.
@@ -608,6 +861,8 @@ void LLCacheName::processPending()
 		return;
 	}
 
+	impl.notifyBatchObservers();
+
 	if(!impl.mUpstreamHost.isOk())
 	{
 		lldebugs << "LLCacheName::processPending() - bad upstream host."
@@ -623,29 +878,49 @@ void LLCacheName::deleteEntriesOlderThan(S32 secs)
 {
 	U32 now = (U32)time(NULL);
 	U32 expire_time = now - secs;
-	for(Cache::iterator iter = impl.mCache.begin(); iter != impl.mCache.end(); )
+
+	// Erasing moves entries around, so collect the ids first.
+	std::vector<LLUUID> expired;
+	for(Cache::iterator iter = impl.mCache.begin(); iter != impl.mCache.end(); ++iter)
 	{
-		Cache::iterator curiter = iter++;
-		LLCacheNameEntry* entry = curiter->second;
+		LLCacheNameEntry* entry = iter->second;
 		if (entry->mCreateTime < expire_time)
 		{
 			delete entry;
-			impl.mCache.erase(curiter);
+			expired.push_back(iter->first);
+		}
+	}
+	for(RecordIndex::iterator r_iter = impl.mRecordIndex.begin();
+		r_iter != impl.mRecordIndex.end(); ++r_iter)
+	{
+		if (read_u32(impl.mRecordData, r_iter->second + UUID_BYTES) < expire_time)
+		{
+			expired.push_back(r_iter->first);
 		}
 	}
+	for (std::vector<LLUUID>::iterator e_iter = expired.begin();
+		 e_iter != expired.end(); ++e_iter)
+	{
+		impl.mCache.erase(*e_iter);
+		impl.mRecordIndex.erase(*e_iter);
+	}
 
 	// These are pending requests that we never heard back from.
 	U32 pending_expire_time = now - PENDING_TIMEOUT_SECS;
+	expired.clear();
 	for(PendingQueue::iterator p_iter = impl.mPendingQueue.begin();
-		p_iter != impl.mPendingQueue.end(); )
+		p_iter != impl.mPendingQueue.end(); ++p_iter)
 	{
-		PendingQueue::iterator p_curitor = p_iter++;
- 
-		if (p_curitor->second < pending_expire_time)
+		if (p_iter->second < pending_expire_time)
 		{
-			impl.mPendingQueue.erase(p_curitor);
+			expired.push_back(p_iter->first);
 		}
 	}
+	for (std::vector<LLUUID>::iterator e_iter = expired.begin();
+		 e_iter != expired.end(); ++e_iter)
+	{
+		impl.mPendingQueue.erase(*e_iter);
+	}
 }
 
 
@@ -679,6 +954,7 @@ void LLCacheName::dumpStats()
 {
 	llinfos << "Queue sizes: "
 			<< " Cache=" << impl.mCache.size()
+			<< " Undecoded=" << impl.mRecordIndex.size()
 			<< " AskName=" << impl.mAskNameQueue.size()
 			<< " AskGroup=" << impl.mAskGroupQueue.size()
 			<< " Pending=" << impl.mPendingQueue.size()
@@ -695,21 +971,26 @@ std::string LLCacheName::getDefaultName()
 
 void LLCacheName::Impl::processPendingAsks()
 {
-	sendRequest(_PREHASH_UUIDNameRequest, mAskNameQueue);
-	sendRequest(_PREHASH_UUIDGroupNameRequest, mAskGroupQueue);
-	mAskNameQueue.clear();
-	mAskGroupQueue.clear();
+	sendRequest(_PREHASH_UUIDNameRequest, mAskNameQueue, mAskNameBatch);
+	sendRequest(_PREHASH_UUIDGroupNameRequest, mAskGroupQueue, mAskGroupBatch);
 }
 
 void LLCacheName::Impl::processPendingReplies()
 {
+	// Nothing can have been answered unless names arrived.
+	if (!mRepliesDirty)
+	{
+		return;
+	}
+	mRepliesDirty = false;
+
 	ReplyQueue::iterator it = mReplyQueue.begin();
 	ReplyQueue::iterator end = mReplyQueue.end();
 	
 	// First call all the callbacks, because they might send messages.
 	for(; it != end; ++it)
 	{
-		LLCacheNameEntry* entry = get_ptr_in_map(mCache, it->mID);
+		LLCacheNameEntry* entry = findEntry(it->mID);
 		if(!entry) continue;
 
 		if (it->mCallback)
@@ -732,7 +1013,7 @@ void LLCacheName::Impl::processPendingReplies()
 	ReplySender sender(mMsg);
 	for (it = mReplyQueue.begin(); it != end; ++it)
 	{
-		LLCacheNameEntry* entry = get_ptr_in_map(mCache, it->mID);
+		LLCacheNameEntry* entry = findEntry(it->mID);
 		if(!entry) continue;
 
 		if (it->mHost.isOk())
@@ -752,36 +1033,63 @@ void LLCacheName::Impl::processPendingReplies()
 
 void LLCacheName::Impl::sendRequest(
 	const char* msg_name,
-	const AskQueue& queue)
+	AskQueue& queue,
+	AskBatch& batch)
 {
 	if(queue.empty())
 	{
+		batch.mLastSize = 0;
 		return;		
 	}
 
+	if (!batch.mLastSize)
+	{
+		batch.mAge.reset();
+	}
+
+	// While the queue is still growing, only send full packets and leave
+	// the remainder to fill up, unless it has waited long enough.
+	bool send_partial = queue.size() <= batch.mLastSize
+		|| batch.mAge.getElapsedTimeF32() > ASK_HOLD_SECS;
+
+	size_t remaining = queue.size();
+	S32 blocks = 0;
+	S32 packets = 0;
 	bool start_new_message = true;
-	AskQueue::const_iterator it = queue.begin();
-	AskQueue::const_iterator end = queue.end();
-	for(; it != end; ++it)
+	AskQueue::iterator it = queue.begin();
+	while (it != queue.end())
 	{
 		if(start_new_message)
 		{
+			if (packets >= MAX_REQUEST_PACKETS_PER_PROCESS
+				|| (!send_partial && remaining < (size_t)mRequestBlocksPerPacket))
+			{
+				break;
+			}
 			start_new_message = false;
+			blocks = 0;
 			mMsg->newMessageFast(msg_name);
 		}
 		mMsg->nextBlockFast(_PREHASH_UUIDNameBlock);
 		mMsg->addUUIDFast(_PREHASH_ID, (*it));
+		queue.erase(it++);
+		--remaining;
+		++blocks;
 
 		if(mMsg->isSendFullFast(_PREHASH_UUIDNameBlock))
 		{
+			mRequestBlocksPerPacket = blocks;
 			start_new_message = true;
 			mMsg->sendReliable(mUpstreamHost);
+			++packets;
 		}
 	}
 	if(!start_new_message)
 	{
 		mMsg->sendReliable(mUpstreamHost);
 	}
+
+	batch.mLastSize = queue.size();
 }
 
 void LLCacheName::Impl::notifyObservers(const LLUUID& id,
@@ -796,6 +1104,25 @@ void LLCacheName::Impl::notifyObservers(const LLUUID& id,
 	}
 }
 
+void LLCacheName::Impl::notifyBatchObservers()
+{
+	if (mChangedIDs.empty())
+	{
+		return;
+	}
+
+	// Swap out first, observers may trigger more lookups.
+	std::vector<LLUUID> changed;
+	changed.swap(mChangedIDs);
+	for (BatchObservers::const_iterator i = mBatchObservers.begin(),
+										end = mBatchObservers.end();
+		i != end;
+		++i)
+	{
+		(**i)(changed);
+	}
+}
+
 bool LLCacheName::Impl::isRequestPending(const LLUUID& id)
 {
 	U32 now = (U32)time(NULL);
@@ -831,7 +1158,7 @@ void LLCacheName::Impl::processUUIDRequest(LLMessageSystem* msg, bool isGroup)
 	{
 		LLUUID id;
 		msg->getUUIDFast(_PREHASH_UUIDNameBlock, _PREHASH_ID, id, i);
-		LLCacheNameEntry* entry = get_ptr_in_map(mCache, id);
+		LLCacheNameEntry* entry = findEntry(id);
 		if(entry)
 		{
 			if (isGroup != entry->mIsGroup)
@@ -876,7 +1203,7 @@ void LLCacheName::Impl::processUUIDReply(LLMessageSystem* msg, bool isGroup)
 	{
 		LLUUID id;
 		msg->getUUIDFast(_PREHASH_UUIDNameBlock, _PREHASH_ID, id, i);
-		LLCacheNameEntry* entry = get_ptr_in_map(mCache, id);
+		LLCacheNameEntry* entry = findEntry(id);
 		if (!entry)
 		{
 			entry = new LLCacheNameEntry;
@@ -906,6 +1233,16 @@ void LLCacheName::Impl::processUUIDReply(LLMessageSystem* msg, bool isGroup)
 		{
 			notifyObservers(id, entry->mGroupName, "", TRUE);
 		}
+
+		if (!mBatchObservers.empty())
+		{
+			mChangedIDs.push_back(id);
+		}
+	}
+
+	if (count > 0)
+	{
+		mRepliesDirty = true;
 	}
 }
 
@@ -33,6 +33,8 @@
 #ifndef LL_LLCACHENAME_H
 #define LL_LLCACHENAME_H
 
+#include <vector>
+
 class LLMessageSystem;
 class LLHost;
 class LLUUID;
@@ -40,6 +42,9 @@ class LLUUID;
 // agent_id/group_id, first_name, last_name, is_group, user_data
 typedef void (*LLCacheNameCallback)(const LLUUID&, const std::string&, const std::string&, BOOL, void*);
 
+// ids of every name that arrived since the last batch notification
+typedef void (*LLCacheNameBatchCallback)(const std::vector<LLUUID>&);
+
 // Here's the theory:
 // If you request a name that isn't in the cache, it returns "waiting"
 // and requests the data.  After the data arrives, you get that on 
@@ -62,12 +67,22 @@ public:
 	void addObserver(LLCacheNameCallback callback);
 	void removeObserver(LLCacheNameCallback callback);
 
+	// Batch observers are called at most once per processPending(), after
+	// the per-name observers, with all the names that arrived since the
+	// last call.  Use them for refreshes that cover many names at once.
+	void addBatchObserver(LLCacheNameBatchCallback callback);
+	void removeBatchObserver(LLCacheNameBatchCallback callback);
+
 	void cancelCallback(const LLUUID& id, LLCacheNameCallback callback, void* user_data = NULL);
 
 	// janky old format. Remove after a while. Phoenix. 2008-01-30
 	void importFile(LLFILE* fp);
 
 	// storing cache on disk; for viewer, in name.cache
+	// exportFile() writes a packed binary format.  importFile() reads
+	// either that or the older LLSD format; packed records are only
+	// indexed on import and decoded the first time they are looked up.
+	// Open the streams in binary mode.
 	bool importFile(std::istream& istr);
 	void exportFile(std::ostream& ostr);
 
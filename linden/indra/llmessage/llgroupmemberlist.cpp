@@ -0,0 +1,238 @@
+/** 
+ * @file llgroupmemberlist.cpp
+ * @brief Members of a group, as the viewer learns them
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llgroupmemberlist.h"
+
+#include <algorithm>
+
+#include "llstring.h"
+
+//
+// LLGroupMemberData
+//
+
+LLGroupMemberData::LLGroupMemberData(const LLUUID& id, 
+										S32 contribution,
+										U64 agent_powers,
+										const std::string& title,
+										const std::string& online_status,
+										BOOL is_owner) : 
+	mID(id), 
+	mContribution(contribution), 
+	mAgentPowers(agent_powers), 
+	mTitle(title), 
+	mOnlineStatus(online_status),
+	mIsOwner(is_owner)
+{
+}
+
+LLGroupMemberData::~LLGroupMemberData()
+{
+}
+
+void LLGroupMemberData::addRole(const LLUUID& role, LLGroupRoleData* rd)
+{
+	mRolesList[role] = rd;
+}
+
+bool LLGroupMemberData::removeRole(const LLUUID& role)
+{
+	role_list_t::iterator it = mRolesList.find(role);
+
+	if (it != mRolesList.end())
+	{
+		mRolesList.erase(it);
+		return true;
+	}
+
+	return false;
+}
+
+//
+// LLGroupMemberList
+//
+
+// Rough size of a std::map node holding a role, for memory accounting.
+const size_t ROLE_NODE_BYTES = 48;
+
+U32 LLGroupMemberList::sLastGeneration = 0;
+
+LLGroupMemberList::LLGroupMemberList()
+:	mGeneration(++sLastGeneration)
+{
+}
+
+LLGroupMemberList::iterator LLGroupMemberList::find(const LLUUID& id)
+{
+	sortIndex();
+
+	// Entries for the same id sort by arrival, and the last one wins.
+	std::vector<index_entry_t>::iterator it =
+		std::upper_bound(mIndex.begin(), mIndex.end(),
+						 index_entry_t(id, (U32)mMembers.size()));
+	if (it == mIndex.begin() || (it - 1)->first != id)
+	{
+		return mMembers.end();
+	}
+	return mMembers.begin() + (it - 1)->second;
+}
+
+LLGroupMemberData* LLGroupMemberList::add(const LLUUID& id,
+										  S32 contribution,
+										  U64 agent_powers,
+										  const std::string& title,
+										  const std::string& online_status,
+										  BOOL is_owner)
+{
+	LLGroupMemberData data(id, contribution, agent_powers, title, online_status, is_owner);
+	LLGroupMemberData* datap;
+	if (!mFreeData.empty())
+	{
+		datap = mFreeData.back();
+		mFreeData.pop_back();
+		*datap = data;
+	}
+	else
+	{
+		mPool.push_back(data);
+		datap = &mPool.back();
+	}
+	mMembers.push_back(value_type(id, datap));
+	return datap;
+}
+
+void LLGroupMemberList::erase(const LLUUID& id)
+{
+	iterator it = find(id);
+	if (it == mMembers.end())
+	{
+		return;
+	}
+	freeData(it->second);
+	mMembers.erase(it);
+
+	// Indices past the hole have shifted, so rebuild the index on demand.
+	mIndex.clear();
+	mGeneration = ++sLastGeneration;
+}
+
+void LLGroupMemberList::clear()
+{
+	std::vector<value_type>().swap(mMembers);
+	std::vector<index_entry_t>().swap(mIndex);
+	std::deque<LLGroupMemberData>().swap(mPool);
+	std::vector<LLGroupMemberData*>().swap(mFreeData);
+	mGeneration = ++sLastGeneration;
+}
+
+void LLGroupMemberList::sortIndex()
+{
+	size_t indexed = mIndex.size();
+	if (indexed == mMembers.size())
+	{
+		return;
+	}
+
+	mIndex.reserve(mMembers.size());
+	for (U32 i = (U32)indexed; i < (U32)mMembers.size(); ++i)
+	{
+		mIndex.push_back(index_entry_t(mMembers[i].first, i));
+	}
+	std::sort(mIndex.begin() + indexed, mIndex.end());
+	std::inplace_merge(mIndex.begin(), mIndex.begin() + indexed, mIndex.end());
+}
+
+void LLGroupMemberList::updateIndex()
+{
+	sortIndex();
+
+	// Drop all but the last entry received for each id.
+	std::vector<bool> replaced;
+	for (size_t i = 1; i < mIndex.size(); ++i)
+	{
+		if (mIndex[i].first == mIndex[i - 1].first)
+		{
+			if (replaced.empty())
+			{
+				replaced.resize(mMembers.size(), false);
+			}
+			replaced[mIndex[i - 1].second] = true;
+		}
+	}
+	if (replaced.empty())
+	{
+		return;
+	}
+
+	std::vector<value_type> members;
+	members.reserve(mMembers.size());
+	for (size_t i = 0; i < mMembers.size(); ++i)
+	{
+		if (replaced[i])
+		{
+			freeData(mMembers[i].second);
+		}
+		else
+		{
+			members.push_back(mMembers[i]);
+		}
+	}
+	mMembers.swap(members);
+	mIndex.clear();
+	sortIndex();
+	mGeneration = ++sLastGeneration;
+}
+
+void LLGroupMemberList::freeData(LLGroupMemberData* data)
+{
+	// Keep the slot for reuse but let go of what it points to.
+	*data = LLGroupMemberData(LLUUID::null, 0, 0, LLStringUtil::null, LLStringUtil::null, FALSE);
+	mFreeData.push_back(data);
+}
+
+size_t LLGroupMemberList::getMemoryUsage() const
+{
+	size_t bytes = mMembers.capacity() * sizeof(value_type)
+		+ mIndex.capacity() * sizeof(index_entry_t)
+		+ mPool.size() * sizeof(LLGroupMemberData)
+		+ mFreeData.capacity() * sizeof(LLGroupMemberData*);
+	for (const_iterator it = mMembers.begin(); it != mMembers.end(); ++it)
+	{
+		const LLGroupMemberData* data = it->second;
+		bytes += data->mTitle.capacity()
+			+ data->mOnlineStatus.capacity()
+			+ data->mRolesList.size() * ROLE_NODE_BYTES;
+	}
+	return bytes;
+}
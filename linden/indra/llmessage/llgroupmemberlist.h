@@ -0,0 +1,149 @@
+/** 
+ * @file llgroupmemberlist.h
+ * @brief Members of a group, as the viewer learns them
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLGROUPMEMBERLIST_H
+#define LL_LLGROUPMEMBERLIST_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "lluuid.h"
+
+class LLGroupRoleData;
+
+class LLGroupMemberData
+{
+friend class LLGroupMgrGroupData;
+friend class LLGroupMemberList;
+
+public:
+	typedef std::map<LLUUID,LLGroupRoleData*> role_list_t;
+	
+	LLGroupMemberData(const LLUUID& id, 
+						S32 contribution,
+						U64 agent_powers,
+						const std::string& title,
+						const std::string& online_status,
+						BOOL is_owner);
+
+	~LLGroupMemberData();
+
+	const LLUUID& getID() const { return mID; }
+	S32 getContribution() const { return mContribution; }
+	U64	getAgentPowers() const { return mAgentPowers; }
+	BOOL isOwner() const { return mIsOwner; }
+	const std::string& getTitle() const { return mTitle; }
+	const std::string& getOnlineStatus() const { return mOnlineStatus; }
+	void addRole(const LLUUID& role, LLGroupRoleData* rd);
+	bool removeRole(const LLUUID& role);
+	void clearRoles() { mRolesList.clear(); };
+	role_list_t::iterator roleBegin() { return mRolesList.begin(); }
+	role_list_t::iterator roleEnd() { return mRolesList.end(); }
+
+	BOOL isInRole(const LLUUID& role_id) { return (mRolesList.find(role_id) != mRolesList.end()); }
+
+protected:
+	LLUUID	mID;
+	S32		mContribution;
+	U64		mAgentPowers;
+	std::string	mTitle;
+	std::string	mOnlineStatus;
+	BOOL	mIsOwner;
+	role_list_t mRolesList;
+};
+
+// Member data for one group.  Members are kept in arrival order in one
+// vector of (id, data) pairs, so indices stay valid while reply packets
+// are appended and the UI can page through the list as it fills.  The
+// data comes from a pool that allocates in blocks, and lookups go
+// through an id sorted index that updateIndex() extends once per packet.
+class LLGroupMemberList
+{
+public:
+	typedef std::pair<LLUUID, LLGroupMemberData*> value_type;
+	typedef std::vector<value_type>::iterator iterator;
+	typedef std::vector<value_type>::const_iterator const_iterator;
+
+	LLGroupMemberList();
+
+	iterator begin() { return mMembers.begin(); }
+	iterator end() { return mMembers.end(); }
+	const_iterator begin() const { return mMembers.begin(); }
+	const_iterator end() const { return mMembers.end(); }
+	size_t size() const { return mMembers.size(); }
+	bool empty() const { return mMembers.empty(); }
+
+	// index is in arrival order, 0 <= index < size()
+	const value_type& at(size_t index) const { return mMembers[index]; }
+
+	iterator find(const LLUUID& id);
+
+	// Appends a member.  A later entry for the same id replaces the
+	// earlier one when the index is next updated.
+	LLGroupMemberData* add(const LLUUID& id,
+						   S32 contribution,
+						   U64 agent_powers,
+						   const std::string& title,
+						   const std::string& online_status,
+						   BOOL is_owner);
+	void erase(const LLUUID& id);
+
+	// Frees all member data.
+	void clear();
+
+	// Sorts members appended since the last call into the index.
+	void updateIndex();
+
+	// Changes whenever members are removed or reordered, so that paged
+	// readers know to start over.  Unique across all lists.
+	U32 getGeneration() const { return mGeneration; }
+
+	// Approximate heap bytes held for the members.
+	size_t getMemoryUsage() const;
+
+private:
+	void sortIndex();
+	void freeData(LLGroupMemberData* data);
+
+	typedef std::pair<LLUUID, U32> index_entry_t;
+	std::vector<value_type> mMembers;
+	std::vector<index_entry_t> mIndex;	// covers mMembers[0, mIndex.size())
+	std::deque<LLGroupMemberData> mPool;
+	std::vector<LLGroupMemberData*> mFreeData;
+	U32 mGeneration;
+
+	static U32 sLastGeneration;
+};
+
+#endif // LL_LLGROUPMEMBERLIST_H
@@ -666,14 +666,15 @@ bool LLHTTPAssetStorage::deletePendingRequest(LLAssetStorage::ERequestType rt,
 				{
 					// This request was found in the pending list.  Move it to the end!
 					LLAssetRequest* pending_req = *result;
-					pending->remove(pending_req);
 
 					if (!pending_req->mIsUserWaiting)				//A user is waiting on this request.  Toss it.
 					{
-						pending->push_back(pending_req);
+						// splice keeps the iterator, and so the pending index, valid
+						pending->splice(pending->end(), *pending, result);
 					}
 					else
 					{
+						erasePendingRequest(pending, result);
 						if (pending_req->mUpCallback)	//Clean up here rather than _callUploadCallbacks because this request is already cleared the req.
 						{
 							pending_req->mUpCallback(pending_req->getUUID(), pending_req->mUserData, -1, LL_EXSTAT_REQUEST_DROPPED);
@@ -721,14 +722,7 @@ void LLHTTPAssetStorage::_queueDataRequest(const LLUUID& uuid, LLAssetType::ETyp
 	// that we always want them first, even if they're out of order.
 	//
 	
-	if (req->getType() == LLAssetType::AT_TEXTURE)
-	{
-		mPendingDownloads.push_back(req);
-	}
-	else
-	{
-		mPendingDownloads.push_front(req);
-	}
+	addPendingRequest(RT_DOWNLOAD, req, req->getType() != LLAssetType::AT_TEXTURE);
 }
 
 LLAssetRequest* LLHTTPAssetStorage::findNextRequest(LLAssetStorage::request_list_t& pending, 
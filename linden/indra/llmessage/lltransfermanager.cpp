@@ -35,6 +35,8 @@
 
 #include "lltransfermanager.h"
 
+#include <set>
+
 #include "llerror.h"
 #include "message.h"
 #include "lldatapacker.h"
@@ -94,6 +96,7 @@ void LLTransferManager::init()
 
 void LLTransferManager::cleanup()
 {
+	dumpStats();
 	mValid = FALSE;
 
 	host_tc_map::iterator iter;
@@ -173,6 +176,35 @@ LLTransferTargetChannel *LLTransferManager::getTargetChannel(const LLHost &host,
 	return tcp->getTargetChannel(type);
 }
 
+void LLTransferManager::addSourceStats(const LLTransferChannelType tctype, LLTransferSource *tsp, const LLTSCode status)
+{
+	if ((tctype >= 0) && (tctype < LLTCT_NUM_TYPES))
+	{
+		mSourceStats[tctype].addTransfer(tsp, status);
+	}
+}
+
+
+void LLTransferManager::dumpStats() const
+{
+	S32 i;
+	for (i = 0; i < LLTCT_NUM_TYPES; i++)
+	{
+		const LLTransferStats &stats = mSourceStats[i];
+		if (!stats.mCompleted && !stats.mFailed)
+		{
+			continue;
+		}
+		llinfos << "Transfer channel " << i
+			<< " completed " << stats.mCompleted
+			<< " failed " << stats.mFailed
+			<< " bytes " << stats.mBytesSent
+			<< " mean latency " << stats.getMeanLatency()
+			<< " max latency " << stats.mMaxLatency
+			<< " mean bps " << stats.getMeanThroughput() << llendl;
+	}
+}
+
 // virtual
 LLTransferSourceParams::~LLTransferSourceParams()
 { }
@@ -626,6 +658,56 @@ void LLTransferManager::reliablePacketCallback(void **user_data, S32 result)
 	delete transfer_idp;
 }
 
+//
+// LLTransferStats implementation
+//
+
+LLTransferStats::LLTransferStats() :
+	mCompleted(0),
+	mFailed(0),
+	mBytesSent(0),
+	mTotalLatency(0.0),
+	mTotalActiveTime(0.0),
+	mMaxLatency(0.f)
+{
+}
+
+
+void LLTransferStats::addTransfer(LLTransferSource *tsp, const LLTSCode status)
+{
+	if (status == LLTS_DONE)
+	{
+		mCompleted++;
+	}
+	else
+	{
+		mFailed++;
+	}
+	mBytesSent += tsp->mBytesSent;
+
+	if (tsp->mFirstPacketTime)
+	{
+		F32 latency = tsp->getLatency();
+		mTotalLatency += latency;
+		mMaxLatency = llmax(mMaxLatency, latency);
+		mTotalActiveTime += (tsp->mLastPacketTime - tsp->mFirstPacketTime) * SEC_PER_USEC;
+	}
+}
+
+
+F32 LLTransferStats::getMeanLatency() const
+{
+	U32 count = mCompleted + mFailed;
+	return count ? (F32)(mTotalLatency / count) : 0.f;
+}
+
+
+F32 LLTransferStats::getMeanThroughput() const
+{
+	return (mTotalActiveTime > 0.0) ? (F32)(mBytesSent * 8 / mTotalActiveTime) : 0.f;
+}
+
+
 //
 // LLTransferConnection implementation
 //
@@ -714,6 +796,12 @@ LLTransferTargetChannel *LLTransferConnection::getTargetChannel(const LLTransfer
 
 const S32 DEFAULT_PACKET_SIZE = 1000;
 
+// Deficit round robin: each round a transfer is credited with a quantum of
+// bytes and may send while its credit is positive.  The highest priority
+// level gets a full packet per round and each lower level half as much as
+// the one above it, down to a floor so nothing starves.
+const F32 MIN_TRANSFER_WEIGHT = 1.f / 16.f;
+
 
 LLTransferSourceChannel::LLTransferSourceChannel(const LLTransferChannelType channel_type, const LLHost &host) :
 	mChannelType(channel_type),
@@ -737,6 +825,7 @@ LLTransferSourceChannel::~LLTransferSourceChannel()
 		delete iter->second;
 	}
 	mTransferSources.mMap.clear();
+	mTransferSourceIDs.clear();
 }
 
 void LLTransferSourceChannel::updatePriority(LLTransferSource *tsp, const F32 priority)
@@ -768,147 +857,200 @@ void LLTransferSourceChannel::updateTransfers()
 		return;
 	}
 
-	const S32 throttle_id = mThrottleID;
+	sendTransfers(cdp->getThrottleGroup());
+}
 
-	LLThrottleGroup &tg = cdp->getThrottleGroup();
+void LLTransferSourceChannel::sendTransfers(LLThrottleGroup &tg)
+{
+	const S32 throttle_id = mThrottleID;
 
 	if (tg.checkOverflow(throttle_id, 0.f))
 	{
 		return;
 	}
 
-	LLPriQueueMap<LLTransferSource *>::pqm_iter iter, next;
+	// Transfers with nothing to send right now sit out the rest of this update.
+	std::set<LLUUID> stalled;
+	std::vector<std::pair<LLUUID, F32> > round;
 
 	BOOL done = FALSE;
-	for (iter = mTransferSources.mMap.begin(); (iter != mTransferSources.mMap.end()) && !done;)
+	while (!done)
 	{
-		//llinfos << "LLTransferSourceChannel::updateTransfers()" << llendl;
-		// Do stuff. 
-		next = iter;
-		next++;
-
-		LLTransferSource *tsp = iter->second;
-		U8 *datap = NULL;
-		S32 data_size = 0;
-		BOOL delete_data = FALSE;
-		S32 packet_id = 0;
-		S32 sent_bytes = 0;
-		LLTSCode status = LLTS_OK;
-
-		// Get the packetID for the next packet that we're transferring.
-		packet_id = tsp->getNextPacketID();
-		status = tsp->dataCallback(packet_id, DEFAULT_PACKET_SIZE, &datap, data_size, delete_data);
-
-		if (status == LLTS_SKIP)
+		// Snapshot the round in priority order, since sending can delete
+		// transfers out from under us.
+		round.clear();
+		F32 weight = 1.f;
+		F32 last_priority = 0.f;
+		LLPriQueueMap<LLTransferSource *>::pqm_iter iter;
+		for (iter = mTransferSources.mMap.begin(); iter != mTransferSources.mMap.end(); ++iter)
 		{
-			// We don't have any data, but we're not done, just go on.
-			// This will presumably be used for streaming or async transfers that
-			// are stalled waiting for data from another source.
-			iter=next;
-			continue;
+			LLTransferSource *tsp = iter->second;
+			if (stalled.count(tsp->getID()))
+			{
+				continue;
+			}
+			if (!round.empty() && (tsp->getPriority() < last_priority))
+			{
+				weight = llmax(weight * 0.5f, MIN_TRANSFER_WEIGHT);
+			}
+			last_priority = tsp->getPriority();
+			round.push_back(std::make_pair(tsp->getID(), weight));
 		}
 
-		LLUUID *cb_uuid = new LLUUID(tsp->getID());
-		LLUUID transaction_id = tsp->getID();
-
-		// Send the data now, even if it's an error.
-		// The status code will tell the other end what to do.
-		gMessageSystem->newMessage("TransferPacket");
-		gMessageSystem->nextBlock("TransferData");
-		gMessageSystem->addUUID("TransferID", tsp->getID());
-		gMessageSystem->addS32("ChannelType", getChannelType());
-		gMessageSystem->addS32("Packet", packet_id);	// HACK!  Need to put in a REAL packet id
-		gMessageSystem->addS32("Status", status);
-		gMessageSystem->addBinaryData("Data", datap, data_size);
-		sent_bytes = gMessageSystem->getCurrentSendTotal();
-		gMessageSystem->sendReliable(getHost(), LL_DEFAULT_RELIABLE_RETRIES, TRUE, 0.f,
-									 LLTransferManager::reliablePacketCallback, (void**)cb_uuid);
-
-		// Do bookkeeping for the throttle
-		done = tg.throttleOverflow(throttle_id, sent_bytes*8.f);
-		gTransferManager.addTransferBitsOut(mChannelType, sent_bytes*8);
-
-		// Clean up our temporary data.
-		if (delete_data)
+		if (round.empty())
 		{
-			delete[] datap;
-			datap = NULL;
+			break;
 		}
 
-		if (findTransferSource(transaction_id) == NULL)
+		for (U32 i = 0; (i < round.size()) && !done; i++)
 		{
-			//Warning!  In the case of an aborted transfer, the sendReliable call above calls 
-			//AbortTransfer which in turn calls deleteTransfer which means that somewhere way 
-			//down the chain our current iter can get invalidated resulting in an infrequent
-			//sim crash.  This check gets us to a valid transfer source in this event.
-			iter=next;
-			continue;
-		}
+			const LLUUID &transfer_id = round[i].first;
+			LLTransferSource *tsp = findTransferSource(transfer_id);
+			if (!tsp)
+			{
+				continue;
+			}
 
-		// Update the packet counter
-		tsp->setLastPacketID(packet_id);
+			tsp->mDeficit += llmax(1, llround(DEFAULT_PACKET_SIZE * round[i].second));
 
-		switch (status)
-		{
-		case LLTS_OK:
-			// We're OK, don't need to do anything.  Keep sending data.
-			break;
-		case LLTS_ERROR:
-			llwarns << "Error in transfer dataCallback!" << llendl;
-		case LLTS_DONE:
-			// We need to clean up this transfer source.
-			//llinfos << "LLTransferSourceChannel::updateTransfers() " << tsp->getID() << " done" << llendl;
-			tsp->completionCallback(status);
-			delete tsp;
-			
-			mTransferSources.mMap.erase(iter);
-			iter = next;
-			break;
-		default:
-			llerrs << "Unknown transfer error code!" << llendl;
-		}
+			while (!done && (tsp->mDeficit > 0))
+			{
+				U8 *datap = NULL;
+				S32 data_size = 0;
+				BOOL delete_data = FALSE;
+
+				// Get the packetID for the next packet that we're transferring.
+				S32 packet_id = tsp->getNextPacketID();
+				LLTSCode status = tsp->dataCallback(packet_id, DEFAULT_PACKET_SIZE, &datap, data_size, delete_data);
+
+				if (status == LLTS_SKIP)
+				{
+					// We don't have any data, but we're not done, just go on.
+					// This will presumably be used for streaming or async transfers that
+					// are stalled waiting for data from another source.
+					// Idle transfers don't bank credit.
+					tsp->mDeficit = 0;
+					stalled.insert(transfer_id);
+					break;
+				}
+
+				// Send the data now, even if it's an error.
+				// The status code will tell the other end what to do.
+				S32 sent_bytes = sendTransferPacket(tsp, packet_id, status, datap, data_size);
+
+				// Do bookkeeping for the throttle
+				done = tg.throttleOverflow(throttle_id, sent_bytes*8.f);
+				gTransferManager.addTransferBitsOut(mChannelType, sent_bytes*8);
+
+				// Clean up our temporary data.
+				if (delete_data)
+				{
+					delete[] datap;
+					datap = NULL;
+				}
+
+				if (findTransferSource(transfer_id) == NULL)
+				{
+					// In the case of an aborted transfer, the send above can end up
+					// calling deleteTransfer, so tsp is no longer valid.
+					break;
+				}
+
+				// Update the packet counter
+				tsp->setLastPacketID(packet_id);
+				tsp->mDeficit -= (data_size > 0) ? data_size : sent_bytes;
+				tsp->mBytesSent += data_size;
+				tsp->mLastPacketTime = totalTime();
+				if (!tsp->mFirstPacketTime)
+				{
+					tsp->mFirstPacketTime = tsp->mLastPacketTime;
+				}
+
+				if (status == LLTS_OK)
+				{
+					// We're OK, don't need to do anything.  Keep sending data.
+					continue;
+				}
 
-		// At this point, we should do priority adjustment (since some transfers like
-		// streaming transfers will adjust priority based on how much they've sent and time,
-		// but I'm not going to bother yet. - djs.
+				switch (status)
+				{
+				case LLTS_ERROR:
+					llwarns << "Error in transfer dataCallback!" << llendl;
+				case LLTS_DONE:
+					// We need to clean up this transfer source.
+					//llinfos << "LLTransferSourceChannel::updateTransfers() " << tsp->getID() << " done" << llendl;
+					tsp->completionCallback(status);
+					gTransferManager.addSourceStats(mChannelType, tsp, status);
+					removeTransferSource(tsp);
+					delete tsp;
+					break;
+				default:
+					llerrs << "Unknown transfer error code!" << llendl;
+				}
+				break;
+			}
+		}
 	}
 }
 
 
+S32 LLTransferSourceChannel::sendTransferPacket(LLTransferSource *tsp,
+												const S32 packet_id,
+												const LLTSCode status,
+												U8 *datap,
+												const S32 data_size)
+{
+	LLUUID *cb_uuid = new LLUUID(tsp->getID());
+
+	gMessageSystem->newMessage("TransferPacket");
+	gMessageSystem->nextBlock("TransferData");
+	gMessageSystem->addUUID("TransferID", tsp->getID());
+	gMessageSystem->addS32("ChannelType", getChannelType());
+	gMessageSystem->addS32("Packet", packet_id);	// HACK!  Need to put in a REAL packet id
+	gMessageSystem->addS32("Status", status);
+	gMessageSystem->addBinaryData("Data", datap, data_size);
+	S32 sent_bytes = gMessageSystem->getCurrentSendTotal();
+	gMessageSystem->sendReliable(getHost(), LL_DEFAULT_RELIABLE_RETRIES, TRUE, 0.f,
+								 LLTransferManager::reliablePacketCallback, (void**)cb_uuid);
+	return sent_bytes;
+}
+
+
 void LLTransferSourceChannel::addTransferSource(LLTransferSource *sourcep)
 {
 	sourcep->mChannelp = this;
 	mTransferSources.push(sourcep->getPriority(), sourcep);
+	mTransferSourceIDs[sourcep->getID()] = sourcep;
 }
 
 
 LLTransferSource *LLTransferSourceChannel::findTransferSource(const LLUUID &transfer_id)
 {
-	LLPriQueueMap<LLTransferSource *>::pqm_iter iter;
-	for (iter = mTransferSources.mMap.begin(); iter != mTransferSources.mMap.end(); iter++)
+	ts_id_map::iterator iter = mTransferSourceIDs.find(transfer_id);
+	if (iter != mTransferSourceIDs.end())
 	{
-		LLTransferSource *tsp = iter->second;
-		if (tsp->getID() == transfer_id)
-		{
-			return tsp;
-		}
+		return iter->second;
 	}
 	return NULL;
 }
 
 
-BOOL LLTransferSourceChannel::deleteTransfer(LLTransferSource *tsp)
+void LLTransferSourceChannel::removeTransferSource(LLTransferSource *tsp)
 {
+	mTransferSourceIDs.erase(tsp->getID());
+	mTransferSources.mMap.erase(LLPQMKey<LLTransferSource *>(tsp->getPriority(), tsp));
+}
 
-	LLPriQueueMap<LLTransferSource *>::pqm_iter iter;
-	for (iter = mTransferSources.mMap.begin(); iter != mTransferSources.mMap.end(); iter++)
+
+BOOL LLTransferSourceChannel::deleteTransfer(LLTransferSource *tsp)
+{
+	ts_id_map::iterator iter = mTransferSourceIDs.find(tsp->getID());
+	if ((iter != mTransferSourceIDs.end()) && (iter->second == tsp))
 	{
-		if (iter->second == tsp)
-		{
-			delete tsp;
-			mTransferSources.mMap.erase(iter);
-			return TRUE;
-		}
+		gTransferManager.addSourceStats(mChannelType, tsp, LLTS_ABORT);
+		removeTransferSource(tsp);
+		delete tsp;
+		return TRUE;
 	}
 
 	llerrs << "Unable to find transfer source to delete!" << llendl;
@@ -932,8 +1074,8 @@ LLTransferTargetChannel::~LLTransferTargetChannel()
 	for (iter = mTransferTargets.begin(); iter != mTransferTargets.end(); iter++)
 	{
 		// Abort all of the current transfers
-		(*iter)->abortTransfer();
-		delete *iter;
+		iter->second->abortTransfer();
+		delete iter->second;
 	}
 	mTransferTargets.clear();
 }
@@ -994,20 +1136,16 @@ void LLTransferTargetChannel::sendTransferRequest(LLTransferTarget *targetp,
 void LLTransferTargetChannel::addTransferTarget(LLTransferTarget *targetp)
 {
 	targetp->mChannelp = this;
-	mTransferTargets.push_back(targetp);
+	mTransferTargets[targetp->getID()] = targetp;
 }
 
 
 LLTransferTarget *LLTransferTargetChannel::findTransferTarget(const LLUUID &transfer_id)
 {
-	tt_iter iter;
-	for (iter = mTransferTargets.begin(); iter != mTransferTargets.end(); iter++)
+	tt_iter iter = mTransferTargets.find(transfer_id);
+	if (iter != mTransferTargets.end())
 	{
-		LLTransferTarget *ttp = *iter;
-		if (ttp->getID() == transfer_id)
-		{
-			return ttp;
-		}
+		return iter->second;
 	}
 	return NULL;
 }
@@ -1015,15 +1153,12 @@ LLTransferTarget *LLTransferTargetChannel::findTransferTarget(const LLUUID &tran
 
 BOOL LLTransferTargetChannel::deleteTransfer(LLTransferTarget *ttp)
 {
-	tt_iter iter;
-	for (iter = mTransferTargets.begin(); iter != mTransferTargets.end(); iter++)
+	tt_iter iter = mTransferTargets.find(ttp->getID());
+	if ((iter != mTransferTargets.end()) && (iter->second == ttp))
 	{
-		if (*iter == ttp)
-		{
-			delete ttp;
-			mTransferTargets.erase(iter);
-			return TRUE;
-		}
+		delete ttp;
+		mTransferTargets.erase(iter);
+		return TRUE;
 	}
 
 	llerrs << "Unable to find transfer target to delete!" << llendl;
@@ -1043,7 +1178,12 @@ LLTransferSource::LLTransferSource(const LLTransferSourceType type,
 	mChannelp(NULL),
 	mPriority(priority),
 	mSize(0),
-	mLastPacketID(-1)
+	mLastPacketID(-1),
+	mDeficit(0),
+	mBytesSent(0),
+	mRequestTime(totalTime()),
+	mFirstPacketTime(0),
+	mLastPacketTime(0)
 {
 	setPriority(priority);
 }
@@ -1082,6 +1222,26 @@ void LLTransferSource::sendTransferStatus(LLTSCode status)
 }
 
 
+F32 LLTransferSource::getLatency() const
+{
+	if (!mFirstPacketTime)
+	{
+		return 0.f;
+	}
+	return (F32)((mFirstPacketTime - mRequestTime) * SEC_PER_USEC);
+}
+
+
+F32 LLTransferSource::getThroughput() const
+{
+	if (!mFirstPacketTime || (mLastPacketTime <= mFirstPacketTime))
+	{
+		return 0.f;
+	}
+	return (F32)(mBytesSent * 8 / ((mLastPacketTime - mFirstPacketTime) * SEC_PER_USEC));
+}
+
+
 // This should never be called directly, the transfer manager is responsible for
 // aborting the transfer from the channel.  I might want to rethink this in the
 // future, though.
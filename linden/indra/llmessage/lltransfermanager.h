@@ -109,6 +109,28 @@ class LLTransferTargetParams;
 class LLTransferSource;
 class LLTransferTarget;
 
+//
+// Running totals for finished transfers out of one type of channel.
+//
+class LLTransferStats
+{
+public:
+	LLTransferStats();
+
+	void addTransfer(LLTransferSource *tsp, const LLTSCode status);
+
+	F32 getMeanLatency() const;		// Seconds from request to first packet
+	F32 getMeanThroughput() const;	// Bits per second while the transfer was active
+
+public:
+	U32		mCompleted;
+	U32		mFailed;
+	U64		mBytesSent;
+	F64		mTotalLatency;
+	F64		mTotalActiveTime;
+	F32		mMaxLatency;
+};
+
 class LLTransferManager
 {
 public:
@@ -142,6 +164,11 @@ public:
 	void resetTransferBitsOut(const LLTransferChannelType tctype)		{ mTransferBitsOut[tctype] = 0; }
 	void addTransferBitsIn(const LLTransferChannelType tctype, const S32 bits)	{ mTransferBitsIn[tctype] += bits; }
 	void addTransferBitsOut(const LLTransferChannelType tctype, const S32 bits)	{ mTransferBitsOut[tctype] += bits; }
+
+	void addSourceStats(const LLTransferChannelType tctype, LLTransferSource *tsp, const LLTSCode status);
+	const LLTransferStats &getSourceStats(const LLTransferChannelType tctype) const	{ return mSourceStats[tctype]; }
+	void resetSourceStats(const LLTransferChannelType tctype)			{ mSourceStats[tctype] = LLTransferStats(); }
+	void dumpStats() const;
 protected:
 	LLTransferConnection		*getTransferConnection(const LLHost &host);
 	BOOL						removeTransferConnection(const LLHost &host);
@@ -156,6 +183,8 @@ protected:
 	S32		mTransferBitsIn[LLTTT_NUM_TYPES];
 	S32		mTransferBitsOut[LLTTT_NUM_TYPES];
 
+	LLTransferStats	mSourceStats[LLTCT_NUM_TYPES];
+
 	// We keep a map between each host and LLTransferConnection.
 	host_tc_map mTransferConnections;
 };
@@ -201,6 +230,10 @@ public:
 
 	void updateTransfers();
 
+	// Sends as much as the throttle allows, sharing it between transfers
+	// with deficit round robin weighted by priority.
+	void sendTransfers(LLThrottleGroup &tg);
+
 	void updatePriority(LLTransferSource *tsp, const F32 priority);
 
 	void				addTransferSource(LLTransferSource *sourcep);
@@ -211,13 +244,25 @@ public:
 
 	LLTransferChannelType	getChannelType() const		{ return mChannelType; }
 	LLHost					getHost() const				{ return mHost; }
+	S32						getNumTransfers() const		{ return mTransferSources.getLength(); }
 
 protected:
-	typedef std::list<LLTransferSource *>::iterator ts_iter;
+	// Puts one packet on the wire, returns the number of bytes sent.
+	virtual S32				sendTransferPacket(LLTransferSource *tsp,
+											   const S32 packet_id,
+											   const LLTSCode status,
+											   U8 *datap,
+											   const S32 data_size);
+
+	void					removeTransferSource(LLTransferSource *tsp);
+
+protected:
+	typedef std::map<LLUUID, LLTransferSource *> ts_id_map;
 
 	LLTransferChannelType				mChannelType;
 	LLHost								mHost;
 	LLPriQueueMap<LLTransferSource*>	mTransferSources;
+	ts_id_map							mTransferSourceIDs;	// Same sources, by transfer id
 
 	// The throttle that this source channel should use
 	S32									mThrottleID;
@@ -254,11 +299,12 @@ protected:
 	friend class LLTransferTarget;
 	friend class LLTransferManager;
 protected:
-	typedef std::list<LLTransferTarget *>::iterator tt_iter;
+	typedef std::map<LLUUID, LLTransferTarget *> tt_id_map;
+	typedef tt_id_map::iterator tt_iter;
 
 	LLTransferChannelType			mChannelType;
 	LLHost							mHost;
-	std::list<LLTransferTarget *>	mTransferTargets;
+	tt_id_map						mTransferTargets;
 };
 
 
@@ -289,8 +335,13 @@ public:
 
 	LLUUID getID()				{ return mID; }
 
+	S32		getBytesSent() const			{ return mBytesSent; }
+	F32		getLatency() const;		// Seconds from request to first packet, 0 until one is sent
+	F32		getThroughput() const;	// Bits per second since the first packet
+
 	friend class LLTransferManager;
 	friend class LLTransferSourceChannel;
+	friend class LLTransferStats;
 
 protected:
 	LLTransferSource(const LLTransferSourceType source_type,
@@ -341,6 +392,13 @@ protected:
 	F32		mPriority;
 	S32		mSize;
 	S32		mLastPacketID;
+
+	// Scheduling and statistics, maintained by the channel
+	S32		mDeficit;			// Bytes this transfer may still send in the current round
+	S32		mBytesSent;
+	U64		mRequestTime;		// Microseconds
+	U64		mFirstPacketTime;
+	U64		mLastPacketTime;
 };
 
 
@@ -0,0 +1,1122 @@
+/** 
+ * @file llvivoxprotocolparser.cpp
+ * @brief Parser for the voice daemon protocol
+ *
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llvivoxprotocolparser.h"
+
+#include <algorithm>
+
+#include "llbuffer.h"
+#include "llstring.h"
+
+// Names in the daemon protocol that the parser acts on.  They are looked
+// up once per element, case insensitively, and then switched on.
+enum EVivoxTag
+{
+	VX_TAG_UNKNOWN = -1,
+	VX_TAG_ACCOUNT_HANDLE,
+	VX_TAG_ACCOUNT_NAME,
+	VX_TAG_ALIAS,
+	VX_TAG_APPLICATION,
+	VX_TAG_AUDIO_MEDIA,
+	VX_TAG_AUTO_ACCEPT_MASK,
+	VX_TAG_AUTO_ACCEPT_RULE,
+	VX_TAG_AUTO_ACCEPT_RULES,
+	VX_TAG_AUTO_ADD_AS_BUDDY,
+	VX_TAG_BLOCK_MASK,
+	VX_TAG_BLOCK_RULE,
+	VX_TAG_BLOCK_RULES,
+	VX_TAG_BUDDIES,
+	VX_TAG_BUDDY,
+	VX_TAG_BUDDY_URI,
+	VX_TAG_CAPTURE_DEVICE,
+	VX_TAG_CAPTURE_DEVICES,
+	VX_TAG_CHANNEL_NAME,
+	VX_TAG_CHANNEL_URI,
+	VX_TAG_CONNECTOR_HANDLE,
+	VX_TAG_DEVICE,
+	VX_TAG_DISPLAY_NAME,
+	VX_TAG_ENABLED,
+	VX_TAG_ENERGY,
+	VX_TAG_EVENT,
+	VX_TAG_HAS_AUDIO,
+	VX_TAG_HAS_TEXT,
+	VX_TAG_HAS_VIDEO,
+	VX_TAG_INCOMING,
+	VX_TAG_INPUT_XML,
+	VX_TAG_IS_CHANNEL,
+	VX_TAG_IS_LOCALLY_MUTED,
+	VX_TAG_IS_MODERATOR_MUTED,
+	VX_TAG_IS_SPEAKING,
+	VX_TAG_MESSAGE_BODY,
+	VX_TAG_MESSAGE_HEADER,
+	VX_TAG_MIC_ENERGY,
+	VX_TAG_NAME,
+	VX_TAG_NOTIFICATION_TYPE,
+	VX_TAG_NUMBER_OF_ALIASES,
+	VX_TAG_PARTICIPANT_TYPE,
+	VX_TAG_PARTICIPANT_URI,
+	VX_TAG_PRESENCE,
+	VX_TAG_PRESENCE_ONLY,
+	VX_TAG_RENDER_DEVICE,
+	VX_TAG_RENDER_DEVICES,
+	VX_TAG_RESPONSE,
+	VX_TAG_RETURN_CODE,
+	VX_TAG_SESSION_GROUP_HANDLE,
+	VX_TAG_SESSION_HANDLE,
+	VX_TAG_STATE,
+	VX_TAG_STATUS_CODE,
+	VX_TAG_STATUS_STRING,
+	VX_TAG_SUBSCRIPTION_HANDLE,
+	VX_TAG_SUBSCRIPTION_TYPE,
+	VX_TAG_TERMINATED,
+	VX_TAG_URI,
+	VX_TAG_VERSION_ID,
+	VX_TAG_VOLUME
+};
+
+enum EVivoxEvent
+{
+	VX_EVENT_UNKNOWN = -1,
+	VX_EVENT_ACCOUNT_LOGIN_STATE_CHANGE,
+	VX_EVENT_AUX_AUDIO_PROPERTIES,
+	VX_EVENT_BUDDY_AND_GROUP_LIST_CHANGED,
+	VX_EVENT_BUDDY_CHANGED,
+	VX_EVENT_BUDDY_PRESENCE,
+	VX_EVENT_MEDIA_STREAM_UPDATED,
+	VX_EVENT_MESSAGE,
+	VX_EVENT_PARTICIPANT_ADDED,
+	VX_EVENT_PARTICIPANT_REMOVED,
+	VX_EVENT_PARTICIPANT_UPDATED,
+	VX_EVENT_SESSION_ADDED,
+	VX_EVENT_SESSION_GROUP_ADDED,
+	VX_EVENT_SESSION_GROUP_REMOVED,
+	VX_EVENT_SESSION_NOTIFICATION,
+	VX_EVENT_SESSION_REMOVED,
+	VX_EVENT_SESSION_UPDATED,
+	VX_EVENT_SUBSCRIPTION,
+	VX_EVENT_TEXT_STREAM_UPDATED
+};
+
+enum EVivoxAction
+{
+	VX_ACTION_UNKNOWN = -1,
+	VX_ACTION_ACCOUNT_LIST_AUTO_ACCEPT_RULES,
+	VX_ACTION_ACCOUNT_LIST_BLOCK_RULES,
+	VX_ACTION_ACCOUNT_LOGIN,
+	VX_ACTION_ACCOUNT_LOGOUT,
+	VX_ACTION_CONNECTOR_CREATE,
+	VX_ACTION_CONNECTOR_INITIATE_SHUTDOWN,
+	VX_ACTION_SESSION_CONNECT,
+	VX_ACTION_SESSION_CREATE,
+	VX_ACTION_SESSION_GROUP_ADD_SESSION,
+	VX_ACTION_SESSION_SET_3D_POSITION
+};
+
+struct LLVivoxName
+{
+	const char*	mName;
+	S32			mID;
+};
+
+static bool vivox_name_less(const LLVivoxName& a, const LLVivoxName& b)
+{
+	return stricmp(a.mName, b.mName) < 0;
+}
+
+// Sorted copy of a name list, searched without allocating
+class LLVivoxNameTable
+{
+public:
+	LLVivoxNameTable(const LLVivoxName* names, S32 count)
+	:	mNames(names, names + count)
+	{
+		std::sort(mNames.begin(), mNames.end(), vivox_name_less);
+	}
+
+	// Returns the id for name, or -1 if it is not in the table.
+	S32 find(const char* name) const
+	{
+		S32 low = 0;
+		S32 high = (S32)mNames.size() - 1;
+		while (low <= high)
+		{
+			S32 mid = (low + high) / 2;
+			int cmp = stricmp(name, mNames[mid].mName);
+			if (cmp == 0)
+			{
+				return mNames[mid].mID;
+			}
+			if (cmp < 0)
+			{
+				high = mid - 1;
+			}
+			else
+			{
+				low = mid + 1;
+			}
+		}
+		return -1;
+	}
+
+private:
+	std::vector<LLVivoxName> mNames;
+};
+
+static const LLVivoxName sVivoxTagNames[] =
+{
+	{ "AccountHandle",		VX_TAG_ACCOUNT_HANDLE },
+	{ "AccountName",		VX_TAG_ACCOUNT_NAME },
+	{ "Alias",				VX_TAG_ALIAS },
+	{ "Application",		VX_TAG_APPLICATION },
+	{ "AudioMedia",			VX_TAG_AUDIO_MEDIA },
+	{ "AutoAcceptMask",		VX_TAG_AUTO_ACCEPT_MASK },
+	{ "AutoAcceptRule",		VX_TAG_AUTO_ACCEPT_RULE },
+	{ "AutoAcceptRules",	VX_TAG_AUTO_ACCEPT_RULES },
+	{ "AutoAddAsBuddy",		VX_TAG_AUTO_ADD_AS_BUDDY },
+	{ "BlockMask",			VX_TAG_BLOCK_MASK },
+	{ "BlockRule",			VX_TAG_BLOCK_RULE },
+	{ "BlockRules",			VX_TAG_BLOCK_RULES },
+	{ "Buddies",			VX_TAG_BUDDIES },
+	{ "Buddy",				VX_TAG_BUDDY },
+	{ "BuddyURI",			VX_TAG_BUDDY_URI },
+	{ "CaptureDevice",		VX_TAG_CAPTURE_DEVICE },
+	{ "CaptureDevices",		VX_TAG_CAPTURE_DEVICES },
+	{ "ChannelName",		VX_TAG_CHANNEL_NAME },
+	{ "ChannelURI",			VX_TAG_CHANNEL_URI },
+	{ "ConnectorHandle",	VX_TAG_CONNECTOR_HANDLE },
+	{ "Device",				VX_TAG_DEVICE },
+	{ "DisplayName",		VX_TAG_DISPLAY_NAME },
+	{ "Enabled",			VX_TAG_ENABLED },
+	{ "Energy",				VX_TAG_ENERGY },
+	{ "Event",				VX_TAG_EVENT },
+	{ "HasAudio",			VX_TAG_HAS_AUDIO },
+	{ "HasText",			VX_TAG_HAS_TEXT },
+	{ "HasVideo",			VX_TAG_HAS_VIDEO },
+	{ "Incoming",			VX_TAG_INCOMING },
+	{ "InputXml",			VX_TAG_INPUT_XML },
+	{ "IsChannel",			VX_TAG_IS_CHANNEL },
+	{ "IsLocallyMuted",		VX_TAG_IS_LOCALLY_MUTED },
+	{ "IsModeratorMuted",	VX_TAG_IS_MODERATOR_MUTED },
+	{ "IsSpeaking",			VX_TAG_IS_SPEAKING },
+	{ "MessageBody",		VX_TAG_MESSAGE_BODY },
+	{ "MessageHeader",		VX_TAG_MESSAGE_HEADER },
+	{ "MicEnergy",			VX_TAG_MIC_ENERGY },
+	{ "Name",				VX_TAG_NAME },
+	{ "NotificationType",	VX_TAG_NOTIFICATION_TYPE },
+	{ "NumberOfAliases",	VX_TAG_NUMBER_OF_ALIASES },
+	{ "ParticipantType",	VX_TAG_PARTICIPANT_TYPE },
+	{ "ParticipantURI",		VX_TAG_PARTICIPANT_URI },
+	{ "Presence",			VX_TAG_PRESENCE },
+	{ "PresenceOnly",		VX_TAG_PRESENCE_ONLY },
+	{ "RenderDevice",		VX_TAG_RENDER_DEVICE },
+	{ "RenderDevices",		VX_TAG_RENDER_DEVICES },
+	{ "Response",			VX_TAG_RESPONSE },
+	{ "ReturnCode",			VX_TAG_RETURN_CODE },
+	{ "SessionGroupHandle",	VX_TAG_SESSION_GROUP_HANDLE },
+	{ "SessionHandle",		VX_TAG_SESSION_HANDLE },
+	{ "State",				VX_TAG_STATE },
+	{ "StatusCode",			VX_TAG_STATUS_CODE },
+	{ "StatusString",		VX_TAG_STATUS_STRING },
+	{ "SubscriptionHandle",	VX_TAG_SUBSCRIPTION_HANDLE },
+	{ "SubscriptionType",	VX_TAG_SUBSCRIPTION_TYPE },
+	{ "Terminated",			VX_TAG_TERMINATED },
+	{ "URI",				VX_TAG_URI },
+	{ "VersionID",			VX_TAG_VERSION_ID },
+	{ "Volume",				VX_TAG_VOLUME }
+};
+
+static const LLVivoxName sVivoxEventNames[] =
+{
+	{ "AccountLoginStateChangeEvent",	VX_EVENT_ACCOUNT_LOGIN_STATE_CHANGE },
+	{ "AuxAudioPropertiesEvent",		VX_EVENT_AUX_AUDIO_PROPERTIES },
+	{ "BuddyAndGroupListChangedEvent",	VX_EVENT_BUDDY_AND_GROUP_LIST_CHANGED },
+	{ "BuddyChangedEvent",				VX_EVENT_BUDDY_CHANGED },
+	{ "BuddyPresenceEvent",				VX_EVENT_BUDDY_PRESENCE },
+	{ "MediaStreamUpdatedEvent",		VX_EVENT_MEDIA_STREAM_UPDATED },
+	{ "MessageEvent",					VX_EVENT_MESSAGE },
+	{ "ParticipantAddedEvent",			VX_EVENT_PARTICIPANT_ADDED },
+	{ "ParticipantRemovedEvent",		VX_EVENT_PARTICIPANT_REMOVED },
+	{ "ParticipantUpdatedEvent",		VX_EVENT_PARTICIPANT_UPDATED },
+	{ "SessionAddedEvent",				VX_EVENT_SESSION_ADDED },
+	{ "SessionGroupAddedEvent",			VX_EVENT_SESSION_GROUP_ADDED },
+	{ "SessionGroupRemovedEvent",		VX_EVENT_SESSION_GROUP_REMOVED },
+	{ "SessionNotificationEvent",		VX_EVENT_SESSION_NOTIFICATION },
+	{ "SessionRemovedEvent",			VX_EVENT_SESSION_REMOVED },
+	{ "SessionUpdatedEvent",			VX_EVENT_SESSION_UPDATED },
+	{ "SubscriptionEvent",				VX_EVENT_SUBSCRIPTION },
+	{ "TextStreamUpdatedEvent",			VX_EVENT_TEXT_STREAM_UPDATED }
+};
+
+static const LLVivoxName sVivoxActionNames[] =
+{
+	{ "Account.ListAutoAcceptRules.1",	VX_ACTION_ACCOUNT_LIST_AUTO_ACCEPT_RULES },
+	{ "Account.ListBlockRules.1",		VX_ACTION_ACCOUNT_LIST_BLOCK_RULES },
+	{ "Account.Login.1",				VX_ACTION_ACCOUNT_LOGIN },
+	{ "Account.Logout.1",				VX_ACTION_ACCOUNT_LOGOUT },
+	{ "Connector.Create.1",				VX_ACTION_CONNECTOR_CREATE },
+	{ "Connector.InitiateShutdown.1",	VX_ACTION_CONNECTOR_INITIATE_SHUTDOWN },
+	{ "Session.Connect.1",				VX_ACTION_SESSION_CONNECT },
+	{ "Session.Create.1",				VX_ACTION_SESSION_CREATE },
+	{ "SessionGroup.AddSession.1",		VX_ACTION_SESSION_GROUP_ADD_SESSION },
+	{ "Session.Set3DPosition.1",		VX_ACTION_SESSION_SET_3D_POSITION }
+};
+
+static const LLVivoxNameTable sVivoxTags(sVivoxTagNames, sizeof(sVivoxTagNames) / sizeof(sVivoxTagNames[0]));
+static const LLVivoxNameTable sVivoxEvents(sVivoxEventNames, sizeof(sVivoxEventNames) / sizeof(sVivoxEventNames[0]));
+static const LLVivoxNameTable sVivoxActions(sVivoxActionNames, sizeof(sVivoxActionNames) / sizeof(sVivoxActionNames[0]));
+
+LLVivoxProtocolParser::LLVivoxProtocolParser(LLVivoxProtocolSink* sink)
+{
+	mSink = sink;
+	mScanPos = 0;
+	mNumParticipantUpdates = 0;
+	parser = NULL;
+	parser = XML_ParserCreate(NULL);
+	
+	reset();
+}
+
+void LLVivoxProtocolParser::reset()
+{
+	responseDepth = 0;
+	ignoringTags = false;
+	accumulateText = false;
+	energy = 0.f;
+	ignoreDepth = 0;
+	isChannel = false;
+	isEvent = false;
+	isLocallyMuted = false;
+	isModeratorMuted = false;
+	isSpeaking = false;
+	participantType = 0;
+	squelchDebugOutput = false;
+	returnCode = -1;
+	state = 0;
+	statusCode = 0;
+	volume = 0;
+	textBuffer.clear();
+	alias.clear();
+	numberOfAliases = 0;
+	applicationString.clear();
+}
+
+//virtual 
+LLVivoxProtocolParser::~LLVivoxProtocolParser()
+{
+	if (parser)
+		XML_ParserFree(parser);
+}
+
+// virtual
+LLIOPipe::EStatus LLVivoxProtocolParser::process_impl(
+	const LLChannelDescriptors& channels,
+	buffer_ptr_t& buffer,
+	bool& eos,
+	LLSD& context,
+	LLPumpIO* pump)
+{
+	// Take the data on our channel straight from the buffer segments.
+	// mInput keeps its storage between reads.
+	LLBufferArray::segment_iterator_t iter = buffer->beginSegment();
+	LLBufferArray::segment_iterator_t end = buffer->endSegment();
+	while (iter != end)
+	{
+		if ((*iter).isOnChannel(channels.in()))
+		{
+			mInput.append((const char*)(*iter).data(), (*iter).size());
+			buffer->eraseSegment(iter++);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+	
+	// Look for input delimiter(s) in the input buffer.  If one is found, send the message to the xml parser.
+	// Only the bytes that arrived since the last search need looking at.
+	size_t start = 0;
+	size_t delim;
+	while((delim = mInput.find("\n\n\n", mScanPos)) != std::string::npos)
+	{	
+		
+		// Reset internal state of the LLVivoxProtocolParser (no effect on the expat parser)
+		reset();
+		
+		XML_ParserReset(parser, NULL);
+		XML_SetElementHandler(parser, ExpatStartTag, ExpatEndTag);
+		XML_SetCharacterDataHandler(parser, ExpatCharHandler);
+		XML_SetUserData(parser, this);	
+		XML_Parse(parser, mInput.data() + start, delim - start, false);
+		
+		// If this message isn't set to be squelched, output the raw XML received.
+		if(!squelchDebugOutput)
+		{
+			LL_DEBUGS("Voice") << "parsing: " << mInput.substr(start, delim - start) << LL_ENDL;
+		}
+		
+		start = delim + 3;
+		mScanPos = start;
+	}
+	
+	if(start != 0)
+		mInput.erase(0, start);
+
+	// A delimiter may be split across reads
+	mScanPos = mInput.size() > 2 ? mInput.size() - 2 : 0;
+
+	flushParticipantUpdates();
+
+	LL_DEBUGS("VivoxProtocolParser") << "at end, mInput is: " << mInput << LL_ENDL;
+	
+	if(!mSink->isDaemonConnected())
+	{
+		// If voice has been disabled, we just want to close the socket.  This does so.
+		LL_INFOS("Voice") << "returning STATUS_STOP" << LL_ENDL;
+		return STATUS_STOP;
+	}
+	
+	return STATUS_OK;
+}
+
+void XMLCALL LLVivoxProtocolParser::ExpatStartTag(void *data, const char *el, const char **attr)
+{
+	if (data)
+	{
+		LLVivoxProtocolParser	*object = (LLVivoxProtocolParser*)data;
+		object->StartTag(el, attr);
+	}
+}
+
+// --------------------------------------------------------------------------------
+
+void XMLCALL LLVivoxProtocolParser::ExpatEndTag(void *data, const char *el)
+{
+	if (data)
+	{
+		LLVivoxProtocolParser	*object = (LLVivoxProtocolParser*)data;
+		object->EndTag(el);
+	}
+}
+
+// --------------------------------------------------------------------------------
+
+void XMLCALL LLVivoxProtocolParser::ExpatCharHandler(void *data, const XML_Char *s, int len)
+{
+	if (data)
+	{
+		LLVivoxProtocolParser	*object = (LLVivoxProtocolParser*)data;
+		object->CharData(s, len);
+	}
+}
+
+// --------------------------------------------------------------------------------
+
+
+void LLVivoxProtocolParser::StartTag(const char *tag, const char **attr)
+{
+	// Reset the text accumulator. We shouldn't have strings that are inturrupted by new tags
+	textBuffer.clear();
+	// only accumulate text if we're not ignoring tags.
+	accumulateText = !ignoringTags;
+	
+	S32 tag_id = sVivoxTags.find(tag);
+
+	if (responseDepth == 0)
+	{	
+		isEvent = (tag_id == VX_TAG_EVENT);
+		
+		if (tag_id == VX_TAG_RESPONSE || isEvent)
+		{
+			// Grab the attributes
+			while (*attr)
+			{
+				const char	*key = *attr++;
+				const char	*value = *attr++;
+				
+				if (!stricmp("requestId", key))
+				{
+					requestId = value;
+				}
+				else if (!stricmp("action", key))
+				{
+					actionString = value;
+				}
+				else if (!stricmp("type", key))
+				{
+					eventTypeString = value;
+				}
+			}
+		}
+		LL_DEBUGS("VivoxProtocolParser") << tag << " (" << responseDepth << ")"  << LL_ENDL;
+	}
+	else
+	{
+		if (ignoringTags)
+		{
+			LL_DEBUGS("VivoxProtocolParser") << "ignoring tag " << tag << " (depth = " << responseDepth << ")" << LL_ENDL;
+		}
+		else
+		{
+			LL_DEBUGS("VivoxProtocolParser") << tag << " (" << responseDepth << ")"  << LL_ENDL;
+	
+			switch (tag_id)
+			{
+			case VX_TAG_INPUT_XML:
+				// Ignore the InputXml stuff so we don't get confused
+				ignoringTags = true;
+				ignoreDepth = responseDepth;
+				accumulateText = false;
+
+				LL_DEBUGS("VivoxProtocolParser") << "starting ignore, ignoreDepth is " << ignoreDepth << LL_ENDL;
+				break;
+			case VX_TAG_CAPTURE_DEVICES:
+				mSink->clearCaptureDevices();
+				break;
+			case VX_TAG_RENDER_DEVICES:
+				mSink->clearRenderDevices();
+				break;
+			case VX_TAG_BUDDIES:
+				mSink->deleteAllBuddies();
+				break;
+			case VX_TAG_BLOCK_RULES:
+				mSink->deleteAllBlockRules();
+				break;
+			case VX_TAG_AUTO_ACCEPT_RULES:
+				mSink->deleteAllAutoAcceptRules();
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	responseDepth++;
+}
+
+// --------------------------------------------------------------------------------
+
+void LLVivoxProtocolParser::EndTag(const char *tag)
+{
+	const std::string& string = textBuffer;
+	bool clearbuffer = true;
+
+	responseDepth--;
+
+	if (ignoringTags)
+	{
+		if (ignoreDepth == responseDepth)
+		{
+			LL_DEBUGS("VivoxProtocolParser") << "end of ignore" << LL_ENDL;
+			ignoringTags = false;
+		}
+		else
+		{
+			LL_DEBUGS("VivoxProtocolParser") << "ignoring tag " << tag << " (depth = " << responseDepth << ")" << LL_ENDL;
+		}
+	}
+	
+	if (!ignoringTags)
+	{
+		LL_DEBUGS("VivoxProtocolParser") << "processing tag " << tag << " (depth = " << responseDepth << ")" << LL_ENDL;
+
+		// Closing a tag. Finalize the text we've accumulated and reset
+		switch (sVivoxTags.find(tag))
+		{
+		case VX_TAG_RETURN_CODE:
+			returnCode = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_SESSION_HANDLE:
+			sessionHandle = string;
+			break;
+		case VX_TAG_SESSION_GROUP_HANDLE:
+			sessionGroupHandle = string;
+			break;
+		case VX_TAG_STATUS_CODE:
+			statusCode = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_STATUS_STRING:
+		case VX_TAG_PRESENCE:
+			statusString = string;
+			break;
+		case VX_TAG_PARTICIPANT_URI:
+		case VX_TAG_URI:
+		case VX_TAG_CHANNEL_URI:
+		case VX_TAG_BUDDY_URI:
+			uriString = string;
+			break;
+		case VX_TAG_VOLUME:
+			volume = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_ENERGY:
+		case VX_TAG_MIC_ENERGY:
+			energy = (F32)strtod(string.c_str(), NULL);
+			break;
+		case VX_TAG_IS_MODERATOR_MUTED:
+			isModeratorMuted = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_IS_SPEAKING:
+			isSpeaking = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_ALIAS:
+			alias = string;
+			break;
+		case VX_TAG_NUMBER_OF_ALIASES:
+			numberOfAliases = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_APPLICATION:
+			applicationString = string;
+			break;
+		case VX_TAG_CONNECTOR_HANDLE:
+			connectorHandle = string;
+			break;
+		case VX_TAG_VERSION_ID:
+			versionID = string;
+			break;
+		case VX_TAG_ACCOUNT_HANDLE:
+			accountHandle = string;
+			break;
+		case VX_TAG_STATE:
+			state = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_IS_CHANNEL:
+			isChannel = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_INCOMING:
+			incoming = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_ENABLED:
+			enabled = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_NAME:
+		case VX_TAG_CHANNEL_NAME:
+		case VX_TAG_ACCOUNT_NAME:
+			nameString = string;
+			break;
+		case VX_TAG_AUDIO_MEDIA:
+			audioMediaString = string;
+			break;
+		case VX_TAG_DISPLAY_NAME:
+			displayNameString = string;
+			break;
+		case VX_TAG_PARTICIPANT_TYPE:
+			participantType = strtol(string.c_str(), NULL, 10);
+			break;
+		case VX_TAG_IS_LOCALLY_MUTED:
+			isLocallyMuted = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_DEVICE:
+			// This closing tag shouldn't clear the accumulated text.
+			clearbuffer = false;
+			break;
+		case VX_TAG_CAPTURE_DEVICE:
+			mSink->addCaptureDevice(textBuffer);
+			break;
+		case VX_TAG_RENDER_DEVICE:
+			mSink->addRenderDevice(textBuffer);
+			break;
+		case VX_TAG_BUDDY:
+			mSink->processBuddyListEntry(uriString, displayNameString);
+			break;
+		case VX_TAG_BLOCK_RULE:
+			mSink->addBlockRule(blockMask, presenceOnly);
+			break;
+		case VX_TAG_BLOCK_MASK:
+			blockMask = string;
+			break;
+		case VX_TAG_PRESENCE_ONLY:
+			presenceOnly = string;
+			break;
+		case VX_TAG_AUTO_ACCEPT_RULE:
+			mSink->addAutoAcceptRule(autoAcceptMask, autoAddAsBuddy);
+			break;
+		case VX_TAG_AUTO_ACCEPT_MASK:
+			autoAcceptMask = string;
+			break;
+		case VX_TAG_AUTO_ADD_AS_BUDDY:
+			autoAddAsBuddy = string;
+			break;
+		case VX_TAG_MESSAGE_HEADER:
+			messageHeader = string;
+			break;
+		case VX_TAG_MESSAGE_BODY:
+			messageBody = string;
+			break;
+		case VX_TAG_NOTIFICATION_TYPE:
+			notificationType = string;
+			break;
+		case VX_TAG_HAS_TEXT:
+			hasText = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_HAS_AUDIO:
+			hasAudio = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_HAS_VIDEO:
+			hasVideo = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_TERMINATED:
+			terminated = !stricmp(string.c_str(), "true");
+			break;
+		case VX_TAG_SUBSCRIPTION_HANDLE:
+			subscriptionHandle = string;
+			break;
+		case VX_TAG_SUBSCRIPTION_TYPE:
+			subscriptionType = string;
+			break;
+		default:
+			break;
+		}
+
+		if(clearbuffer)
+		{
+			textBuffer.clear();
+			accumulateText= false;
+		}
+		
+		if (responseDepth == 0)
+		{
+			// We finished all of the XML, process the data
+			processResponse(tag);
+		}
+	}
+}
+
+// --------------------------------------------------------------------------------
+
+void LLVivoxProtocolParser::CharData(const char *buffer, int length)
+{
+	/*
+		This method is called for anything that isn't a tag, which can be text you
+		want that lies between tags, and a lot of stuff you don't want like file formatting
+		(tabs, spaces, CR/LF, etc).
+		
+		Only copy text if we are in accumulate mode...
+	*/
+	if (accumulateText)
+		textBuffer.append(buffer, length);
+}
+
+// --------------------------------------------------------------------------------
+
+void LLVivoxProtocolParser::queueParticipantUpdate()
+{
+	// A later update for the same participant replaces the earlier one
+	U32 i = 0;
+	while (i < mNumParticipantUpdates &&
+		   !(mParticipantUpdates[i].mURI == uriString && mParticipantUpdates[i].mSessionHandle == sessionHandle))
+	{
+		i++;
+	}
+	if (i == mNumParticipantUpdates)
+	{
+		if (mNumParticipantUpdates == mParticipantUpdates.size())
+		{
+			mParticipantUpdates.resize(mNumParticipantUpdates + 1);
+		}
+		mNumParticipantUpdates++;
+	}
+
+	ParticipantUpdate& update = mParticipantUpdates[i];
+	update.mSessionHandle = sessionHandle;
+	update.mSessionGroupHandle = sessionGroupHandle;
+	update.mURI = uriString;
+	update.mAlias = alias;
+	update.mIsModeratorMuted = isModeratorMuted;
+	update.mIsSpeaking = isSpeaking;
+	update.mVolume = volume;
+	update.mEnergy = energy;
+}
+
+// --------------------------------------------------------------------------------
+
+void LLVivoxProtocolParser::flushParticipantUpdates()
+{
+	for (U32 i = 0; i < mNumParticipantUpdates; i++)
+	{
+		ParticipantUpdate& update = mParticipantUpdates[i];
+		mSink->participantUpdatedEvent(update.mSessionHandle, update.mSessionGroupHandle, update.mURI, update.mAlias,
+			update.mIsModeratorMuted, update.mIsSpeaking, update.mVolume, update.mEnergy);
+	}
+	mNumParticipantUpdates = 0;
+}
+
+// --------------------------------------------------------------------------------
+
+void LLVivoxProtocolParser::processResponse(const char *tag)
+{
+	LL_DEBUGS("VivoxProtocolParser") << tag << LL_ENDL;
+
+	// SLIM SDK: the SDK now returns a statusCode of "200" (OK) for success.  This is a change vs. previous SDKs.
+	// According to Mike S., "The actual API convention is that responses with return codes of 0 are successful, regardless of the status code returned",
+	// so I believe this will give correct behavior.
+	
+	if(returnCode == 0)
+		statusCode = 0;
+		
+	if (isEvent)
+	{
+		S32 event_type = sVivoxEvents.find(eventTypeString.c_str());
+		if (event_type != VX_EVENT_PARTICIPANT_UPDATED)
+		{
+			flushParticipantUpdates();
+		}
+
+		switch (event_type)
+		{
+		case VX_EVENT_ACCOUNT_LOGIN_STATE_CHANGE:
+		{
+			mSink->accountLoginStateChangeEvent(accountHandle, statusCode, statusString, state);
+			break;
+		}
+		case VX_EVENT_SESSION_ADDED:
+		{
+			/*
+			<Event type="SessionAddedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg0</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==0</SessionHandle>
+				<Uri>sip:confctl-1408789@bhr.vivox.com</Uri>
+				<IsChannel>true</IsChannel>
+				<Incoming>false</Incoming>
+				<ChannelName />
+			</Event>
+			*/
+			mSink->sessionAddedEvent(uriString, alias, sessionHandle, sessionGroupHandle, isChannel, incoming, nameString, applicationString);
+			break;
+		}
+		case VX_EVENT_SESSION_REMOVED:
+		{
+			mSink->sessionRemovedEvent(sessionHandle, sessionGroupHandle);
+			break;
+		}
+		case VX_EVENT_SESSION_GROUP_ADDED:
+		{
+			mSink->sessionGroupAddedEvent(sessionGroupHandle);
+			break;
+		}
+		case VX_EVENT_MEDIA_STREAM_UPDATED:
+		{
+			/*
+			<Event type="MediaStreamUpdatedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg0</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==0</SessionHandle>
+				<StatusCode>200</StatusCode>
+				<StatusString>OK</StatusString>
+				<State>2</State>
+				<Incoming>false</Incoming>
+			</Event>
+			*/
+			mSink->mediaStreamUpdatedEvent(sessionHandle, sessionGroupHandle, statusCode, statusString, state, incoming);
+			break;
+		}
+		case VX_EVENT_TEXT_STREAM_UPDATED:
+		{
+			/*
+			<Event type="TextStreamUpdatedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg1</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==1</SessionHandle>
+				<Enabled>true</Enabled>
+				<State>1</State>
+				<Incoming>true</Incoming>
+			</Event>
+			*/
+			mSink->textStreamUpdatedEvent(sessionHandle, sessionGroupHandle, enabled, state, incoming);
+			break;
+		}
+		case VX_EVENT_PARTICIPANT_ADDED:
+		{
+			/* 
+			<Event type="ParticipantAddedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg4</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==4</SessionHandle>
+				<ParticipantUri>sip:xI5auBZ60SJWIk606-1JGRQ==@bhr.vivox.com</ParticipantUri>
+				<AccountName>xI5auBZ60SJWIk606-1JGRQ==</AccountName>
+				<DisplayName />
+				<ParticipantType>0</ParticipantType>
+			</Event>
+			*/
+			mSink->participantAddedEvent(sessionHandle, sessionGroupHandle, uriString, alias, nameString, displayNameString, participantType);
+			break;
+		}
+		case VX_EVENT_PARTICIPANT_REMOVED:
+		{
+			/*
+			<Event type="ParticipantRemovedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg4</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==4</SessionHandle>
+				<ParticipantUri>sip:xtx7YNV-3SGiG7rA1fo5Ndw==@bhr.vivox.com</ParticipantUri>
+				<AccountName>xtx7YNV-3SGiG7rA1fo5Ndw==</AccountName>
+			</Event>
+			*/
+			mSink->participantRemovedEvent(sessionHandle, sessionGroupHandle, uriString, alias, nameString);
+			break;
+		}
+		case VX_EVENT_PARTICIPANT_UPDATED:
+		{
+			/*
+			<Event type="ParticipantUpdatedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg0</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==0</SessionHandle>
+				<ParticipantUri>sip:xFnPP04IpREWNkuw1cOXlhw==@bhr.vivox.com</ParticipantUri>
+				<IsModeratorMuted>false</IsModeratorMuted>
+				<IsSpeaking>true</IsSpeaking>
+				<Volume>44</Volume>
+				<Energy>0.0879437</Energy>
+			</Event>
+			*/
+			
+			// These happen so often that logging them is pretty useless.
+			squelchDebugOutput = true;
+			
+			queueParticipantUpdate();
+			break;
+		}
+		case VX_EVENT_AUX_AUDIO_PROPERTIES:
+		{
+			mSink->auxAudioPropertiesEvent(energy);
+			break;
+		}
+		case VX_EVENT_BUDDY_PRESENCE:
+		{
+			mSink->buddyPresenceEvent(uriString, alias, statusString, applicationString);
+			break;
+		}
+		case VX_EVENT_BUDDY_AND_GROUP_LIST_CHANGED:
+		{
+			// The buddy list was updated during parsing.
+			// Need to recheck against the friends list.
+			mSink->buddyListChanged();
+			break;
+		}
+		case VX_EVENT_BUDDY_CHANGED:
+		{
+			/*
+			<Event type="BuddyChangedEvent">
+				<AccountHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==</AccountHandle>
+				<BuddyURI>sip:x9fFHFZjOTN6OESF1DUPrZQ==@bhr.vivox.com</BuddyURI>
+				<DisplayName>Monroe Tester</DisplayName>
+				<BuddyData />
+				<GroupID>0</GroupID>
+				<ChangeType>Set</ChangeType>
+			</Event>
+			*/		
+			// TODO: Question: Do we need to process this at all?
+			break;
+		}
+		case VX_EVENT_MESSAGE:
+		{
+			mSink->messageEvent(sessionHandle, uriString, alias, messageHeader, messageBody, applicationString);
+			break;
+		}
+		case VX_EVENT_SESSION_NOTIFICATION:
+		{
+			mSink->sessionNotificationEvent(sessionHandle, uriString, notificationType);
+			break;
+		}
+		case VX_EVENT_SUBSCRIPTION:
+		{
+			mSink->subscriptionEvent(uriString, subscriptionHandle, alias, displayNameString, applicationString, subscriptionType);
+			break;
+		}
+		case VX_EVENT_SESSION_UPDATED:
+		{
+			/*
+			<Event type="SessionUpdatedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg0</SessionGroupHandle>
+				<SessionHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==0</SessionHandle>
+				<Uri>sip:confctl-9@bhd.vivox.com</Uri>
+				<IsMuted>0</IsMuted>
+				<Volume>50</Volume>
+				<TransmitEnabled>1</TransmitEnabled>
+				<IsFocused>0</IsFocused>
+				<SpeakerPosition><Position><X>0</X><Y>0</Y><Z>0</Z></Position></SpeakerPosition>
+				<SessionFontID>0</SessionFontID>
+			</Event>
+			*/
+			// We don't need to process this, but we also shouldn't warn on it, since that confuses people.
+			break;
+		}
+		case VX_EVENT_SESSION_GROUP_REMOVED:
+		{
+			/*
+			<Event type="SessionGroupRemovedEvent">
+				<SessionGroupHandle>c1_m1000xFnPP04IpREWNkuw1cOXlhw==_sg0</SessionGroupHandle>
+			</Event>
+			*/
+			// We don't need to process this, but we also shouldn't warn on it, since that confuses people.
+			break;
+		}
+		default:
+			LL_WARNS("VivoxProtocolParser") << "Unknown event type " << eventTypeString << LL_ENDL;
+			break;
+		}
+	}
+	else
+	{
+		flushParticipantUpdates();
+
+		switch (sVivoxActions.find(actionString.c_str()))
+		{
+		case VX_ACTION_CONNECTOR_CREATE:
+		{
+			mSink->connectorCreateResponse(statusCode, statusString, connectorHandle, versionID);
+			break;
+		}
+		case VX_ACTION_ACCOUNT_LOGIN:
+		{
+			mSink->loginResponse(statusCode, statusString, accountHandle, numberOfAliases);
+			break;
+		}
+		case VX_ACTION_SESSION_CREATE:
+		{
+			mSink->sessionCreateResponse(requestId, statusCode, statusString, sessionHandle);			
+			break;
+		}
+		case VX_ACTION_SESSION_GROUP_ADD_SESSION:
+		{
+			mSink->sessionGroupAddSessionResponse(requestId, statusCode, statusString, sessionHandle);			
+			break;
+		}
+		case VX_ACTION_SESSION_CONNECT:
+		{
+			mSink->sessionConnectResponse(requestId, statusCode, statusString);			
+			break;
+		}
+		case VX_ACTION_ACCOUNT_LOGOUT:
+		{
+			mSink->logoutResponse(statusCode, statusString);			
+			break;
+		}
+		case VX_ACTION_CONNECTOR_INITIATE_SHUTDOWN:
+		{
+			mSink->connectorShutdownResponse(statusCode, statusString);			
+			break;
+		}
+		case VX_ACTION_ACCOUNT_LIST_BLOCK_RULES:
+		{
+			mSink->accountListBlockRulesResponse(statusCode, statusString);						
+			break;
+		}
+		case VX_ACTION_ACCOUNT_LIST_AUTO_ACCEPT_RULES:
+		{
+			mSink->accountListAutoAcceptRulesResponse(statusCode, statusString);						
+			break;
+		}
+		case VX_ACTION_SESSION_SET_3D_POSITION:
+		{
+			// We don't need to process these, but they're so spammy we don't want to log them.
+			squelchDebugOutput = true;
+			break;
+		}
+		default:
+			break;
+		}
+/*
+		else if (!stricmp(actionCstr, "Account.ChannelGetList.1"))
+		{
+			mSink->channelGetListResponse(statusCode, statusString);
+		}
+		else if (!stricmp(actionCstr, "Connector.AccountCreate.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Connector.MuteLocalMic.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Connector.MuteLocalSpeaker.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Connector.SetLocalMicVolume.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Connector.SetLocalSpeakerVolume.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Session.ListenerSetPosition.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Session.SpeakerSetPosition.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Session.AudioSourceSetPosition.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Session.GetChannelParticipants.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelCreate.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelUpdate.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelDelete.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelCreateAndInvite.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelFolderCreate.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelFolderUpdate.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelFolderDelete.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelAddModerator.1"))
+		{
+			
+		}
+		else if (!stricmp(actionCstr, "Account.ChannelDeleteModerator.1"))
+		{
+			
+		}
+*/
+	}
+}
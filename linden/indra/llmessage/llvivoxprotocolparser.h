@@ -0,0 +1,233 @@
+/** 
+ * @file llvivoxprotocolparser.h
+ * @brief Parser for the voice daemon protocol
+ *
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVIVOXPROTOCOLPARSER_H
+#define LL_LLVIVOXPROTOCOLPARSER_H
+
+#include <string>
+#include <vector>
+
+#ifdef LL_STANDALONE
+# include "expat.h"
+#else
+# include "expat/expat.h"
+#endif
+
+#include "lliopipe.h"
+
+/** 
+ * @class LLVivoxProtocolSink
+ * @brief Receives what LLVivoxProtocolParser reads from the voice daemon
+ *
+ * The parameters mirror the daemon's messages.  Every call defaults to
+ * doing nothing.
+ */
+class LLVivoxProtocolSink
+{
+public:
+	virtual ~LLVivoxProtocolSink() {}
+
+	// False once the connection to the daemon should be closed.
+	virtual bool isDaemonConnected() { return true; }
+
+	// Lists sent with responses
+	virtual void clearCaptureDevices() {}
+	virtual void addCaptureDevice(const std::string& name) {}
+	virtual void clearRenderDevices() {}
+	virtual void addRenderDevice(const std::string& name) {}
+	virtual void deleteAllBuddies(void) {}
+	virtual void processBuddyListEntry(const std::string &uri, const std::string &displayName) {}
+	virtual void deleteAllBlockRules(void) {}
+	virtual void addBlockRule(const std::string &blockMask, const std::string &presenceOnly) {}
+	virtual void deleteAllAutoAcceptRules(void) {}
+	virtual void addAutoAcceptRule(const std::string &autoAcceptMask, const std::string &autoAddAsBuddy) {}
+
+	// Responses
+	virtual void connectorCreateResponse(int statusCode, std::string &statusString, std::string &connectorHandle, std::string &versionID) {}
+	virtual void loginResponse(int statusCode, std::string &statusString, std::string &accountHandle, int numberOfAliases) {}
+	virtual void sessionCreateResponse(std::string &requestId, int statusCode, std::string &statusString, std::string &sessionHandle) {}
+	virtual void sessionGroupAddSessionResponse(std::string &requestId, int statusCode, std::string &statusString, std::string &sessionHandle) {}
+	virtual void sessionConnectResponse(std::string &requestId, int statusCode, std::string &statusString) {}
+	virtual void logoutResponse(int statusCode, std::string &statusString) {}
+	virtual void connectorShutdownResponse(int statusCode, std::string &statusString) {}
+	virtual void accountListBlockRulesResponse(int statusCode, const std::string &statusString) {}
+	virtual void accountListAutoAcceptRulesResponse(int statusCode, const std::string &statusString) {}
+
+	// Events
+	virtual void accountLoginStateChangeEvent(std::string &accountHandle, int statusCode, std::string &statusString, int state) {}
+	virtual void mediaStreamUpdatedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, int statusCode, std::string &statusString, int state, bool incoming) {}
+	virtual void textStreamUpdatedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, bool enabled, int state, bool incoming) {}
+	virtual void sessionAddedEvent(std::string &uriString, std::string &alias, std::string &sessionHandle, std::string &sessionGroupHandle, bool isChannel, bool incoming, std::string &nameString, std::string &applicationString) {}
+	virtual void sessionGroupAddedEvent(std::string &sessionGroupHandle) {}
+	virtual void sessionRemovedEvent(std::string &sessionHandle, std::string &sessionGroupHandle) {}
+	virtual void participantAddedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, std::string &uriString, std::string &alias, std::string &nameString, std::string &displayNameString, int participantType) {}
+	virtual void participantRemovedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, std::string &uriString, std::string &alias, std::string &nameString) {}
+	virtual void participantUpdatedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, std::string &uriString, std::string &alias, bool isModeratorMuted, bool isSpeaking, int volume, F32 energy) {}
+	virtual void auxAudioPropertiesEvent(F32 energy) {}
+	virtual void buddyPresenceEvent(std::string &uriString, std::string &alias, std::string &statusString, std::string &applicationString) {}
+	virtual void messageEvent(std::string &sessionHandle, std::string &uriString, std::string &alias, std::string &messageHeader, std::string &messageBody, std::string &applicationString) {}
+	virtual void sessionNotificationEvent(std::string &sessionHandle, std::string &uriString, std::string &notificationType) {}
+	virtual void subscriptionEvent(std::string &buddyURI, std::string &subscriptionHandle, std::string &alias, std::string &displayName, std::string &applicationString, std::string &subscriptionType) {}
+	virtual void buddyListChanged() {}
+};
+
+/** 
+ * @class LLVivoxProtocolParser
+ * @brief Parses the voice daemon's replies and events
+ * @see LLIOPipe
+ *
+ * Messages are XML separated by "\n\n\n".  Each complete message is
+ * parsed and handed to the sink; a partial one waits for the next read.
+ */
+class LLVivoxProtocolParser : public LLIOPipe
+{
+	LOG_CLASS(LLVivoxProtocolParser);
+public:
+	LLVivoxProtocolParser(LLVivoxProtocolSink* sink);
+	virtual ~LLVivoxProtocolParser();
+
+protected:
+	/* @name LLIOPipe virtual implementations
+	 */
+	//@{
+	/** 
+	 * @brief Process the data in buffer
+	 */
+	virtual EStatus process_impl(
+		const LLChannelDescriptors& channels,
+		buffer_ptr_t& buffer,
+		bool& eos,
+		LLSD& context,
+		LLPumpIO* pump);
+	//@}
+	
+	LLVivoxProtocolSink* mSink;
+
+	std::string 	mInput;
+	size_t			mScanPos;		// where to resume looking for the message delimiter
+	
+	// Expat control members
+	XML_Parser		parser;
+	int				responseDepth;
+	bool			ignoringTags;
+	bool			isEvent;
+	int				ignoreDepth;
+
+	// Members for processing responses. The values are transient and only valid within a call to processResponse().
+	bool			squelchDebugOutput;
+	int				returnCode;
+	int				statusCode;
+	std::string		statusString;
+	std::string		requestId;
+	std::string		actionString;
+	std::string		connectorHandle;
+	std::string		versionID;
+	std::string		accountHandle;
+	std::string		sessionHandle;
+	std::string		sessionGroupHandle;
+	std::string		alias;
+	std::string		applicationString;
+
+	// Members for processing events. The values are transient and only valid within a call to processResponse().
+	std::string		eventTypeString;
+	int				state;
+	std::string		uriString;
+	bool			isChannel;
+	bool			incoming;
+	bool			enabled;
+	std::string		nameString;
+	std::string		audioMediaString;
+	std::string		displayNameString;
+	int				participantType;
+	bool			isLocallyMuted;
+	bool			isModeratorMuted;
+	bool			isSpeaking;
+	int				volume;
+	F32				energy;
+	std::string		messageHeader;
+	std::string		messageBody;
+	std::string		notificationType;
+	bool			hasText;
+	bool			hasAudio;
+	bool			hasVideo;
+	bool			terminated;
+	std::string		blockMask;
+	std::string		presenceOnly;
+	std::string		autoAcceptMask;
+	std::string		autoAddAsBuddy;
+	int				numberOfAliases;
+	std::string		subscriptionHandle;
+	std::string		subscriptionType;
+		
+
+	// Members for processing text between tags
+	std::string		textBuffer;
+	bool			accumulateText;
+
+	// ParticipantUpdatedEvents make up most of the traffic on a busy
+	// channel.  They are collected here, the latest one per participant,
+	// and delivered together before anything else is processed and at the
+	// end of each read.  Entries past mNumParticipantUpdates keep their
+	// string storage for reuse.
+	struct ParticipantUpdate
+	{
+		std::string	mSessionHandle;
+		std::string	mSessionGroupHandle;
+		std::string	mURI;
+		std::string	mAlias;
+		bool		mIsModeratorMuted;
+		bool		mIsSpeaking;
+		int			mVolume;
+		F32			mEnergy;
+	};
+	std::vector<ParticipantUpdate> mParticipantUpdates;
+	U32				mNumParticipantUpdates;
+
+	void			queueParticipantUpdate();
+	void			flushParticipantUpdates();
+	
+	void			reset();
+
+	void			processResponse(const char *tag);
+
+static void XMLCALL ExpatStartTag(void *data, const char *el, const char **attr);
+static void XMLCALL ExpatEndTag(void *data, const char *el);
+static void XMLCALL ExpatCharHandler(void *data, const XML_Char *s, int len);
+
+	void			StartTag(const char *tag, const char **attr);
+	void			EndTag(const char *tag);
+	void			CharData(const char *buffer, int length);
+	
+};
+
+#endif // LL_LLVIVOXPROTOCOLPARSER_H
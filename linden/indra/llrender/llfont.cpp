@@ -141,6 +141,7 @@ LLFont::LLFont()
 
 	mRenderGlyphCount = 0;
 	mAddGlyphCount = 0;
+	mGlyphGeneration = 0;
 
 	mPointSize = 0;
 }
@@ -264,6 +265,7 @@ void LLFont::resetBitmapCache()
 		iter->second->mMetricsValid = FALSE;
 	}
 	mFontBitmapCachep->reset();
+	mGlyphGeneration++;
 
 	// Add the empty glyph`5
 	addGlyph(0, 0);
@@ -339,6 +341,10 @@ void LLFont::insertGlyphInfo(llwchar wch, LLFontGlyphInfo* gi) const
 	char_glyph_info_map_t::iterator iter = mCharGlyphInfoMap.find(wch);
 	if (iter != mCharGlyphInfoMap.end())
 	{
+		if (iter->second->mIsRendered)
+		{
+			mGlyphGeneration++;
+		}
 		delete iter->second;
 		iter->second = gi;
 	}
@@ -360,9 +366,25 @@ BOOL LLFont::addGlyphFromFont(const LLFont *fontp, const llwchar wch, const U32
 
 	S32 pos_x, pos_y;
 	S32 bitmap_num;
-	mFontBitmapCachep->nextOpenPos(width, pos_x, pos_y, bitmap_num);
+	S32 evicted_num;
+	mFontBitmapCachep->nextOpenPos(width, pos_x, pos_y, bitmap_num, evicted_num);
 	mAddGlyphCount++;
 
+	if (evicted_num >= 0)
+	{
+		// The bitmap was recycled, so its glyphs have to be rendered again
+		// the next time they are drawn.
+		for (char_glyph_info_map_t::iterator iter = mCharGlyphInfoMap.begin();
+			 iter != mCharGlyphInfoMap.end(); ++iter)
+		{
+			if (iter->second->mBitmapNum == evicted_num)
+			{
+				iter->second->mIsRendered = FALSE;
+			}
+		}
+		mGlyphGeneration++;
+	}
+
 	LLFontGlyphInfo* gi = new LLFontGlyphInfo(glyph_index);
 	gi->mXBitmapOffset = pos_x;
 	gi->mYBitmapOffset = pos_y;
@@ -191,6 +191,9 @@ protected:
 								   S32 stride = 0) const;
 	mutable S32 mRenderGlyphCount;
 	mutable S32 mAddGlyphCount;
+	// Bumped whenever a rendered glyph is dropped from the bitmaps, so
+	// anything remembering glyph placement knows to recompute it.
+	mutable U32 mGlyphGeneration;
 };
 
 #endif // LL_FONT_
@@ -34,6 +34,10 @@
 
 #include "llgl.h"
 #include "llfontbitmapcache.h"
+#include "llframetimer.h"
+
+// static
+S32 LLFontBitmapCache::sMaxBitmaps = 0;
 
 LLFontBitmapCache::LLFontBitmapCache():
 	mNumComponents(0),
@@ -41,6 +45,7 @@ LLFontBitmapCache::LLFontBitmapCache():
 	mMaxCharHeight(0),
 	mBitmapWidth(0),
 	mBitmapHeight(0),
+	mBitmapNum(-1),
 	mCurrentOffsetX(1),
 	mCurrentOffsetY(1),
 	mCurrentBitmapNum(-1)
@@ -79,11 +84,54 @@ LLImageGL *LLFontBitmapCache::getImageGL(U32 bitmap_num) const
 }
 
 
-BOOL LLFontBitmapCache::nextOpenPos(S32 width, S32 &pos_x, S32 &pos_y, S32& bitmap_num)
+BOOL LLFontBitmapCache::nextOpenPos(S32 width, S32 &pos_x, S32 &pos_y, S32& bitmap_num, S32& evicted_num)
 {
+	evicted_num = -1;
 	if ((mBitmapNum<0) || (mCurrentOffsetX + width + 1) > mBitmapWidth)
 	{
-		if ((mBitmapNum<0) || (mCurrentOffsetY + 2*mMaxCharHeight + 2) > mBitmapHeight)
+		S32 oldest = -1;
+		if ((mBitmapNum >= 0)
+			&& (mCurrentOffsetY + 2*mMaxCharHeight + 2) > mBitmapHeight
+			&& sMaxBitmaps > 0
+			&& (S32)mImageRawVec.size() >= sMaxBitmaps)
+		{
+			// Out of space and out of bitmaps.  Recycle the one that has
+			// gone longest without being drawn from, but never one drawn
+			// from this frame: glyphs already laid out may still be waiting
+			// to be drawn.  If every bitmap is in use, grow past the limit
+			// until a later frame frees one up.
+			const U32 frame = LLFrameTimer::getFrameCount();
+			for (S32 i = 0; i < (S32)mLastUsedFrame.size(); i++)
+			{
+				if (i != mBitmapNum
+					&& mLastUsedFrame[i] != frame
+					&& (oldest < 0 || mLastUsedFrame[i] < mLastUsedFrame[oldest]))
+				{
+					oldest = i;
+				}
+			}
+		}
+
+		if (oldest >= 0)
+		{
+			LLImageRaw *image_raw = getImageRaw(oldest);
+			switch (mNumComponents)
+			{
+				case 1:
+					image_raw->clear();
+				break;
+				case 2:
+					image_raw->clear(255, 0);
+				break;
+			}
+
+			mBitmapNum = oldest;
+			mLastUsedFrame[oldest] = LLFrameTimer::getFrameCount();
+			mCurrentOffsetX = 1;
+			mCurrentOffsetY = 1;
+			evicted_num = oldest;
+		}
+		else if ((mBitmapNum<0) || (mCurrentOffsetY + 2*mMaxCharHeight + 2) > mBitmapHeight)
 		{
 			// We're out of space in the current image, or no image
 			// has been allocated yet.  Make a new one.
@@ -94,6 +142,7 @@ BOOL LLFontBitmapCache::nextOpenPos(S32 width, S32 &pos_x, S32 &pos_y, S32& bitm
 			// Make corresponding GL image.
 			mImageGLVec.push_back(new LLImageGL(FALSE));
 			LLImageGL *image_gl = getImageGL(mBitmapNum);
+			mLastUsedFrame.push_back(LLFrameTimer::getFrameCount());
 			
 			S32 image_width = mMaxCharWidth * 20;
 			S32 pow_iw = 2;
@@ -159,7 +208,9 @@ void LLFontBitmapCache::reset()
 {
 	mImageRawVec.clear();
 	mImageGLVec.clear();
+	mLastUsedFrame.clear();
 	
+	mBitmapNum = -1;
 	mBitmapWidth = 0,
 	mBitmapHeight = 0,
 	mCurrentOffsetX = 0,
@@ -50,7 +50,20 @@ public:
 
 	void reset();
 
-	BOOL nextOpenPos(S32 width, S32 &posX, S32 &posY, S32 &bitmapNum);
+	// If sMaxBitmaps are already in use, the least recently touched
+	// bitmap is cleared and reused; its index is returned in evictedNum
+	// (otherwise -1) so the caller can forget the glyphs it held.
+	// Bitmaps touched this frame are never reused.
+	BOOL nextOpenPos(S32 width, S32 &posX, S32 &posY, S32 &bitmapNum, S32 &evictedNum);
+
+	// Mark a bitmap as drawn from this frame, for eviction.
+	void touch(S32 bitmap_num, U32 frame)
+	{
+		if (bitmap_num >= 0 && bitmap_num < (S32)mLastUsedFrame.size())
+		{
+			mLastUsedFrame[bitmap_num] = frame;
+		}
+	}
 	
 	void destroyGL();
 	
@@ -61,6 +74,10 @@ public:
 	S32 getNumComponents() const { return mNumComponents; }
 	S32 getBitmapWidth() const { return mBitmapWidth; }
 	S32 getBitmapHeight() const { return mBitmapHeight; }
+	S32 getNumBitmaps() const { return (S32)mImageRawVec.size(); }
+
+	// Upper bound on bitmaps per font, 0 for unlimited.
+	static S32 sMaxBitmaps;
 
 private:
 	S32 mNumComponents;
@@ -74,6 +91,7 @@ private:
 	S32 mCurrentBitmapNum;
 	std::vector<LLPointer<LLImageRaw> >	mImageRawVec;
 	std::vector<LLPointer<LLImageGL> > mImageGLVec;
+	std::vector<U32> mLastUsedFrame;
 };
 
 #endif //LL_LLFONTBITMAPCACHE_H
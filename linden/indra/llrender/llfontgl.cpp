@@ -38,6 +38,7 @@
 #include "llfontgl.h"
 #include "llfontbitmapcache.h"
 #include "llfontregistry.h"
+#include "llframetimer.h"
 #include "llgl.h"
 #include "llrender.h"
 #include "v4color.h"
@@ -68,6 +69,11 @@ const F32 PIXEL_CORRECTION_DISTANCE = 0.01f;
 const F32 PAD_UVY = 0.5f; // half of vertical padding between glyphs in the glyph texture
 const F32 DROP_SHADOW_SOFT_STRENGTH = 0.3f;
 
+// Per font.  Longer strings (whole notecards) are laid out every time.
+const U32 MAX_CACHED_RUNS = 256;
+const U32 MAX_CACHED_WIDTHS = 512;
+const S32 MAX_CACHED_RUN_LENGTH = 256;
+
 F32 llfont_round_x(F32 x)
 {
 	//return llfloor((x-LLFontGL::sCurOrigin.mX)/LLFontGL::sScaleX+0.5f)*LLFontGL::sScaleX+LLFontGL::sCurOrigin.mX;
@@ -114,12 +120,18 @@ U8 LLFontGL::getStyleFromString(const std::string &style)
 }
 
 LLFontGL::LLFontGL()
-	: LLFont()
+	: LLFont(),
+	  mRunCache(MAX_CACHED_RUNS),
+	  mWidthCache(MAX_CACHED_WIDTHS),
+	  mRunCacheGeneration(0)
 {
 	clearEmbeddedChars();
 }
 
 LLFontGL::LLFontGL(const LLFontGL &source)
+	: mRunCache(MAX_CACHED_RUNS),
+	  mWidthCache(MAX_CACHED_WIDTHS),
+	  mRunCacheGeneration(0)
 {
 	llerrs << "Not implemented!" << llendl;
 }
@@ -150,6 +162,8 @@ void LLFontGL::reset()
 		}
 	}
 	resetBitmapCache(); 
+	// glyph metrics are recomputed, unlike a bitmap eviction
+	mWidthCache.clear();
 }
 
 // static 
@@ -290,6 +304,7 @@ BOOL LLFontGL::loadFace(const std::string& filename,
 	{
 		return FALSE;
 	}
+	mWidthCache.clear();
 	return TRUE;
 }
 
@@ -484,12 +499,6 @@ S32 LLFontGL::render(const LLWString &wstr,
 
 	F32 start_x = cur_x;
 
-	F32 inv_width = 1.f / mFontBitmapCachep->getBitmapWidth();
-	F32 inv_height = 1.f / mFontBitmapCachep->getBitmapHeight();
-
-	const S32 LAST_CHARACTER = LLFont::LAST_CHAR_FULL;
-
-
 	BOOL draw_ellipses = FALSE;
 	if (use_ellipses && halign == LEFT)
 	{
@@ -504,9 +513,22 @@ S32 LLFontGL::render(const LLWString &wstr,
 	}
 
 
+	// Reuse the layout from earlier frames when there are no embedded
+	// characters to account for.
+	const glyph_run_t* run = NULL;
+	if (length > 0 && length <= MAX_CACHED_RUN_LENGTH && (!use_embedded || mEmbeddedChars.empty()))
+	{
+		run = getGlyphRun(wstr, begin_offset, length);
+	}
+	glyph_quad_t scratch_quad;
+	const U32 frame = LLFrameTimer::getFrameCount();
+
 	// Remember last-used texture to avoid unnecesssary bind calls.
 	LLImageGL *last_bound_texture = NULL;
 
+	// All glyphs go out as one batch, broken only by texture changes.
+	gGL.begin(LLRender::QUADS);
+
 	for (i = begin_offset; i < begin_offset + length; i++)
 	{
 		llwchar wch = wstr[i];
@@ -576,59 +598,46 @@ S32 LLFontGL::render(const LLWString &wstr,
 		}
 		else
 		{
-			if (!hasGlyph(wch))
+			const glyph_quad_t* quad = &scratch_quad;
+			if (run)
 			{
-				addChar(wch);
+				quad = &((*run)[i - begin_offset]);
 			}
-
-			const LLFontGlyphInfo* fgi= getGlyphInfo(wch);
-			if (!fgi)
+			else if (!layoutGlyph(wstr.c_str(), i, scratch_quad))
 			{
-				llerrs << "Missing Glyph Info" << llendl;
 				break;
 			}
+
 			// Per-glyph bitmap texture.
-			LLImageGL *image_gl = mFontBitmapCachep->getImageGL(fgi->mBitmapNum);
+			LLImageGL *image_gl = mFontBitmapCachep->getImageGL(quad->mBitmapNum);
 			if (last_bound_texture != image_gl)
 			{
 				gGL.getTexUnit(0)->bind(image_gl);
 				last_bound_texture = image_gl;
 			}
+			mFontBitmapCachep->touch(quad->mBitmapNum, frame);
 
-			if ((start_x + scaled_max_pixels) < (cur_x + fgi->mXBearing + fgi->mWidth))
+			if ((start_x + scaled_max_pixels) < (cur_x + quad->mXBearing + quad->mWidth))
 			{
 				// Not enough room for this character.
 				break;
 			}
 
 			// Draw the text at the appropriate location
-			//Specify vertices and texture coordinates
-			LLRectf uv_rect((fgi->mXBitmapOffset) * inv_width,
-					(fgi->mYBitmapOffset + fgi->mHeight + PAD_UVY) * inv_height,
-					(fgi->mXBitmapOffset + fgi->mWidth) * inv_width,
-					(fgi->mYBitmapOffset - PAD_UVY) * inv_height);
 			// snap glyph origin to whole screen pixel
-			LLRectf screen_rect(llround(cur_render_x + (F32)fgi->mXBearing),
-					    llround(cur_render_y + (F32)fgi->mYBearing),
-					    llround(cur_render_x + (F32)fgi->mXBearing) + (F32)fgi->mWidth,
-					    llround(cur_render_y + (F32)fgi->mYBearing) - (F32)fgi->mHeight);
+			LLRectf screen_rect(llround(cur_render_x + (F32)quad->mXBearing),
+					    llround(cur_render_y + (F32)quad->mYBearing),
+					    llround(cur_render_x + (F32)quad->mXBearing) + (F32)quad->mWidth,
+					    llround(cur_render_y + (F32)quad->mYBearing) - (F32)quad->mHeight);
 			
-			drawGlyph(screen_rect, uv_rect, color, style, drop_shadow_strength);
+			drawGlyph(screen_rect, quad->mUVRect, color, style, drop_shadow_strength);
 
 			chars_drawn++;
-			cur_x += fgi->mXAdvance;
-			cur_y += fgi->mYAdvance;
+			cur_x += quad->mXAdvance;
+			cur_y += quad->mYAdvance;
 
-			llwchar next_char = wstr[i+1];
-			if (next_char && (next_char < LAST_CHARACTER))
-			{
-				// Kern this puppy.
-				if (!hasGlyph(next_char))
-				{
-					addChar(next_char);
-				}
-				cur_x += getXKerning(wch, next_char);
-			}
+			// Kern this puppy.
+			cur_x += quad->mKerning;
 
 			// Round after kerning.
 			// Must do this to cur_x, not just to cur_render_x, otherwise you
@@ -642,6 +651,8 @@ S32 LLFontGL::render(const LLWString &wstr,
 		}
 	}
 
+	gGL.end();
+
 	if (right_x)
 	{
 		*right_x = cur_x / sScaleX;
@@ -682,6 +693,93 @@ S32 LLFontGL::render(const LLWString &wstr,
 	return chars_drawn;
 }
 
+BOOL LLFontGL::layoutGlyph(const llwchar* wchars, S32 i, glyph_quad_t& quad) const
+{
+	const S32 LAST_CHARACTER = LLFont::LAST_CHAR_FULL;
+
+	llwchar wch = wchars[i];
+	if (!hasGlyph(wch))
+	{
+		addChar(wch);
+	}
+
+	const LLFontGlyphInfo* fgi= getGlyphInfo(wch);
+	if (!fgi)
+	{
+		llerrs << "Missing Glyph Info" << llendl;
+		return FALSE;
+	}
+	// Adding the kerning glyph below may recycle a bitmap, so claim ours
+	// for this frame first.
+	mFontBitmapCachep->touch(fgi->mBitmapNum, LLFrameTimer::getFrameCount());
+
+	F32 inv_width = 1.f / mFontBitmapCachep->getBitmapWidth();
+	F32 inv_height = 1.f / mFontBitmapCachep->getBitmapHeight();
+
+	//Specify vertices and texture coordinates
+	quad.mUVRect = LLRectf((fgi->mXBitmapOffset) * inv_width,
+				(fgi->mYBitmapOffset + fgi->mHeight + PAD_UVY) * inv_height,
+				(fgi->mXBitmapOffset + fgi->mWidth) * inv_width,
+				(fgi->mYBitmapOffset - PAD_UVY) * inv_height);
+	quad.mBitmapNum = fgi->mBitmapNum;
+	quad.mXBearing = fgi->mXBearing;
+	quad.mYBearing = fgi->mYBearing;
+	quad.mWidth = fgi->mWidth;
+	quad.mHeight = fgi->mHeight;
+	quad.mXAdvance = fgi->mXAdvance;
+	quad.mYAdvance = fgi->mYAdvance;
+	quad.mKerning = 0.f;
+
+	llwchar next_char = wchars[i+1];
+	if (next_char && (next_char < LAST_CHARACTER))
+	{
+		if (!hasGlyph(next_char))
+		{
+			addChar(next_char);
+		}
+		quad.mKerning = getXKerning(wch, next_char);
+	}
+	return TRUE;
+}
+
+const LLFontGL::glyph_run_t* LLFontGL::getGlyphRun(const LLWString& wstr, S32 begin_offset, S32 length) const
+{
+	validateRunCaches();
+
+	LLWString key = wstr.substr(begin_offset, length);
+	// The last glyph kerns against whatever follows the run.
+	key += (begin_offset + length < (S32)wstr.length()) ? wstr[begin_offset + length] : 0;
+
+	glyph_run_t* runp = mRunCache.find(key);
+	if (runp)
+	{
+		return runp;
+	}
+
+	glyph_run_t run(length);
+	for (S32 i = 0; i < length; i++)
+	{
+		if (!layoutGlyph(key.c_str(), i, run[i]))
+		{
+			return NULL;
+		}
+	}
+
+	// Adding these glyphs may have pushed others out of the bitmaps, but
+	// not any of ours, which were all drawn from this frame.  Drop the
+	// runs that went stale before remembering this one.
+	validateRunCaches();
+	return &mRunCache.insert(key, run);
+}
+
+void LLFontGL::validateRunCaches() const
+{
+	if (mRunCacheGeneration != mGlyphGeneration)
+	{
+		mRunCache.clear();
+		mRunCacheGeneration = mGlyphGeneration;
+	}
+}
 
 S32 LLFontGL::getWidth(const std::string& utf8text) const
 {
@@ -732,6 +830,31 @@ F32 LLFontGL::getWidthF32(const llwchar* wchars, const S32 begin_offset, const S
 
 	const S32 LAST_CHARACTER = LLFont::LAST_CHAR_FULL;
 
+	// Widths of short whole strings are remembered, since layout code
+	// asks for the same ones every frame.  Prefixes are not: wrapping and
+	// cursor code measure every prefix of a line once, and caching those
+	// would only push the whole strings out.
+	LLWString key;
+	BOOL cacheable = (begin_offset == 0) && (!use_embedded || mEmbeddedChars.empty());
+	if (cacheable)
+	{
+		S32 len = 0;
+		while (len <= MAX_CACHED_RUN_LENGTH && wchars[len] != 0)
+		{
+			len++;
+		}
+		cacheable = (len <= MAX_CACHED_RUN_LENGTH) && (wchars[len] == 0) && (len <= max_chars);
+		if (cacheable)
+		{
+			key.assign(wchars, len);
+			F32* widthp = mWidthCache.find(key);
+			if (widthp)
+			{
+				return (*widthp == 0) ? 0 : *widthp / sScaleX;
+			}
+		}
+	}
+
 	F32 cur_x = 0;
 	const S32 max_index = begin_offset + max_chars;
 	for (S32 i = begin_offset; i < max_index && wchars[i] != 0; i++)
@@ -765,6 +888,11 @@ F32 LLFontGL::getWidthF32(const llwchar* wchars, const S32 begin_offset, const S
 		cur_x = (F32)llfloor(cur_x + 0.5f);
 	}
 
+	if (cacheable)
+	{
+		mWidthCache.insert(key, cur_x);
+	}
+
 	if (cur_x == 0)
 	{
 		return cur_x;
@@ -1119,7 +1247,7 @@ void LLFontGL::drawGlyph(const LLRectf& screen_rect, const LLRectf& uv_rect, con
 	F32 slant_offset;
 	slant_offset = ((style & ITALIC) ? ( -mAscender * 0.2f) : 0.f);
 
-	gGL.begin(LLRender::QUADS);
+	// The caller brackets whole runs of glyphs with gGL.begin(QUADS)/end().
 	{
 		//FIXME: bold and drop shadow are mutually exclusive only for convenience
 		//Allow both when we need them.
@@ -1185,7 +1313,6 @@ void LLFontGL::drawGlyph(const LLRectf& screen_rect, const LLRectf& uv_rect, con
 		}
 
 	}
-	gGL.end();
 }
 
 std::string LLFontGL::nameFromFont(const LLFontGL* fontp)
@@ -39,6 +39,7 @@
 #include "v2math.h"
 #include "llcoord.h"
 #include "llrect.h"
+#include "lllrucache.h"
 
 #include "llfontregistry.h"
 
@@ -222,6 +223,28 @@ protected:
 	void renderQuad(const LLRectf& screen_rect, const LLRectf& uv_rect, F32 slant_amt) const;
 	void drawGlyph(const LLRectf& screen_rect, const LLRectf& uv_rect, const LLColor4& color, U8 style, F32 drop_shadow_fade) const;
 
+	// Placement of one glyph, relative to the pen position.
+	struct glyph_quad_t
+	{
+		LLRectf mUVRect;
+		S32 mBitmapNum;
+		S32 mXBearing;
+		S32 mYBearing;
+		S32 mWidth;
+		S32 mHeight;
+		F32 mXAdvance;
+		F32 mYAdvance;
+		F32 mKerning;		// against the following character
+	};
+	// A run of text laid out once and replayed on later frames.  Style
+	// only changes how the quads are drawn, so runs are keyed on the
+	// text alone (plus the character after it, for kerning).
+	typedef std::vector<glyph_quad_t> glyph_run_t;
+
+	BOOL layoutGlyph(const llwchar* wchars, S32 i, glyph_quad_t& quad) const;
+	const glyph_run_t* getGlyphRun(const LLWString& wstr, S32 begin_offset, S32 length) const;
+	void validateRunCaches() const;
+
 public:
 	static F32 sVertDPI;
 	static F32 sHorizDPI;
@@ -250,6 +273,10 @@ protected:
 protected:
 	typedef std::map<llwchar,embedded_data_t*> embedded_map_t;
 	mutable embedded_map_t mEmbeddedChars;
+
+	mutable LLLRUCache<LLWString, glyph_run_t> mRunCache;
+	mutable LLLRUCache<LLWString, F32> mWidthCache;
+	mutable U32 mRunCacheGeneration;
 	
 	LLFontDescriptor mFontDesc;
 
@@ -678,6 +678,7 @@ void LLTexUnit::debugTextureUnit(void)
 
 LLRender::LLRender()
 : mDirty(false), mCount(0), mMode(LLRender::TRIANGLES),
+	mAccumulateAlpha(false),
 	mMaxAnisotropy(0.f) 
 {
 	mBuffer = new LLVertexBuffer(immediate_mask, 0);
@@ -782,31 +783,49 @@ void LLRender::setColorMask(bool writeColorR, bool writeColorG, bool writeColorB
 				writeAlpha ? GL_TRUE : GL_FALSE);
 }
 
+void LLRender::setAccumulateAlpha(bool accumulate)
+{
+	flush();
+	mAccumulateAlpha = accumulate;
+}
+
+void LLRender::applyBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (mAccumulateAlpha)
+	{
+		glBlendFuncSeparateEXT(sfactor, dfactor, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	else
+	{
+		glBlendFunc(sfactor, dfactor);
+	}
+}
+
 void LLRender::setSceneBlendType(eBlendType type)
 {
 	flush();
 	switch (type) 
 	{
 		case BT_ALPHA:
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			applyBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			break;
 		case BT_ADD:
-			glBlendFunc(GL_ONE, GL_ONE);
+			applyBlendFunc(GL_ONE, GL_ONE);
 			break;
 		case BT_ADD_WITH_ALPHA:
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+			applyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 			break;
 		case BT_MULT:
-			glBlendFunc(GL_DST_COLOR, GL_ZERO);
+			applyBlendFunc(GL_DST_COLOR, GL_ZERO);
 			break;
 		case BT_MULT_ALPHA:
-			glBlendFunc(GL_DST_ALPHA, GL_ZERO);
+			applyBlendFunc(GL_DST_ALPHA, GL_ZERO);
 			break;
 		case BT_MULT_X2:
-			glBlendFunc(GL_DST_COLOR, GL_SRC_COLOR);
+			applyBlendFunc(GL_DST_COLOR, GL_SRC_COLOR);
 			break;
 		case BT_REPLACE:
-			glBlendFunc(GL_ONE, GL_ZERO);
+			applyBlendFunc(GL_ONE, GL_ZERO);
 			break;
 		default:
 			llerrs << "Unknown Scene Blend Type: " << type << llendl;
@@ -833,7 +852,7 @@ void LLRender::setAlphaRejectSettings(eCompareFunc func, F32 value)
 void LLRender::blendFunc(eBlendFactor sfactor, eBlendFactor dfactor)
 {
 	flush();
-	glBlendFunc(sGLBlendFactor[sfactor], sGLBlendFactor[dfactor]);
+	applyBlendFunc(sGLBlendFactor[sfactor], sGLBlendFactor[dfactor]);
 }
 
 LLTexUnit* LLRender::getTexUnit(U32 index)
@@ -953,8 +972,11 @@ void LLRender::flush()
 		}
 #endif
 				
-		mBuffer->setBuffer(immediate_mask);
-		mBuffer->drawArrays(mMode, 0, mCount);
+		if (!mBuffer->drawArraysStreamed(mMode, mCount, immediate_mask))
+		{
+			mBuffer->setBuffer(immediate_mask);
+			mBuffer->drawArrays(mMode, 0, mCount);
+		}
 		
 		mVerticesp[0] = mVerticesp[mCount];
 		mTexcoordsp[0] = mTexcoordsp[mCount];
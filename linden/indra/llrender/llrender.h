@@ -309,6 +309,13 @@ public:
 	void setColorMask(bool writeColorR, bool writeColorG, bool writeColorB, bool writeAlpha);
 	void setSceneBlendType(eBlendType type);
 
+	// While set, every blend function blends color as asked but adds
+	// source coverage to the destination alpha (src + dst * (1 - src_alpha)),
+	// so offscreen UI rendered in one pass can itself be blended onto the
+	// screen later.  Needs gGLManager.mHasBlendFuncSeparate.
+	void setAccumulateAlpha(bool accumulate);
+	bool getAccumulateAlpha() const { return mAccumulateAlpha; }
+
 	void setAlphaRejectSettings(eCompareFunc func, F32 value = 0.01f);
 
 	void blendFunc(eBlendFactor sfactor, eBlendFactor dfactor);
@@ -333,11 +340,14 @@ public:
 public:
 
 private:
+	void applyBlendFunc(GLenum sfactor, GLenum dfactor);
+
 	bool				mDirty;
 	U32				mCount;
 	U32				mMode;
 	U32				mCurrTextureUnitIndex;
 	bool				mCurrColorMask[4];
+	bool				mAccumulateAlpha;
 	eCompareFunc			mCurrAlphaFunc;
 	F32				mCurrAlphaFuncVal;
 
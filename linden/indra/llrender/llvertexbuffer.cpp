@@ -63,6 +63,17 @@ BOOL LLVertexBuffer::sIBOActive = FALSE;
 U32 LLVertexBuffer::sAllocatedBytes = 0;
 BOOL LLVertexBuffer::sMapped = FALSE;
 
+BOOL LLVertexBuffer::sUseStreamRing = TRUE;
+U32 LLVertexBuffer::sStreamRingBuffer = 0;
+U32 LLVertexBuffer::sStreamRingOffset = 0;
+U32 LLVertexBuffer::sStreamedBytes = 0;
+U32 LLVertexBuffer::sStreamRingWraps = 0;
+U32 LLVertexBuffer::sLastStreamedBytes = 0;
+U32 LLVertexBuffer::sLastStreamRingWraps = 0;
+
+const U32 STREAM_RING_SIZE = 1024*1024;
+const U32 STREAM_RING_ALIGN = 32;
+
 std::vector<U32> LLVertexBuffer::sDeleteList;
 
 S32 LLVertexBuffer::sTypeOffsets[LLVertexBuffer::TYPE_MAX] =
@@ -282,6 +293,77 @@ void LLVertexBuffer::drawArrays(U32 mode, U32 first, U32 count) const
 	stop_glerror();
 }
 
+bool LLVertexBuffer::drawArraysStreamed(U32 mode, U32 count, U32 data_mask)
+{
+#if LL_DARWIN
+	//streaming through VBOs is generally ineffective on apple, see useVBOs()
+	const bool use_stream_ring = false;
+#else
+	const bool use_stream_ring = sUseStreamRing;
+#endif
+
+	if (!use_stream_ring || !sEnableVBOs || useVBOs() || !mMappedData)
+	{
+		return false;
+	}
+
+	U32 size = count*mStride;
+	if (count == 0 || size > STREAM_RING_SIZE)
+	{
+		return false;
+	}
+
+	if (count > (U32) mRequestedNumVerts)
+	{
+		llerrs << "Bad vertex buffer draw range: [0, " << count << "]" << llendl;
+	}
+
+	if (mode > LLRender::NUM_MODES)
+	{
+		llerrs << "Invalid draw mode: " << mode << llendl;
+		return false;
+	}
+
+	LLMemType mt(LLMemType::MTYPE_VERTEX_DATA);
+	stop_glerror();
+	if (!sStreamRingBuffer)
+	{
+		glGenBuffersARB(1, (GLuint*) &sStreamRingBuffer);
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, sStreamRingBuffer);
+		glBufferDataARB(GL_ARRAY_BUFFER_ARB, STREAM_RING_SIZE, NULL, GL_STREAM_DRAW_ARB);
+		sStreamRingOffset = 0;
+		sBindCount++;
+	}
+	else if (sStreamRingBuffer != sGLRenderBuffer || !sVBOActive)
+	{
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, sStreamRingBuffer);
+		sBindCount++;
+	}
+	sVBOActive = TRUE;
+	sGLRenderBuffer = sStreamRingBuffer;
+
+	if (sStreamRingOffset + size > STREAM_RING_SIZE)
+	{ //orphan instead of waiting for the GPU to finish with the front of the ring
+		glBufferDataARB(GL_ARRAY_BUFFER_ARB, STREAM_RING_SIZE, NULL, GL_STREAM_DRAW_ARB);
+		sStreamRingOffset = 0;
+		sStreamRingWraps++;
+	}
+
+	glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, sStreamRingOffset, size, mMappedData);
+	sStreamedBytes += size;
+
+	//the pointers change with every copy, so set them up every time
+	setupClientArrays(data_mask);
+	setupVertexPointers(data_mask, (U8*) NULL + sStreamRingOffset);
+	sSetCount++;
+
+	glDrawArrays(sGLMode[mode], 0, count);
+	stop_glerror();
+
+	sStreamRingOffset = (sStreamRingOffset + size + STREAM_RING_ALIGN - 1) & ~(STREAM_RING_ALIGN - 1);
+	return true;
+}
+
 //static
 void LLVertexBuffer::initClass(bool use_vbo)
 {
@@ -318,6 +400,13 @@ void LLVertexBuffer::cleanupClass()
 	LLMemType mt(LLMemType::MTYPE_VERTEX_DATA);
 	unbind();
 	clientCopy(); // deletes GL buffers
+
+	if (sStreamRingBuffer)
+	{
+		glDeleteBuffersARB(1, (GLuint*) &sStreamRingBuffer);
+		sStreamRingBuffer = 0;
+		sStreamRingOffset = 0;
+	}
 }
 
 void LLVertexBuffer::clientCopy(F64 max_time)
@@ -327,6 +416,12 @@ void LLVertexBuffer::clientCopy(F64 max_time)
 		glDeleteBuffersARB(sDeleteList.size(), (GLuint*) &(sDeleteList[0]));
 		sDeleteList.clear();
 	}
+
+	//called once a frame, keep last frame's stream totals for display
+	sLastStreamedBytes = sStreamedBytes;
+	sLastStreamRingWraps = sStreamRingWraps;
+	sStreamedBytes = 0;
+	sStreamRingWraps = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1121,10 +1216,14 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 
 // virtual (default)
 void LLVertexBuffer::setupVertexBuffer(U32 data_mask) const
+{
+	setupVertexPointers(data_mask, useVBOs() ? NULL : mMappedData);
+}
+
+void LLVertexBuffer::setupVertexPointers(U32 data_mask, U8* base) const
 {
 	LLMemType mt(LLMemType::MTYPE_VERTEX_DATA);
 	stop_glerror();
-	U8* base = useVBOs() ? NULL : mMappedData;
 	S32 stride = mStride;
 
 	if ((data_mask & mTypeMask) != data_mask)
@@ -132,6 +132,7 @@ protected:
 	virtual ~LLVertexBuffer(); // use unref()
 
 	virtual void setupVertexBuffer(U32 data_mask) const; // pure virtual, called from mapBuffer()
+	void	setupVertexPointers(U32 data_mask, U8* base) const;
 	
 	void	genBuffer();
 	void	genIndices();
@@ -199,6 +200,11 @@ public:
 
 	void draw(U32 mode, U32 count, U32 indices_offset) const;
 	void drawArrays(U32 mode, U32 offset, U32 count) const;
+
+	// Copy the first count vertices of this client memory buffer into the
+	// stream ring and draw them from there.  Returns false without drawing
+	// if the ring can't be used, caller should fall back to setBuffer()/drawArrays().
+	bool drawArraysStreamed(U32 mode, U32 count, U32 data_mask);
 	void drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
 
 protected:	
@@ -256,6 +262,17 @@ public:
 	static U32 sAllocatedBytes;
 	static U32 sBindCount;
 	static U32 sSetCount;
+
+	// Per-frame client memory geometry (immediate mode) is appended to one
+	// large stream VBO.  When it fills up the storage is orphaned and
+	// writing starts over at the front, draws still in flight keep the old copy.
+	static BOOL sUseStreamRing;
+	static U32 sStreamRingBuffer;
+	static U32 sStreamRingOffset;
+	static U32 sStreamedBytes;		// bytes copied into the ring this frame
+	static U32 sStreamRingWraps;	// times the ring was orphaned this frame
+	static U32 sLastStreamedBytes;	// totals of the last complete frame
+	static U32 sLastStreamRingWraps;
 };
 
 
@@ -412,6 +412,11 @@ void LLButton::draw()
 		S32 flash_count = S32(elapsed * LLUI::sConfigGroup->getF32("ButtonFlashRate") * 2.f);
 		// flash on or off?
 		flash = (flash_count % 2 == 0) || flash_count > S32((F32)LLUI::sConfigGroup->getS32("ButtonFlashCount") * 2.f);
+		if (flash_count <= S32((F32)LLUI::sConfigGroup->getS32("ButtonFlashCount") * 2.f))
+		{
+			// still blinking, keep a cached floater from freezing it
+			invalidate();
+		}
 	}
 
 	BOOL pressed_by_keyboard = FALSE;
@@ -750,6 +755,7 @@ void LLButton::setToggleState(BOOL b)
 	{
 		setControlValue(b); // will fire LLControlVariable callbacks (if any)
 		mToggleState = b; // may or may not be redundant
+		invalidate();
 	}
 }
 
@@ -759,6 +765,7 @@ void LLButton::setFlashing( BOOL b )
 	{
 		mFlashing = b; 
 		mFlashingTimer.reset();
+		invalidate();
 	}
 }
 
@@ -771,7 +778,12 @@ BOOL LLButton::toggleState()
 
 void LLButton::setValue(const LLSD& value )
 {
-	mToggleState = value.asBoolean();
+	BOOL toggle_state = value.asBoolean();
+	if (toggle_state != mToggleState)
+	{
+		mToggleState = toggle_state;
+		invalidate();
+	}
 }
 
 LLSD LLButton::getValue() const
@@ -790,32 +802,53 @@ BOOL LLButton::setLabelArg( const std::string& key, const LLStringExplicit& text
 {
 	mUnselectedLabel.setArg(key, text);
 	mSelectedLabel.setArg(key, text);
+	invalidate();
 	return TRUE;
 }
 
 void LLButton::setLabelUnselected( const LLStringExplicit& label )
 {
-	mUnselectedLabel = label;
+	if (mUnselectedLabel.getString() != label)
+	{
+		mUnselectedLabel = label;
+		invalidate();
+	}
 }
 
 void LLButton::setLabelSelected( const LLStringExplicit& label )
 {
-	mSelectedLabel = label;
+	if (mSelectedLabel.getString() != label)
+	{
+		mSelectedLabel = label;
+		invalidate();
+	}
 }
 
 void LLButton::setDisabledLabel( const LLStringExplicit& label )
 {
-	mDisabledLabel = label;
+	if (mDisabledLabel.getString() != label)
+	{
+		mDisabledLabel = label;
+		invalidate();
+	}
 }
 
 void LLButton::setDisabledSelectedLabel( const LLStringExplicit& label )
 {
-	mDisabledSelectedLabel = label;
+	if (mDisabledSelectedLabel.getString() != label)
+	{
+		mDisabledSelectedLabel = label;
+		invalidate();
+	}
 }
 
 void LLButton::setImageUnselected(LLPointer<LLUIImage> image)
 {
-	mImageUnselected = image;
+	if (mImageUnselected != image)
+	{
+		mImageUnselected = image;
+		invalidate();
+	}
 }
 
 void LLButton::setImages( const std::string &image_name, const std::string &selected_name )
@@ -827,12 +860,20 @@ void LLButton::setImages( const std::string &image_name, const std::string &sele
 
 void LLButton::setImageSelected(LLPointer<LLUIImage> image)
 {
-	mImageSelected = image;
+	if (mImageSelected != image)
+	{
+		mImageSelected = image;
+		invalidate();
+	}
 }
 
 void LLButton::setImageColor(const LLColor4& c)		
 { 
-	mImageColor = c; 
+	if (mImageColor != c)
+	{
+		mImageColor = c; 
+		invalidate();
+	}
 }
 
 void LLButton::setColor(const LLColor4& color)
@@ -846,6 +887,7 @@ void LLButton::setImageDisabled(LLPointer<LLUIImage> image)
 	mImageDisabled = image;
 	mDisabledImageColor = mImageColor;
 	mDisabledImageColor.mV[VALPHA] *= 0.5f;
+	invalidate();
 }
 
 void LLButton::setImageDisabledSelected(LLPointer<LLUIImage> image)
@@ -853,6 +895,7 @@ void LLButton::setImageDisabledSelected(LLPointer<LLUIImage> image)
 	mImageDisabledSelected = image;
 	mDisabledImageColor = mImageColor;
 	mDisabledImageColor.mV[VALPHA] *= 0.5f;
+	invalidate();
 }
 
 void LLButton::setDisabledImages( const std::string &image_name, const std::string &selected_name, const LLColor4& c )
@@ -864,7 +907,11 @@ void LLButton::setDisabledImages( const std::string &image_name, const std::stri
 
 void LLButton::setImageHoverSelected(LLPointer<LLUIImage> image)
 {
-	mImageHoverSelected = image;
+	if (mImageHoverSelected != image)
+	{
+		mImageHoverSelected = image;
+		invalidate();
+	}
 }
 
 void LLButton::setDisabledImages( const std::string &image_name, const std::string &selected_name)
@@ -876,7 +923,11 @@ void LLButton::setDisabledImages( const std::string &image_name, const std::stri
 
 void LLButton::setImageHoverUnselected(LLPointer<LLUIImage> image)
 {
-	mImageHoverUnselected = image;
+	if (mImageHoverUnselected != image)
+	{
+		mImageHoverUnselected = image;
+		invalidate();
+	}
 }
 
 void LLButton::setHoverImages( const std::string& image_name, const std::string& selected_name )
@@ -887,6 +938,10 @@ void LLButton::setHoverImages( const std::string& image_name, const std::string&
 
 void LLButton::setImageOverlay(const std::string& image_name, LLFontGL::HAlign alignment, const LLColor4& color)
 {
+	LLPointer<LLUIImage> old_image = mImageOverlay;
+	LLFontGL::HAlign old_alignment = mImageOverlayAlignment;
+	LLColor4 old_color = mImageOverlayColor;
+
 	if (image_name.empty())
 	{
 		mImageOverlay = NULL;
@@ -897,6 +952,13 @@ void LLButton::setImageOverlay(const std::string& image_name, LLFontGL::HAlign a
 		mImageOverlayAlignment = alignment;
 		mImageOverlayColor = color;
 	}
+
+	if (mImageOverlay != old_image
+		|| mImageOverlayAlignment != old_alignment
+		|| mImageOverlayColor != old_color)
+	{
+		invalidate();
+	}
 }
 
 
@@ -102,8 +102,8 @@ public:
 	// LLCheckBoxCtrl interface
 	virtual BOOL		toggle()				{ return mButton->toggleState(); }		// returns new state
 
-	void				setEnabledColor( const LLColor4 &color ) { mTextEnabledColor = color; }
-	void				setDisabledColor( const LLColor4 &color ) { mTextDisabledColor = color; }
+	void				setEnabledColor( const LLColor4 &color ) { if (mTextEnabledColor != color) { mTextEnabledColor = color; invalidate(); } }
+	void				setDisabledColor( const LLColor4 &color ) { if (mTextDisabledColor != color) { mTextDisabledColor = color; invalidate(); } }
 
 	void				setLabel( const LLStringExplicit& label );
 	std::string			getLabel() const;
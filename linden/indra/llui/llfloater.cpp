@@ -55,12 +55,18 @@
 #include "llstl.h"
 #include "llcontrol.h"
 #include "lltabcontainer.h"
+#include "llrendertarget.h"
 #include "v2math.h"
 
 const S32 MINIMIZED_WIDTH = 160;
 const S32 CLOSE_BOX_FROM_TOP = 1;
 // use this to control "jumping" behavior when Ctrl-Tabbing
 const S32 TABBED_FLOATER_OFFSET = 0;
+// room around a retained floater for its drop shadow and border
+const S32 RETAINED_MARGIN = 8;
+// floaters invalidated this many frames running are drawn directly
+const S32 RETAINED_CHURN_LIMIT = 4;
+const F32 INVALIDATION_FLASH_TIME = 0.5f;
 
 std::string	LLFloater::sButtonActiveImageNames[BUTTON_COUNT] = 
 {
@@ -123,6 +129,10 @@ LLFloater::click_callback LLFloater::sButtonCallbacks[BUTTON_COUNT] =
 LLMultiFloater* LLFloater::sHostp = NULL;
 BOOL			LLFloater::sEditModeEnabled;
 LLFloater::handle_map_t	LLFloater::sFloaterMap;
+BOOL			LLFloater::sRetainedMode = FALSE;
+F32				LLFloater::sRetainedMaxAge = 1.f;
+BOOL			LLFloater::sShowInvalidations = FALSE;
+LLFloater::invalidation_list_t LLFloater::sInvalidations;
 
 LLFloaterView* gFloaterView = NULL;
 
@@ -463,6 +473,8 @@ LLFloater::~LLFloater()
 
 	sFloaterMap.erase(mHandle);
 
+	releaseRetainedTarget();
+
 	delete mDragHandle;
 	for (S32 i = 0; i < 4; i++) 
 	{
@@ -482,6 +494,9 @@ void LLFloater::setVisible( BOOL visible )
 
 	if( !visible )
 	{
+		// don't hold on to video memory for hidden floaters
+		releaseRetainedTarget();
+
 		if( gFocusMgr.childIsTopCtrl( this ) )
 		{
 			gFocusMgr.setTopCtrl(NULL);
@@ -1413,6 +1428,60 @@ void LLFloater::onClickClose( void* userdata )
 
 // virtual
 void LLFloater::draw()
+{
+	LLPanel::updateDefaultBtn();
+
+	if( getDefaultButton() )
+	{
+		if (hasFocus() && getDefaultButton()->getEnabled())
+		{
+			LLUICtrl* focus_ctrl = gFocusMgr.getKeyboardFocus();
+			// is this button a direct descendent and not a nested widget (e.g. checkbox)?
+			BOOL focus_is_child_button = dynamic_cast<LLButton*>(focus_ctrl) != NULL && focus_ctrl->getParent() == this;
+			// only enable default button when current focus is not a button
+			getDefaultButton()->setBorderEnabled(!focus_is_child_button);
+		}
+		else
+		{
+			getDefaultButton()->setBorderEnabled(FALSE);
+		}
+	}
+
+	if (canDrawRetained())
+	{
+		drawRetained();
+	}
+	else
+	{
+		if (!sRetainedMode)
+		{
+			releaseRetainedTarget();
+		}
+		else if (mRetained.mChurn >= RETAINED_CHURN_LIMIT && mRetained.mDirtyRect.isNull())
+		{
+			// Quiet since last frame, try caching again.
+			mRetained.mChurn = 0;
+		}
+		mRetained.mDirtyRect = LLRect::null;
+		mRetained.mLive = TRUE;
+		U32 live_views = LLView::sLiveViewsDrawn;
+		drawFloater();
+		mRetained.mHasLiveView = LLView::sLiveViewsDrawn != live_views;
+	}
+
+	// update tearoff button for torn off floaters
+	// when last host goes away
+	if (mCanTearOff && !getHost())
+	{
+		LLFloater* old_host = mLastHostHandle.get();
+		if (!old_host)
+		{
+			setCanTearOff(FALSE);
+		}
+	}
+}
+
+void LLFloater::drawFloater()
 {
 	// draw background
 	if( isBackgroundVisible() )
@@ -1453,23 +1522,6 @@ void LLFloater::draw()
 		}
 	}
 
-	LLPanel::updateDefaultBtn();
-
-	if( getDefaultButton() )
-	{
-		if (hasFocus() && getDefaultButton()->getEnabled())
-		{
-			LLUICtrl* focus_ctrl = gFocusMgr.getKeyboardFocus();
-			// is this button a direct descendent and not a nested widget (e.g. checkbox)?
-			BOOL focus_is_child_button = dynamic_cast<LLButton*>(focus_ctrl) != NULL && focus_ctrl->getParent() == this;
-			// only enable default button when current focus is not a button
-			getDefaultButton()->setBorderEnabled(!focus_is_child_button);
-		}
-		else
-		{
-			getDefaultButton()->setBorderEnabled(FALSE);
-		}
-	}
 	if (isMinimized())
 	{
 		for (S32 i = 0; i < BUTTON_COUNT; i++)
@@ -1508,15 +1560,238 @@ void LLFloater::draw()
 		gl_rect_2d_offset_local(0, getRect().getHeight() + 1, getRect().getWidth() + 1, 0, outlineColor, -LLPANEL_BORDER_WIDTH, FALSE);
 		LLUI::setLineWidth(1.f);
 	}
+}
 
-	// update tearoff button for torn off floaters
-	// when last host goes away
-	if (mCanTearOff && !getHost())
+// virtual
+void LLFloater::invalidateRect(const LLRect& local_rect)
+{
+	if (mRetained.mDirtyRect.isNull())
 	{
-		LLFloater* old_host = mLastHostHandle.get();
-		if (!old_host)
+		mRetained.mDirtyRect = local_rect;
+	}
+	else
+	{
+		mRetained.mDirtyRect.unionWith(local_rect);
+	}
+	// hosted floaters also dirty their host
+	LLPanel::invalidateRect(local_rect);
+}
+
+BOOL LLFloater::canDrawRetained()
+{
+	if (!sRetainedMode
+		|| !gGLManager.mHasFramebufferObject
+		|| !gGLManager.mHasBlendFuncSeparate
+		|| getParent() != gFloaterView
+		|| getDrawsLive()
+		|| mRetained.mHasLiveView
+		|| LLView::sDebugRects
+		|| LLView::sEditingUI
+		|| getRect().getWidth() <= 0
+		|| getRect().getHeight() <= 0
+		|| mRetained.mChurn >= RETAINED_CHURN_LIMIT)
+	{
+		return FALSE;
+	}
+
+	// Whatever the user is interacting with is drawn directly, so
+	// hover highlights, cursors and drags need no invalidation.
+	if (gFocusMgr.childHasKeyboardFocus(this) || gFocusMgr.childHasMouseCapture(this))
+	{
+		return FALSE;
+	}
+	S32 x, y;
+	LLUI::getCursorPositionLocal(this, &x, &y);
+	return !getLocalRect().pointInRect(x, y);
+}
+
+void LLFloater::drawRetained()
+{
+	LLRect cache_rect(-RETAINED_MARGIN, getRect().getHeight() + RETAINED_MARGIN,
+					  getRect().getWidth() + RETAINED_MARGIN, -RETAINED_MARGIN);
+	U32 res_x = (U32)llceil(cache_rect.getWidth() * LLUI::sGLScaleFactor.mV[VX]);
+	U32 res_y = (U32)llceil(cache_rect.getHeight() * LLUI::sGLScaleFactor.mV[VY]);
+
+	if (!mRetained.mTarget)
+	{
+		mRetained.mTarget = new LLRenderTarget();
+	}
+	if (mRetained.mTarget->getWidth() != res_x || mRetained.mTarget->getHeight() != res_y)
+	{
+		mRetained.mTarget->allocate(res_x, res_y, GL_RGBA, FALSE, FALSE, LLTexUnit::TT_RECT_TEXTURE, TRUE);
+		mRetained.mLive = TRUE;
+	}
+	if (mRetained.mLive || mRetained.mAge.getElapsedTimeF32() > sRetainedMaxAge)
+	{
+		mRetained.mDirtyRect = cache_rect;
+		mRetained.mLive = FALSE;
+	}
+
+	if (mRetained.mDirtyRect.notNull())
+	{
+		LLRect dirty_rect = mRetained.mDirtyRect;
+		dirty_rect.intersectWith(cache_rect);
+		if (dirty_rect == cache_rect)
 		{
-			setCanTearOff(FALSE);
+			mRetained.mAge.reset();
+		}
+
+		// Anything invalidated while drawing is picked up next frame.
+		mRetained.mDirtyRect = LLRect::null;
+		renderRetained(dirty_rect);
+		mRetained.mChurn++;
+
+		if (sShowInvalidations)
+		{
+			LLRect screen_rect;
+			localRectToScreen(dirty_rect, &screen_rect);
+			sInvalidations.push_back(std::make_pair(screen_rect, (F32)LLFrameTimer::getElapsedSeconds()));
+		}
+	}
+	else
+	{
+		mRetained.mChurn = 0;
+	}
+
+	// Composite the cached image, which holds premultiplied color.
+	F32 width = (F32)res_x / LLUI::sGLScaleFactor.mV[VX];
+	F32 height = (F32)res_y / LLUI::sGLScaleFactor.mV[VY];
+	F32 left = (F32)cache_rect.mLeft;
+	F32 bottom = (F32)cache_rect.mBottom;
+
+	gGL.getTexUnit(0)->bind(mRetained.mTarget);
+	gGL.blendFunc(LLRender::BF_ONE, LLRender::BF_ONE_MINUS_SOURCE_ALPHA);
+	gGL.color4f(1.f, 1.f, 1.f, 1.f);
+	gGL.begin(LLRender::QUADS);
+	{
+		gGL.texCoord2f(0.f, (F32)res_y);
+		gGL.vertex2f(left, bottom + height);
+		gGL.texCoord2f(0.f, 0.f);
+		gGL.vertex2f(left, bottom);
+		gGL.texCoord2f((F32)res_x, 0.f);
+		gGL.vertex2f(left + width, bottom);
+		gGL.texCoord2f((F32)res_x, (F32)res_y);
+		gGL.vertex2f(left + width, bottom + height);
+	}
+	gGL.end();
+	gGL.flush();
+	gGL.getTexUnit(0)->unbind(LLTexUnit::TT_RECT_TEXTURE);
+	gGL.setSceneBlendType(LLRender::BT_ALPHA);
+}
+
+void LLFloater::renderRetained(const LLRect& dirty_rect)
+{
+	gGL.flush();
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLfloat clear_color[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_color);
+
+	// Draw against a clean clip stack and transform, with the target's
+	// lower left corner at (-RETAINED_MARGIN, -RETAINED_MARGIN).
+	std::stack<LLRect> saved_clip_stack;
+	LLScreenClipRect::swapClipStack(saved_clip_stack);
+
+	mRetained.mTarget->bindTarget();
+
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0.0f, (F32)mRetained.mTarget->getWidth(), 0.0f, (F32)mRetained.mTarget->getHeight(), -1.0f, 1.0f);
+	glMatrixMode(GL_MODELVIEW);
+	LLUI::pushMatrix();
+	LLUI::loadIdentity();
+	gGL.scalef(LLUI::sGLScaleFactor.mV[VX], LLUI::sGLScaleFactor.mV[VY], 1.f);
+	LLUI::translate((F32)RETAINED_MARGIN, (F32)RETAINED_MARGIN, 0.f);
+	{
+		LLLocalClipRect dirty_clip(dirty_rect);
+
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// One pass: color blends as usual, which leaves it premultiplied,
+		// while alpha accumulates coverage, since ordinary blending would
+		// square it.  Drawing once keeps the children's draw() side effects
+		// to one per refresh.
+		gGL.setAccumulateAlpha(true);
+		gGL.setSceneBlendType(LLRender::BT_ALPHA);
+		U32 live_views = LLView::sLiveViewsDrawn;
+		drawFloater();
+		mRetained.mHasLiveView = LLView::sLiveViewsDrawn != live_views;
+		gGL.setAccumulateAlpha(false);
+		gGL.setSceneBlendType(LLRender::BT_ALPHA);
+	}
+	LLUI::popMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+
+	mRetained.mTarget->flush();
+
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+	LLScreenClipRect::swapClipStack(saved_clip_stack);
+}
+
+void LLFloater::releaseRetainedTarget()
+{
+	delete mRetained.mTarget;
+	mRetained.mTarget = NULL;
+	mRetained.mLive = TRUE;
+}
+
+// static
+void LLFloater::setRetainedMode(BOOL retained, F32 max_age)
+{
+	sRetainedMode = retained;
+	sRetainedMaxAge = max_age;
+}
+
+// static
+void LLFloater::releaseRetainedTargets()
+{
+	for (handle_map_iter_t it = sFloaterMap.begin(); it != sFloaterMap.end(); ++it)
+	{
+		it->second->releaseRetainedTarget();
+	}
+}
+
+// static
+void LLFloater::drawInvalidations()
+{
+	if (!sShowInvalidations)
+	{
+		sInvalidations.clear();
+		return;
+	}
+
+	F32 now = (F32)LLFrameTimer::getElapsedSeconds();
+	while (!sInvalidations.empty() && now - sInvalidations.front().second > INVALIDATION_FLASH_TIME)
+	{
+		sInvalidations.pop_front();
+	}
+
+	gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+	for (invalidation_list_t::iterator it = sInvalidations.begin(); it != sInvalidations.end(); ++it)
+	{
+		F32 alpha = 1.f - (now - it->second) / INVALIDATION_FLASH_TIME;
+		gl_rect_2d(it->first, LLColor4(1.f, 0.f, 0.f, 0.25f * alpha), TRUE);
+		gl_rect_2d(it->first, LLColor4(1.f, 0.f, 0.f, alpha), FALSE);
+	}
+
+	// outline the floaters that are drawn directly
+	if (gFloaterView)
+	{
+		for (child_list_const_iter_t child_it = gFloaterView->getChildList()->begin();
+			 child_it != gFloaterView->getChildList()->end(); ++child_it)
+		{
+			LLView* viewp = *child_it;
+			LLFloater* floaterp = dynamic_cast<LLFloater*>(viewp);
+			if (floaterp && floaterp->getVisible() && floaterp->mRetained.mLive)
+			{
+				gl_rect_2d(floaterp->getScreenRect(), LLColor4(1.f, 1.f, 0.f, 0.8f), FALSE);
+			}
 		}
 	}
 }
@@ -2321,6 +2596,10 @@ void LLFloaterView::draw()
 {
 	refresh();
 
+	LLFloater::setRetainedMode(LLUI::sConfigGroup->getBOOL("UIRetainedFloaters"),
+							   LLUI::sConfigGroup->getF32("UIRetainedMaxAge"));
+	LLFloater::setShowInvalidations(LLUI::sConfigGroup->getBOOL("UIShowInvalidations"));
+
 	// hide focused floater if in cycle mode, so that it can be drawn on top
 	LLFloater* focused_floater = getFocusedFloater();
 
@@ -2341,6 +2620,9 @@ void LLFloaterView::draw()
 	{
 		LLView::draw();
 	}
+
+	// floater view is at the screen origin
+	LLFloater::drawInvalidations();
 }
 
 LLRect LLFloaterView::getSnapRect() const
@@ -41,8 +41,11 @@
 #include "lluuid.h"
 #include "lltabcontainer.h"
 #include "llnotifications.h"
+#include "llframetimer.h"
 #include <set>
 
+class LLRenderTarget;
+
 class LLDragHandle;
 class LLResizeHandle;
 class LLResizeBar;
@@ -199,6 +202,7 @@ public:
 	virtual BOOL	handleDoubleClick(S32 x, S32 y, MASK mask);
 	virtual BOOL	handleMiddleMouseDown(S32 x, S32 y, MASK mask);
 	virtual void	draw();
+	/*virtual*/ void invalidateRect(const LLRect& local_rect);
 
 	virtual void	onOpen() {}
 
@@ -247,6 +251,15 @@ public:
 	static BOOL		getEditModeEnabled() { return sEditModeEnabled; }
 	static LLMultiFloater*		getFloaterHost() {return sHostp; }
 
+	// Retained mode: top level floaters draw into an offscreen target that
+	// is refreshed only where they have been invalidated, and otherwise
+	// composited with a single quad.
+	static void		setRetainedMode(BOOL retained, F32 max_age);
+	static BOOL		getRetainedMode() { return sRetainedMode; }
+	static void		releaseRetainedTargets();	// call when GL goes away
+	static void		setShowInvalidations(BOOL show) { sShowInvalidations = show; }
+	static void		drawInvalidations();
+
 protected:
 
 	virtual void	bringToFront(S32 x, S32 y);
@@ -263,6 +276,11 @@ protected:
 private:
 	
 	void			setForeground(BOOL b);	// called only by floaterview
+	void			drawFloater();
+	BOOL			canDrawRetained();
+	void			drawRetained();
+	void			renderRetained(const LLRect& dirty_rect);
+	void			releaseRetainedTarget();
 	void			cleanupHandles(); // remove handles to dead floaters
 	void			createMinimizeButton();
 	void			updateButtons();
@@ -325,6 +343,25 @@ private:
 	
 	LLFloaterNotificationContext* mNotificationContext;
 	LLRootHandle<LLFloater>		mHandle;	
+
+	struct retained_state_t
+	{
+		retained_state_t() : mTarget(NULL), mLive(TRUE), mChurn(0), mHasLiveView(FALSE) {}
+
+		LLRenderTarget*	mTarget;
+		LLRect			mDirtyRect;	// local coordinates, null when clean
+		LLFrameTimer	mAge;		// since the last full refresh
+		BOOL			mLive;		// drawn directly last frame
+		S32				mChurn;		// consecutive frames that needed a refresh
+		BOOL			mHasLiveView;	// drew a view that is drawn live last time
+	};
+	retained_state_t mRetained;
+
+	static BOOL		sRetainedMode;
+	static F32		sRetainedMaxAge;
+	static BOOL		sShowInvalidations;
+	typedef std::list<std::pair<LLRect, F32> > invalidation_list_t;
+	static invalidation_list_t sInvalidations;	// screen rect, time refreshed
 };
 
 /////////////////////////////////////////////////////////////
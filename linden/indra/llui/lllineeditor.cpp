@@ -339,6 +339,7 @@ void LLLineEditor::setText(const LLStringExplicit &new_text)
 	mCurrentHistoryLine = mLineHistory.end() - 1;
 
 	mPrevText = mText;
+	invalidate();
 }
 
 
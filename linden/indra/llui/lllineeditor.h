@@ -140,7 +140,7 @@ public:
 	virtual BOOL	setTextArg( const std::string& key, const LLStringExplicit& text );
 	virtual BOOL	setLabelArg( const std::string& key, const LLStringExplicit& text );
 
-	void			setLabel(const LLStringExplicit &new_label) { mLabel = new_label; }
+	void			setLabel(const LLStringExplicit &new_label) { if (mLabel.getString() != new_label) { mLabel = new_label; invalidate(); } }
 	void			setText(const LLStringExplicit &new_text);
 
 	const std::string& getText() const		{ return mText.getString(); }
@@ -159,15 +159,15 @@ public:
 	void			setCommitOnFocusLost( BOOL b )	{ mCommitOnFocusLost = b; }
 	void			setRevertOnEsc( BOOL b )		{ mRevertOnEsc = b; }
 
-	void setCursorColor(const LLColor4& c)			{ mCursorColor = c; }
+	void setCursorColor(const LLColor4& c)			{ if (mCursorColor != c) { mCursorColor = c; invalidate(); } }
 	const LLColor4& getCursorColor() const			{ return mCursorColor; }
 
-	void setFgColor( const LLColor4& c )			{ mFgColor = c; }
-	void setReadOnlyFgColor( const LLColor4& c )	{ mReadOnlyFgColor = c; }
-	void setTentativeFgColor(const LLColor4& c)		{ mTentativeFgColor = c; }
-	void setWriteableBgColor( const LLColor4& c )	{ mWriteableBgColor = c; }
-	void setReadOnlyBgColor( const LLColor4& c )	{ mReadOnlyBgColor = c; }
-	void setFocusBgColor(const LLColor4& c)			{ mFocusBgColor = c; }
+	void setFgColor( const LLColor4& c )			{ if (mFgColor != c) { mFgColor = c; invalidate(); } }
+	void setReadOnlyFgColor( const LLColor4& c )	{ if (mReadOnlyFgColor != c) { mReadOnlyFgColor = c; invalidate(); } }
+	void setTentativeFgColor(const LLColor4& c)		{ if (mTentativeFgColor != c) { mTentativeFgColor = c; invalidate(); } }
+	void setWriteableBgColor( const LLColor4& c )	{ if (mWriteableBgColor != c) { mWriteableBgColor = c; invalidate(); } }
+	void setReadOnlyBgColor( const LLColor4& c )	{ if (mReadOnlyBgColor != c) { mReadOnlyBgColor = c; invalidate(); } }
+	void setFocusBgColor(const LLColor4& c)			{ if (mFocusBgColor != c) { mFocusBgColor = c; invalidate(); } }
 
 	const LLColor4& getFgColor() const			{ return mFgColor; }
 	const LLColor4& getReadOnlyFgColor() const	{ return mReadOnlyFgColor; }
@@ -158,6 +158,7 @@ void LLMultiSlider::setSliderValue(const std::string& name, F32 value, BOOL from
 	S32 x = left_edge + S32( t * (right_edge - left_edge) );
 	mThumbRects[name].mLeft = x - (MULTI_THUMB_WIDTH/2);
 	mThumbRects[name].mRight = x + (MULTI_THUMB_WIDTH/2);
+	invalidate();
 }
 
 void LLMultiSlider::setValue(const LLSD& value)
@@ -184,6 +185,7 @@ void LLMultiSlider::setCurSlider(const std::string& name)
 {
 	if(mValue.has(name)) {
 		mCurSlider = name;
+		invalidate();
 	}
 }
 
@@ -287,6 +289,7 @@ void LLMultiSlider::deleteSlider(const std::string& name)
 		mIt--;
 		mCurSlider = mIt->first;
 	}
+	invalidate();
 }
 
 void LLMultiSlider::clear()
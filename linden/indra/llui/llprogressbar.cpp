@@ -93,34 +93,45 @@ void LLProgressBar::draw()
 
 void LLProgressBar::setPercent(const F32 percent)
 {
-	mPercentDone = llclamp(percent, 0.f, 100.f);
+	F32 percent_done = llclamp(percent, 0.f, 100.f);
+	if (percent_done != mPercentDone)
+	{
+		mPercentDone = percent_done;
+		invalidate();
+	}
 }
 
 void LLProgressBar::setImageBar( const std::string &bar_name )
 {
 	mImageBar = LLUI::sImageProvider->getUIImage(bar_name)->getImage();
+	invalidate();
 }
 
 void LLProgressBar::setImageShadow(const std::string &shadow_name)
 {
 	mImageShadow = LLUI::sImageProvider->getUIImage(shadow_name)->getImage();
+	invalidate();
 }
 
 void LLProgressBar::setColorBar(const LLColor4 &c)
 {
 	mColorBar = c;
+	invalidate();
 }
 void LLProgressBar::setColorBar2(const LLColor4 &c)
 {
 	mColorBar2 = c;
+	invalidate();
 }
 void LLProgressBar::setColorShadow(const LLColor4 &c)
 {
 	mColorShadow = c;
+	invalidate();
 }
 void LLProgressBar::setColorBackground(const LLColor4 &c)
 {
 	mColorBackground = c;
+	invalidate();
 }
 
 
@@ -166,6 +166,12 @@ void LLScrollbar::setDocPos(S32 pos, BOOL update_thumb)
 		mDocPos = pos;
 		mDocChanged = TRUE;
 
+		// the view we scroll shows something else now
+		if (getParent())
+		{
+			getParent()->invalidate();
+		}
+
 		if( mChangeCallback )
 		{
 			mChangeCallback( mDocPos, this, mCallbackUserData );
@@ -215,6 +221,8 @@ BOOL LLScrollbar::isAtEnd()
 
 void LLScrollbar::updateThumbRect()
 {
+	invalidate();
+
 //	llassert( 0 <= mDocSize );
 //	llassert( 0 <= mDocPos && mDocPos <= getDocPosMax() );
 	
@@ -31,6 +31,7 @@
  */
 
 #include <algorithm>
+#include <set>
 
 #include "linden_common.h"
 #include "llstl.h"
@@ -62,12 +63,20 @@ static LLRegisterWidget<LLScrollListCtrl> r("scroll_list");
 // local structures & classes.
 struct SortScrollListItem
 {
-	SortScrollListItem(const std::vector<std::pair<S32, BOOL> >& sort_orders)
-	:	mSortOrders(sort_orders)
+	SortScrollListItem(const std::vector<std::pair<S32, BOOL> >& sort_orders, const LLScrollListDataSource* source = NULL)
+	:	mSortOrders(sort_orders),
+		mSource(source)
 	{}
 
 	bool operator()(const LLScrollListItem* i1, const LLScrollListItem* i2)
 	{
+		if (mSource)
+		{
+			// virtual rows sort on the source's text, whether built or not
+			return LLScrollListRowOrder(mSortOrders, *mSource)(static_cast<const LLScrollListVirtualItem*>(i1)->getRow(),
+															  static_cast<const LLScrollListVirtualItem*>(i2)->getRow());
+		}
+
 		// sort over all columns in order specified by mSortOrders
 		S32 sort_result = 0;
 		for (sort_order_t::const_reverse_iterator it = mSortOrders.rbegin();
@@ -94,6 +103,7 @@ struct SortScrollListItem
 
 	typedef std::vector<std::pair<S32, BOOL> > sort_order_t;
 	const sort_order_t& mSortOrders;
+	const LLScrollListDataSource* mSource;
 };
 
 
@@ -401,6 +411,12 @@ LLScrollListItem::~LLScrollListItem()
 	std::for_each(mColumns.begin(), mColumns.end(), DeletePointer());
 }
 
+void LLScrollListItem::clearColumns()
+{
+	std::for_each(mColumns.begin(), mColumns.end(), DeletePointer());
+	mColumns.clear();
+}
+
 void LLScrollListItem::setNumColumns(S32 columns)
 {
 	S32 prev_columns = mColumns.size();
@@ -597,6 +613,11 @@ LLScrollListCtrl::LLScrollListCtrl(const std::string& name, const LLRect& rect,
 	mTotalStaticColumnWidth(0),
 	mTotalColumnPadding(0),
 	mSorted(TRUE),
+	mSortedCount(0),
+	mDataSource(NULL),
+	mDataSourceRows(0),
+	mDrawFrame(0),
+	mNumMaterialized(0),
 	mDirty(FALSE),
 	mOriginalSelection(-1),
 	mDrewSelected(FALSE)
@@ -703,6 +724,9 @@ void LLScrollListCtrl::clearRows()
 	std::for_each(mItemList.begin(), mItemList.end(), DeletePointer());
 	mItemList.clear();
 	//mItemCount = 0;
+	mSortedCount = 0;
+	mDataSourceRows = 0;
+	mNumMaterialized = 0;
 
 	// Scroll the bar back up to the top.
 	mScrollbar->setDocParams(0, 0);
@@ -880,6 +904,12 @@ LLRect LLScrollListCtrl::getRequiredRect()
 
 BOOL LLScrollListCtrl::addItem( LLScrollListItem* item, EAddPosition pos, BOOL requires_column )
 {
+	if (mDataSource && !dynamic_cast<LLScrollListVirtualItem*>(item))
+	{
+		llwarns << "Can't add items to " << getName() << ", it takes its rows from a data source" << llendl;
+		return FALSE;
+	}
+
 	BOOL not_too_big = getItemCount() < mMaxItemCount;
 	if (not_too_big)
 	{
@@ -908,8 +938,9 @@ BOOL LLScrollListCtrl::addItem( LLScrollListItem* item, EAddPosition pos, BOOL r
 				break;
 			}	
 		case ADD_BOTTOM:
+			// items already in place stay sorted, see updateSort()
 			mItemList.push_back(item);
-			setSorted(FALSE);
+			mSorted = FALSE;
 			break;
 	
 		default:
@@ -1202,6 +1233,7 @@ void LLScrollListCtrl::swapWithNext(S32 index)
 	LLScrollListItem *cur_itemp = mItemList[index];
 	mItemList[index] = mItemList[index + 1];
 	mItemList[index + 1] = cur_itemp;
+	invalidate();
 }
 
 
@@ -1215,6 +1247,7 @@ void LLScrollListCtrl::swapWithPrevious(S32 index)
 	LLScrollListItem *cur_itemp = mItemList[index];
 	mItemList[index] = mItemList[index - 1];
 	mItemList[index - 1] = cur_itemp;
+	invalidate();
 }
 
 
@@ -1231,14 +1264,22 @@ void LLScrollListCtrl::deleteSingleItem(S32 target_index)
 	{
 		mLastSelected = NULL;
 	}
+	std::vector<S32> removed_rows;
+	forgetDataSourceRow(itemp, removed_rows);
 	delete itemp;
 	mItemList.erase(mItemList.begin() + target_index);
+	if (target_index < mSortedCount)
+	{
+		mSortedCount--;
+	}
+	removeDataSourceRows(removed_rows);
 	dirtyColumns();
 }
 
 //FIXME: refactor item deletion
 void LLScrollListCtrl::deleteItems(const LLSD& sd)
 {
+	std::vector<S32> removed_rows;
 	item_list::iterator iter;
 	for (iter = mItemList.begin(); iter < mItemList.end(); )
 	{
@@ -1249,6 +1290,11 @@ void LLScrollListCtrl::deleteItems(const LLSD& sd)
 			{
 				mLastSelected = NULL;
 			}
+			if (iter - mItemList.begin() < mSortedCount)
+			{
+				mSortedCount--;
+			}
+			forgetDataSourceRow(itemp, removed_rows);
 			delete itemp;
 			iter = mItemList.erase(iter);
 		}
@@ -1258,17 +1304,24 @@ void LLScrollListCtrl::deleteItems(const LLSD& sd)
 		}
 	}
 
+	removeDataSourceRows(removed_rows);
 	dirtyColumns();
 }
 
 void LLScrollListCtrl::deleteSelectedItems()
 {
+	std::vector<S32> removed_rows;
 	item_list::iterator iter;
 	for (iter = mItemList.begin(); iter < mItemList.end(); )
 	{
 		LLScrollListItem* itemp = *iter;
 		if (itemp->getSelected())
 		{
+			if (iter - mItemList.begin() < mSortedCount)
+			{
+				mSortedCount--;
+			}
+			forgetDataSourceRow(itemp, removed_rows);
 			delete itemp;
 			iter = mItemList.erase(iter);
 		}
@@ -1278,6 +1331,7 @@ void LLScrollListCtrl::deleteSelectedItems()
 		}
 	}
 	mLastSelected = NULL;
+	removeDataSourceRows(removed_rows);
 	dirtyColumns();
 }
 
@@ -1286,6 +1340,7 @@ void LLScrollListCtrl::highlightNthItem(S32 target_index)
 	if (mHighlightedItem != target_index)
 	{
 		mHighlightedItem = target_index;
+		invalidate();
 	}
 }
 
@@ -1497,7 +1552,7 @@ BOOL LLScrollListCtrl::selectItemByLabel(const std::string& label, BOOL case_sen
 	{
 		LLScrollListItem* item = *iter;
 		// Only select enabled items with matching names
-		std::string item_text = item->getColumn(0)->getValue().asString();
+		std::string item_text = getItemText(item, 0);
 		if (!case_sensitive)
 		{
 			LLStringUtil::toLower(item_text);
@@ -1542,8 +1597,7 @@ BOOL LLScrollListCtrl::selectItemByPrefix(const LLWString& target, BOOL case_sen
 		{
 			LLScrollListItem* item = *iter;
 			// Only select enabled items with matching names
-			LLScrollListCell* cellp = item->getColumn(getSearchColumn());
-			BOOL select = cellp ? item->getEnabled() && ('\0' == cellp->getValue().asString()[0]) : FALSE;
+			BOOL select = item->getEnabled() && getItemText(item, getSearchColumn()).empty();
 			if (select)
 			{
 				selectItem(item);
@@ -1565,12 +1619,11 @@ BOOL LLScrollListCtrl::selectItemByPrefix(const LLWString& target, BOOL case_sen
 			LLScrollListItem* item = *iter;
 
 			// Only select enabled items with matching names
-			LLScrollListCell* cellp = item->getColumn(getSearchColumn());
-			if (!cellp)
+			if (!mDataSource && !item->getColumn(getSearchColumn()))
 			{
 				continue;
 			}
-			LLWString item_label = utf8str_to_wstring(cellp->getValue().asString());
+			LLWString item_label = utf8str_to_wstring(getItemText(item, getSearchColumn()));
 			if (!case_sensitive)
 			{
 				LLWStringUtil::toLower(item_label);
@@ -1585,7 +1638,12 @@ BOOL LLScrollListCtrl::selectItemByPrefix(const LLWString& target, BOOL case_sen
 			{
 				// find offset of matching text (might have leading whitespace)
 				S32 offset = item_label.find(target_trimmed);
-				cellp->highlightText(offset, target_trimmed.size());
+				materializeItem(item);
+				LLScrollListCell* cellp = item->getColumn(getSearchColumn());
+				if (cellp)
+				{
+					cellp->highlightText(offset, target_trimmed.size());
+				}
 				selectItem(item);
 				found = TRUE;
 				break;
@@ -1608,7 +1666,7 @@ const std::string LLScrollListCtrl::getSelectedItemLabel(S32 column) const
 	item = getFirstSelected();
 	if (item)
 	{
-		return item->getColumn(column)->getValue().asString();
+		return getItemText(item, column);
 	}
 
 	return LLStringUtil::null;
@@ -1728,18 +1786,25 @@ void LLScrollListCtrl::drawItems()
 		
 		mDrewSelected = FALSE;
 
-		S32 line = 0;
 		S32 max_columns = 0;
 
 		LLColor4 highlight_color = LLColor4::white;
 		F32 type_ahead_timeout = LLUI::sConfigGroup->getF32("TypeAheadTimeout");
 		highlight_color.mV[VALPHA] = clamp_rescale(mSearchTimer.getElapsedTimeF32(), type_ahead_timeout * 0.7f, type_ahead_timeout, 0.4f, 0.f);
 
-		item_list::iterator iter;
-		for (iter = mItemList.begin(); iter != mItemList.end(); iter++)
+		// only the rows on screen are visited, so virtual lists build
+		// cells for just those
+		mDrawFrame++;
+		S32 last_line = llmin((S32)mItemList.size(), mScrollLines + num_page_lines);
+		for (S32 line = llmax(mScrollLines, 0); line < last_line; line++)
 		{
-			LLScrollListItem* item = *iter;
-			
+			LLScrollListItem* item = mItemList[line];
+			if (mDataSource)
+			{
+				materializeItem(item);
+				static_cast<LLScrollListVirtualItem*>(item)->setLastDrawn(mDrawFrame);
+			}
+
 			item_rect.setOriginAndSize( 
 				x, 
 				cur_y, 
@@ -1758,38 +1823,36 @@ void LLScrollListCtrl::drawItems()
 			LLColor4 fg_color;
 			LLColor4 bg_color(LLColor4::transparent);
 
-			if( mScrollLines <= line && line < mScrollLines + num_page_lines )
+			fg_color = (item->getEnabled() ? mFgUnselectedColor : mFgDisabledColor);
+			if( item->getSelected() && mCanSelect)
 			{
-				fg_color = (item->getEnabled() ? mFgUnselectedColor : mFgDisabledColor);
-				if( item->getSelected() && mCanSelect)
-				{
-					bg_color = mBgSelectedColor;
-					fg_color = (item->getEnabled() ? mFgSelectedColor : mFgDisabledColor);
-				}
-				else if (mHighlightedItem == line && mCanSelect)
-				{
-					bg_color = mHighlightedColor;
-				}
-				else 
+				bg_color = mBgSelectedColor;
+				fg_color = (item->getEnabled() ? mFgSelectedColor : mFgDisabledColor);
+			}
+			else if (mHighlightedItem == line && mCanSelect)
+			{
+				bg_color = mHighlightedColor;
+			}
+			else 
+			{
+				if (mDrawStripes && (line % 2 == 0) && (max_columns > 1))
 				{
-					if (mDrawStripes && (line % 2 == 0) && (max_columns > 1))
-					{
-						bg_color = mBgStripeColor;
-					}
+					bg_color = mBgStripeColor;
 				}
+			}
 
-				if (!item->getEnabled())
-				{
-					bg_color = mBgReadOnlyColor;
-				}
+			if (!item->getEnabled())
+			{
+				bg_color = mBgReadOnlyColor;
+			}
 
-				item->draw(item_rect, fg_color, bg_color, highlight_color, mColumnPadding);
+			item->draw(item_rect, fg_color, bg_color, highlight_color, mColumnPadding);
 
-				cur_y -= mLineHeight;
-			}
-			line++;
+			cur_y -= mLineHeight;
 		}
 	}
+
+	trimMaterializedItems();
 }
 
 
@@ -1800,7 +1863,7 @@ void LLScrollListCtrl::draw()
 	// if user specifies sort, make sure it is maintained
 	if (needsSorting() && !isSorted())
 	{
-		sortItems();
+		updateSort();
 	}
 
 	if (mNeedsScroll)
@@ -2134,22 +2197,18 @@ LLScrollListItem* LLScrollListCtrl::hitItem( S32 x, S32 y )
 	// allow for partial line at bottom
 	S32 num_page_lines = mPageLines + 1;
 
-	S32 line = 0;
-	item_list::iterator iter;
-	for(iter = mItemList.begin(); iter != mItemList.end(); iter++)
+	S32 last_line = llmin((S32)mItemList.size(), mScrollLines + num_page_lines);
+	for (S32 line = llmax(mScrollLines, 0); line < last_line; line++)
 	{
-		LLScrollListItem* item  = *iter;
-		if( mScrollLines <= line && line < mScrollLines + num_page_lines )
+		LLScrollListItem* item  = mItemList[line];
+		materializeItem(item);
+		if( item->getEnabled() && item_rect.pointInRect( x, y ) )
 		{
-			if( item->getEnabled() && item_rect.pointInRect( x, y ) )
-			{
-				hit_item = item;
-				break;
-			}
-
-			item_rect.translate(0, -mLineHeight);
+			hit_item = item;
+			break;
 		}
-		line++;
+
+		item_rect.translate(0, -mLineHeight);
 	}
 
 	return hit_item;
@@ -2433,16 +2492,20 @@ BOOL LLScrollListCtrl::handleUnicodeCharHere(llwchar uni_char)
 		{
 			LLScrollListItem* item = *iter;
 
-			LLScrollListCell* cellp = item->getColumn(getSearchColumn());
-			if (cellp)
+			if (mDataSource || item->getColumn(getSearchColumn()))
 			{
 				// Only select enabled items with matching first characters
-				LLWString item_label = utf8str_to_wstring(cellp->getValue().asString());
+				LLWString item_label = utf8str_to_wstring(getItemText(item, getSearchColumn()));
 				if (item->getEnabled() && LLStringOps::toLower(item_label[0]) == uni_char)
 				{
 					selectItem(item);
 					mNeedsScroll = TRUE;
-					cellp->highlightText(0, 1);
+					materializeItem(item);
+					LLScrollListCell* cellp = item->getColumn(getSearchColumn());
+					if (cellp)
+					{
+						cellp->highlightText(0, 1);
+					}
 					mSearchTimer.reset();
 
 					if (mCommitOnKeyboardMovement
@@ -2513,6 +2576,7 @@ void LLScrollListCtrl::selectItem(LLScrollListItem* itemp, BOOL select_single_it
 		itemp->setSelected(TRUE);
 		mLastSelected = itemp;
 		mSelectionChanged = TRUE;
+		invalidate();
 	}
 }
 
@@ -2534,6 +2598,7 @@ void LLScrollListCtrl::deselectItem(LLScrollListItem* itemp)
 			cellp->highlightText(0, 0);	
 		}
 		mSelectionChanged = TRUE;
+		invalidate();
 	}
 }
 
@@ -2617,9 +2682,31 @@ void LLScrollListCtrl::sortItems()
 	std::stable_sort(
 		mItemList.begin(), 
 		mItemList.end(), 
-		SortScrollListItem(mSortColumns));
+		SortScrollListItem(mSortColumns, mDataSource));
+
+	setSorted(TRUE);
+	invalidate();
+}
+
+// Only items added at the bottom since the last sort can be out of place.
+// Sorting just those and merging them in is much cheaper than a full sort
+// when rows trickle into a long list, and is just as stable.
+void LLScrollListCtrl::updateSort()
+{
+	S32 count = mItemList.size();
+	if (mSortedCount <= 0 || mSortedCount > count)
+	{
+		sortItems();
+		return;
+	}
+
+	SortScrollListItem comparator(mSortColumns, mDataSource);
+	item_list::iterator middle = mItemList.begin() + mSortedCount;
+	std::stable_sort(middle, mItemList.end(), comparator);
+	std::inplace_merge(mItemList.begin(), middle, mItemList.end(), comparator);
 
 	setSorted(TRUE);
+	invalidate();
 }
 
 // for one-shot sorts, does not save sort column/order
@@ -2632,12 +2719,18 @@ void LLScrollListCtrl::sortOnce(S32 column, BOOL ascending)
 	std::stable_sort(
 		mItemList.begin(), 
 		mItemList.end(), 
-		SortScrollListItem(sort_column));
+		SortScrollListItem(sort_column, mDataSource));
+
+	// no longer in mSortColumns order
+	mSortedCount = 0;
+	invalidate();
 }
 
 void LLScrollListCtrl::dirtyColumns() 
 { 
 	mColumnsDirty = TRUE; 
+	// rows were added, removed or laid out again
+	invalidate();
 
 	// need to keep mColumnsIndexed up to date
 	// just in case someone indexes into it immediately
@@ -3007,6 +3100,7 @@ void	LLScrollListCtrl::copy()
 	std::vector<LLScrollListItem*>::iterator itor;
 	for (itor = items.begin(); itor != items.end(); ++itor)
 	{
+		materializeItem(*itor);
 		buffer += (*itor)->getContentsCSV() + "\n";
 	}
 	gClipboard.copyFromSubstring(utf8str_to_wstring(buffer), 0, buffer.length());
@@ -3253,7 +3347,22 @@ LLScrollListItem* LLScrollListCtrl::addElement(const LLSD& value, EAddPosition p
 	// ID
 	LLSD id = value["id"];
 
+	if (mDataSource)
+	{
+		llwarns << "Can't add elements to " << getName() << ", it takes its rows from a data source" << llendl;
+		return NULL;
+	}
+
 	LLScrollListItem *new_item = new LLScrollListItem(id, userdata);
+	buildCells(new_item, value);
+
+	addItem(new_item, pos);
+
+	return new_item;
+}
+
+void LLScrollListCtrl::buildCells(LLScrollListItem* new_item, const LLSD& value)
+{
 	if (value.has("enabled"))
 	{
 		new_item->setEnabled( value["enabled"].asBoolean() );
@@ -3410,10 +3519,180 @@ LLScrollListItem* LLScrollListCtrl::addElement(const LLSD& value, EAddPosition p
 			new_item->setColumn(column_idx, new LLScrollListText(LLStringUtil::null, LLResMgr::getInstance()->getRes( LLFONT_SANSSERIF_SMALL ), column_ptr->getWidth(), LLFontGL::NORMAL));
 		}
 	}
+}
 
-	addItem(new_item, pos);
+void LLScrollListCtrl::setDataSource(LLScrollListDataSource* source)
+{
+	clearRows();
+	mDataSource = source;
+	refreshDataSource();
+}
 
-	return new_item;
+void LLScrollListCtrl::refreshDataSource()
+{
+	// rows may have moved, so carry the selection over by value
+	std::set<std::string> selected;
+	for (item_list::iterator iter = mItemList.begin(); iter != mItemList.end(); ++iter)
+	{
+		if ((*iter)->getSelected())
+		{
+			selected.insert((*iter)->getValue().asString());
+		}
+	}
+	S32 scroll_lines = mScrollLines;
+
+	std::for_each(mItemList.begin(), mItemList.end(), DeletePointer());
+	mItemList.clear();
+	mLastSelected = NULL;
+	mSortedCount = 0;
+	mDataSourceRows = 0;
+	mNumMaterialized = 0;
+
+	if (mDataSource)
+	{
+		mDataSourceRows = llmin(mDataSource->getRowCount(), mMaxItemCount);
+		for (S32 row = 0; row < mDataSourceRows; ++row)
+		{
+			LLScrollListVirtualItem* item = new LLScrollListVirtualItem(mDataSource->getRowValue(row), row);
+			if (!selected.empty() && selected.count(item->getValue().asString()))
+			{
+				item->setSelected(TRUE);
+				mLastSelected = item;
+			}
+			mItemList.push_back(item);
+		}
+
+		// rows have no cells yet, so take the line height from the first
+		if (!mItemList.empty())
+		{
+			materializeItem(mItemList.front());
+		}
+	}
+	mSorted = FALSE;
+
+	updateLayout();
+	setScrollPos(scroll_lines);
+}
+
+void LLScrollListCtrl::appendDataSourceRows()
+{
+	if (!mDataSource)
+	{
+		return;
+	}
+
+	S32 count = llmin(mDataSource->getRowCount(), mMaxItemCount);
+	if (count <= mDataSourceRows)
+	{
+		return;
+	}
+	for (S32 row = mDataSourceRows; row < count; ++row)
+	{
+		mItemList.push_back(new LLScrollListVirtualItem(mDataSource->getRowValue(row), row));
+	}
+	mDataSourceRows = count;
+
+	// updateSort() merges the new rows into place
+	mSorted = FALSE;
+	updateLayout();
+}
+
+void LLScrollListCtrl::materializeItem(LLScrollListItem* item)
+{
+	if (!mDataSource || !item)
+	{
+		return;
+	}
+
+	LLScrollListVirtualItem* virtual_item = static_cast<LLScrollListVirtualItem*>(item);
+	if (virtual_item->isMaterialized())
+	{
+		return;
+	}
+
+	buildCells(item, mDataSource->getRowElement(virtual_item->getRow()));
+	virtual_item->setMaterialized(TRUE);
+	mNumMaterialized++;
+
+	S32 old_line_height = mLineHeight;
+	updateLineHeightInsert(item);
+	if (mLineHeight != old_line_height)
+	{
+		updateLayout();
+	}
+}
+
+// Drops the cells of rows not drawn this frame, once more than a few
+// pages' worth have been built.
+void LLScrollListCtrl::trimMaterializedItems()
+{
+	if (!mDataSource || !LLScrollListPaging::needsTrim(mNumMaterialized, mPageLines))
+	{
+		return;
+	}
+
+	mNumMaterialized = 0;
+	for (item_list::iterator iter = mItemList.begin(); iter != mItemList.end(); ++iter)
+	{
+		LLScrollListVirtualItem* item = static_cast<LLScrollListVirtualItem*>(*iter);
+		if (!item->isMaterialized())
+		{
+			continue;
+		}
+		if (LLScrollListPaging::keepCells(item->getLastDrawn(), mDrawFrame))
+		{
+			mNumMaterialized++;
+		}
+		else
+		{
+			item->setMaterialized(FALSE);
+		}
+	}
+}
+
+// Virtual mode: note the source row of an item about to be deleted
+void LLScrollListCtrl::forgetDataSourceRow(LLScrollListItem* item, std::vector<S32>& removed_rows)
+{
+	if (!mDataSource)
+	{
+		return;
+	}
+
+	LLScrollListVirtualItem* virtual_item = static_cast<LLScrollListVirtualItem*>(item);
+	if (virtual_item->isMaterialized())
+	{
+		mNumMaterialized--;
+	}
+	removed_rows.push_back(virtual_item->getRow());
+}
+
+// Virtual mode: the source has dropped removed_rows along with their items,
+// so the rows after them move up
+void LLScrollListCtrl::removeDataSourceRows(std::vector<S32>& removed_rows)
+{
+	if (!mDataSource || removed_rows.empty())
+	{
+		return;
+	}
+
+	std::sort(removed_rows.begin(), removed_rows.end());
+	for (item_list::iterator iter = mItemList.begin(); iter != mItemList.end(); ++iter)
+	{
+		LLScrollListVirtualItem* item = static_cast<LLScrollListVirtualItem*>(*iter);
+		item->setRow(LLScrollListPaging::shiftRow(item->getRow(), removed_rows));
+	}
+	mDataSourceRows -= (S32)removed_rows.size();
+}
+
+std::string LLScrollListCtrl::getItemText(const LLScrollListItem* item, S32 column) const
+{
+	if (mDataSource)
+	{
+		return mDataSource->getCellText(static_cast<const LLScrollListVirtualItem*>(item)->getRow(), column);
+	}
+
+	const LLScrollListCell* cellp = item->getColumn(column);
+	return cellp ? cellp->getValue().asString() : LLStringUtil::null;
 }
 
 LLScrollListItem* LLScrollListCtrl::addSimpleElement(const std::string& value, EAddPosition pos, const LLSD& id)
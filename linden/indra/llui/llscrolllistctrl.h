@@ -49,6 +49,7 @@
 #include "llscrollbar.h"
 #include "llresizebar.h"
 #include "lldate.h"
+#include "llscrolllistdatasource.h"
 
 /*
  * Represents a cell in a scrollable table.
@@ -304,6 +305,9 @@ public:
 
 	std::string getContentsCSV() const;
 
+	// deletes all cells
+	void	clearColumns();
+
 	virtual void draw(const LLRect& rect, const LLColor4& fg_color, const LLColor4& bg_color, const LLColor4& highlight_color, S32 column_padding);
 
 private:
@@ -337,6 +341,29 @@ public:
 	/*virtual*/ void draw(const LLRect& rect, const LLColor4& fg_color, const LLColor4& bg_color, const LLColor4& highlight_color, S32 column_padding);
 };
 
+// Placeholder for a data source row.  Its cells are built on demand and
+// dropped again once the row has been off screen for a while.
+class LLScrollListVirtualItem : public LLScrollListItem
+{
+public:
+	LLScrollListVirtualItem(const LLSD& item_value, S32 row)
+		: LLScrollListItem(item_value), mRow(row), mMaterialized(FALSE), mLastDrawn(0) {}
+
+	S32		getRow() const					{ return mRow; }
+	void	setRow(S32 row)					{ mRow = row; }
+
+	BOOL	isMaterialized() const			{ return mMaterialized; }
+	void	setMaterialized(BOOL b)			{ mMaterialized = b; if (!b) clearColumns(); }
+
+	void	setLastDrawn(U32 frame)			{ mLastDrawn = frame; }
+	U32		getLastDrawn() const			{ return mLastDrawn; }
+
+private:
+	S32		mRow;
+	BOOL	mMaterialized;
+	U32		mLastDrawn;
+};
+
 class LLScrollListCtrl : public LLUICtrl, public LLEditMenuHandler, 
 	public LLCtrlListInterface, public LLCtrlScrollInterface
 {
@@ -470,18 +497,18 @@ public:
 	
 	void setAllowMultipleSelection(BOOL mult )	{ mAllowMultipleSelection = mult; }
 
-	void setBgWriteableColor(const LLColor4 &c)	{ mBgWriteableColor = c; }
-	void setReadOnlyBgColor(const LLColor4 &c)	{ mBgReadOnlyColor = c; }
-	void setBgSelectedColor(const LLColor4 &c)	{ mBgSelectedColor = c; }
-	void setBgStripeColor(const LLColor4& c)	{ mBgStripeColor = c; }
-	void setFgSelectedColor(const LLColor4 &c)	{ mFgSelectedColor = c; }
-	void setFgUnselectedColor(const LLColor4 &c){ mFgUnselectedColor = c; }
-	void setHighlightedColor(const LLColor4 &c)	{ mHighlightedColor = c; }
-	void setFgDisableColor(const LLColor4 &c)	{ mFgDisabledColor = c; }
-
-	void setBackgroundVisible(BOOL b)			{ mBackgroundVisible = b; }
-	void setDrawStripes(BOOL b)					{ mDrawStripes = b; }
-	void setColumnPadding(const S32 c)          { mColumnPadding = c; }
+	void setBgWriteableColor(const LLColor4 &c)	{ if (mBgWriteableColor != c) { mBgWriteableColor = c; invalidate(); } }
+	void setReadOnlyBgColor(const LLColor4 &c)	{ if (mBgReadOnlyColor != c) { mBgReadOnlyColor = c; invalidate(); } }
+	void setBgSelectedColor(const LLColor4 &c)	{ if (mBgSelectedColor != c) { mBgSelectedColor = c; invalidate(); } }
+	void setBgStripeColor(const LLColor4& c)	{ if (mBgStripeColor != c) { mBgStripeColor = c; invalidate(); } }
+	void setFgSelectedColor(const LLColor4 &c)	{ if (mFgSelectedColor != c) { mFgSelectedColor = c; invalidate(); } }
+	void setFgUnselectedColor(const LLColor4 &c){ if (mFgUnselectedColor != c) { mFgUnselectedColor = c; invalidate(); } }
+	void setHighlightedColor(const LLColor4 &c)	{ if (mHighlightedColor != c) { mHighlightedColor = c; invalidate(); } }
+	void setFgDisableColor(const LLColor4 &c)	{ if (mFgDisabledColor != c) { mFgDisabledColor = c; invalidate(); } }
+
+	void setBackgroundVisible(BOOL b)			{ if (mBackgroundVisible != b) { mBackgroundVisible = b; invalidate(); } }
+	void setDrawStripes(BOOL b)					{ if (mDrawStripes != b) { mDrawStripes = b; invalidate(); } }
+	void setColumnPadding(const S32 c)          { if (mColumnPadding != c) { mColumnPadding = c; invalidate(); } }
 	S32  getColumnPadding()						{ return mColumnPadding; }
 	void setCommitOnKeyboardMovement(BOOL b)	{ mCommitOnKeyboardMovement = b; }
 	void setCommitOnSelectionChange(BOOL b)		{ mCommitOnSelectionChange = b; }
@@ -568,9 +595,21 @@ public:
 	void			sortOnce(S32 column, BOOL ascending);
 
 	// manually call this whenever editing list items in place to flag need for resorting
-	void			setSorted(BOOL sorted) { mSorted = sorted; }
+	void			setSorted(BOOL sorted) { mSorted = sorted; mSortedCount = sorted ? (S32)mItemList.size() : 0; }
 	void			dirtyColumns(); // some operation has potentially affected column layout or ordering
 
+	// Virtual mode: rows come from source instead of addElement()/addItem().
+	// The source must outlive the list, or be detached with
+	// setDataSource(NULL).  Cell state such as check boxes lives in the
+	// source, since cells are rebuilt as rows scroll in and out of view.
+	// Deleting items removes their rows: the source must drop them too.
+	void			setDataSource(LLScrollListDataSource* source);
+	LLScrollListDataSource* getDataSource() const { return mDataSource; }
+	// source rows changed: rebuild, keeping selection and scroll position
+	void			refreshDataSource();
+	// rows were appended to source: add them and merge them into the sort
+	void			appendDataSourceRows();
+
 protected:
 	// "Full" interface: use this when you're creating a list that has one or more of the following:
 	// * contains icons
@@ -604,6 +643,13 @@ private:
 	void			deselectItem(LLScrollListItem* itemp);
 	void			commitIfChanged();
 	BOOL			setSort(S32 column, BOOL ascending);
+	void			updateSort();
+	void			buildCells(LLScrollListItem* item, const LLSD& element);
+	void			materializeItem(LLScrollListItem* item);
+	void			trimMaterializedItems();
+	void			forgetDataSourceRow(LLScrollListItem* item, std::vector<S32>& removed_rows);
+	void			removeDataSourceRows(std::vector<S32>& removed_rows);
+	std::string		getItemText(const LLScrollListItem* item, S32 column) const;
 
 
 	S32				mCurIndex;			// For get[First/Next]Data
@@ -664,6 +710,12 @@ private:
 	S32				mTotalColumnPadding;
 
 	BOOL			mSorted;
+	S32				mSortedCount;	// leading items known to be in sort order
+
+	LLScrollListDataSource* mDataSource;
+	S32				mDataSourceRows;	// source rows with an item
+	U32				mDrawFrame;
+	S32				mNumMaterialized;
 	
 	typedef std::map<std::string, LLScrollListColumn> column_map_t;
 	column_map_t mColumns;
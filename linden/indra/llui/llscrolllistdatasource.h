@@ -0,0 +1,127 @@
+/** 
+ * @file llscrolllistdatasource.h
+ * @brief Rows supplied to an LLScrollListCtrl in virtual mode
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSCROLLLISTDATASOURCE_H
+#define LL_LLSCROLLLISTDATASOURCE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "llsd.h"
+#include "llstring.h"
+
+/*
+ * Supplies the rows of an LLScrollListCtrl in virtual mode (see
+ * LLScrollListCtrl::setDataSource()).  The list keeps a lightweight
+ * placeholder item per row and only builds cells for the rows on screen.
+ */
+class LLScrollListDataSource
+{
+public:
+	virtual ~LLScrollListDataSource() {}
+
+	virtual S32			getRowCount() const = 0;
+	// item value of row, as "id" in LLScrollListCtrl::addElement()
+	virtual LLSD		getRowValue(S32 row) const = 0;
+	// text of a cell, for sorting and type-ahead without building the row
+	virtual std::string	getCellText(S32 row, S32 column) const = 0;
+	// contents of row, in the format taken by LLScrollListCtrl::addElement()
+	virtual LLSD		getRowElement(S32 row) const = 0;
+};
+
+// Orders source rows by the list's sort columns, on the source's text so
+// rows without cells sort the same as built ones.
+class LLScrollListRowOrder
+{
+public:
+	typedef std::vector<std::pair<S32, BOOL> > sort_order_t;
+
+	LLScrollListRowOrder(const sort_order_t& sort_orders, const LLScrollListDataSource& source)
+	:	mSortOrders(sort_orders),
+		mSource(source)
+	{}
+
+	// < 0, 0 or > 0 as row1 sorts before, with or after row2
+	S32 compare(S32 row1, S32 row2) const
+	{
+		// last sort column is the primary one
+		for (sort_order_t::const_reverse_iterator it = mSortOrders.rbegin();
+			 it != mSortOrders.rend(); ++it)
+		{
+			S32 order = it->second ? 1 : -1;
+			S32 result = order * LLStringUtil::compareDict(mSource.getCellText(row1, it->first), mSource.getCellText(row2, it->first));
+			if (result != 0)
+			{
+				return result;
+			}
+		}
+		return 0;
+	}
+
+	bool operator()(S32 row1, S32 row2) const { return compare(row1, row2) < 0; }
+
+private:
+	const sort_order_t& mSortOrders;
+	const LLScrollListDataSource& mSource;
+};
+
+// Cells are built for source rows as they come on screen.  Once more rows
+// have cells than a few pages' worth, rows not drawn this frame drop theirs.
+class LLScrollListPaging
+{
+public:
+	// virtual lists keep cells for at least this many rows
+	static const S32 MIN_MATERIALIZED_ROWS = 64;
+
+	static S32 getMaxMaterialized(S32 page_lines)
+	{
+		return llmax((S32)MIN_MATERIALIZED_ROWS, 4 * (page_lines + 1));
+	}
+
+	static bool needsTrim(S32 num_materialized, S32 page_lines)
+	{
+		return num_materialized > getMaxMaterialized(page_lines);
+	}
+
+	static bool keepCells(U32 last_drawn, U32 draw_frame)
+	{
+		return last_drawn == draw_frame;
+	}
+
+	// Where row ends up once the sorted source rows in removed are gone
+	static S32 shiftRow(S32 row, const std::vector<S32>& removed)
+	{
+		return row - (S32)(std::lower_bound(removed.begin(), removed.end(), row) - removed.begin());
+	}
+};
+
+#endif // LL_LLSCROLLLISTDATASOURCE_H
@@ -107,7 +107,11 @@ void LLSlider::setValue(F32 value, BOOL from_event)
 		setControlValue(value);
 	}
 
-	mValue = value;
+	if (mValue != value)
+	{
+		mValue = value;
+		invalidate();
+	}
 	updateThumbRect();
 }
 
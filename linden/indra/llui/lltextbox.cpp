@@ -162,6 +162,7 @@ void LLTextBox::setText(const LLStringExplicit& text)
 {
 	mText.assign(text);
 	setLineLengths();
+	invalidate();
 }
 
 void LLTextBox::setLineLengths()
@@ -72,26 +72,26 @@ public:
 	virtual BOOL	handleMouseUp(S32 x, S32 y, MASK mask);
 	virtual BOOL	handleHover(S32 x, S32 y, MASK mask);
 
-	void			setColor( const LLColor4& c )			{ mTextColor = c; }
-	void			setDisabledColor( const LLColor4& c)	{ mDisabledColor = c; }
-	void			setBackgroundColor( const LLColor4& c)	{ mBackgroundColor = c; }	
-	void			setBorderColor( const LLColor4& c)		{ mBorderColor = c; }	
+	void			setColor( const LLColor4& c )			{ if (mTextColor != c) { mTextColor = c; invalidate(); } }
+	void			setDisabledColor( const LLColor4& c)	{ if (mDisabledColor != c) { mDisabledColor = c; invalidate(); } }
+	void			setBackgroundColor( const LLColor4& c)	{ if (mBackgroundColor != c) { mBackgroundColor = c; invalidate(); } }	
+	void			setBorderColor( const LLColor4& c)		{ if (mBorderColor != c) { mBorderColor = c; invalidate(); } }	
 
 	void			setHoverColor( const LLColor4& c )		{ mHoverColor = c; }
 	void			setHoverActive( BOOL active )			{ mHoverActive = active; }
 
 	void			setText( const LLStringExplicit& text );
 	void			setWrappedText(const LLStringExplicit& text, F32 max_width = -1.0); // -1 means use existing control width
-	void			setUseEllipses( BOOL use_ellipses )		{ mUseEllipses = use_ellipses; }
+	void			setUseEllipses( BOOL use_ellipses )		{ if (mUseEllipses != use_ellipses) { mUseEllipses = use_ellipses; invalidate(); } }
 	
-	void			setBackgroundVisible(BOOL visible)		{ mBackgroundVisible = visible; }
-	void			setBorderVisible(BOOL visible)			{ mBorderVisible = visible; }
-	void			setFontStyle(U8 style)					{ mFontStyle = style; }
-	void			setBorderDropshadowVisible(BOOL visible){ mBorderDropShadowVisible = visible; }
-	void			setHPad(S32 pixels)						{ mHPad = pixels; }
-	void			setVPad(S32 pixels)						{ mVPad = pixels; }
-	void			setRightAlign()							{ mHAlign = LLFontGL::RIGHT; }
-	void			setHAlign( LLFontGL::HAlign align )		{ mHAlign = align; }
+	void			setBackgroundVisible(BOOL visible)		{ if (mBackgroundVisible != visible) { mBackgroundVisible = visible; invalidate(); } }
+	void			setBorderVisible(BOOL visible)			{ if (mBorderVisible != visible) { mBorderVisible = visible; invalidate(); } }
+	void			setFontStyle(U8 style)					{ if (mFontStyle != style) { mFontStyle = style; invalidate(); } }
+	void			setBorderDropshadowVisible(BOOL visible){ if (mBorderDropShadowVisible != visible) { mBorderDropShadowVisible = visible; invalidate(); } }
+	void			setHPad(S32 pixels)						{ if (mHPad != pixels) { mHPad = pixels; invalidate(); } }
+	void			setVPad(S32 pixels)						{ if (mVPad != pixels) { mVPad = pixels; invalidate(); } }
+	void			setRightAlign()							{ if (mHAlign != LLFontGL::RIGHT) { mHAlign = LLFontGL::RIGHT; invalidate(); } }
+	void			setHAlign( LLFontGL::HAlign align )		{ if (mHAlign != align) { mHAlign = align; invalidate(); } }
 	void			setClickedCallback( void (*cb)(void *data), void* data = NULL ){ mClickedCallback = cb; mCallbackUserData = data; }		// mouse down and up within button
 
 	const LLFontGL* getFont() const							{ return mFontGL; }
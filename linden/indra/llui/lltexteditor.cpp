@@ -527,6 +527,7 @@ void LLTextEditor::setText(const LLStringExplicit &utf8str)
 	needsReflow();
 
 	resetDirty();
+	invalidate();
 }
 
 void LLTextEditor::setWText(const LLWString &wtext)
@@ -186,12 +186,12 @@ public:
 	LLKeywords::keyword_iterator_t keywordsEnd()	{ return mKeywords.end(); }
 
 	// Color support
-	void 			setCursorColor(const LLColor4& c)			{ mCursorColor = c; }
-	void 			setFgColor( const LLColor4& c )				{ mFgColor = c; }
-	void			setTextDefaultColor( const LLColor4& c )				{ mDefaultColor = c; }
-	void 			setReadOnlyFgColor( const LLColor4& c )		{ mReadOnlyFgColor = c; }
-	void 			setWriteableBgColor( const LLColor4& c )	{ mWriteableBgColor = c; }
-	void 			setReadOnlyBgColor( const LLColor4& c )		{ mReadOnlyBgColor = c; }
+	void 			setCursorColor(const LLColor4& c)			{ if (mCursorColor != c) { mCursorColor = c; invalidate(); } }
+	void 			setFgColor( const LLColor4& c )				{ if (mFgColor != c) { mFgColor = c; invalidate(); } }
+	void			setTextDefaultColor( const LLColor4& c )				{ if (mDefaultColor != c) { mDefaultColor = c; invalidate(); } }
+	void 			setReadOnlyFgColor( const LLColor4& c )		{ if (mReadOnlyFgColor != c) { mReadOnlyFgColor = c; invalidate(); } }
+	void 			setWriteableBgColor( const LLColor4& c )	{ if (mWriteableBgColor != c) { mWriteableBgColor = c; invalidate(); } }
+	void 			setReadOnlyBgColor( const LLColor4& c )		{ if (mReadOnlyBgColor != c) { mReadOnlyBgColor = c; invalidate(); } }
 	void			setTrackColor( const LLColor4& color );
 	void			setThumbColor( const LLColor4& color );
 	void			setHighlightColor( const LLColor4& color );
@@ -455,6 +455,8 @@ private:
 		mReflowNeeded = TRUE; 
 		// cursor might have moved, need to scroll
 		mScrollNeeded = TRUE;
+		// every text change comes through here, appends included
+		invalidate();
 	}
 	void			needsScroll() { mScrollNeeded = TRUE; }
 
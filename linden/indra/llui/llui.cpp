@@ -1823,6 +1823,13 @@ void LLScreenClipRect::popClipRect()
 	sClipRectStack.pop();
 }
 
+//static
+void LLScreenClipRect::swapClipStack(std::stack<LLRect>& stack)
+{
+	std::swap(sClipRectStack, stack);
+	updateScissorRegion();
+}
+
 //static
 void LLScreenClipRect::updateScissorRegion()
 {
@@ -395,6 +395,10 @@ public:
 	LLScreenClipRect(const LLRect& rect, BOOL enabled = TRUE);
 	virtual ~LLScreenClipRect();
 
+	// Exchange the clip stack with another, e.g. an empty one while
+	// drawing into an offscreen target, and reapply the scissor.
+	static void swapClipStack(std::stack<LLRect>& stack);
+
 private:
 	static void pushClipRect(const LLRect& rect);
 	static void popClipRect();
@@ -40,6 +40,8 @@
 // other library includes
 #include "llcontrol.h"
 #include "lldir.h"
+#include "llmd5.h"
+#include "lltimer.h"
 #include "v4color.h"
 
 // this library includes
@@ -76,7 +78,15 @@ const S32 VPAD = 4;
 const S32 FLOATER_H_MARGIN = 15;
 const S32 MIN_WIDGET_HEIGHT = 10;
 
+// Bump this whenever the LLXMLNode binary layout changes.
+const char XUI_CACHE_MAGIC[] = "XUIB";
+const U32 XUI_CACHE_VERSION = 1;
+
 std::vector<std::string> LLUICtrlFactory::sXUIPaths;
+U32 LLUICtrlFactory::sXUIParseCount = 0;
+F64 LLUICtrlFactory::sXUIParseTime = 0.0;
+U32 LLUICtrlFactory::sXUICacheHitCount = 0;
+F64 LLUICtrlFactory::sXUICacheHitTime = 0.0;
 
 // UI Ctrl class for padding
 class LLUICtrlLocate : public LLUICtrl
@@ -120,6 +130,10 @@ LLUICtrlFactory::LLUICtrlFactory()
 
 LLUICtrlFactory::~LLUICtrlFactory()
 {
+	llinfos << "XUI files parsed: " << sXUIParseCount << " in " << sXUIParseTime
+			<< "s, loaded from cache: " << sXUICacheHitCount << " in "
+			<< sXUICacheHitTime << "s" << llendl;
+
 	delete mDummyPanel;
 	mDummyPanel = NULL;
 }
@@ -183,6 +197,42 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
 		}
 	}
 
+	// Collect every file that contributes to the final tree, since all of
+	// them take part in validating the cached copy.
+	std::vector<std::string> layer_files;
+	layer_files.push_back(full_filename);
+
+	std::vector<std::string>::const_iterator itor;
+	for (itor = sXUIPaths.begin(), ++itor; itor != sXUIPaths.end(); ++itor)
+	{
+		std::string layer_filename = gDirUtilp->findSkinnedFilename((*itor), xui_filename);
+		if (!layer_filename.empty())
+		{
+			layer_files.push_back(layer_filename);
+		}
+	}
+
+	LLTimer load_timer;
+
+	bool use_cache = LLUI::sConfigGroup
+		&& LLUI::sConfigGroup->controlExists("XUIBinaryCache")
+		&& LLUI::sConfigGroup->getBOOL("XUIBinaryCache")
+		&& !gDirUtilp->getCacheDir().empty();
+
+	std::string cache_stamp;
+	std::string cache_filename;
+	if (use_cache)
+	{
+		cache_stamp = getXUICacheStamp(layer_files);
+		cache_filename = getXUICacheFilename(layer_files);
+		if (loadXUICache(cache_filename, cache_stamp, root))
+		{
+			++sXUICacheHitCount;
+			sXUICacheHitTime += load_timer.getElapsedTimeF64();
+			return true;
+		}
+	}
+
 	if (!LLXMLNode::parseFile(full_filename, root, NULL))
 	{
 		llwarns << "Problem reading UI description file: " << full_filename << llendl;
@@ -191,23 +241,15 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
 
 	LLXMLNodePtr updateRoot;
 
-	std::vector<std::string>::const_iterator itor;
-
-	for (itor = sXUIPaths.begin(), ++itor; itor != sXUIPaths.end(); ++itor)
+	for (itor = layer_files.begin(), ++itor; itor != layer_files.end(); ++itor)
 	{
 		std::string nodeName;
 		std::string updateName;
 
-		std::string layer_filename = gDirUtilp->findSkinnedFilename((*itor), xui_filename);
-		if(layer_filename.empty())
-		{
-			// no localized version of this file, that's ok, keep looking
-			continue;
-		}
-
+		const std::string& layer_filename = *itor;
 		if (!LLXMLNode::parseFile(layer_filename, updateRoot, NULL))
 		{
-			llwarns << "Problem reading localized UI description file: " << (*itor) + gDirUtilp->getDirDelimiter() + xui_filename << llendl;
+			llwarns << "Problem reading localized UI description file: " << layer_filename << llendl;
 			return false;
 		}
 
@@ -220,9 +262,141 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
 		}
 	}
 
+	if (use_cache)
+	{
+		saveXUICache(cache_filename, cache_stamp, root);
+	}
+
+	++sXUIParseCount;
+	sXUIParseTime += load_timer.getElapsedTimeF64();
 	return true;
 }
 
+// static
+std::string LLUICtrlFactory::getXUICacheStamp(const std::vector<std::string>& layer_files)
+{
+	// The stamp lists each source file with its size and modification
+	// time.  Editing, adding or removing any layer changes the stamp.
+	// The parser's stripping options change the tree built from the same
+	// files, so they are part of the stamp too.
+	std::ostringstream stamp;
+	stamp << "strip " << (S32)LLXMLNode::sStripEscapedStrings
+		  << " " << (S32)LLXMLNode::sStripWhitespaceValues << "\n";
+	for (std::vector<std::string>::const_iterator iter = layer_files.begin();
+		 iter != layer_files.end(); ++iter)
+	{
+		llstat stat_data;
+		if (LLFile::stat(*iter, &stat_data) != 0)
+		{
+			return std::string();
+		}
+		stamp << *iter << " " << (U64)stat_data.st_size << " " << (U64)stat_data.st_mtime << "\n";
+	}
+	return stamp.str();
+}
+
+// static
+std::string LLUICtrlFactory::getXUICacheFilename(const std::vector<std::string>& layer_files)
+{
+	LLMD5 md5;
+	for (std::vector<std::string>::const_iterator iter = layer_files.begin();
+		 iter != layer_files.end(); ++iter)
+	{
+		md5.update((const unsigned char*)iter->c_str(), iter->length() + 1);
+	}
+	md5.finalize();
+
+	char digest[33];		/* Flawfinder: ignore */
+	md5.hex_digest(digest);
+
+	std::string dir = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "xui");
+	LLFile::mkdir(dir);
+	return dir + gDirUtilp->getDirDelimiter() + digest + ".xuib";
+}
+
+// static
+bool LLUICtrlFactory::loadXUICache(const std::string& cache_filename, const std::string& stamp, LLXMLNodePtr& root)
+{
+	if (stamp.empty())
+	{
+		return false;
+	}
+
+	llifstream input(cache_filename, std::ios::in | std::ios::binary);
+	if (!input.is_open())
+	{
+		return false;
+	}
+
+	char magic[sizeof(XUI_CACHE_MAGIC)];		/* Flawfinder: ignore */
+	U32 version = 0;
+	U32 stamp_length = 0;
+	input.read(magic, sizeof(magic));
+	input.read((char*)&version, sizeof(version));
+	input.read((char*)&stamp_length, sizeof(stamp_length));
+	if (!input.good()
+		|| memcmp(magic, XUI_CACHE_MAGIC, sizeof(magic))
+		|| version != XUI_CACHE_VERSION
+		|| stamp_length != stamp.length())
+	{
+		return false;
+	}
+
+	std::string cached_stamp(stamp_length, '\0');
+	input.read(&cached_stamp[0], stamp_length);
+	if (!input.good() || cached_stamp != stamp)
+	{
+		// sources changed since the cache was written
+		return false;
+	}
+
+	LLXMLNodePtr cached_root;
+	if (!LLXMLNode::parseBinary(input, cached_root))
+	{
+		llwarns << "Discarding corrupt XUI cache file " << cache_filename << llendl;
+		return false;
+	}
+
+	root = cached_root;
+	return true;
+}
+
+// static
+void LLUICtrlFactory::saveXUICache(const std::string& cache_filename, const std::string& stamp, LLXMLNodePtr& root)
+{
+	if (stamp.empty())
+	{
+		return;
+	}
+
+	// Write to a temporary file and move it into place, so that a
+	// concurrently running viewer never reads a half written cache.
+	std::string temp_filename = cache_filename + ".tmp";
+	{
+		llofstream output(temp_filename, std::ios::out | std::ios::binary);
+		if (!output.is_open())
+		{
+			return;
+		}
+
+		U32 stamp_length = stamp.length();
+		output.write(XUI_CACHE_MAGIC, sizeof(XUI_CACHE_MAGIC));
+		output.write((const char*)&XUI_CACHE_VERSION, sizeof(XUI_CACHE_VERSION));
+		output.write((const char*)&stamp_length, sizeof(stamp_length));
+		output.write(stamp.data(), stamp_length);
+		root->writeBinary(output);
+		if (!output.good())
+		{
+			output.close();
+			LLFile::remove(temp_filename);
+			return;
+		}
+	}
+
+	LLFile::remove(cache_filename);
+	LLFile::rename(temp_filename, cache_filename);
+}
+
 
 //-----------------------------------------------------------------------------
 // buildFloater()
@@ -83,6 +83,12 @@ public:
 private:
 	bool getLayeredXMLNodeImpl(const std::string &filename, LLXMLNodePtr& root);
 
+	// Binary cache of layered XUI trees, see getLayeredXMLNode()
+	static std::string getXUICacheStamp(const std::vector<std::string>& layer_files);
+	static std::string getXUICacheFilename(const std::vector<std::string>& layer_files);
+	static bool loadXUICache(const std::string& cache_filename, const std::string& stamp, LLXMLNodePtr& root);
+	static void saveXUICache(const std::string& cache_filename, const std::string& stamp, LLXMLNodePtr& root);
+
 	typedef std::map<LLHandle<LLPanel>, std::string> built_panel_t;
 	built_panel_t mBuiltPanels;
 
@@ -93,6 +99,12 @@ private:
 
 	static std::vector<std::string> sXUIPaths;
 
+	// Load statistics, reported on shutdown
+	static U32 sXUIParseCount;
+	static F64 sXUIParseTime;
+	static U32 sXUICacheHitCount;
+	static F64 sXUICacheHitTime;
+
 	LLPanel* mDummyPanel;
 };
 
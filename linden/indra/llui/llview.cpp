@@ -69,6 +69,7 @@ BOOL	LLView::sForceReshape = FALSE;
 LLView*	LLView::sEditingUIView = NULL;
 S32		LLView::sLastLeftXML = S32_MIN;
 S32		LLView::sLastBottomXML = S32_MIN;
+U32		LLView::sLiveViewsDrawn = 0;
 
 #if LL_DEBUG
 BOOL LLView::sIsDrawing = FALSE;
@@ -86,6 +87,7 @@ LLView::LLView() :
 	mLastVisible(TRUE),
 	mUseBoundingRect(FALSE),
 	mVisible(TRUE),
+	mDrawsLive(FALSE),
 	mNextInsertionOrdinal(0),
 	mHoverCursor(UI_CURSOR_ARROW)
 {
@@ -104,6 +106,7 @@ LLView::LLView(const std::string& name, BOOL mouse_opaque) :
 	mLastVisible(TRUE),
 	mUseBoundingRect(FALSE),
 	mVisible(TRUE),
+	mDrawsLive(FALSE),
 	mNextInsertionOrdinal(0),
 	mHoverCursor(UI_CURSOR_ARROW)
 {
@@ -126,6 +129,7 @@ LLView::LLView(
 	mLastVisible(TRUE),
 	mUseBoundingRect(FALSE),
 	mVisible(TRUE),
+	mDrawsLive(FALSE),
 	mNextInsertionOrdinal(0),
 	mHoverCursor(UI_CURSOR_ARROW)
 {
@@ -205,6 +209,11 @@ void LLView::setToolTipArgs( const LLStringUtil::format_map_t& args )
 // virtual
 void LLView::setRect(const LLRect& rect)
 {
+	if (mParentView && mRect != rect)
+	{
+		mParentView->invalidateRect(mRect);
+		mParentView->invalidateRect(rect);
+	}
 	mRect = rect;
 	updateBoundingRect();
 }
@@ -236,6 +245,7 @@ void LLView::sendChildToFront(LLView* child)
 	{
 		mChildList.remove( child );
 		mChildList.push_front(child);
+		invalidateRect(child->getRect());
 	}
 }
 
@@ -245,6 +255,7 @@ void LLView::sendChildToBack(LLView* child)
 	{
 		mChildList.remove( child );
 		mChildList.push_back(child);
+		invalidateRect(child->getRect());
 	}
 }
 
@@ -287,6 +298,7 @@ void LLView::addChild(LLView* child, S32 tab_group)
 	}
 
 	child->mParentView = this;
+	invalidateRect(child->getRect());
 	updateBoundingRect();
 }
 
@@ -314,6 +326,7 @@ void LLView::addChildAtEnd(LLView* child, S32 tab_group)
 	}
 	
 	child->mParentView = this;
+	invalidateRect(child->getRect());
 	updateBoundingRect();
 }
 
@@ -322,6 +335,7 @@ void LLView::removeChild(LLView* child, BOOL deleteIt)
 {
 	if (child->mParentView == this) 
 	{
+		invalidateRect(child->getRect());
 		mChildList.remove( child );
 		child->mParentView = NULL;
 		if (child->isCtrl())
@@ -459,7 +473,11 @@ BOOL LLView::getTentative() const
 //virtual
 void LLView::setEnabled(BOOL enabled)
 {
-	mEnabled = enabled;
+	if (mEnabled != enabled)
+	{
+		mEnabled = enabled;
+		invalidate();
+	}
 }
 
 //virtual
@@ -612,6 +630,7 @@ void LLView::setVisible(BOOL visible)
 		}
 
 		mVisible = visible;
+		invalidate();
 
 		// notify children of visibility change if root, or part of visible hierarchy
 		if (!getParent() || getParent()->isInVisibleChain())
@@ -640,10 +659,46 @@ void LLView::onVisibilityChange ( BOOL new_visibility )
 // virtual
 void LLView::translate(S32 x, S32 y)
 {
-	mRect.translate(x, y);
+	if (mParentView && (x || y))
+	{
+		mParentView->invalidateRect(mRect);
+		mRect.translate(x, y);
+		mParentView->invalidateRect(mRect);
+	}
+	else
+	{
+		mRect.translate(x, y);
+	}
 	updateBoundingRect();
 }
 
+void LLView::setOrigin(S32 x, S32 y)
+{
+	S32 dx = x - mRect.mLeft;
+	S32 dy = y - mRect.mBottom;
+	if (mParentView && (dx || dy))
+	{
+		mParentView->invalidateRect(mRect);
+		mRect.translate(dx, dy);
+		mParentView->invalidateRect(mRect);
+	}
+	else
+	{
+		mRect.translate(dx, dy);
+	}
+}
+
+// virtual
+void LLView::invalidateRect(const LLRect& local_rect)
+{
+	if (mParentView)
+	{
+		LLRect parent_rect(local_rect);
+		parent_rect.translate(mRect.mLeft, mRect.mBottom);
+		mParentView->invalidateRect(parent_rect);
+	}
+}
+
 // virtual
 BOOL LLView::canSnapTo(const LLView* other_view)
 {
@@ -1349,6 +1404,10 @@ void LLView::draw()
 				{
 					LLUI::translate((F32)viewp->getRect().mLeft, (F32)viewp->getRect().mBottom, 0.f);
 					viewp->draw();
+					if (viewp->mDrawsLive)
+					{
+						++sLiveViewsDrawn;
+					}
 				}
 				LLUI::popMatrix();
 			}
@@ -1443,6 +1502,10 @@ void LLView::drawChild(LLView* childp, S32 x_offset, S32 y_offset, BOOL force_dr
 			{
 				LLUI::translate((F32)childp->getRect().mLeft + x_offset, (F32)childp->getRect().mBottom + y_offset, 0.f);
 				childp->draw();
+				if (childp->mDrawsLive)
+				{
+					++sLiveViewsDrawn;
+				}
 			}
 			LLUI::popMatrix();
 		}
@@ -1460,6 +1523,11 @@ void LLView::reshape(S32 width, S32 height, BOOL called_from_parent)
 
 	if (delta_width || delta_height || sForceReshape)
 	{
+		if (mParentView)
+		{
+			mParentView->invalidateRect(mRect);
+		}
+
 		// adjust our rectangle
 		mRect.mRight = getRect().mLeft + width;
 		mRect.mTop = getRect().mBottom + height;
@@ -1513,6 +1581,11 @@ void LLView::reshape(S32 width, S32 height, BOOL called_from_parent)
 			viewp->translate( delta_x, delta_y );
 			viewp->reshape(child_rect.getWidth(), child_rect.getHeight());
 		}
+
+		if (mParentView)
+		{
+			mParentView->invalidateRect(mRect);
+		}
 	}
 
 	if (!called_from_parent)
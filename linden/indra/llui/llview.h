@@ -387,10 +387,21 @@ public:
 	// Default behavior is to use reshape flags to resize child views
 	virtual void	reshape(S32 width, S32 height, BOOL called_from_parent = TRUE);
 	virtual void	translate( S32 x, S32 y );
-	void			setOrigin( S32 x, S32 y )	{ mRect.translate( x - mRect.mLeft, y - mRect.mBottom ); }
+	void			setOrigin( S32 x, S32 y );
 	BOOL			translateIntoRect( const LLRect& constraint, BOOL allow_partial_outside );
 	void			centerWithin(const LLRect& bounds);
 
+	// Mark local_rect (in this view's coordinates) as needing a redraw.
+	// Passed up the hierarchy to views that cache their rendering.
+	void			invalidate()	{ invalidateRect(getLocalRect()); }
+	virtual void	invalidateRect(const LLRect& local_rect);
+
+	// Views whose content changes without any call that invalidates them
+	// (maps, media, stats, streaming textures) are drawn live: a floater
+	// holding a visible one is never drawn from its cached image.
+	void			setDrawsLive(BOOL live)		{ mDrawsLive = live; }
+	BOOL			getDrawsLive() const		{ return mDrawsLive; }
+
 	virtual void	userSetShape(const LLRect& new_rect);
 	virtual LLView*	findSnapRect(LLRect& new_rect, const LLCoordGL& mouse_dir, LLView::ESnapType snap_type, S32 threshold, S32 padding = 0);
 	virtual LLView*	findSnapEdge(S32& new_edge_val, const LLCoordGL& mouse_dir, ESnapEdge snap_edge, ESnapType snap_type, S32 threshold, S32 padding = 0);
@@ -646,6 +657,7 @@ private:
 	BOOL		mLastVisible;
 
 	BOOL		mVisible;
+	BOOL		mDrawsLive;
 
 	S32			mNextInsertionOrdinal;
 
@@ -675,6 +687,7 @@ public:
 	static S32 sLastLeftXML;
 	static S32 sLastBottomXML;
 	static BOOL sForceReshape;
+	static U32	sLiveViewsDrawn;	// running count of live views drawn
 };
 
 class LLCompareByTabOrder
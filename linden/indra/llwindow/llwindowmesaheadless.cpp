@@ -47,7 +47,11 @@ U16 *gMesaBuffer = NULL;
 LLWindowMesaHeadless::LLWindowMesaHeadless(const std::string& title, const std::string& name, S32 x, S32 y, S32 width, S32 height,
 							 U32 flags,  BOOL fullscreen, BOOL clearBg,
 							 BOOL disable_vsync, BOOL use_gl, BOOL ignore_pixel_depth)
-	: LLWindow(fullscreen, flags)
+	: LLWindow(fullscreen, flags),
+	  mMesaContext(NULL),
+	  mMesaBuffer(NULL),
+	  mWidth(width),
+	  mHeight(height)
 {
 	if (use_gl)
 	{
@@ -73,8 +77,25 @@ LLWindowMesaHeadless::LLWindowMesaHeadless(const std::string& title, const std::
 
 LLWindowMesaHeadless::~LLWindowMesaHeadless()
 {
-	delete mMesaBuffer;
-	OSMesaDestroyContext( mMesaContext );
+	delete[] mMesaBuffer;
+	if (mMesaContext)
+	{
+		OSMesaDestroyContext( mMesaContext );
+	}
+}
+
+BOOL LLWindowMesaHeadless::getSize(LLCoordScreen *size)
+{
+	size->mX = mWidth;
+	size->mY = mHeight;
+	return TRUE;
+}
+
+BOOL LLWindowMesaHeadless::getSize(LLCoordWindow *size)
+{
+	size->mX = mWidth;
+	size->mY = mHeight;
+	return TRUE;
 }
 
 void LLWindowMesaHeadless::swapBuffers()
@@ -52,8 +52,8 @@ public:
 	/*virtual*/ BOOL maximize() {return FALSE;};
 	/*virtual*/ BOOL getFullscreen() {return FALSE;};
 	/*virtual*/ BOOL getPosition(LLCoordScreen *position) {return FALSE;};
-	/*virtual*/ BOOL getSize(LLCoordScreen *size) {return FALSE;};
-	/*virtual*/ BOOL getSize(LLCoordWindow *size) {return FALSE;};
+	/*virtual*/ BOOL getSize(LLCoordScreen *size);
+	/*virtual*/ BOOL getSize(LLCoordWindow *size);
 	/*virtual*/ BOOL setPosition(LLCoordScreen position) {return FALSE;};
 	/*virtual*/ BOOL setSize(LLCoordScreen size) {return FALSE;};
 	/*virtual*/ BOOL switchContext(BOOL fullscreen, const LLCoordScreen &size, BOOL disable_vsync, const LLCoordScreen * const posp = NULL) {return FALSE;};
@@ -107,6 +107,8 @@ public:
 private:
 	OSMesaContext	mMesaContext;
 	unsigned char *	mMesaBuffer;
+	S32				mWidth;
+	S32				mHeight;
 };
 
 class LLSplashScreenMesaHeadless : public LLSplashScreen
@@ -120,6 +120,7 @@ LLXMLNode::LLXMLNode(LLStringTableEntry* name, BOOL is_attribute) :
 // copy constructor (except for the children)
 LLXMLNode::LLXMLNode(const LLXMLNode& rhs) : 
 	mID(rhs.mID),
+	mParser(NULL),
 	mIsAttribute(rhs.mIsAttribute),
 	mVersionMajor(rhs.mVersionMajor), 
 	mVersionMinor(rhs.mVersionMinor), 
@@ -796,6 +797,155 @@ bool LLXMLNode::parseStream(
 }
 
 
+//
+// Binary serialization
+//
+// Each node is written as its flags, name, id, value and typing info,
+// followed by its attribute nodes and then its children in document
+// order.  Strings are length prefixed.  Numbers are written in host
+// byte order since the result is only ever a local cache.
+//
+
+const U32 XML_BINARY_MAX_DEPTH = 256;
+const U32 XML_BINARY_MAX_STRING = 1 << 24;
+
+static void write_binary_u32(std::ostream& output_stream, U32 value)
+{
+	output_stream.write((const char*)&value, sizeof(U32));
+}
+
+static void write_binary_string(std::ostream& output_stream, const std::string& value)
+{
+	write_binary_u32(output_stream, (U32)value.length());
+	output_stream.write(value.data(), value.length());
+}
+
+static bool read_binary_u32(std::istream& input_stream, U32& value)
+{
+	input_stream.read((char*)&value, sizeof(U32));
+	return input_stream.good();
+}
+
+static bool read_binary_string(std::istream& input_stream, std::string& value)
+{
+	U32 length = 0;
+	if (!read_binary_u32(input_stream, length) || length > XML_BINARY_MAX_STRING)
+	{
+		return false;
+	}
+	value.resize(length);
+	if (length)
+	{
+		input_stream.read(&value[0], length);
+	}
+	return input_stream.good();
+}
+
+void LLXMLNode::writeBinary(std::ostream& output_stream)
+{
+	write_binary_u32(output_stream, mIsAttribute ? 1 : 0);
+	write_binary_string(output_stream, mName ? std::string(mName->mString) : std::string());
+	write_binary_string(output_stream, mID);
+	write_binary_string(output_stream, mValue);
+	write_binary_u32(output_stream, mVersionMajor);
+	write_binary_u32(output_stream, mVersionMinor);
+	write_binary_u32(output_stream, mLength);
+	write_binary_u32(output_stream, mPrecision);
+	write_binary_u32(output_stream, (U32)mType);
+	write_binary_u32(output_stream, (U32)mEncoding);
+
+	write_binary_u32(output_stream, (U32)mAttributes.size());
+	for (LLXMLAttribList::iterator iter = mAttributes.begin();
+		 iter != mAttributes.end(); ++iter)
+	{
+		iter->second->writeBinary(output_stream);
+	}
+
+	U32 num_children = mChildren.notNull() ? (U32)mChildren->map.size() : 0;
+	write_binary_u32(output_stream, num_children);
+	if (num_children)
+	{
+		for (LLXMLNodePtr child = mChildren->head; child.notNull(); child = child->mNext)
+		{
+			child->writeBinary(output_stream);
+		}
+	}
+}
+
+// static
+bool LLXMLNode::readBinaryNode(std::istream& input_stream, LLXMLNodePtr& node, U32 depth)
+{
+	if (depth > XML_BINARY_MAX_DEPTH)
+	{
+		return false;
+	}
+
+	U32 is_attribute = 0;
+	std::string name;
+	if (!read_binary_u32(input_stream, is_attribute)
+		|| !read_binary_string(input_stream, name))
+	{
+		return false;
+	}
+
+	node = new LLXMLNode(name.c_str(), is_attribute ? TRUE : FALSE);
+
+	U32 type = 0;
+	U32 encoding = 0;
+	if (!read_binary_string(input_stream, node->mID)
+		|| !read_binary_string(input_stream, node->mValue)
+		|| !read_binary_u32(input_stream, node->mVersionMajor)
+		|| !read_binary_u32(input_stream, node->mVersionMinor)
+		|| !read_binary_u32(input_stream, node->mLength)
+		|| !read_binary_u32(input_stream, node->mPrecision)
+		|| !read_binary_u32(input_stream, type)
+		|| !read_binary_u32(input_stream, encoding)
+		|| type > TYPE_NODEREF
+		|| encoding > ENCODING_HEX)
+	{
+		return false;
+	}
+	node->mType = (ValueType)type;
+	node->mEncoding = (Encoding)encoding;
+
+	for (S32 pass = 0; pass < 2; ++pass)
+	{
+		// first pass reads attributes, second reads children
+		U32 count = 0;
+		if (!read_binary_u32(input_stream, count))
+		{
+			return false;
+		}
+		for (U32 i = 0; i < count; ++i)
+		{
+			LLXMLNodePtr child;
+			if (!readBinaryNode(input_stream, child, depth + 1))
+			{
+				return false;
+			}
+			node->addChild(child);
+		}
+	}
+	return true;
+}
+
+// static
+bool LLXMLNode::parseBinary(std::istream& input_stream, LLXMLNodePtr& node)
+{
+	LLXMLNodePtr root;
+	if (!readBinaryNode(input_stream, root, 0))
+	{
+		llwarns << "Parse failure - truncated or corrupt binary xml." << llendl;
+		node = new LLXMLNode();
+		return false;
+	}
+
+	root->setDefault(NULL);
+	root->updateDefault();
+	node = root;
+	return true;
+}
+
 BOOL LLXMLNode::isFullyDefault()
 {
 	if (mDefault.isNull())
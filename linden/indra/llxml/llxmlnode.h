@@ -157,6 +157,11 @@ public:
     void writeToFile(LLFILE *fOut, const std::string& indent = std::string());
     void writeToOstream(std::ostream& output_stream, const std::string& indent = std::string());
 
+	// Compact binary form of a parsed tree, used to cache XUI files on
+	// disk so they do not have to go through expat again.
+	void writeBinary(std::ostream& output_stream);
+	static bool parseBinary(std::istream& input_stream, LLXMLNodePtr& node);
+
     // Utility
     void findName(const std::string& name, LLXMLNodeList &results);
     void findName(LLStringTableEntry* name, LLXMLNodeList &results);
@@ -316,6 +321,8 @@ protected:
 
 	LLXMLNodePtr mDefault;		// Mirror node in the default tree
 
+	static bool readBinaryNode(std::istream& input_stream, LLXMLNodePtr& node, U32 depth);
+
 	static const char *skipWhitespace(const char *str);
 	static const char *skipNonWhitespace(const char *str);
 	static const char *parseInteger(const char *str, U64 *dest, BOOL *is_negative, U32 precision, Encoding encoding);
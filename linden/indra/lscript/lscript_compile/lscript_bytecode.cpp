@@ -64,7 +64,7 @@ void LLScriptJumpTable::addJump(char *name, S32 offset)
 
 
 LLScriptByteCodeChunk::LLScriptByteCodeChunk(BOOL b_need_jumps)
-: mCodeChunk(NULL), mCurrentOffset(0), mJumpTable(NULL)
+: mCodeChunk(NULL), mCurrentOffset(0), mJumpTable(NULL), mCapacity(0)
 {
 	if (b_need_jumps)
 	{
@@ -78,19 +78,31 @@ LLScriptByteCodeChunk::~LLScriptByteCodeChunk()
 	delete mJumpTable;
 }
 
-void LLScriptByteCodeChunk::addByte(U8 byte)
+// smallest buffer handed out; most event handlers fit without growing
+const S32 LSCRIPT_MIN_CHUNK_CAPACITY = 256;
+
+void LLScriptByteCodeChunk::reserve(S32 size)
 {
+	S32 needed = mCurrentOffset + size;
+	if (mCodeChunk && needed <= mCapacity)
+	{
+		return;
+	}
+
+	S32 capacity = llmax(needed, mCapacity * 2, LSCRIPT_MIN_CHUNK_CAPACITY);
+	U8 *temp = new U8[capacity];
 	if (mCodeChunk)
 	{
-		U8 *temp = new U8[mCurrentOffset + 1];
 		memcpy(temp, mCodeChunk, mCurrentOffset);	/* Flawfinder: ignore */
 		delete [] mCodeChunk;
-		mCodeChunk = temp;
-	}
-	else
-	{
-		mCodeChunk = new U8[1];
 	}
+	mCodeChunk = temp;
+	mCapacity = capacity;
+}
+
+void LLScriptByteCodeChunk::addByte(U8 byte)
+{
+	reserve(1);
 	*(mCodeChunk + mCurrentOffset++) = byte;
 }
 
@@ -104,68 +116,28 @@ void LLScriptByteCodeChunk::addU16(U16 data)
 
 void LLScriptByteCodeChunk::addBytes(const U8 *bytes, S32 size)
 {
-	if (mCodeChunk)
-	{
-		U8 *temp = new U8[mCurrentOffset + size];
-		memcpy(temp, mCodeChunk, mCurrentOffset);	/* Flawfinder: ignore */
-		delete [] mCodeChunk;
-		mCodeChunk = temp;
-	}
-	else
-	{
-		mCodeChunk = new U8[size];
-	}
+	reserve(size);
 	memcpy(mCodeChunk + mCurrentOffset, bytes, size);/* Flawfinder: ignore */
 	mCurrentOffset += size;
 }
 
 void LLScriptByteCodeChunk::addBytes(const char *bytes, S32 size)
 {
-	if (mCodeChunk)
-	{
-		U8 *temp = new U8[mCurrentOffset + size];
-		memcpy(temp, mCodeChunk, mCurrentOffset);	 	/*Flawfinder: ignore*/
-		delete [] mCodeChunk;
-		mCodeChunk = temp;
-	}
-	else
-	{
-		mCodeChunk = new U8[size];
-	}
+	reserve(size);
 	memcpy(mCodeChunk + mCurrentOffset, bytes, size);	/*Flawfinder: ignore*/
 	mCurrentOffset += size;
 }
 
 void LLScriptByteCodeChunk::addBytes(S32 size)
 {
-	if (mCodeChunk)
-	{
-		U8 *temp = new U8[mCurrentOffset + size];
-		memcpy(temp, mCodeChunk, mCurrentOffset);	/*Flawfinder: ignore*/
-		delete [] mCodeChunk;
-		mCodeChunk = temp;
-	}
-	else
-	{
-		mCodeChunk = new U8[size];
-	}
+	reserve(size);
 	memset(mCodeChunk + mCurrentOffset, 0, size);
 	mCurrentOffset += size;
 }
 
 void LLScriptByteCodeChunk::addBytesDontInc(S32 size)
 {
-	if (mCodeChunk)
-	{
-		U8 *temp = new U8[mCurrentOffset + size];
-		memcpy(temp, mCodeChunk, mCurrentOffset);	 	/*Flawfinder: ignore*/
-		delete [] mCodeChunk;
-		mCodeChunk = temp;
-	}
-	else
-	{
-		mCodeChunk = new U8[size];
-	}
+	reserve(size);
 	memset(mCodeChunk + mCurrentOffset, 0, size);
 }
 
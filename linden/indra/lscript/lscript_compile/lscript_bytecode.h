@@ -70,6 +70,13 @@ public:
 	U8					*mCodeChunk;
 	S32					mCurrentOffset;
 	LLScriptJumpTable	*mJumpTable;
+
+private:
+	// makes room for size more bytes past mCurrentOffset, growing the
+	// buffer geometrically so emitting a chunk stays linear in its size
+	void reserve(S32 size);
+
+	S32					mCapacity;
 };
 
 class LLScriptScriptCodeChunk
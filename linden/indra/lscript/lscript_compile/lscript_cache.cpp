@@ -0,0 +1,153 @@
+/** 
+ * @file lscript_cache.cpp
+ * @brief content addressed cache of compiled scripts
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmd5.h"
+#include "lscript_library.h"
+#include "lscript_rt_interface.h"
+
+// Bump whenever the compiler emits different bytecode for the same source,
+// so output cached by older builds stops matching.
+const U8 LSCRIPT_COMPILE_CACHE_VERSION = 1;
+
+static BOOL copy_file(const std::string& from, const std::string& to)
+{
+	LLFILE* in = LLFile::fopen(from, "rb");		/* Flawfinder: ignore */
+	if (!in)
+	{
+		return FALSE;
+	}
+	LLFILE* out = LLFile::fopen(to, "wb");		/* Flawfinder: ignore */
+	if (!out)
+	{
+		fclose(in);
+		return FALSE;
+	}
+
+	BOOL ok = TRUE;
+	U8 buffer[4096];		/* Flawfinder: ignore */
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0)
+	{
+		if (fwrite(buffer, 1, read, out) != read)
+		{
+			ok = FALSE;
+			break;
+		}
+	}
+	fclose(in);
+	fclose(out);
+	return ok;
+}
+
+// The library table decides which calls compile and the function numbers
+// they compile to, so builds with different tables must not share entries.
+static void update_library_digest(LLMD5& md5)
+{
+	static U8 library_digest[16];
+	static BOOL have_digest = FALSE;
+	if (!have_digest)
+	{
+		LLMD5 library;
+		for (S32 i = 0; i < gScriptLibrary.mNextNumber; i++)
+		{
+			const LLScriptLibraryFunction* func = gScriptLibrary.mFunctions[i];
+			const char* fields[3] = { func->mName, func->mReturnType, func->mArgs };
+			for (S32 f = 0; f < 3; f++)
+			{
+				const char* field = fields[f] ? fields[f] : "";
+				// keep the terminator so adjacent fields can't run together
+				library.update((const U8*)field, (U32)strlen(field) + 1);
+			}
+			U8 god_only = func->mGodOnly ? 1 : 0;
+			library.update(&god_only, 1);
+		}
+		library.finalize();
+		library.raw_digest(library_digest);
+		have_digest = TRUE;
+	}
+	md5.update(library_digest, sizeof(library_digest));
+}
+
+BOOL lscript_compile_cached(const char* src_filename, const char* dst_filename,
+							const char* err_filename, const char* cache_prefix, BOOL is_god_like)
+{
+	LLFILE* src = cache_prefix ? LLFile::fopen(std::string(src_filename), "rb") : NULL;	/* Flawfinder: ignore */
+	if (!src)
+	{
+		return lscript_compile(src_filename, dst_filename, err_filename, FALSE, "", is_god_like);
+	}
+
+	// key on everything that changes the output: the compiler, which
+	// library functions are visible, and the source text
+	LLMD5 md5;
+	U8 header[2];
+	header[0] = LSCRIPT_COMPILE_CACHE_VERSION;
+	header[1] = is_god_like ? 1 : 0;
+	md5.update(header, sizeof(header));
+	update_library_digest(md5);
+	md5.update(src);	// closes src
+	md5.finalize();
+	char digest[MD5HEX_STR_SIZE];		/* Flawfinder: ignore */
+	md5.hex_digest(digest);
+
+	std::string cached_dst = llformat("%s%s.lso", cache_prefix, digest);
+	std::string cached_err = llformat("%s%s.out", cache_prefix, digest);
+
+	if (LLFile::isfile(cached_dst) && copy_file(cached_dst, dst_filename))
+	{
+		// hand back the warnings from the original compile too
+		copy_file(cached_err, err_filename);
+		return TRUE;
+	}
+
+	if (!lscript_compile(src_filename, dst_filename, err_filename, FALSE, digest, is_god_like))
+	{
+		// failures aren't cached, the error text is wanted fresh
+		return FALSE;
+	}
+
+	// the bytecode goes in last and by rename, so a cache entry is never
+	// seen half written
+	std::string temp_dst = cached_dst + ".tmp";
+	if (  copy_file(err_filename, cached_err)
+		&& copy_file(dst_filename, temp_dst))
+	{
+		LLFile::rename(temp_dst, cached_dst);
+	}
+	else
+	{
+		LLFile::remove(temp_dst);
+	}
+	return TRUE;
+}
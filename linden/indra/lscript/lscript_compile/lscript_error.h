@@ -43,6 +43,7 @@ typedef enum e_lscript_compile_pass
 	LSCP_SCOPE_PASS1,
 	LSCP_SCOPE_PASS2,
 	LSCP_TYPE,
+	LSCP_OPTIMIZE,
 	LSCP_RESOURCE,
 	LSCP_EMIT_ASSEMBLY,
 	LSCP_EMIT_BYTE_CODE,
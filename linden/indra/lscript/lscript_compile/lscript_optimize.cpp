@@ -0,0 +1,162 @@
+/** 
+ * @file lscript_optimize.cpp
+ * @brief constant folding used by the compiler's optimize pass
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lscript_optimize.h"
+
+// Integer arithmetic wraps at 32 bits in both runtimes, so do it unsigned
+// to keep the overflow well defined here.
+static S32 wrap_add(S32 a, S32 b)
+{
+	return (S32)((U32)a + (U32)b);
+}
+
+static S32 wrap_sub(S32 a, S32 b)
+{
+	return (S32)((U32)a - (U32)b);
+}
+
+static S32 wrap_mul(S32 a, S32 b)
+{
+	return (S32)((U32)a * (U32)b);
+}
+
+BOOL fold_integer_binary(S32 &result, S32 left_side, S32 right_side, LSCRIPTExpressionType expression)
+{
+	switch(expression)
+	{
+	case LET_PLUS:
+		result = wrap_add(left_side, right_side);
+		return TRUE;
+	case LET_MINUS:
+		result = wrap_sub(left_side, right_side);
+		return TRUE;
+	case LET_TIMES:
+		result = wrap_mul(left_side, right_side);
+		return TRUE;
+	case LET_DIVIDE:
+	case LET_MOD:
+		// division by zero is a runtime math error, and LSO special cases
+		// division by -1 (SL-31252) where Mono would overflow on S32_MIN
+		if (right_side == 0 || right_side == -1)
+		{
+			return FALSE;
+		}
+		result = (expression == LET_DIVIDE) ? left_side / right_side : left_side % right_side;
+		return TRUE;
+	case LET_EQUALITY:
+		result = (left_side == right_side);
+		return TRUE;
+	case LET_NOT_EQUALS:
+		result = (left_side != right_side);
+		return TRUE;
+	case LET_LESS_EQUALS:
+		result = (left_side <= right_side);
+		return TRUE;
+	case LET_GREATER_EQUALS:
+		result = (left_side >= right_side);
+		return TRUE;
+	case LET_LESS_THAN:
+		result = (left_side < right_side);
+		return TRUE;
+	case LET_GREATER_THAN:
+		result = (left_side > right_side);
+		return TRUE;
+	case LET_BIT_AND:
+		result = left_side & right_side;
+		return TRUE;
+	case LET_BIT_OR:
+		result = left_side | right_side;
+		return TRUE;
+	case LET_BIT_XOR:
+		result = left_side ^ right_side;
+		return TRUE;
+	case LET_BOOLEAN_AND:
+		// LSL evaluates both sides, which is fine since constants have no
+		// side effects
+		result = (left_side && right_side);
+		return TRUE;
+	case LET_BOOLEAN_OR:
+		result = (left_side || right_side);
+		return TRUE;
+	case LET_SHIFT_LEFT:
+	case LET_SHIFT_RIGHT:
+		// counts outside 0-31 depend on the host (LSO) or get masked (Mono)
+		if (right_side < 0 || right_side > 31)
+		{
+			return FALSE;
+		}
+		if (expression == LET_SHIFT_LEFT)
+		{
+			result = (S32)((U32)left_side << right_side);
+		}
+		else
+		{
+			// arithmetic shift, as both runtimes do
+			result = (left_side < 0) ? ~(~left_side >> right_side) : left_side >> right_side;
+		}
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+BOOL fold_integer_unary(S32 &result, S32 value, LSCRIPTExpressionType expression)
+{
+	switch(expression)
+	{
+	case LET_UNARY_MINUS:
+		result = wrap_sub(0, value);
+		return TRUE;
+	case LET_BOOLEAN_NOT:
+		result = !value;
+		return TRUE;
+	case LET_BIT_NOT:
+		result = ~value;
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+BOOL fold_float_unary(F32 &result, F32 value, LSCRIPTExpressionType expression)
+{
+	// only negation is exact regardless of the precision the runtime
+	// evaluates floats at
+	if (expression == LET_UNARY_MINUS)
+	{
+		result = -value;
+		return TRUE;
+	}
+	return FALSE;
+}
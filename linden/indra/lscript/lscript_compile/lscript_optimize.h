@@ -0,0 +1,47 @@
+/** 
+ * @file lscript_optimize.h
+ * @brief constant folding used by the compiler's optimize pass
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LSCRIPT_OPTIMIZE_H
+#define LL_LSCRIPT_OPTIMIZE_H
+
+#include "lscript_typecheck.h"
+
+// The optimize pass (LSCP_OPTIMIZE) runs after typechecking and folds
+// operators whose operands are all constants.  These compute what both the
+// LSO and Mono runtimes would produce for the same operands and return
+// FALSE whenever the two could disagree or the operation would raise a
+// runtime error, in which case the expression is emitted unchanged.
+BOOL fold_integer_binary(S32 &result, S32 left_side, S32 right_side, LSCRIPTExpressionType expression);
+BOOL fold_integer_unary(S32 &result, S32 value, LSCRIPTExpressionType expression);
+BOOL fold_float_unary(F32 &result, F32 value, LSCRIPTExpressionType expression);
+
+#endif
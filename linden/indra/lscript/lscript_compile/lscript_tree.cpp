@@ -38,6 +38,7 @@
 #include "lscript_typecheck.h"
 #include "lscript_resource.h"
 #include "lscript_bytecode.h"
+#include "lscript_optimize.h"
 #include "lscript_heap.h"
 #include "lscript_library.h"
 #include "lscript_alloc.h"
@@ -4012,6 +4013,106 @@ S32 LLScriptExpression::getSize()
 	return 0;
 }
 
+BOOL LLScriptExpression::emitFolded(LLFILE *fp, LSCRIPTCompilePass pass, LLScriptByteCodeChunk *chunk, LLScriptByteCodeChunk *heap)
+{
+	if (!mFoldedConstant)
+	{
+		return FALSE;
+	}
+	switch(pass)
+	{
+	case LSCP_TO_STACK:
+	case LSCP_EMIT_CIL_ASSEMBLY:
+		{
+			// push the folded value exactly as a literal would be pushed
+			BOOL b_dummy = FALSE;
+			U64 dummy_count = 0;
+			LSCRIPTType folded_type = mFoldedConstant->mType;
+			mFoldedConstant->recurse(fp, 0, 0, pass, LSPRUNE_INVALID, b_dummy, NULL, folded_type, folded_type, dummy_count, chunk, heap, 0, NULL, 0, NULL);
+		}
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static LLScriptConstant *new_folded_integer(LLScriptExpression *expression, S32 value)
+{
+	LLScriptConstant *constant = new LLScriptConstantInteger(expression->mLineNumber, expression->mColumnNumber, value);
+	gAllocationManager->addAllocation(constant);
+	return constant;
+}
+
+static LLScriptConstant *fold_binary_constant(LLScriptExpression *expression, LLScriptExpression *left_side, LLScriptExpression *right_side)
+{
+	LLScriptConstant *left = left_side->mFoldedConstant;
+	LLScriptConstant *right = right_side->mFoldedConstant;
+
+	// only integer results are folded: float arithmetic may be evaluated
+	// at a different precision by the runtime than it would be here
+	if (  !left
+		||!right
+		||(left->mType != LST_INTEGER)
+		||(right->mType != LST_INTEGER)
+		||(expression->mReturnType != LST_INTEGER))
+	{
+		return NULL;
+	}
+
+	S32 result;
+	if (!fold_integer_binary(result, ((LLScriptConstantInteger *)left)->mValue, ((LLScriptConstantInteger *)right)->mValue, expression->mType))
+	{
+		return NULL;
+	}
+	return new_folded_integer(expression, result);
+}
+
+static LLScriptConstant *fold_unary_constant(LLScriptExpression *expression, LLScriptExpression *operand)
+{
+	LLScriptConstant *value = operand->mFoldedConstant;
+	if (!value || (value->mType != expression->mReturnType))
+	{
+		return NULL;
+	}
+
+	if (value->mType == LST_INTEGER)
+	{
+		S32 result;
+		if (fold_integer_unary(result, ((LLScriptConstantInteger *)value)->mValue, expression->mType))
+		{
+			return new_folded_integer(expression, result);
+		}
+	}
+	else if (value->mType == LST_FLOATINGPOINT)
+	{
+		F32 result;
+		if (fold_float_unary(result, ((LLScriptConstantFloat *)value)->mValue, expression->mType))
+		{
+			LLScriptConstant *constant = new LLScriptConstantFloat(expression->mLineNumber, expression->mColumnNumber, result);
+			gAllocationManager->addAllocation(constant);
+			return constant;
+		}
+	}
+	return NULL;
+}
+
+static LSCRIPTFoldedCondition fold_condition(LLScriptExpression *expression)
+{
+	LLScriptConstant *constant = expression->mFoldedConstant;
+	if (constant)
+	{
+		if (constant->mType == LST_INTEGER)
+		{
+			return ((LLScriptConstantInteger *)constant)->mValue ? LSFC_TRUE : LSFC_FALSE;
+		}
+		if (constant->mType == LST_FLOATINGPOINT)
+		{
+			return (((LLScriptConstantFloat *)constant)->mValue != 0.f) ? LSFC_TRUE : LSFC_FALSE;
+		}
+	}
+	return LSFC_UNKNOWN;
+}
+
 void LLScriptExpression::gonext(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass pass, LSCRIPTPruneType ptype, BOOL &prunearg, LLScriptScope *scope, LSCRIPTType &type, LSCRIPTType basetype, U64 &count, LLScriptByteCodeChunk *chunk, LLScriptByteCodeChunk *heap, S32 stacksize, LLScriptScopeEntry *entry, S32 entrycount, LLScriptLibData **ldata)
 {
 	if (gErrorToText.getErrors())
@@ -5636,6 +5737,11 @@ void LLScriptEquality::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompile
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5661,6 +5767,11 @@ void LLScriptEquality::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompile
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -5696,6 +5807,11 @@ void LLScriptNotEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5721,6 +5837,11 @@ void LLScriptNotEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -5773,6 +5894,11 @@ void LLScriptLessEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5798,6 +5924,11 @@ void LLScriptLessEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -5841,6 +5972,11 @@ void LLScriptGreaterEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCo
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5866,6 +6002,11 @@ void LLScriptGreaterEquals::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCo
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -5907,6 +6048,11 @@ void LLScriptLessThan::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompile
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5932,6 +6078,11 @@ void LLScriptLessThan::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompile
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -5973,6 +6124,11 @@ void LLScriptGreaterThan::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTComp
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -5998,6 +6154,11 @@ void LLScriptGreaterThan::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTComp
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6033,6 +6194,11 @@ void LLScriptPlus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6058,6 +6224,11 @@ void LLScriptPlus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6093,6 +6264,11 @@ void LLScriptMinus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6118,6 +6294,11 @@ void LLScriptMinus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6153,6 +6334,11 @@ void LLScriptTimes::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6178,6 +6364,11 @@ void LLScriptTimes::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6213,6 +6404,11 @@ void LLScriptDivide::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6238,6 +6434,11 @@ void LLScriptDivide::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6273,6 +6474,11 @@ void LLScriptMod::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6298,6 +6504,11 @@ void LLScriptMod::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6331,6 +6542,11 @@ void LLScriptBitAnd::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6356,6 +6572,11 @@ void LLScriptBitAnd::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6387,6 +6608,11 @@ void LLScriptBitOr::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6412,6 +6638,11 @@ void LLScriptBitOr::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6443,6 +6674,11 @@ void LLScriptBitXor::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6468,6 +6704,11 @@ void LLScriptBitXor::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6499,6 +6740,11 @@ void LLScriptBooleanAnd::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6524,6 +6770,11 @@ void LLScriptBooleanAnd::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6561,6 +6812,11 @@ void LLScriptBooleanOr::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6586,6 +6842,11 @@ void LLScriptBooleanOr::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6621,6 +6882,11 @@ void LLScriptShiftLeft::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6646,6 +6912,11 @@ void LLScriptShiftLeft::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompil
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6678,6 +6949,11 @@ void LLScriptShiftRight::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6703,6 +6979,11 @@ void LLScriptShiftRight::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 			type = mReturnType;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mLeftSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_binary_constant(this, mLeftSide, mRightSide);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mRightSide->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6749,6 +7030,10 @@ void LLScriptParenthesis::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTComp
 		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		mReturnType = mLeftType = type;
 		break;
+	case LSCP_OPTIMIZE:
+		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = mExpression->mFoldedConstant;
+		break;
 	default:
 		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		break;
@@ -6767,6 +7052,11 @@ void LLScriptUnaryMinus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6788,6 +7078,10 @@ void LLScriptUnaryMinus::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 			mReturnType = mLeftType = type;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_unary_constant(this, mExpression);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6820,6 +7114,11 @@ void LLScriptBooleanNot::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6841,6 +7140,10 @@ void LLScriptBooleanNot::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompi
 			mReturnType = mLeftType = type;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_unary_constant(this, mExpression);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -6870,6 +7173,11 @@ void LLScriptBitNot::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 	{
 		return;
 	}
+	if (emitFolded(fp, pass, chunk, heap))
+	{
+		gonext(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		return;
+	}
 	switch(pass)
 	{
 	case LSCP_PRETTY_PRINT:
@@ -6891,6 +7199,10 @@ void LLScriptBitNot::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 			mReturnType = mLeftType = type;
 		}
 		break;
+	case LSCP_OPTIMIZE:
+		mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		mFoldedConstant = fold_unary_constant(this, mExpression);
+		break;
 	case LSCP_TO_STACK:
 		{
 			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -8076,6 +8388,13 @@ void LLScriptConstantExpression::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCR
 	case LSCP_TO_STACK:
 		mConstant->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		break;
+	case LSCP_OPTIMIZE:
+		if (  (mConstant->mType == LST_INTEGER)
+			||(mConstant->mType == LST_FLOATINGPOINT))
+		{
+			mFoldedConstant = mConstant;
+		}
+		break;
 	default:
 		mConstant->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		break;
@@ -8475,6 +8794,10 @@ void LLScriptLabel::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 		// might start up code at this label, so we need to stop pruning.
 		prunearg = FALSE;
 		break;
+	case LSCP_OPTIMIZE:
+		// count labels, so branches that might be jumped into are kept
+		count++;
+		break;
 	case LSCP_SCOPE_PASS1:
 		// add labels to scope
 		if (scope->checkEntry(mIdentifier->mName))
@@ -8802,7 +9125,25 @@ void LLScriptIf::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass p
 		mType = type;
 		mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);		
 		break;
+	case LSCP_OPTIMIZE:
+		{
+			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+			U64 labels = 0;
+			mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, labels, chunk, heap, stacksize, entry, entrycount, NULL);
+			count += labels;
+			mCondition = fold_condition(mExpression);
+			if ((mCondition == LSFC_FALSE) && labels)
+			{
+				mCondition = LSFC_UNKNOWN;
+			}
+		}
+		break;
 	case LSCP_EMIT_BYTE_CODE:
+		if (mCondition == LSFC_TRUE)
+		{
+			mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else if (mCondition == LSFC_UNKNOWN)
 		{
 			char jumpname[32];	 	/*Flawfinder: ignore*/
 			snprintf(jumpname, sizeof(jumpname),"##Temp Jump %d##", gTempJumpCount++); 	/* Flawfinder: ignore */
@@ -8817,6 +9158,11 @@ void LLScriptIf::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePass p
 		}
 		break;
 	case LSCP_EMIT_CIL_ASSEMBLY:
+		if (mCondition == LSFC_TRUE)
+		{
+			mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else if (mCondition == LSFC_UNKNOWN)
 		{
 			S32 tjump = gTempJumpCount++;
 			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
@@ -8888,7 +9234,31 @@ void LLScriptIfElse::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 		mStatement1->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		mStatement2->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		break;
+	case LSCP_OPTIMIZE:
+		{
+			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+			U64 labels1 = 0, labels2 = 0;
+			mStatement1->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, labels1, chunk, heap, stacksize, entry, entrycount, NULL);
+			mStatement2->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, labels2, chunk, heap, stacksize, entry, entrycount, NULL);
+			count += labels1 + labels2;
+			mCondition = fold_condition(mExpression);
+			if (  ((mCondition == LSFC_TRUE) && labels2)
+				||((mCondition == LSFC_FALSE) && labels1))
+			{
+				mCondition = LSFC_UNKNOWN;
+			}
+		}
+		break;
 	case LSCP_EMIT_BYTE_CODE:
+		if (mCondition == LSFC_TRUE)
+		{
+			mStatement1->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else if (mCondition == LSFC_FALSE)
+		{
+			mStatement2->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else
 		{
 			char jumpname1[32]; 				/*Flawfinder: ignore*/
 			snprintf(jumpname1, sizeof(jumpname1), "##Temp Jump %d##", gTempJumpCount++); 	/* Flawfinder: ignore */
@@ -8910,6 +9280,15 @@ void LLScriptIfElse::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePa
 		}
 		break;
 	case LSCP_EMIT_CIL_ASSEMBLY:
+		if (mCondition == LSFC_TRUE)
+		{
+			mStatement1->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else if (mCondition == LSFC_FALSE)
+		{
+			mStatement2->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+		}
+		else
 		{
 			S32 tjump1 =  gTempJumpCount++;
 			S32 tjump2 =  gTempJumpCount++;
@@ -9168,7 +9547,22 @@ void LLScriptWhile::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 		mType = type;
 		mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
 		break;
+	case LSCP_OPTIMIZE:
+		{
+			mExpression->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, count, chunk, heap, stacksize, entry, entrycount, NULL);
+			U64 labels = 0;
+			mStatement->recurse(fp, tabs, tabsize, pass, ptype, prunearg, scope, type, basetype, labels, chunk, heap, stacksize, entry, entrycount, NULL);
+			count += labels;
+			// only loops that never run are dropped
+			mCondition = fold_condition(mExpression);
+			if ((mCondition == LSFC_TRUE) || labels)
+			{
+				mCondition = LSFC_UNKNOWN;
+			}
+		}
+		break;
 	case LSCP_EMIT_BYTE_CODE:
+		if (mCondition == LSFC_UNKNOWN)
 		{
 			char jumpname1[32]; 	/*Flawfinder: ignore*/
 			snprintf(jumpname1, sizeof(jumpname1), "##Temp Jump %d##", gTempJumpCount++); 	/* Flawfinder: ignore */
@@ -9189,6 +9583,7 @@ void LLScriptWhile::recurse(LLFILE *fp, S32 tabs, S32 tabsize, LSCRIPTCompilePas
 		}
 		break;
 	case LSCP_EMIT_CIL_ASSEMBLY:
+		if (mCondition == LSFC_UNKNOWN)
 		{
 			S32 tjump1 =  gTempJumpCount++;
 			S32 tjump2 =  gTempJumpCount++;
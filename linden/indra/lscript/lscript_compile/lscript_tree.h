@@ -948,12 +948,16 @@ class LLScriptExpression : public LLScriptFilePosition
 {
 public:
 	LLScriptExpression(S32 line, S32 col, LSCRIPTExpressionType type)
-		: LLScriptFilePosition(line, col), mType(type), mNextp(NULL), mLeftType(LST_NULL), mRightType(LST_NULL), mReturnType(LST_NULL)
+		: LLScriptFilePosition(line, col), mType(type), mNextp(NULL), mLeftType(LST_NULL), mRightType(LST_NULL), mReturnType(LST_NULL), mFoldedConstant(NULL)
 	{
 	}
 
 	void addExpression(LLScriptExpression *expression);
 
+	// if the optimize pass folded this expression, pushes its value
+	// instead of the code that computes it and returns TRUE
+	BOOL emitFolded(LLFILE *fp, LSCRIPTCompilePass pass, LLScriptByteCodeChunk *chunk, LLScriptByteCodeChunk *heap);
+
 	virtual ~LLScriptExpression() 
 	{
 		// don't delete next pointer because we're going to store allocation lists and delete from those
@@ -968,6 +972,8 @@ public:
 	LLScriptExpression		*mNextp;
 	LSCRIPTType				mLeftType, mRightType, mReturnType;
 
+	// value computed by the optimize pass, owned by gAllocationManager
+	LLScriptConstant		*mFoldedConstant;
 };
 
 class LLScriptForExpressionList : public LLScriptExpression
@@ -1792,6 +1798,14 @@ public:
 	LLScriptConstant	*mConstant;
 };
 
+// what the optimize pass knows about a branch condition
+typedef enum e_lscript_folded_condition
+{
+	LSFC_UNKNOWN,
+	LSFC_TRUE,
+	LSFC_FALSE
+} LSCRIPTFoldedCondition;
+
 // statement
 typedef enum e_lscript_statement_types
 {
@@ -1967,7 +1981,7 @@ class LLScriptIf : public LLScriptStatement
 {
 public:
 	LLScriptIf(S32 line, S32 col, LLScriptExpression *expression, LLScriptStatement *statement)
-		: LLScriptStatement(line, col, LSSMT_IF), mType(LST_NULL), mExpression(expression), mStatement(statement)
+		: LLScriptStatement(line, col, LSSMT_IF), mType(LST_NULL), mExpression(expression), mStatement(statement), mCondition(LSFC_UNKNOWN)
 	{
 	}
 
@@ -1981,13 +1995,14 @@ public:
 	LSCRIPTType				mType;
 	LLScriptExpression		*mExpression;
 	LLScriptStatement		*mStatement;
+	LSCRIPTFoldedCondition	mCondition;
 };
 
 class LLScriptIfElse : public LLScriptStatement
 {
 public:
 	LLScriptIfElse(S32 line, S32 col, LLScriptExpression *expression, LLScriptStatement *statement1, LLScriptStatement *statement2)
-		: LLScriptStatement(line, col, LSSMT_IF_ELSE), mExpression(expression), mStatement1(statement1), mStatement2(statement2), mType(LST_NULL)
+		: LLScriptStatement(line, col, LSSMT_IF_ELSE), mExpression(expression), mStatement1(statement1), mStatement2(statement2), mType(LST_NULL), mCondition(LSFC_UNKNOWN)
 	{
 	}
 
@@ -2002,6 +2017,7 @@ public:
 	LLScriptStatement		*mStatement1;
 	LLScriptStatement		*mStatement2;
 	LSCRIPTType				mType;
+	LSCRIPTFoldedCondition	mCondition;
 };
 
 class LLScriptFor : public LLScriptStatement
@@ -2050,7 +2066,7 @@ class LLScriptWhile : public LLScriptStatement
 {
 public:
 	LLScriptWhile(S32 line, S32 col, LLScriptExpression *expression, LLScriptStatement *statement)
-		: LLScriptStatement(line, col, LSSMT_WHILE), mExpression(expression), mStatement(statement), mType(LST_NULL)
+		: LLScriptStatement(line, col, LSSMT_WHILE), mExpression(expression), mStatement(statement), mType(LST_NULL), mCondition(LSFC_UNKNOWN)
 	{
 	}
 
@@ -2064,6 +2080,7 @@ public:
 	LLScriptExpression			*mExpression;
 	LLScriptStatement			*mStatement;
 	LSCRIPTType					mType;
+	LSCRIPTFoldedCondition		mCondition;
 };
 
 // local variables
@@ -35,7 +35,13 @@
 
 BOOL lscript_compile(char *filename, BOOL compile_to_mono, BOOL is_god_like = FALSE);
 BOOL lscript_compile(const char* src_filename, const char* dst_filename,
-					 const char* err_filename, BOOL compile_to_mono, const char* class_name, BOOL is_god_like = FALSE);
+					 const char* err_filename, BOOL compile_to_mono, const char* class_name, BOOL is_god_like = FALSE,
+					 BOOL optimize = TRUE);
+// Compiles to LSO bytecode like lscript_compile(), but reuses the output of
+// an earlier successful compile of identical source.  Cached files are named
+// cache_prefix followed by a hash of the source; pass NULL to bypass.
+BOOL lscript_compile_cached(const char* src_filename, const char* dst_filename,
+							const char* err_filename, const char* cache_prefix, BOOL is_god_like = FALSE);
 void lscript_run(const std::string& filename, BOOL b_debug);
 
 
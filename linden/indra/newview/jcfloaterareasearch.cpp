@@ -67,6 +67,10 @@ mResultList(0)
 
 JCFloaterAreaSearch::~JCFloaterAreaSearch()
 {
+	if (mResultList)
+	{
+		mResultList->setDataSource(NULL);
+	}
 	sInstance = NULL;
 }
 
@@ -90,6 +94,7 @@ BOOL JCFloaterAreaSearch::postBuild()
 	mResultList = getChild<LLScrollListCtrl>("result_list");
 	mResultList->setCallbackUserData(this);
 	mResultList->setDoubleClickCallback(onDoubleClick);
+	mResultList->setDataSource(this);
 	mResultList->sortByColumn("Name", TRUE);
 
 	mCounterText = getChild<LLTextBox>("counter");
@@ -117,7 +122,8 @@ void JCFloaterAreaSearch::checkRegion()
 		sObjectDetails.clear();
 		if (sInstance)
 		{
-			sInstance->mResultList->deleteAllItems();
+			sInstance->mResults.clear();
+			sInstance->mResultList->refreshDataSource();
 			sInstance->mCounterText->setText(std::string("Listed/Pending/Total"));
 		}
 	}
@@ -235,9 +241,7 @@ void JCFloaterAreaSearch::results()
 	if (!(sInstance->getVisible())) return;
 	if (sRequested > 0 && sInstance->mLastUpdateTimer.getElapsedTimeF32() < min_refresh_interval) return;
 	//llinfos << "results()" << llendl;
-	LLDynamicArray<LLUUID> selected = sInstance->mResultList->getSelectedIDs();
-	S32 scrollpos = sInstance->mResultList->getScrollPos();
-	sInstance->mResultList->deleteAllItems();
+	std::vector<result_row_t> found;
 	S32 i;
 	S32 total = gObjectList.getNumObjects();
 
@@ -281,21 +285,13 @@ void JCFloaterAreaSearch::results()
 							(sSearchedGroup == "" || object_group.find(sSearchedGroup) != -1))
 						{
 							//llinfos << "pass" << llendl;
-							LLSD element;
-							element["id"] = object_id;
-							element["columns"][LIST_OBJECT_NAME]["column"] = "Name";
-							element["columns"][LIST_OBJECT_NAME]["type"] = "text";
-							element["columns"][LIST_OBJECT_NAME]["value"] = details->name;	//item->getName();//ai->second//"avatar_icon";
-							element["columns"][LIST_OBJECT_DESC]["column"] = "Description";
-							element["columns"][LIST_OBJECT_DESC]["type"] = "text";
-							element["columns"][LIST_OBJECT_DESC]["value"] = details->desc;	//ai->second;
-							element["columns"][LIST_OBJECT_OWNER]["column"] = "Owner";
-							element["columns"][LIST_OBJECT_OWNER]["type"] = "text";
-							element["columns"][LIST_OBJECT_OWNER]["value"] = onU;			//ai->first;
-							element["columns"][LIST_OBJECT_GROUP]["column"] = "Group";
-							element["columns"][LIST_OBJECT_GROUP]["type"] = "text";
-							element["columns"][LIST_OBJECT_GROUP]["value"] = cnU;			//ai->second;
-							sInstance->mResultList->addElement(element, ADD_BOTTOM);
+							result_row_t row;
+							row.id = object_id;
+							row.name = details->name;
+							row.desc = details->desc;
+							row.owner = onU;
+							row.group = cnU;
+							found.push_back(row);
 						}
 					}
 				}
@@ -303,13 +299,85 @@ void JCFloaterAreaSearch::results()
 		}
 	}
 
-	sInstance->mResultList->sortItems();
-	sInstance->mResultList->selectMultiple(selected);
-	sInstance->mResultList->setScrollPos(scrollpos);
+	// Rows already listed keep their place: when all of them still match
+	// unchanged, only the new matches are appended and merged into the sort.
+	// Anything else (a row gone or renamed, a new query) rebuilds the list.
+	std::map<LLUUID, const result_row_t*> matches;
+	for (std::vector<result_row_t>::const_iterator it = found.begin(); it != found.end(); ++it)
+	{
+		matches[it->id] = &(*it);
+	}
+	bool append_only = true;
+	for (std::vector<result_row_t>::const_iterator it = sInstance->mResults.begin(); it != sInstance->mResults.end(); ++it)
+	{
+		std::map<LLUUID, const result_row_t*>::iterator match = matches.find(it->id);
+		if (match == matches.end() || !(*match->second == *it))
+		{
+			append_only = false;
+			break;
+		}
+		matches.erase(match);
+	}
+
+	if (append_only)
+	{
+		for (std::vector<result_row_t>::const_iterator it = found.begin(); it != found.end(); ++it)
+		{
+			if (matches.count(it->id))
+			{
+				sInstance->mResults.push_back(*it);
+			}
+		}
+		sInstance->mResultList->appendDataSourceRows();
+	}
+	else
+	{
+		sInstance->mResults.swap(found);
+		// keeps the selection and scroll position
+		sInstance->mResultList->refreshDataSource();
+	}
 	sInstance->mCounterText->setText(llformat("%d listed/%d pending/%d total", sInstance->mResultList->getItemCount(), sRequested, sObjectDetails.size()));
 	sInstance->mLastUpdateTimer.reset();
 }
 
+std::string JCFloaterAreaSearch::getCellText(S32 row, S32 column) const
+{
+	const result_row_t& result = mResults[row];
+	switch (column)
+	{
+	case LIST_OBJECT_NAME:
+		return result.name;
+	case LIST_OBJECT_DESC:
+		return result.desc;
+	case LIST_OBJECT_OWNER:
+		return result.owner;
+	case LIST_OBJECT_GROUP:
+		return result.group;
+	default:
+		return LLStringUtil::null;
+	}
+}
+
+LLSD JCFloaterAreaSearch::getRowElement(S32 row) const
+{
+	const result_row_t& result = mResults[row];
+	LLSD element;
+	element["id"] = result.id;
+	element["columns"][LIST_OBJECT_NAME]["column"] = "Name";
+	element["columns"][LIST_OBJECT_NAME]["type"] = "text";
+	element["columns"][LIST_OBJECT_NAME]["value"] = result.name;
+	element["columns"][LIST_OBJECT_DESC]["column"] = "Description";
+	element["columns"][LIST_OBJECT_DESC]["type"] = "text";
+	element["columns"][LIST_OBJECT_DESC]["value"] = result.desc;
+	element["columns"][LIST_OBJECT_OWNER]["column"] = "Owner";
+	element["columns"][LIST_OBJECT_OWNER]["type"] = "text";
+	element["columns"][LIST_OBJECT_OWNER]["value"] = result.owner;
+	element["columns"][LIST_OBJECT_GROUP]["column"] = "Group";
+	element["columns"][LIST_OBJECT_GROUP]["type"] = "text";
+	element["columns"][LIST_OBJECT_GROUP]["value"] = result.group;
+	return element;
+}
+
 // static
 void JCFloaterAreaSearch::callbackLoadOwnerName(const LLUUID& id, const std::string& first, const std::string& last, BOOL is_group, void* data)
 {
@@ -35,9 +35,9 @@
 #include "lluuid.h"
 #include "llstring.h"
 #include "llframetimer.h"
+#include "llscrolllistctrl.h"
 
 class LLTextBox;
-class LLScrollListCtrl;
 class LLViewerRegion;
 
 struct AObjectDetails
@@ -49,7 +49,9 @@ struct AObjectDetails
 	LLUUID group_id;
 };
 
-class JCFloaterAreaSearch : public LLFloater
+// The result list pulls its rows from the floater, so only the rows on
+// screen get cells however many objects match.
+class JCFloaterAreaSearch : public LLFloater, public LLScrollListDataSource
 {
 public:
 	JCFloaterAreaSearch();
@@ -64,6 +66,12 @@ public:
 	static void callbackLoadOwnerName(const LLUUID& id, const std::string& first, const std::string& last, BOOL is_group, void* data);
 	static void processObjectPropertiesFamily(LLMessageSystem* msg, void** user_data);
 
+	// LLScrollListDataSource
+	/*virtual*/ S32 getRowCount() const { return mResults.size(); }
+	/*virtual*/ LLSD getRowValue(S32 row) const { return mResults[row].id; }
+	/*virtual*/ std::string getCellText(S32 row, S32 column) const;
+	/*virtual*/ LLSD getRowElement(S32 row) const;
+
 private:
 	static void checkRegion();
 	static void cancel(void* data);
@@ -88,6 +96,22 @@ private:
 	LLScrollListCtrl* mResultList;
 	LLFrameTimer mLastUpdateTimer;
 
+	struct result_row_t
+	{
+		LLUUID id;
+		std::string name;
+		std::string desc;
+		std::string owner;
+		std::string group;
+
+		bool operator==(const result_row_t& other) const
+		{
+			return id == other.id && name == other.name && desc == other.desc &&
+				   owner == other.owner && group == other.group;
+		}
+	};
+	std::vector<result_row_t> mResults;
+
 	static std::map<LLUUID, AObjectDetails> sObjectDetails;
 
 	static std::string sSearchedName;
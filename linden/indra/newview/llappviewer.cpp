@@ -90,6 +90,7 @@
 #include "llnotify.h"
 #include "llviewerkeyboard.h"
 #include "lllfsthread.h"
+#include "lltaskscheduler.h"
 #include "llworkerthread.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
@@ -146,6 +147,7 @@
 #include "lltoolbar.h"
 #include "llframestats.h"
 #include "llagentpilot.h"
+#include "llviewerbenchmark.h"
 #include "llsrv.h"
 #include "llvovolume.h"
 #include "llflexibleobject.h" 
@@ -403,6 +405,7 @@ static void settings_to_globals()
 	LLImageGL::sGlobalUseAnisotropic	= gSavedSettings.getBOOL("RenderAnisotropic");
 	LLVOVolume::sLODFactor				= gSavedSettings.getF32("RenderVolumeLODFactor");
 	LLVOVolume::sDistanceFactor			= 1.f-LLVOVolume::sLODFactor * 0.1f;
+	LLVolumeFace::sOptimizeVertexCache	= gSavedSettings.getBOOL("RenderOptimizeVertexCache");
 	LLVolumeImplFlexible::sUpdateFactor = gSavedSettings.getF32("RenderFlexTimeFactor");
 	LLVOTree::sTreeFactor				= gSavedSettings.getF32("RenderTreeLODFactor");
 	LLVOAvatar::sLODFactor				= gSavedSettings.getF32("RenderAvatarLODFactor");
@@ -916,6 +919,7 @@ bool LLAppViewer::mainLoop()
 	// Handle messages
 	while (!LLApp::isExiting())
 	{
+		gViewerBenchmark.logFrame(); // reads the counters reset() clears
 		LLFastTimer::reset(); // Should be outside of any timer instances
 		try
 		{
@@ -1291,6 +1295,7 @@ bool LLAppViewer::cleanup()
 	removeCacheFiles("*.dsf");
 	removeCacheFiles("*.bodypart");
 	removeCacheFiles("*.clothing");
+	removeCacheFiles("lslc_*");		// compiled script cache
 
 	llinfos << "Cache files removed" << llendflush;
 
@@ -1465,6 +1470,9 @@ bool LLAppViewer::cleanup()
 		}
 	}
 	
+	// make sure the inventory caches written on logout are complete
+	LLInventoryModel::flushCacheWrites();
+
 	// Delete workers first
 	// shutdown all worker threads before deleting them in case of co-dependencies
 	sTextureCache->shutdown();
@@ -1492,6 +1500,9 @@ bool LLAppViewer::cleanup()
 	LLVFSThread::cleanupClass();
 	LLLFSThread::cleanupClass();
 
+	// Only once every queue that used it is gone
+	LLTaskScheduler::cleanupClass();
+
 	llinfos << "VFS Thread finished" << llendflush;
 
 #ifndef LL_RELEASE_FOR_DOWNLOAD
@@ -1573,6 +1584,12 @@ bool LLAppViewer::initThreads()
 		LLWatchdog::getInstance()->init(watchdog_killer_callback);
 	}
 
+	// Background queues share one pool of workers unless this is off
+	if (enable_threads && gSavedSettings.getBOOL("BackgroundWorkerPool"))
+	{
+		LLTaskScheduler::initClass(llmax(gSavedSettings.getS32("BackgroundWorkerThreads"), 0));
+	}
+
 	LLVFSThread::initClass(enable_threads && false);
 	LLLFSThread::initClass(enable_threads && false);
 
@@ -3262,7 +3279,7 @@ void LLAppViewer::loadNameCache()
 
 	std::string name_cache;
 	name_cache = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name.cache");
-	llifstream cache_file(name_cache);
+	llifstream cache_file(name_cache, llifstream::binary);
 	if(cache_file.is_open())
 	{
 		if(gCacheName->importFile(cache_file)) return;
@@ -3284,7 +3301,7 @@ void LLAppViewer::saveNameCache()
 
 	std::string name_cache;
 	name_cache = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name.cache");
-	llofstream cache_file(name_cache);
+	llofstream cache_file(name_cache, llofstream::binary);
 	if(cache_file.is_open())
 	{
 		gCacheName->exportFile(cache_file);
@@ -3399,6 +3416,9 @@ void LLAppViewer::idle()
 	    // Handle automatic walking towards points
 	    gAgentPilot.updateTarget();
 	    gAgent.autoPilot(&yaw);
+
+	    // Fly the benchmark camera path, if any
+	    gViewerBenchmark.updateCamera();
     
 	    static LLFrameTimer agent_update_timer;
 	    static U32 				last_control_flags;
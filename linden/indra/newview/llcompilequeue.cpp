@@ -571,10 +571,13 @@ void LLFloaterCompileQueue::compile(const std::string& filename,
 								  LLAssetType::AT_LSL_TEXT,
 								  &onSaveTextComplete, NULL, FALSE);
 
-	const BOOL compile_to_mono = FALSE;
-	if(!lscript_compile(filename.c_str(), dst_filename.c_str(),
-						err_filename.c_str(), compile_to_mono,
-						uuid_string.c_str(), gAgent.isGodlike()))
+	// recompiling a whole object usually hits scripts already compiled
+	// from identical source, so let those come out of the compile cache
+	std::string cache_prefix = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "lslc_");
+	if(!lscript_compile_cached(filename.c_str(), dst_filename.c_str(),
+							   err_filename.c_str(),
+							   gSavedSettings.getBOOL("LSLCompileCache") ? cache_prefix.c_str() : NULL,
+							   gAgent.isGodlike()))
 	{
 		llwarns << "compile failed" << llendl;
 		removeItemByItemID(item_id);
@@ -900,6 +900,61 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 							   const S32 &f,
 								const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
 								const U16 &index_offset)
+{
+	VolumeGeometryParams params;
+	if (!prepareGeometryVolume(volume, f, mat_vert, mat_normal, index_offset, params))
+	{
+		return FALSE;
+	}
+
+	LLStrider<LLVector3> vertices;
+	LLStrider<LLVector2> tex_coords;
+	LLStrider<LLVector2> tex_coords2;
+	LLStrider<LLVector3> normals;
+	LLStrider<LLColor4U> colors;
+	LLStrider<LLVector3> binormals;
+	LLStrider<U16> indicesp;
+
+	if (params.mRebuildPos)
+	{
+		mVertexBuffer->getVertexStrider(vertices, mGeomIndex);
+	}
+	if (params.mRebuildNormal)
+	{
+		mVertexBuffer->getNormalStrider(normals, mGeomIndex);
+	}
+	if (params.mRebuildBinormal)
+	{
+		mVertexBuffer->getBinormalStrider(binormals, mGeomIndex);
+	}
+	if (params.mRebuildTCoord)
+	{
+		mVertexBuffer->getTexCoord0Strider(tex_coords, mGeomIndex);
+	}
+	if (params.mRebuildTCoord2)
+	{
+		mVertexBuffer->getTexCoord1Strider(tex_coords2, mGeomIndex);
+	}
+	if (params.mRebuildColor)
+	{	
+		mVertexBuffer->getColorStrider(colors, mGeomIndex);
+	}
+	if (params.mRebuildIndices)
+	{
+		mVertexBuffer->getIndexStrider(indicesp, mIndicesIndex);
+	}
+
+	fillGeometryVolume(params, vertices, normals, binormals, tex_coords, tex_coords2, colors, indicesp);
+
+	return TRUE;
+}
+
+BOOL LLFace::prepareGeometryVolume(const LLVolume& volume,
+								   const S32 &f,
+								   const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
+								   const U16 &index_offset,
+								   VolumeGeometryParams& params,
+								   BOOL force_full)
 {
 	const LLVolumeFace &vf = volume.getVolumeFace(f);
 	S32 num_vertices = (S32)vf.mVertices.size();
@@ -920,69 +975,43 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		}
 	}
 
-	LLStrider<LLVector3> vertices;
-	LLStrider<LLVector2> tex_coords;
-	LLStrider<LLVector2> tex_coords2;
-	LLStrider<LLVector3> normals;
-	LLStrider<LLColor4U> colors;
-	LLStrider<LLVector3> binormals;
-	LLStrider<U16> indicesp;
+	params.mVolumeFace = &vf;
+	params.mMatVert = mat_vert;
+	params.mMatNormal = mat_normal;
+	params.mIndexOffset = index_offset;
 
-	BOOL full_rebuild = mDrawablep->isState(LLDrawable::REBUILD_VOLUME);
+	BOOL full_rebuild = force_full || mDrawablep->isState(LLDrawable::REBUILD_VOLUME);
 	
 	BOOL global_volume = mDrawablep->getVOVolume()->isVolumeGlobal();
-	LLVector3 scale;
 	if (global_volume)
 	{
-		scale.setVec(1,1,1);
+		params.mScale.setVec(1,1,1);
 	}
 	else
 	{
-		scale = mVObjp->getScale();
+		params.mScale = mVObjp->getScale();
 	}
 	
 	BOOL rebuild_pos = full_rebuild || mDrawablep->isState(LLDrawable::REBUILD_POSITION);
 	BOOL rebuild_color = full_rebuild || mDrawablep->isState(LLDrawable::REBUILD_COLOR);
 	BOOL rebuild_tcoord = full_rebuild || mDrawablep->isState(LLDrawable::REBUILD_TCOORD);
-	BOOL rebuild_normal = rebuild_pos && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_NORMAL);
-	BOOL rebuild_binormal = rebuild_pos && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_BINORMAL);
 
 	const LLTextureEntry *tep = mVObjp->getTE(f);
 	U8  bump_code = tep ? tep->getBumpmap() : 0;
 
-	if (rebuild_pos)
-	{
-		mVertexBuffer->getVertexStrider(vertices, mGeomIndex);
-	}
-	if (rebuild_normal)
-	{
-		mVertexBuffer->getNormalStrider(normals, mGeomIndex);
-	}
-	if (rebuild_binormal)
-	{
-		mVertexBuffer->getBinormalStrider(binormals, mGeomIndex);
-	}
-
-	if (rebuild_tcoord)
-	{
-		mVertexBuffer->getTexCoord0Strider(tex_coords, mGeomIndex);
-		if (bump_code && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TEXCOORD1))
-		{
-			mVertexBuffer->getTexCoord1Strider(tex_coords2, mGeomIndex);
-		}
-	}
-	if (rebuild_color)
-	{	
-		mVertexBuffer->getColorStrider(colors, mGeomIndex);
-	}
+	params.mRebuildIndices = full_rebuild;
+	params.mRebuildPos = rebuild_pos;
+	params.mRebuildNormal = rebuild_pos && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_NORMAL);
+	params.mRebuildBinormal = rebuild_pos && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_BINORMAL);
+	params.mRebuildTCoord = rebuild_tcoord;
+	params.mRebuildTCoord2 = rebuild_tcoord && bump_code && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TEXCOORD1);
+	params.mRebuildColor = rebuild_color;
 
 	F32 r = 0, os = 0, ot = 0, ms = 0, mt = 0, cos_ang = 0, sin_ang = 0;
 	
 	BOOL is_static = mDrawablep->isStatic();
 	BOOL is_global = is_static;
 
-	LLVector3 center_sum(0.f, 0.f, 0.f);
-	
 	if (is_global)
 	{
 		setState(GLOBAL);
@@ -992,10 +1021,6 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		clearState(GLOBAL);
 	}
 
-	LLVector2 tmin, tmax;
-	
-	
-
 	if (rebuild_tcoord)
 	{
 		if (tep)
@@ -1045,6 +1070,18 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		}
 	}
 
+	params.mUseTextureMatrix = tex_mode && mTextureMatrix;
+	if (params.mUseTextureMatrix)
+	{
+		params.mTextureMatrix = *mTextureMatrix;
+	}
+	params.mCosAng = cos_ang;
+	params.mSinAng = sin_ang;
+	params.mOffsetS = os;
+	params.mOffsetT = ot;
+	params.mScaleS = ms;
+	params.mScaleT = mt;
+
 	LLColor4U color = tep->getColor();
 
 	if (rebuild_color)
@@ -1062,29 +1099,19 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 			color.mV[3] = U8 (alpha[tep->getShiny()] * 255);
 		}
 	}
+	params.mColor = color;
 
-    // INDICES
-	if (full_rebuild)
-	{
-		mVertexBuffer->getIndexStrider(indicesp, mIndicesIndex);
-		for (U16 i = 0; i < num_indices; i++)
-		{
-			*indicesp++ = vf.mIndices[i] + index_offset;
-		}
-	}
-	
-	
 	//bump setup
-	LLVector3 binormal_dir( -sin_ang, cos_ang, 0 );
-	LLVector3 bump_s_primary_light_ray;
-	LLVector3 bump_t_primary_light_ray;
-
-	LLQuaternion bump_quat;
-	if (mDrawablep->isActive())
+	params.mBinormalDir.setVec( -sin_ang, cos_ang, 0 );
+	params.mActive = mDrawablep->isActive();
+	params.mBumpQuat = LLQuaternion();
+	if (params.mActive)
 	{
-		bump_quat = LLQuaternion(mDrawablep->getRenderMatrix());
+		params.mBumpQuat = LLQuaternion(mDrawablep->getRenderMatrix());
 	}
 	
+	params.mBumpSRay.clearVec();
+	params.mBumpTRay.clearVec();
 	if (bump_code)
 	{
 		mVObjp->getVolume()->genBinormals(f);
@@ -1129,19 +1156,61 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 		LLVector3   moon_ray = gSky.getMoonDirection();
 		LLVector3& primary_light_ray = (sun_ray.mV[VZ] > 0) ? sun_ray : moon_ray;
 
-		bump_s_primary_light_ray = offset_multiple * s_scale * primary_light_ray;
-		bump_t_primary_light_ray = offset_multiple * t_scale * primary_light_ray;
+		params.mBumpSRay = offset_multiple * s_scale * primary_light_ray;
+		params.mBumpTRay = offset_multiple * t_scale * primary_light_ray;
 	}
 		
-	U8 texgen = getTextureEntry()->getTexGen();
-	if (rebuild_tcoord && texgen != LLTextureEntry::TEX_GEN_DEFAULT)
+	params.mTexGen = getTextureEntry()->getTexGen();
+	if (rebuild_tcoord && params.mTexGen != LLTextureEntry::TEX_GEN_DEFAULT)
 	{ //planar texgen needs binormals
 		mVObjp->getVolume()->genBinormals(f);
 	}
 
+	if (rebuild_tcoord)
+	{
+		mTexExtents[0].setVec(0,0);
+		mTexExtents[1].setVec(1,1);
+		xform(mTexExtents[0], cos_ang, sin_ang, os, ot, ms, mt);
+		xform(mTexExtents[1], cos_ang, sin_ang, os, ot, ms, mt);		
+	}
+
+	mLastVertexBuffer = mVertexBuffer;
+	mLastGeomCount = mGeomCount;
+	mLastGeomIndex = mGeomIndex;
+	mLastIndicesCount = mIndicesCount;
+	mLastIndicesIndex = mIndicesIndex;
+
+	return TRUE;
+}
+
+//static
+void LLFace::fillGeometryVolume(const VolumeGeometryParams& params,
+								LLStrider<LLVector3>& vertices,
+								LLStrider<LLVector3>& normals,
+								LLStrider<LLVector3>& binormals,
+								LLStrider<LLVector2>& tex_coords,
+								LLStrider<LLVector2>& tex_coords2,
+								LLStrider<LLColor4U>& colors,
+								LLStrider<U16>& indicesp)
+{
+	const LLVolumeFace& vf = *params.mVolumeFace;
+	S32 num_vertices = (S32)vf.mVertices.size();
+	S32 num_indices = (S32)vf.mIndices.size();
+
+    // INDICES
+	if (params.mRebuildIndices)
+	{
+		for (U16 i = 0; i < num_indices; i++)
+		{
+			*indicesp++ = vf.mIndices[i] + params.mIndexOffset;
+		}
+	}
+
+	const U8 texgen = params.mTexGen;
+
 	for (S32 i = 0; i < num_vertices; i++)
 	{
-		if (rebuild_tcoord)
+		if (params.mRebuildTCoord)
 		{
 			LLVector2 tc = vf.mVertices[i].mTexCoord;
 		
@@ -1149,7 +1218,7 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 			{
 				LLVector3 vec = vf.mVertices[i].mPosition; 
 			
-				vec.scaleVec(scale);
+				vec.scaleVec(params.mScale);
 
 				switch (texgen)
 				{
@@ -1167,82 +1236,66 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 				}		
 			}
 
-			if (tex_mode && mTextureMatrix)
+			if (params.mUseTextureMatrix)
 			{
 				LLVector3 tmp(tc.mV[0], tc.mV[1], 0.f);
-				tmp = tmp * *mTextureMatrix;
+				tmp = tmp * params.mTextureMatrix;
 				tc.mV[0] = tmp.mV[0];
 				tc.mV[1] = tmp.mV[1];
 			}
 			else
 			{
-				xform(tc, cos_ang, sin_ang, os, ot, ms, mt);
+				xform(tc, params.mCosAng, params.mSinAng, params.mOffsetS, params.mOffsetT, params.mScaleS, params.mScaleT);
 			}
 
 			*tex_coords++ = tc;
 		
-			if (bump_code && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TEXCOORD1))
+			if (params.mRebuildTCoord2)
 			{
 				LLVector3 tangent = vf.mVertices[i].mBinormal % vf.mVertices[i].mNormal;
 
 				LLMatrix3 tangent_to_object;
 				tangent_to_object.setRows(tangent, vf.mVertices[i].mBinormal, vf.mVertices[i].mNormal);
-				LLVector3 binormal = binormal_dir * tangent_to_object;
-				binormal = binormal * mat_normal;
+				LLVector3 binormal = params.mBinormalDir * tangent_to_object;
+				binormal = binormal * params.mMatNormal;
 				
-				if (mDrawablep->isActive())
+				if (params.mActive)
 				{
-					binormal *= bump_quat;
+					binormal *= params.mBumpQuat;
 				}
 
 				binormal.normVec();
-				tc += LLVector2( bump_s_primary_light_ray * tangent, bump_t_primary_light_ray * binormal );
+				tc += LLVector2( params.mBumpSRay * tangent, params.mBumpTRay * binormal );
 				
 				*tex_coords2++ = tc;
 			}	
 		}
 			
-		if (rebuild_pos)
+		if (params.mRebuildPos)
 		{
-			*vertices++ = vf.mVertices[i].mPosition * mat_vert;
+			*vertices++ = vf.mVertices[i].mPosition * params.mMatVert;
 		}
 		
-		if (rebuild_normal)
+		if (params.mRebuildNormal)
 		{
-			LLVector3 normal = vf.mVertices[i].mNormal * mat_normal;
+			LLVector3 normal = vf.mVertices[i].mNormal * params.mMatNormal;
 			normal.normVec();
 			
 			*normals++ = normal;
 		}
 		
-		if (rebuild_binormal)
+		if (params.mRebuildBinormal)
 		{
-			LLVector3 binormal = vf.mVertices[i].mBinormal * mat_normal;
+			LLVector3 binormal = vf.mVertices[i].mBinormal * params.mMatNormal;
 			binormal.normVec();
 			*binormals++ = binormal;
 		}
 		
-		if (rebuild_color)
+		if (params.mRebuildColor)
 		{
-			*colors++ = color;		
+			*colors++ = params.mColor;		
 		}
 	}
-
-	if (rebuild_tcoord)
-	{
-		mTexExtents[0].setVec(0,0);
-		mTexExtents[1].setVec(1,1);
-		xform(mTexExtents[0], cos_ang, sin_ang, os, ot, ms, mt);
-		xform(mTexExtents[1], cos_ang, sin_ang, os, ot, ms, mt);		
-	}
-
-	mLastVertexBuffer = mVertexBuffer;
-	mLastGeomCount = mGeomCount;
-	mLastGeomIndex = mGeomIndex;
-	mLastIndicesCount = mIndicesCount;
-	mLastIndicesIndex = mIndicesIndex;
-
-	return TRUE;
 }
 
 const F32 LEAST_IMPORTANCE = 0.05f ;
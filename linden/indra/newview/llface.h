@@ -39,6 +39,7 @@
 #include "v2math.h"
 #include "v3math.h"
 #include "v4math.h"
+#include "m3math.h"
 #include "m4math.h"
 #include "v4coloru.h"
 #include "llquaternion.h"
@@ -51,6 +52,7 @@
 
 class LLFacePool;
 class LLVolume;
+class LLVolumeFace;
 class LLViewerImage;
 class LLTextureEntry;
 class LLVertexProgram;
@@ -145,6 +147,54 @@ public:
 						const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
 						const U16 &index_offset);
 
+	// Everything needed to write one volume face into a vertex buffer.
+	// prepareGeometryVolume() gathers it on the main thread (and updates the
+	// face's own state), fillGeometryVolume() only reads it and the volume
+	// face, so it may run on a worker thread.
+	struct VolumeGeometryParams
+	{
+		const LLVolumeFace* mVolumeFace;
+		LLMatrix4	mMatVert;
+		LLMatrix3	mMatNormal;
+		LLMatrix4	mTextureMatrix;
+		LLVector3	mScale;
+		LLVector3	mBinormalDir;
+		LLVector3	mBumpSRay;
+		LLVector3	mBumpTRay;
+		LLQuaternion mBumpQuat;
+		LLColor4U	mColor;
+		F32			mCosAng, mSinAng;
+		F32			mOffsetS, mOffsetT;
+		F32			mScaleS, mScaleT;
+		U16			mIndexOffset;
+		U8			mTexGen;
+		BOOL		mUseTextureMatrix;
+		BOOL		mActive;
+		BOOL		mRebuildIndices;
+		BOOL		mRebuildPos;
+		BOOL		mRebuildNormal;
+		BOOL		mRebuildBinormal;
+		BOOL		mRebuildTCoord;
+		BOOL		mRebuildTCoord2;
+		BOOL		mRebuildColor;
+	};
+
+	// force_full rebuilds every stream regardless of the drawable's rebuild flags
+	BOOL prepareGeometryVolume(const LLVolume& volume,
+						const S32 &f,
+						const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
+						const U16 &index_offset,
+						VolumeGeometryParams& params,
+						BOOL force_full = FALSE);
+	static void fillGeometryVolume(const VolumeGeometryParams& params,
+						LLStrider<LLVector3>& vertices,
+						LLStrider<LLVector3>& normals,
+						LLStrider<LLVector3>& binormals,
+						LLStrider<LLVector2>& tex_coords,
+						LLStrider<LLVector2>& tex_coords2,
+						LLStrider<LLColor4U>& colors,
+						LLStrider<U16>& indices);
+
 	// For avatar
 	U16			 getGeometryAvatar(
 									LLStrider<LLVector3> &vertices,
@@ -39,6 +39,7 @@
 #include "llerror.h"
 #include "llgl.h"
 #include "llrender.h"
+#include "llvertexbuffer.h"
 #include "llmath.h"
 #include "llfontgl.h"
 
@@ -143,6 +144,8 @@ static struct ft_display_info ft_display_table[] =
 	{ LLFastTimer::FTM_CULL,				"  Object Cull",	&LLColor4::blue2, 1 },
     { LLFastTimer::FTM_CULL_REBOUND,		"   Rebound",		&LLColor4::blue3, 0 },
 	{ LLFastTimer::FTM_FRUSTUM_CULL,		"   Frustum Cull",	&LLColor4::blue4, 0 },
+	{ LLFastTimer::FTM_CULL_PRECULL,		"   Precull",		&LLColor4::blue5, 0 },
+	{ LLFastTimer::FTM_CULL_OCCLUDERS,		"   Occluders",		&LLColor4::blue6, 0 },
 	{ LLFastTimer::FTM_OCCLUSION_READBACK,	"   Occlusion Read", &LLColor4::red2, 0 },
 	{ LLFastTimer::FTM_IMAGE_UPDATE,		"  Image Update",	&LLColor4::yellow4, 1 },
 	{ LLFastTimer::FTM_IMAGE_CREATE,		"   Image CreateGL",&LLColor4::yellow5, 0 },
@@ -279,6 +282,21 @@ LLFastTimerView::~LLFastTimerView()
 	delete[] mBarEnd;
 }
 
+// static
+void LLFastTimerView::getTimerNames(std::vector<std::pair<LLFastTimer::EFastTimerType, std::string> >& timers)
+{
+	for (S32 i = 0; i < FTV_DISPLAY_NUM; i++)
+	{
+		// descriptions keep their indentation until the first view is built
+		const char* desc = ft_display_table[i].desc;
+		while (desc[0] == ' ')
+		{
+			desc++;
+		}
+		timers.push_back(std::make_pair((LLFastTimer::EFastTimerType)ft_display_table[i].timer, std::string(desc)));
+	}
+}
+
 BOOL LLFastTimerView::handleRightMouseDown(S32 x, S32 y, MASK mask)
 {
 	if (mBarRect.pointInRect(x, y))
@@ -503,6 +521,10 @@ void LLFastTimerView::draw()
 
 		textw = LLFontGL::getFontMonospace()->getWidth(tdesc);
 
+		tdesc = llformat("Streamed VB: %.1f KB, %d ring wraps",
+						 LLVertexBuffer::sLastStreamedBytes/1024.f, LLVertexBuffer::sLastStreamRingWraps);
+		LLFontGL::getFontMonospace()->renderUTF8(tdesc, 0, x + textw + 40, y, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
+
 		x = xleft, y -= (texth + 2);
 		tdesc = llformat("Justification = %s [CTRL-Click to toggle]",centerdesc[mDisplayCenter]);
 		LLFontGL::getFontMonospace()->renderUTF8(tdesc, 0, x, y, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
@@ -51,6 +51,9 @@ public:
 
 	S32 getLegendIndex(S32 y);
 	F64 getTime(LLFastTimer::EFastTimerType tidx);
+
+	// Timers in legend order with their legend names, for logging.
+	static void getTimerNames(std::vector<std::pair<LLFastTimer::EFastTimerType, std::string> >& timers);
 	
 private:	
 	S32* mBarStart;
@@ -429,6 +429,9 @@ void LLPanelActiveSpeakers::refreshSpeakers()
 
 	LLSpeakerMgr::speaker_list_t speaker_list;
 	mSpeakerMgr->getSpeakerList(&speaker_list, mShowTextChatters);
+	// cells do not tell their list when they change, so summarize everything
+	// the rows show and invalidate the list only when that summary moves
+	std::string list_signature;
 	for (std::vector<LLScrollListItem*>::iterator item_it = items.begin();
 		item_it != items.end();
 		++item_it)
@@ -445,6 +448,12 @@ void LLPanelActiveSpeakers::refreshSpeakers()
 		// since we are forced to sort by text, encode sort order as string
 		std::string speaking_order_sort_string = llformat("%010d", speakerp->mSortIndex);
 
+		S32 volume_level = llmin(2, llfloor((speakerp->mSpeechVolume / LLVoiceClient::OVERDRIVEN_POWER_LEVEL) * 3.f));
+		list_signature += speaker_id.asString();
+		list_signature += llformat("%d %d %d %d ", (S32)speakerp->mStatus, volume_level, (S32)speakerp->mIsModerator, (S32)speakerp->mModeratorMutedVoice);
+		list_signature += speakerp->mDisplayName;
+		list_signature += speaking_order_sort_string;
+
 		LLScrollListCell* icon_cell = itemp->getColumn(0);
 		if (icon_cell)
 		{
@@ -545,6 +554,12 @@ void LLPanelActiveSpeakers::refreshSpeakers()
 	// we potentially modified the sort order by touching the list items
 	mSpeakerList->setSorted(FALSE);
 
+	if (list_signature != mListSignature)
+	{
+		mListSignature = list_signature;
+		mSpeakerList->invalidate();
+	}
+
 	LLPointer<LLSpeaker> selected_speakerp = mSpeakerMgr->findSpeaker(selected_id);
 	// update UI for selected participant
 	if (mMuteVoiceCtrl)
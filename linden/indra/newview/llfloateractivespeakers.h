@@ -292,6 +292,8 @@ protected:
 	LLPointer<SpeakerAddListener> mSpeakerAddListener;
 	LLPointer<SpeakerRemoveListener> mSpeakerRemoveListener;
 	LLPointer<SpeakerClearListener> mSpeakerClearListener;
+	// what the rows showed last refresh, so the list is only redrawn when it changes
+	std::string			mListSignature;
 };
 
 
@@ -90,6 +90,9 @@ const F32 BASE_ANIM_TIME_OFFSET = 5.f;
 LLFloaterAnimPreview::LLFloaterAnimPreview(const std::string& filename) : 
 	LLFloaterNameDesc(filename)
 {
+	// the preview avatar animates every frame
+	setDrawsLive(TRUE);
+
 	mLastMouseX = 0;
 	mLastMouseY = 0;
 
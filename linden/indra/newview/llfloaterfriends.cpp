@@ -319,6 +319,9 @@ BOOL LLPanelFriends::updateFriendItem(const LLUUID& agent_id, const LLRelationsh
 	// enable this item, in case it was disabled after user input
 	itemp->setEnabled(TRUE);
 
+	// the cells were edited in place, the list does not know on its own
+	mFriendsList->invalidate();
+
 	// Do not resort, this function can be called frequently.
 	return have_name;
 }
@@ -80,6 +80,9 @@ LLFloaterImagePreview::LLFloaterImagePreview(const std::string& filename) :
 	mAvatarPreview(NULL),
 	mSculptedPreview(NULL)
 {
+	// the previews render into dynamic textures every frame
+	setDrawsLive(TRUE);
+
 	mLastMouseX = 0;
 	mLastMouseY = 0;
 	mImagep = NULL ;
@@ -347,6 +347,17 @@ void LLFolderViewItem::refresh()
 	LLStringUtil::toUpper(searchable_label_desc);
 	LLStringUtil::toUpper(searchable_label_all);
 
+	std::string searchable_suffix(mLabelSuffix);
+	LLStringUtil::toUpper(searchable_suffix);
+	if (searchable_suffix != mSearchableSuffix)
+	{
+		if (mListener && mRoot)
+		{
+			mRoot->updateItemSuffix(mListener->getUUID(), mSearchableSuffix, searchable_suffix);
+		}
+		mSearchableSuffix = searchable_suffix;
+	}
+
 	if (mSearchableLabel.compare(searchable_label) ||
 		mSearchableLabelCreator.compare(searchable_label_creator) ||
 		mSearchableLabelDesc.compare(searchable_label_desc) ||
@@ -877,6 +888,7 @@ void LLFolderViewItem::draw()
 	bool possibly_has_children = false;
 	bool up_to_date = mListener && mListener->isUpToDate();
 	if((up_to_date && hasVisibleChildren() ) || // we fetched our children and some of them have passed the filter...
+		(up_to_date && getChildrenPending() && mListener->hasChildren()) || // ...or we have children we haven't built views for yet
 		(!up_to_date && mListener && mListener->hasChildren())) // ...or we know we have children but haven't fetched them (doesn't obey filter)
 	{
 		possibly_has_children = true;
@@ -1079,7 +1091,8 @@ LLFolderViewFolder::LLFolderViewFolder( const std::string& name, LLUIImagePtr ic
 	mLastArrangeGeneration( -1 ),
 	mLastCalculatedWidth(0),
 	mCompletedFilterGeneration(-1),
-	mMostFilteredDescendantGeneration(-1)
+	mMostFilteredDescendantGeneration(-1),
+	mChildrenPending(FALSE)
 {
 	mType = std::string("(folder)");
 }
@@ -1322,6 +1335,21 @@ void LLFolderViewFolder::filter( LLInventoryFilter& filter)
 		gInventory.startBackgroundFetch(mListener->getUUID());
 	}
 
+	// the search index knows nothing below here can pass, unless the
+	// search could match the suffix of an item nobody has built yet:
+	// those only get found by building them, below
+	if (mListener && filter.isOutsideIndexMatches(mListener->getUUID()) && !filter.mayMatchSuffix())
+	{
+		setCompletedFilterGeneration(filter_generation, FALSE);
+		return;
+	}
+
+	// an active filter has to look at children we haven't built yet
+	if (mChildrenPending && filter.isNotDefault())
+	{
+		populate();
+	}
+
 	// now query children
 	for (folders_t::iterator iter = mFolders.begin();
 		 iter != mFolders.end();)
@@ -2020,6 +2048,15 @@ void LLFolderViewFolder::requestArrange(BOOL include_descendants)
 	}
 }
 
+void LLFolderViewFolder::populate()
+{
+	if (mChildrenPending)
+	{
+		mChildrenPending = FALSE;
+		getRoot()->populateFolder(this);
+	}
+}
+
 void LLFolderViewFolder::toggleOpen()
 {
 	setOpen(!mIsOpen);
@@ -2042,6 +2079,10 @@ void LLFolderViewFolder::setOpenArrangeRecursively(BOOL openitem, ERecurseType r
 			mListener->openItem();
 		}
 	}
+	if (openitem)
+	{
+		populate();
+	}
 
 	if (recurse == RECURSE_DOWN || recurse == RECURSE_UP_DOWN)
 	{
@@ -2627,6 +2668,8 @@ LLFolderView::LLFolderView( const std::string& name, LLUIImagePtr root_folder_ic
 	mUserData(NULL),
 	mSelectCallback(NULL),
 	mSignalSelectCallback(0),
+	mPopulateCallback(NULL),
+	mPopulateUserData(NULL),
 	mMinWidth(0),
 	mDragAndDropThisFrame(FALSE)
 {
@@ -2779,6 +2822,14 @@ void LLFolderView::closeAllFolders()
 	setOpenArrangeRecursively(FALSE, LLFolderViewFolder::RECURSE_DOWN);
 }
 
+void LLFolderView::populateFolder(LLFolderViewFolder* folder)
+{
+	if (mPopulateCallback)
+	{
+		mPopulateCallback(folder, mPopulateUserData);
+	}
+}
+
 void LLFolderView::openFolder(const std::string& foldername)
 {
 	LLFolderViewFolder* inv = getChild<LLFolderViewFolder>(foldername);
@@ -2895,6 +2946,11 @@ void LLFolderView::filter( LLInventoryFilter& filter )
 	LLFastTimer t2(LLFastTimer::FTM_FILTER);
 	filter.setFilterCount(llclamp(gSavedSettings.getS32("FilterItemsPerFrame"), 1, 5000));
 
+	if (filter.updateIndexMatches())
+	{
+		addSuffixMatches(filter);
+	}
+
 	if (getCompletedFilterGeneration() < filter.getCurrentGeneration())
 	{
 		mFiltered = FALSE;
@@ -4314,7 +4370,79 @@ void LLFolderView::addItemID(const LLUUID& id, LLFolderViewItem* itemp)
 
 void LLFolderView::removeItemID(const LLUUID& id)
 {
-	mItemMap.erase(id);
+	std::map<LLUUID, LLFolderViewItem*>::iterator map_it = mItemMap.find(id);
+	if (map_it != mItemMap.end())
+	{
+		if (!map_it->second->getSearchableSuffix().empty())
+		{
+			updateItemSuffix(id, map_it->second->getSearchableSuffix(), LLStringUtil::null);
+		}
+		mItemMap.erase(map_it);
+	}
+}
+
+void LLFolderView::updateItemSuffix(const LLUUID& id, const std::string& old_suffix, const std::string& new_suffix)
+{
+	if (!old_suffix.empty())
+	{
+		suffix_map_t::iterator it = mSuffixedItems.find(old_suffix);
+		if (it != mSuffixedItems.end())
+		{
+			it->second.erase(id);
+			if (it->second.empty())
+			{
+				mSuffixedItems.erase(it);
+			}
+		}
+	}
+	if (!new_suffix.empty())
+	{
+		mSuffixedItems[new_suffix].insert(id);
+	}
+	mFilter.dirtyIndexMatches();
+}
+
+// The search index only holds names, but searchable labels end with
+// suffixes like " (NO COPY)".  Add the items whose suffix holds the
+// whole search string, and check the label of any item where the
+// string could start in the name and run on into the suffix.
+void LLFolderView::addSuffixMatches(LLInventoryFilter& filter)
+{
+	const std::string needle = filter.getFilterSubString();
+	for (suffix_map_t::iterator it = mSuffixedItems.begin();
+		 it != mSuffixedItems.end(); ++it)
+	{
+		const std::string& suffix = it->first;
+		BOOL in_suffix = suffix.find(needle) != std::string::npos;
+		BOOL straddles = FALSE;
+		if (!in_suffix)
+		{
+			// does the needle end with the start of the suffix?
+			std::string::size_type max_overlap = llmin(needle.size() - 1, suffix.size());
+			for (std::string::size_type overlap = 1; overlap <= max_overlap && !straddles; ++overlap)
+			{
+				straddles = !needle.compare(needle.size() - overlap, overlap, suffix, 0, overlap);
+			}
+		}
+		if (!in_suffix && !straddles)
+		{
+			continue;
+		}
+
+		for (std::set<LLUUID>::iterator id_it = it->second.begin();
+			 id_it != it->second.end(); ++id_it)
+		{
+			if (straddles)
+			{
+				LLFolderViewItem* item = getItemByID(*id_it);
+				if (!item || item->getSearchableLabel().find(needle) == std::string::npos)
+				{
+					continue;
+				}
+			}
+			filter.addIndexMatch(*id_it);
+		}
+	}
 }
 
 LLFolderViewItem* LLFolderView::getItemByID(const LLUUID& id)
@@ -4602,6 +4730,12 @@ LLInventoryFilter::LLInventoryFilter(const std::string& name) :
 	mFilterCount = 0;
 	mNextFilterGeneration = mFilterGeneration + 1;
 
+	mSearchIndex = NULL;
+	mUseIndexMatches = FALSE;
+	mIndexGeneration = -1;
+	mIndexVersion = 0;
+	mMayMatchSuffix = FALSE;
+
 	mLastLogoff = gSavedPerAccountSettings.getU32("LastLogoff");
 	mFilterBehavior = FILTER_NONE;
 
@@ -4664,9 +4798,31 @@ BOOL LLInventoryFilter::check(LLFolderViewItem* item)
 	}	
 	else
 	{
-		mSubStringMatchOffset = mFilterSubString.size() ? item->getSearchableLabel().find(mFilterSubString) : std::string::npos;
+		BOOL subStringMatch;
+		if (mUseIndexMatches)
+		{
+			// only look for the offset on items we know will match
+			LLInventorySearchIndex::match_map_t::const_iterator it = mIndexMatches.find(item_id);
+			subStringMatch = it != mIndexMatches.end() && it->second;
+			if (!subStringMatch && mMayMatchSuffix && !item->getSearchableSuffix().empty())
+			{
+				// items built since the last query have not been added for
+				// their suffixes yet
+				mSubStringMatchOffset = item->getSearchableLabel().find(mFilterSubString);
+				subStringMatch = mSubStringMatchOffset != std::string::npos;
+			}
+			else
+			{
+				mSubStringMatchOffset = subStringMatch ? item->getSearchableLabel().find(mFilterSubString) : std::string::npos;
+			}
+		}
+		else
+		{
+			mSubStringMatchOffset = mFilterSubString.size() ? item->getSearchableLabel().find(mFilterSubString) : std::string::npos;
+			subStringMatch = mFilterSubString.size() == 0 || mSubStringMatchOffset != std::string::npos;
+		}
 		passed = (listener->getNInventoryType() & mFilterOps.mFilterTypes || listener->getNInventoryType() == LLInventoryType::NIT_NONE)
-					&& (mFilterSubString.size() == 0 || mSubStringMatchOffset != std::string::npos)
+					&& (subStringMatch)
 					&& (mFilterWorn == false || gAgent.isWearingItem(item_id) ||
 						(gAgent.getAvatarObject() && gAgent.getAvatarObject()->isWearingAttachment(item_id)))
 					&& ((listener->getPermissionMask() & mFilterOps.mPermissions) == mFilterOps.mPermissions)
@@ -4721,6 +4877,100 @@ BOOL LLInventoryFilter::isModifiedAndClear()
 }
 
 
+// Searchable labels are the upper cased name followed by the suffix from
+// getLabelSuffix().  A match that is not all in the name either runs into
+// the suffix, taking in the " (" every suffix starts with or at least the
+// space, or lies within a single suffix.
+static BOOL could_match_suffix(const std::string& needle)
+{
+	if (needle.empty())
+	{
+		return FALSE;
+	}
+	if (needle.find(" (") != std::string::npos || needle[needle.size() - 1] == ' ')
+	{
+		return TRUE;
+	}
+
+	// see the getLabelSuffix() overrides in llinventorybridge.cpp
+	static const char* SUFFIXES[] =
+	{
+		" (NO COPY)", " (NO MODIFY)", " (NO TRANSFER)", " (TEMPORARY)",
+		" (WORN)", " (ACTIVE)", " (ONLINE)", NULL
+	};
+	for (S32 i = 0; SUFFIXES[i]; ++i)
+	{
+		if (std::string(SUFFIXES[i]).find(needle) != std::string::npos)
+		{
+			return TRUE;
+		}
+	}
+
+	LLVOAvatar* avatarp = gAgent.getAvatarObject();
+	if (avatarp)
+	{
+		for (LLVOAvatar::attachment_map_t::iterator it = avatarp->mAttachmentPoints.begin();
+			 it != avatarp->mAttachmentPoints.end(); ++it)
+		{
+			std::string suffix = " (WORN ON " + it->second->getName() + ")";
+			LLStringUtil::toUpper(suffix);
+			if (suffix.find(needle) != std::string::npos)
+			{
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+void LLInventoryFilter::setSearchIndex(const LLInventorySearchIndex* index)
+{
+	mSearchIndex = index;
+	mUseIndexMatches = FALSE;
+	mIndexMatches.clear();
+}
+
+BOOL LLInventoryFilter::updateIndexMatches()
+{
+	// only plain name searches are indexed
+	if (!mSearchIndex || mSearchType != 0 || mFilterSubString.empty())
+	{
+		if (mUseIndexMatches)
+		{
+			mIndexMatches.clear();
+			mUseIndexMatches = FALSE;
+		}
+		return FALSE;
+	}
+
+	if (mUseIndexMatches
+		&& mIndexGeneration == mFilterGeneration
+		&& mIndexVersion == mSearchIndex->getVersion())
+	{
+		return FALSE;
+	}
+
+	mSearchIndex->find(mFilterSubString, mFilterOps.mFilterTypes, mIndexMatches);
+	mMayMatchSuffix = could_match_suffix(mFilterSubString);
+	mUseIndexMatches = TRUE;
+	mIndexGeneration = mFilterGeneration;
+	mIndexVersion = mSearchIndex->getVersion();
+	return TRUE;
+}
+
+void LLInventoryFilter::addIndexMatch(const LLUUID& id)
+{
+	if (mSearchIndex)
+	{
+		mSearchIndex->addMatch(id, mIndexMatches);
+	}
+}
+
+BOOL LLInventoryFilter::isOutsideIndexMatches(const LLUUID& id) const
+{
+	return mUseIndexMatches && mIndexMatches.find(id) == mIndexMatches.end();
+}
+
 //fix to get rid of gSavedSettings use - rkeast
 void LLInventoryFilter::setSearchType(U32 type)
 {
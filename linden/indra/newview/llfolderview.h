@@ -43,6 +43,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 #include <deque>
 
 #include "lluictrl.h"
@@ -54,6 +55,7 @@
 #include "lleditmenuhandler.h"
 #include "llviewerimage.h"
 #include "lldepthstack.h"
+#include "llinventorysearchindex.h"
 #include "lltooldraganddrop.h"
 
 class LLMenuGL;
@@ -248,6 +250,21 @@ public:
 	//RN: this is public to allow system to externally force a global refilter
 	void setModified(EFilterBehavior behavior = FILTER_RESTART);
 
+	// Answer name searches from an inventory search index rather than
+	// matching every label.  NULL turns this off.
+	void setSearchIndex(const LLInventorySearchIndex* index);
+	// Re-queries the index if the filter or the index has changed since
+	// the last query.  Returns TRUE if it did.
+	BOOL updateIndexMatches();
+	void dirtyIndexMatches() { mIndexGeneration = -1; }
+	BOOL usingIndexMatches() const { return mUseIndexMatches; }
+	void addIndexMatch(const LLUUID& id);
+	// TRUE if nothing at or below id can pass, according to the index.
+	BOOL isOutsideIndexMatches(const LLUUID& id) const;
+	// TRUE if the search string could match a label suffix such as
+	// " (no copy)", which the index does not hold.
+	BOOL mayMatchSuffix() const { return mMayMatchSuffix; }
+
 	void toLLSD(LLSD& data);
 	void fromLLSD(LLSD& data);
 
@@ -278,6 +295,13 @@ protected:
 	S32				mNextFilterGeneration;
 	EFilterBehavior mFilterBehavior;
 
+	const LLInventorySearchIndex*	mSearchIndex;
+	LLInventorySearchIndex::match_map_t	mIndexMatches;
+	BOOL			mUseIndexMatches;
+	S32				mIndexGeneration;
+	U32				mIndexVersion;
+	BOOL			mMayMatchSuffix;
+
 private:
 	U32 mLastLogoff;
 	BOOL mModified;
@@ -368,6 +392,7 @@ protected:
 	BOOL						mSelectPending;
 	LLFontGL::StyleFlags		mLabelStyle;
 	std::string					mLabelSuffix;
+	std::string					mSearchableSuffix;
 	LLUIImagePtr				mIcon;
 	std::string					mStatusText;
 	BOOL						mHasVisibleChildren;
@@ -469,6 +494,8 @@ public:
 	BOOL getIsCurSelection() { return mIsCurSelection; }
 
 	BOOL hasVisibleChildren() { return mHasVisibleChildren; }
+	// TRUE for folders whose child views have not been built yet
+	virtual BOOL getChildrenPending() const { return FALSE; }
 
 	// Call through to the viewed object and return true if it can be
 	// removed. Returns true if it's removed.
@@ -483,6 +510,7 @@ public:
 	const std::string& getName( void ) const;
 
 	const std::string& getSearchableLabel() const;
+	const std::string& getSearchableSuffix() const { return mSearchableSuffix; }
 
 	// This method returns the label displayed on the view. This
 	// method was primarily added to allow sorting on the folder
@@ -595,6 +623,7 @@ protected:
 	S32			mLastCalculatedWidth;
 	S32			mCompletedFilterGeneration;
 	S32			mMostFilteredDescendantGeneration;
+	BOOL		mChildrenPending;
 public:
 	typedef enum e_recurse_type
 	{
@@ -623,6 +652,13 @@ public:
 
 	BOOL needsArrange();
 
+	// Child views can be left unbuilt until the folder is opened or a
+	// filter needs to look inside it; populate() builds them through
+	// the root's populate callback.
+	void setChildrenPending(BOOL pending) { mChildrenPending = pending; }
+	virtual BOOL getChildrenPending() const { return mChildrenPending; }
+	void populate();
+
 	// Returns the sort group (system, trash, folder) for this folder.
 	virtual EInventorySortGroup getSortGroup() const;
 
@@ -758,6 +794,7 @@ class LLFolderView : public LLFolderViewFolder, LLEditMenuHandler
 {
 public:
 	typedef void (*SelectCallback)(const std::deque<LLFolderViewItem*> &items, BOOL user_action, void* data);
+	typedef void (*PopulateCallback)(LLFolderViewFolder* folder, void* data);
 
 	static F32 sAutoOpenTime;
 
@@ -773,6 +810,9 @@ public:
 	void checkTreeResortForModelChanged();
 	void setFilterPermMask(PermissionMask filter_perm_mask) { mFilter.setFilterPermissions(filter_perm_mask); }
 	void setSelectCallback(SelectCallback callback, void* user_data) { mSelectCallback = callback, mUserData = user_data; }
+	void setPopulateCallback(PopulateCallback callback, void* user_data) { mPopulateCallback = callback, mPopulateUserData = user_data; }
+	// builds the child views of a folder whose children are pending
+	void populateFolder(LLFolderViewFolder* folder);
 	void setAllowMultiSelect(BOOL allow) { mAllowMultiSelect = allow; }
 
 	LLInventoryFilter* getFilter() { return &mFilter; }
@@ -900,6 +940,10 @@ public:
 	void removeItemID(const LLUUID& id);
 	LLFolderViewItem* getItemByID(const LLUUID& id);
 
+	// Tracks label suffixes, which the inventory search index does not
+	// hold, so index backed filtering can still match on them.
+	void updateItemSuffix(const LLUUID& id, const std::string& old_suffix, const std::string& new_suffix);
+
 	void	doIdle();						// Real idle routine
 	static void idle(void* user_data);		// static glue to doIdle()
 
@@ -921,6 +965,8 @@ protected:
 	void finishRenamingItem( void );
 	void closeRenamer( void );
 
+	void addSuffixMatches(LLInventoryFilter& filter);
+
 protected:
 	LLHandle<LLView>					mPopupMenuHandle;
 	
@@ -958,10 +1004,15 @@ protected:
 	void*							mUserData;
 	SelectCallback					mSelectCallback;
 	S32								mSignalSelectCallback;
+	PopulateCallback				mPopulateCallback;
+	void*							mPopulateUserData;
 	S32								mMinWidth;
 	std::map<LLUUID, LLFolderViewItem*> mItemMap;
 	BOOL							mDragAndDropThisFrame;
 
+	typedef std::map<std::string, std::set<LLUUID> > suffix_map_t;
+	suffix_map_t					mSuffixedItems;
+
 };
 
 bool sort_item_name(LLFolderViewItem* a, LLFolderViewItem* b);
@@ -40,6 +40,7 @@
 #include <boost/tokenizer.hpp>
 
 // library
+#include "llanimationstates.h"
 #include "lldatapacker.h"
 #include "llinventory.h"
 #include "llmultigesture.h"
@@ -941,6 +942,41 @@ void LLGestureManager::runStep(LLMultiGesture* gesture, LLGestureStep* step)
 
 
 // static
+// Pull the sounds and animations a gesture plays into the VFS while it
+// sits idle, so triggering it doesn't wait on the asset server.
+void LLGestureManager::prefetchStepAssets(LLMultiGesture* gesture)
+{
+	if (!gAssetStorage)
+	{
+		return;
+	}
+
+	asset_prefetch_list_t prefetches;
+	for (std::vector<LLGestureStep*>::iterator iter = gesture->mSteps.begin();
+		 iter != gesture->mSteps.end(); ++iter)
+	{
+		LLGestureStep* step = *iter;
+		if (step->getType() == STEP_SOUND)
+		{
+			LLGestureStepSound* sound_step = (LLGestureStepSound*)step;
+			prefetches.push_back(LLAssetPrefetch(sound_step->mSoundAssetID, LLAssetType::AT_SOUND, 1.f));
+		}
+		else if (step->getType() == STEP_ANIMATION)
+		{
+			LLGestureStepAnimation* anim_step = (LLGestureStepAnimation*)step;
+			// the built in animations are already on every viewer
+			if (!gAnimLibrary.animStateToString(anim_step->mAnimAssetID))
+			{
+				prefetches.push_back(LLAssetPrefetch(anim_step->mAnimAssetID, LLAssetType::AT_ANIMATION, 1.f));
+			}
+		}
+	}
+	if (!prefetches.empty())
+	{
+		gAssetStorage->prefetchAssets(prefetches);
+	}
+}
+
 void LLGestureManager::onLoadComplete(LLVFS *vfs,
 									   const LLUUID& asset_uuid,
 									   LLAssetType::EType type,
@@ -997,6 +1033,7 @@ void LLGestureManager::onLoadComplete(LLVFS *vfs,
 
 			// Everything has been successful.  Add to the active list.
 			gGestureManager.mActive[item_id] = gesture;
+			gGestureManager.prefetchStepAssets(gesture);
 			gInventory.addChangedMask(LLInventoryObserver::LABEL, item_id);
 			if (inform_server)
 			{
@@ -133,6 +133,9 @@ protected:
 	// Do a single step in a gesture
 	void runStep(LLMultiGesture* gesture, LLGestureStep* step);
 
+	// Warm the asset cache with the sounds and animations a gesture plays
+	void prefetchStepAssets(LLMultiGesture* gesture);
+
 	// Used by loadGesture
 	static void onLoadComplete(LLVFS *vfs,
 						   const LLUUID& asset_uuid,
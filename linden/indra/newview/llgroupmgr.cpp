@@ -71,47 +71,6 @@ LLRoleActionSet::~LLRoleActionSet()
 	std::for_each(mActions.begin(), mActions.end(), DeletePointer());
 }
 
-//
-// LLGroupMemberData
-//
-
-LLGroupMemberData::LLGroupMemberData(const LLUUID& id, 
-										S32 contribution,
-										U64 agent_powers,
-										const std::string& title,
-										const std::string& online_status,
-										BOOL is_owner) : 
-	mID(id), 
-	mContribution(contribution), 
-	mAgentPowers(agent_powers), 
-	mTitle(title), 
-	mOnlineStatus(online_status),
-	mIsOwner(is_owner)
-{
-}
-
-LLGroupMemberData::~LLGroupMemberData()
-{
-}
-
-void LLGroupMemberData::addRole(const LLUUID& role, LLGroupRoleData* rd)
-{
-	mRolesList[role] = rd;
-}
-
-bool LLGroupMemberData::removeRole(const LLUUID& role)
-{
-	role_list_t::iterator it = mRolesList.find(role);
-
-	if (it != mRolesList.end())
-	{
-		mRolesList.erase(it);
-		return true;
-	}
-
-	return false;
-}
-
 //
 // LLGroupRoleData
 //
@@ -404,10 +363,6 @@ void LLGroupMgrGroupData::removeData()
 
 void LLGroupMgrGroupData::removeMemberData()
 {
-	for (member_list_t::iterator mi = mMembers.begin(); mi != mMembers.end(); ++mi)
-	{
-		delete mi->second;
-	}
 	mMembers.clear();
 	mMemberDataComplete = FALSE;
 }
@@ -755,6 +710,28 @@ void LLGroupMgr::clearGroupData(const LLUUID& group_id)
 	}
 }
 
+void LLGroupMgr::releaseMemberData(const LLUUID& group_id)
+{
+	LLGroupMgrGroupData* group_datap = getGroupData(group_id);
+	if (!group_datap
+		|| group_datap->mMembers.empty()
+		|| !group_datap->mRoleMemberChanges.empty())
+	{
+		return;
+	}
+
+	llinfos << "Releasing member data for group " << group_id << ": "
+			<< group_datap->mMembers.size() << " members, "
+			<< group_datap->getMemberMemoryUsage() / 1024 << " KB" << llendl;
+
+	// Role member data points at the members, so it goes first.
+	group_datap->removeRoleMemberData();
+	group_datap->removeMemberData();
+	group_datap->mMemberRequestID.setNull();
+	group_datap->mRoleMembersRequestID.setNull();
+	group_datap->mPendingRoleMemberRequest = FALSE;
+}
+
 void LLGroupMgr::addObserver(LLGroupMgrObserver* observer) 
 { 
 	mObservers.insert(std::pair<LLUUID, LLGroupMgrObserver*>(observer->getID(), observer));
@@ -766,8 +743,9 @@ void LLGroupMgr::removeObserver(LLGroupMgrObserver* observer)
 	{
 		return;
 	}
+	LLUUID group_id = observer->getID();
 	observer_multimap_t::iterator it;
-	it = mObservers.find(observer->getID());
+	it = mObservers.find(group_id);
 	while (it != mObservers.end())
 	{
 		if (it->second == observer)
@@ -780,6 +758,13 @@ void LLGroupMgr::removeObserver(LLGroupMgrObserver* observer)
 			++it;
 		}
 	}
+
+	// Once the last panel on a group goes away, its member list is just
+	// memory; large groups can hold megabytes of it.
+	if (mObservers.find(group_id) == mObservers.end())
+	{
+		releaseMemberData(group_id);
+	}
 }
 
 LLGroupMgrGroupData* LLGroupMgr::getGroupData(const LLUUID& id)
@@ -826,6 +811,12 @@ void LLGroupMgr::processGroupMembersReply(LLMessageSystem* msg, void** data)
 	msg->getUUIDFast(_PREHASH_GroupData, _PREHASH_RequestID, request_id);
 
 	LLGroupMgrGroupData* group_datap = LLGroupMgr::getInstance()->createGroupData(group_id);
+	if (group_datap->mMemberRequestID.isNull())
+	{
+		// The member data was released while this request was in flight.
+		lldebugs << "processGroupMembersReply: Ignoring reply for released member data" << llendl;
+		return;
+	}
 	if (group_datap->mMemberRequestID != request_id)
 	{
 		llwarns << "processGroupMembersReply: Received incorrect (stale?) request id" << llendl;
@@ -859,20 +850,12 @@ void LLGroupMgr::processGroupMembersReply(LLMessageSystem* msg, void** data)
 				formatDateString(online_status); // reformat for sorting, e.g. 12/25/2008 -> 2008/12/25
 				
 				//llinfos << "Member " << member_id << " has powers " << std::hex << agent_powers << std::dec << llendl;
-				LLGroupMemberData* newdata = new LLGroupMemberData(member_id, 
-																	contribution, 
-																	agent_powers, 
-																	title,
-																	online_status,
-																	is_owner);
-#if LL_DEBUG
-				LLGroupMgrGroupData::member_list_t::iterator mit = group_datap->mMembers.find(member_id);
-				if (mit != group_datap->mMembers.end())
-				{
-					llinfos << " *** Received duplicate member data for agent " << member_id << llendl;
-				}
-#endif
-				group_datap->mMembers[member_id] = newdata;
+				group_datap->mMembers.add(member_id, 
+										  contribution, 
+										  agent_powers, 
+										  title,
+										  online_status,
+										  is_owner);
 			}
 			else
 			{
@@ -880,6 +863,10 @@ void LLGroupMgr::processGroupMembersReply(LLMessageSystem* msg, void** data)
 			}
 		}
 
+		// One merge per packet keeps lookups cheap and resolves any
+		// duplicate member data before the count check below.
+		group_datap->mMembers.updateIndex();
+
 		//if group members are loaded while titles are missing, load the titles.
 		if(group_datap->mTitles.size() < 1)
 		{
@@ -1703,7 +1690,6 @@ void LLGroupMgr::sendGroupMemberEjects(const LLUUID& group_id,
 					(*rit).second->removeMember(*it);
 				}
 			}
-			delete (*mit).second;
 			group_datap->mMembers.erase(*it);
 		}
 	}
@@ -35,6 +35,7 @@
 
 #include "lluuid.h"
 #include "roles_constants.h"
+#include "llgroupmemberlist.h"
 #include <vector>
 #include <string>
 #include <map>
@@ -54,46 +55,6 @@ protected:
 
 class LLGroupRoleData;
 
-class LLGroupMemberData
-{
-friend class LLGroupMgrGroupData;
-
-public:
-	typedef std::map<LLUUID,LLGroupRoleData*> role_list_t;
-	
-	LLGroupMemberData(const LLUUID& id, 
-						S32 contribution,
-						U64 agent_powers,
-						const std::string& title,
-						const std::string& online_status,
-						BOOL is_owner);
-
-	~LLGroupMemberData();
-
-	const LLUUID& getID() const { return mID; }
-	S32 getContribution() const { return mContribution; }
-	U64	getAgentPowers() const { return mAgentPowers; }
-	BOOL isOwner() const { return mIsOwner; }
-	const std::string& getTitle() const { return mTitle; }
-	const std::string& getOnlineStatus() const { return mOnlineStatus; }
-	void addRole(const LLUUID& role, LLGroupRoleData* rd);
-	bool removeRole(const LLUUID& role);
-	void clearRoles() { mRolesList.clear(); };
-	role_list_t::iterator roleBegin() { return mRolesList.begin(); }
-	role_list_t::iterator roleEnd() { return mRolesList.end(); }
-
-	BOOL isInRole(const LLUUID& role_id) { return (mRolesList.find(role_id) != mRolesList.end()); }
-
-protected:
-	LLUUID	mID;
-	S32		mContribution;
-	U64		mAgentPowers;
-	std::string	mTitle;
-	std::string	mOnlineStatus;
-	BOOL	mIsOwner;
-	role_list_t mRolesList;
-};
-
 struct LLRoleData
 {
 	LLRoleData() : mRolePowers(0), mChangeType(RC_UPDATE_NONE) { }
@@ -222,6 +183,9 @@ public:
 	void removeMemberData();
 	void removeRoleMemberData();
 
+	// Approximate heap bytes held for this group's member list.
+	size_t getMemberMemoryUsage() const { return mMembers.getMemoryUsage(); }
+
 	bool changeRoleMember(const LLUUID& role_id, const LLUUID& member_id, LLRoleMemberChangeType rmc);
 	void recalcAllAgentPowers();
 	void recalcAgentPowers(const LLUUID& agent_id);
@@ -232,7 +196,7 @@ public:
 	BOOL isGroupPropertiesDataComplete() { return mGroupPropertiesDataComplete; }
 
 public:
-	typedef	std::map<LLUUID,LLGroupMemberData*> member_list_t;
+	typedef	LLGroupMemberList member_list_t;
 	typedef	std::map<LLUUID,LLGroupRoleData*> role_list_t;
 	typedef std::map<lluuid_pair,LLRoleMemberChange,lluuid_pair_less> change_map_t;
 	typedef std::map<LLUUID,LLRoleData> role_data_map_t;
@@ -352,6 +316,11 @@ public:
 	void clearGroups();
 	void clearGroupData(const LLUUID& group_id);
 
+	// Drops member and role member data for a group; it is requested
+	// again the next time a panel needs it.  Called when the last
+	// observer of a group is removed.
+	void releaseMemberData(const LLUUID& group_id);
+
 private:
 	void notifyObservers(LLGroupChange gc);
 	void addGroup(LLGroupMgrGroupData* group_datap);
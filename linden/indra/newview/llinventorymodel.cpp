@@ -37,6 +37,9 @@
 #include "llassetstorage.h"
 #include "llcrc.h"
 #include "lldir.h"
+#include "llinventorycache.h"
+#include "lltaskscheduler.h"
+#include "llthread.h"
 #include "llsys.h"
 #include "llxfermanager.h"
 #include "message.h"
@@ -87,6 +90,11 @@ static std::deque<LLUUID> sFetchQueue;
 const F32 MAX_TIME_FOR_SINGLE_FETCH = 10.f;
 const S32 MAX_FETCH_RETRIES = 10;
 const char CACHE_FORMAT_STRING[] = "%s.inv"; 
+const char BINARY_CACHE_FORMAT_STRING[] = "%s.invc";
+// binary cache loads are split into up to this many chunks...
+const S32 MAX_CACHE_LOAD_CHUNKS = 4;
+// ...each decoding at least this many items
+const S32 MIN_CACHE_LOAD_ITEMS_PER_CHUNK = 8192;
 const char* NEW_CATEGORY_NAME = "New Folder";
 const char* NEW_CATEGORY_NAMES[LLAssetType::AT_COUNT] =
 {
@@ -123,6 +131,156 @@ struct InventoryIDPtrLess
 	}
 };
 
+// An encoded binary inventory cache written on logout.  Whoever claims it
+// first writes it, a worker or flushCacheWrites() on the main thread.
+class LLInventoryCacheWrite : public LLThreadSafeRefCount
+{
+public:
+	LLInventoryCacheWrite(const std::string& filename, const std::string& legacy_filename)
+	:	mFilename(filename),
+		mLegacyFilename(legacy_filename),
+		mClaim(0)
+	{}
+
+	std::vector<U8>& getBuffer() { return mBuffer; }
+
+	bool claim() { return mClaim++ == 0; }
+
+	void write()
+	{
+		if (LLInventoryCacheWriter::writeFile(mFilename, mBuffer))
+		{
+			// the text cache is out of date from now on
+			LLFile::remove(mLegacyFilename);
+		}
+	}
+
+private:
+	std::string mFilename;
+	std::string mLegacyFilename;
+	std::vector<U8> mBuffer;
+	LLAtomicU32 mClaim;
+};
+
+static std::vector<LLPointer<LLInventoryCacheWrite> > sCacheWrites;
+static LLCondition* sCacheWriteDone = NULL;
+static S32 sCacheWritesPending = 0;
+
+// WORKER THREAD OR MAIN THREAD, called once per write after its claim
+static void finish_cache_write()
+{
+	sCacheWriteDone->lock();
+	if (--sCacheWritesPending == 0)
+	{
+		sCacheWriteDone->signal();
+	}
+	sCacheWriteDone->unlock();
+}
+
+class LLInventoryCacheWriteTask : public LLTaskScheduler::Task
+{
+public:
+	LLInventoryCacheWriteTask(LLInventoryCacheWrite* cache_write) : mWrite(cache_write) {}
+
+	/*virtual*/ void run()
+	{
+		if (mWrite->claim())
+		{
+			mWrite->write();
+			finish_cache_write();
+		}
+	}
+
+private:
+	LLPointer<LLInventoryCacheWrite> mWrite;
+};
+
+// Decodes the items of a binary cache in chunks.  Workers and the main
+// thread take chunks in turn, so a chunk no worker has started yet is
+// decoded by the main thread instead of waited for.
+class LLInventoryCacheLoad : public LLThreadSafeRefCount
+{
+public:
+	LLInventoryCacheLoad(const LLInventoryCacheReader& reader,
+						 LLInventoryModel::item_array_t& items,
+						 S32 num_chunks)
+	:	mReader(reader),
+		mItems(items),
+		mNumChunks(num_chunks),
+		mChunkSize((items.count() + num_chunks - 1) / num_chunks),
+		mNextChunk(0),
+		mDone(NULL),
+		mRemaining(num_chunks),
+		mFailed(false)
+	{}
+
+	// WORKER THREAD OR MAIN THREAD
+	void decodeChunks()
+	{
+		S32 chunk;
+		while ((chunk = (S32)(mNextChunk++)) < mNumChunks)
+		{
+			bool ok = true;
+			S32 end = llmin(mItems.count(), (chunk + 1) * mChunkSize);
+			for (S32 i = chunk * mChunkSize; i < end; ++i)
+			{
+				if (!mReader.readItem(i, mItems[i].get()))
+				{
+					ok = false;
+					break;
+				}
+			}
+
+			mDone.lock();
+			mFailed = mFailed || !ok;
+			if (--mRemaining == 0)
+			{
+				mDone.signal();
+			}
+			mDone.unlock();
+		}
+	}
+
+	// Returns false if any item failed to decode.
+	bool wait()
+	{
+		mDone.lock();
+		while (mRemaining > 0)
+		{
+			mDone.wait();
+		}
+		bool ok = !mFailed;
+		mDone.unlock();
+		return ok;
+	}
+
+private:
+	// only touched while a chunk is claimed, so only while the main thread
+	// is still waiting in wait()
+	const LLInventoryCacheReader& mReader;
+	LLInventoryModel::item_array_t& mItems;
+	S32 mNumChunks;
+	S32 mChunkSize;
+	LLAtomicU32 mNextChunk;
+	LLCondition mDone;	// guards mRemaining and mFailed
+	S32 mRemaining;
+	bool mFailed;
+};
+
+class LLInventoryCacheLoadTask : public LLTaskScheduler::Task
+{
+public:
+	LLInventoryCacheLoadTask(LLInventoryCacheLoad* load) : mLoad(load) {}
+
+	/*virtual*/ void run()
+	{
+		mLoad->decodeChunks();
+	}
+
+private:
+	LLPointer<LLInventoryCacheLoad> mLoad;
+};
+
 class LLCanCache : public LLInventoryCollectFunctor 
 {
 public:
@@ -786,6 +944,7 @@ void LLInventoryModel::deleteObject(const LLUUID& id)
 		LLUUID parent_id = obj->getParentUUID();
 		mCategoryMap.erase(id);
 		mItemMap.erase(id);
+		mSearchIndex.remove(id);
 		//mInventory.erase(id);
 		item_array_t* item_list = getUnlockedItemArray(parent_id);
 		if(item_list)
@@ -993,6 +1152,14 @@ BOOL LLInventoryModel::containsObserver(LLInventoryObserver* observer)
 // The optional argument 'service_name' is used by Agent Inventory Service [DEV-20328]
 void LLInventoryModel::notifyObservers(const std::string service_name)
 {
+	// Renames and moves are made in place on the objects, so pick them
+	// up before observers start filtering on the new names.
+	for (changed_items_t::iterator it = mChangedItemIDs.begin();
+		 it != mChangedItemIDs.end(); ++it)
+	{
+		updateSearchIndex(*it);
+	}
+
 	for (observer_list_t::iterator iter = mObservers.begin();
 		 iter != mObservers.end(); )
 	{
@@ -1654,19 +1821,67 @@ void LLInventoryModel::cache(
 	std::string inventory_filename;
 	agent_id.toString(agent_id_str);
 	std::string path(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, agent_id_str));
-	inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
-	saveToFile(inventory_filename, categories, items);
-	std::string gzip_filename(inventory_filename);
-	gzip_filename.append(".gz");
-	if(gzip_file(inventory_filename, gzip_filename))
+	inventory_filename = llformat(BINARY_CACHE_FORMAT_STRING, path.c_str());
+
+	// Encoding is quick, so do it here and leave the disk to a worker.
+	LLInventoryCacheWriter writer;
+	S32 count = categories.count();
+	for(S32 i = 0; i < count; ++i)
 	{
-		lldebugs << "Successfully compressed " << inventory_filename << llendl;
-		LLFile::remove(inventory_filename);
+		LLViewerInventoryCategory* cat = categories[i];
+		if(cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
+		{
+			writer.addCategory(cat, cat->getOwnerID(), cat->getVersion(), cat->getDescendentCount());
+		}
 	}
-	else
+	count = items.count();
+	for(S32 i = 0; i < count; ++i)
+	{
+		writer.addItem(items[i].get());
+	}
+
+	LLPointer<LLInventoryCacheWrite> cache_write = new LLInventoryCacheWrite(inventory_filename,
+		llformat(CACHE_FORMAT_STRING, path.c_str()) + ".gz");
+	writer.finish(cache_write->getBuffer());
+	sCacheWrites.push_back(cache_write);
+
+	if (!sCacheWriteDone)
+	{
+		sCacheWriteDone = new LLCondition(NULL);
+	}
+	sCacheWriteDone->lock();
+	sCacheWritesPending++;
+	sCacheWriteDone->unlock();
+
+	LLTaskScheduler::getInstance()->schedule(new LLInventoryCacheWriteTask(cache_write), LLTaskScheduler::LANE_LOW);
+}
+
+// static
+void LLInventoryModel::flushCacheWrites()
+{
+	if (sCacheWrites.empty())
+	{
+		return;
+	}
+
+	// write whatever no worker has started yet, then wait for the rest
+	for (std::vector<LLPointer<LLInventoryCacheWrite> >::iterator it = sCacheWrites.begin();
+		 it != sCacheWrites.end(); ++it)
+	{
+		if ((*it)->claim())
+		{
+			(*it)->write();
+			finish_cache_write();
+		}
+	}
+
+	sCacheWriteDone->lock();
+	while (sCacheWritesPending > 0)
 	{
-		llwarns << "Unable to compress " << inventory_filename << llendl;
+		sCacheWriteDone->wait();
 	}
+	sCacheWriteDone->unlock();
+	sCacheWrites.clear();
 }
 
 
@@ -1678,6 +1893,7 @@ void LLInventoryModel::addCategory(LLViewerInventoryCategory* category)
 		// Insert category uniquely into the map
 		mCategoryMap[category->getUUID()] = category; // LLPointer will deref and delete the old one
 		//mInventory[category->getUUID()] = category;
+		updateSearchIndex(category->getUUID());
 	}
 }
 
@@ -1688,9 +1904,33 @@ void LLInventoryModel::addItem(LLViewerInventoryItem* item)
 	{
 		mItemMap[item->getUUID()] = item;
 		//mInventory[item->getUUID()] = item;
+		updateSearchIndex(item->getUUID());
 	}
 }
 
+void LLInventoryModel::updateSearchIndex(const LLUUID& id)
+{
+	// Look in the maps directly; mLastItem may still hold an object
+	// that addItem() just replaced.
+	cat_map_t::const_iterator cit = mCategoryMap.find(id);
+	if (cit != mCategoryMap.end())
+	{
+		const LLViewerInventoryCategory* cat = cit->second;
+		mSearchIndex.update(id, cat->getParentUUID(), cat->getName(),
+							calc_ntype(LLInventoryType::IT_CATEGORY, LLAssetType::AT_CATEGORY, 0));
+		return;
+	}
+	item_map_t::const_iterator iit = mItemMap.find(id);
+	if (iit != mItemMap.end())
+	{
+		const LLViewerInventoryItem* item = iit->second;
+		mSearchIndex.update(id, item->getParentUUID(), item->getName(),
+							calc_ntype(item->getInventoryType(), item->getType(), item->getFlags()));
+		return;
+	}
+	mSearchIndex.remove(id);
+}
+
 // Empty the entire contents
 void LLInventoryModel::empty()
 {
@@ -1707,6 +1947,7 @@ void LLInventoryModel::empty()
 	mParentChildItemTree.clear();
 	mCategoryMap.clear(); // remove all references (should delete entries)
 	mItemMap.clear(); // remove all references (should delete entries)
+	mSearchIndex.clear();
 	mLastItem = NULL;
 	//mInventory.clear();
 }
@@ -1941,9 +2182,16 @@ bool LLInventoryModel::loadSkeleton(
 		std::string inventory_filename;
 		inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
 		const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
+		std::string binary_filename = llformat(BINARY_CACHE_FORMAT_STRING, path.c_str());
+		std::map<LLUUID, S32> cached_descendents;
+		// a cache from this session's earlier login may still be writing
+		flushCacheWrites();
+		bool loaded = loadFromBinaryFile(binary_filename, categories, items, cached_descendents);
+
+		// otherwise fall back to the text cache of older viewers
 		std::string gzip_filename(inventory_filename);
 		gzip_filename.append(".gz");
-		LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+		LLFILE* fp = loaded ? NULL : LLFile::fopen(gzip_filename, "rb");
 		bool remove_inventory_file = false;
 		if(fp)
 		{
@@ -1961,7 +2209,11 @@ bool LLInventoryModel::loadSkeleton(
 				llinfos << "Unable to gunzip " << gzip_filename << llendl;
 			}
 		}
-		if(loadFromFile(inventory_filename, categories, items))
+		if(!loaded)
+		{
+			loaded = loadFromFile(inventory_filename, categories, items);
+		}
+		if(loaded)
 		{
 			// We were able to find a cache of files. So, use what we
 			// found to generate a set of categories we should add. We
@@ -2002,6 +2254,8 @@ bool LLInventoryModel::loadSkeleton(
 			// go ahead and add the cats returned during the download
 			std::set<LLUUID>::iterator not_cached_id = cached_ids.end();
 			cached_category_count = cached_ids.size();
+			mCategoryMap.reserve(mCategoryMap.size() + temp_cats.size());
+			mItemMap.reserve(mItemMap.size() + items.count());
 			for(cat_set_t::iterator it = temp_cats.begin(); it != temp_cats.end(); ++it)
 			{
 				if(cached_ids.find((*it)->getUUID()) == not_cached_id)
@@ -2016,6 +2270,43 @@ bool LLInventoryModel::loadSkeleton(
 				++child_counts[(*it)->getParentUUID()];
 			}
 
+			// The binary cache records how many children each folder had
+			// when it was written.  Fetch any folder that the cache no
+			// longer holds in full, rather than show it incomplete.
+			if(!cached_descendents.empty())
+			{
+				std::map<LLUUID, S32> cached_children;
+				count = items.count();
+				for(S32 i = 0; i < count; ++i)
+				{
+					++cached_children[items[i]->getParentUUID()];
+				}
+				S32 invalidated = 0;
+				for(cat_set_t::iterator it = temp_cats.begin(); it != temp_cats.end(); ++it)
+				{
+					LLViewerInventoryCategory* cat = (*it);
+					if(cat->getVersion() == NO_VERSION) continue;
+					std::map<LLUUID, S32>::iterator recorded = cached_descendents.find(cat->getUUID());
+					if(recorded == cached_descendents.end()) continue;
+					S32 children = cached_children[cat->getUUID()];
+					update_map_t::iterator cat_children = child_counts.find(cat->getUUID());
+					if(cat_children != child_counts.end())
+					{
+						children += cat_children->second.mValue;
+					}
+					if(children != recorded->second)
+					{
+						cat->setVersion(NO_VERSION);
+						--cached_category_count;
+						++invalidated;
+					}
+				}
+				if(invalidated)
+				{
+					llinfos << invalidated << " cached inventory folders are incomplete and will be fetched" << llendl;
+				}
+			}
+
 			// Add all the items loaded which are parented to a
 			// category with a correctly cached parent
 			count = items.count();
@@ -2539,6 +2830,81 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 	return true;
 }
 
+// static
+bool LLInventoryModel::loadFromBinaryFile(const std::string& filename,
+										  LLInventoryModel::cat_array_t& categories,
+										  LLInventoryModel::item_array_t& items,
+										  std::map<LLUUID, S32>& descendents)
+{
+	LLInventoryCacheReader reader;
+	if(!reader.open(filename))
+	{
+		llinfos << "No binary inventory cache at " << filename << llendl;
+		return false;
+	}
+	llinfos << "LLInventoryModel::loadFromBinaryFile(" << filename << ")" << llendl;
+
+	S32 cat_count = reader.getCategoryCount();
+	for(S32 i = 0; i < cat_count; ++i)
+	{
+		LLPointer<LLViewerInventoryCategory> cat = new LLViewerInventoryCategory(LLUUID::null);
+		LLUUID owner_id;
+		S32 version;
+		S32 cat_descendents;
+		if(!reader.readCategory(i, cat.get(), owner_id, version, cat_descendents))
+		{
+			llwarns << "Corrupt category in " << filename << llendl;
+			descendents.clear();
+			categories.clear();
+			return false;
+		}
+		cat->setOwnerID(owner_id);
+		cat->setVersion(version);
+		descendents[cat->getUUID()] = cat_descendents;
+		categories.put(cat);
+	}
+
+	// Make the items here, then fill them in on the workers.
+	S32 item_count = reader.getItemCount();
+	item_array_t loaded_items;
+	loaded_items.reserve(item_count);
+	for(S32 i = 0; i < item_count; ++i)
+	{
+		loaded_items.put(new LLViewerInventoryItem);
+	}
+
+	S32 num_chunks = llclamp(item_count / MIN_CACHE_LOAD_ITEMS_PER_CHUNK, 1, MAX_CACHE_LOAD_CHUNKS);
+	LLPointer<LLInventoryCacheLoad> load = new LLInventoryCacheLoad(reader, loaded_items, num_chunks);
+	for(S32 t = 1; t < num_chunks; ++t)
+	{
+		LLTaskScheduler::getInstance()->schedule(new LLInventoryCacheLoadTask(load), LLTaskScheduler::LANE_HIGH);
+	}
+	load->decodeChunks();
+	if(!load->wait())
+	{
+		llwarns << "Corrupt item in " << filename << llendl;
+		descendents.clear();
+		categories.clear();
+		return false;
+	}
+
+	for(S32 i = 0; i < item_count; ++i)
+	{
+		LLViewerInventoryItem* item = loaded_items[i];
+		// see loadFromFile()
+		if(item->getUUID().isNull())
+		{
+			llwarns << "Ignoring inventory with null item id: " << item->getName() << llendl;
+			continue;
+		}
+		item->setComplete(FALSE);
+		items.put(item);
+	}
+	llinfos << "Loaded " << cat_count << " categories and " << items.count()
+			<< " items from the inventory cache in " << num_chunks << " chunks" << llendl;
+	return true;
+}
+
 // static
 bool LLInventoryModel::saveToFile(const std::string& filename,
 								  const cat_array_t& categories,
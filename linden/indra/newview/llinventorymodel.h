@@ -36,8 +36,10 @@
 #include "llassettype.h"
 #include "lldarray.h"
 #include "lluuid.h"
+#include "llinventorysearchindex.h"
 #include "llpermissionsflags.h"
 #include "llstring.h"
+#include "lluuidopenhashmap.h"
 
 #include <map>
 #include <set>
@@ -151,6 +153,10 @@ public:
 	S32 getItemCount() const;
 	S32 getCategoryCount() const;
 
+	// Name index over every category and item, kept current as objects
+	// are added, changed and removed.
+	const LLInventorySearchIndex& getSearchIndex() const { return mSearchIndex; }
+
 	// Return the direct descendents of the id provided.Set passed
 	// in values to NULL if the call fails.
 	// *WARNING: The array provided points straight into the guts of
@@ -386,6 +392,9 @@ protected:
 	void addCategory(LLViewerInventoryCategory* category);
 	void addItem(LLViewerInventoryItem* item);
 
+	// Refreshes or drops the search index entry for id.
+	void updateSearchIndex(const LLUUID& id);
+
 	// Internal method which looks for a category with the specified
 	// preferred type. Returns LLUUID::null if not found
  	LLUUID findCatUUID(LLAssetType::EType preferred_type);
@@ -405,6 +414,17 @@ protected:
 	static bool saveToFile(const std::string& filename,
 						   const cat_array_t& categories,
 						   const item_array_t& items); 
+	// binary cache, see llinventorycache.h. descendents gets the
+	// number of children each cached category had when it was saved.
+	static bool loadFromBinaryFile(const std::string& filename,
+								   cat_array_t& categories,
+								   item_array_t& items,
+								   std::map<LLUUID, S32>& descendents);
+public:
+	// Blocks until inventory caches being written in the background
+	// are on disk.
+	static void flushCacheWrites();
+protected:
 
 	// message handling functionality
 	//static void processUseCachedInventory(LLMessageSystem* msg, void**);
@@ -437,12 +457,15 @@ protected:
 	// information in a lot of different ways so we can access
 	// the inventory using several different identifiers.
 	// mInventory member data is the 'master' list of inventory, and
-	// mCategoryMap and mItemMap store uuid->object mappings. 
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryCategory> > cat_map_t;
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryItem> > item_map_t;
+	// mCategoryMap and mItemMap store uuid->object mappings. These are
+	// hashed rather than ordered since nothing depends on walking them
+	// in uuid order, and lookups dominate on large inventories.
+	typedef LLUUIDOpenHashMap<LLPointer<LLViewerInventoryCategory> > cat_map_t;
+	typedef LLUUIDOpenHashMap<LLPointer<LLViewerInventoryItem> > item_map_t;
 	//inv_map_t mInventory;
 	cat_map_t mCategoryMap;
 	item_map_t mItemMap;
+	LLInventorySearchIndex mSearchIndex;
 
 	std::map<LLUUID, bool> mCategoryLock;
 	std::map<LLUUID, bool> mItemLock;
@@ -451,8 +474,8 @@ protected:
 	mutable LLPointer<LLViewerInventoryItem> mLastItem;
 
 	// This last set of indices is used to map parents to children.
-	typedef std::map<LLUUID, cat_array_t*> parent_cat_map_t;
-	typedef std::map<LLUUID, item_array_t*> parent_item_map_t;
+	typedef LLUUIDOpenHashMap<cat_array_t*> parent_cat_map_t;
+	typedef LLUUIDOpenHashMap<item_array_t*> parent_item_map_t;
 	parent_cat_map_t mParentChildCategoryTree;
 	parent_item_map_t mParentChildItemTree;
 
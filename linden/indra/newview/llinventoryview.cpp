@@ -1781,6 +1781,8 @@ BOOL LLInventoryPanel::postBuild()
 					   0);
 	mFolders = new LLFolderView(getName(), NULL, folder_rect, LLUUID::null, this);
 	mFolders->setAllowMultiSelect(mAllowMultiSelect);
+	mFolders->getFilter()->setSearchIndex(&mInventory->getSearchIndex());
+	mFolders->setPopulateCallback(onPopulateFolder, this);
 
 	// scroller
 	LLRect scroller_view_rect = getRect();
@@ -1997,8 +1999,10 @@ void LLInventoryPanel::modelChanged(U32 mask)
 				{
 					if (!view_item)
 					{
-						// this object was just created, need to build a view for it
-						if ((mask & LLInventoryObserver::ADD) != LLInventoryObserver::ADD)
+						// this object was just created, or moved out of a
+						// folder whose views were never built; either way
+						// it needs a view if its new parent has children
+						if ((mask & (LLInventoryObserver::ADD | LLInventoryObserver::STRUCTURE)) == 0)
 						{
 							llwarns << *id_it << " is in model but not in view, but ADD flag not set" << llendl;
 						}
@@ -2021,7 +2025,13 @@ void LLInventoryPanel::modelChanged(U32 mask)
 						}
 
 						LLFolderViewFolder* new_parent = (LLFolderViewFolder*)mFolders->getItemByID(model_item->getParentUUID());
-						if (view_item->getParentFolder() != new_parent)
+						if (!new_parent || new_parent->getChildrenPending())
+						{
+							// moved somewhere we have no child views for;
+							// it will be rebuilt if that folder is opened
+							view_item->destroyView();
+						}
+						else if (view_item->getParentFolder() != new_parent)
 						{
 							view_item->getParentFolder()->extractItem(view_item);
 							view_item->addToFolder(new_parent, mFolders);
@@ -2039,10 +2049,7 @@ void LLInventoryPanel::modelChanged(U32 mask)
 						// item in view but not model, need to delete view
 						view_item->destroyView();
 					}
-					else
-					{
-						llwarns << *id_it << "Item does not exist in either view or model, but notification triggered" << llendl;
-					}
+					// otherwise it was in a folder whose views were never built
 				}
 			}
 		}
@@ -2078,6 +2085,21 @@ void LLInventoryPanel::buildNewViews(const LLUUID& id)
 
 	if (objectp)
 	{		
+		// nothing to do until the parent folder builds its children
+		LLFolderViewFolder* parent_folder = (LLFolderViewFolder*)mFolders->getItemByID(objectp->getParentUUID());
+		if (!parent_folder)
+		{
+			if (!gInventory.getCategory(objectp->getParentUUID()))
+			{
+				llwarns << "Couldn't find parent folder for child " << objectp->getName() << llendl;
+			}
+			return;
+		}
+		if (parent_folder->getChildrenPending())
+		{
+			return;
+		}
+
 		if (objectp->getType() <= LLAssetType::AT_NONE ||
 			objectp->getType() >= LLAssetType::AT_COUNT)
 		{
@@ -2100,6 +2122,7 @@ void LLInventoryPanel::buildNewViews(const LLUUID& id)
 													new_listener);
 				
 				folderp->setItemSortOrder(mFolders->getSortOrder());
+				folderp->setChildrenPending(TRUE);
 				itemp = folderp;
 			}
 		}
@@ -2122,48 +2145,74 @@ void LLInventoryPanel::buildNewViews(const LLUUID& id)
 			}
 		}
 
-		LLFolderViewFolder* parent_folder = (LLFolderViewFolder*)mFolders->getItemByID(objectp->getParentUUID());
-
 		if (itemp)
 		{
-			if (parent_folder)
-			{
-				itemp->addToFolder(parent_folder, mFolders);
-			}
-			else
-			{
-				llwarns << "Couldn't find parent folder for child " << itemp->getLabel() << llendl;
-				delete itemp;
-			}
+			itemp->addToFolder(parent_folder, mFolders);
 		}
 	}
-
-	if ((id.isNull() ||
-		(objectp && objectp->getType() == LLAssetType::AT_CATEGORY)))
+	else if (id.isNull())
 	{
-		LLViewerInventoryCategory::cat_array_t* categories;
-		LLViewerInventoryItem::item_array_t* items;
+		// the root is always populated
+		buildChildViews(id);
+	}
+}
 
-		mInventory->lockDirectDescendentArrays(id, categories, items);
-		if(categories)
+void LLInventoryPanel::buildChildViews(const LLUUID& id)
+{
+	LLViewerInventoryCategory::cat_array_t* categories;
+	LLViewerInventoryItem::item_array_t* items;
+
+	mInventory->lockDirectDescendentArrays(id, categories, items);
+	if(categories)
+	{
+		S32 count = categories->count();
+		for(S32 i = 0; i < count; ++i)
 		{
-			S32 count = categories->count();
-			for(S32 i = 0; i < count; ++i)
-			{
-				LLInventoryCategory* cat = categories->get(i);
-				buildNewViews(cat->getUUID());
-			}
+			LLInventoryCategory* cat = categories->get(i);
+			buildNewViews(cat->getUUID());
 		}
-		if(items)
+	}
+	if(items)
+	{
+		S32 count = items->count();
+		for(S32 i = 0; i < count; ++i)
 		{
-			S32 count = items->count();
-			for(S32 i = 0; i < count; ++i)
-			{
-				LLInventoryItem* item = items->get(i);
-				buildNewViews(item->getUUID());
-			}
+			LLInventoryItem* item = items->get(i);
+			buildNewViews(item->getUUID());
 		}
-		mInventory->unlockDirectDescendentArrays(id);
+	}
+	mInventory->unlockDirectDescendentArrays(id);
+}
+
+void LLInventoryPanel::buildAncestorViews(const LLUUID& id)
+{
+	// collect the chain of folders above id, then populate top down
+	std::vector<LLUUID> ancestors;
+	LLInventoryObject* objectp = mInventory->getObject(id);
+	while (objectp && objectp->getParentUUID().notNull())
+	{
+		ancestors.push_back(objectp->getParentUUID());
+		objectp = mInventory->getCategory(objectp->getParentUUID());
+	}
+	for (std::vector<LLUUID>::reverse_iterator it = ancestors.rbegin();
+		 it != ancestors.rend(); ++it)
+	{
+		LLFolderViewFolder* folderp = (LLFolderViewFolder*)mFolders->getItemByID(*it);
+		if (!folderp)
+		{
+			break;
+		}
+		folderp->populate();
+	}
+}
+
+// static
+void LLInventoryPanel::onPopulateFolder(LLFolderViewFolder* folder, void* user_data)
+{
+	LLInventoryPanel* self = (LLInventoryPanel*)user_data;
+	if (self && folder->getListener())
+	{
+		self->buildChildViews(folder->getListener()->getUUID());
 	}
 }
 
@@ -2261,12 +2310,14 @@ void LLInventoryPanel::closeAllFolders()
 void LLInventoryPanel::openDefaultFolderForType(LLAssetType::EType type)
 {
 	LLUUID category_id = mInventory->findCategoryUUIDForType(type);
+	buildAncestorViews(category_id);
 	LLOpenFolderByID opener(category_id);
 	mFolders->applyFunctorRecursively(opener);
 }
 
 void LLInventoryPanel::setSelection(const LLUUID& obj_id, BOOL take_keyboard_focus)
 {
+	buildAncestorViews(obj_id);
 	LLFolderViewItem* itemp = mFolders->getItemByID(obj_id);
 	if(itemp && itemp->getListener())
 	{
@@ -141,8 +141,14 @@ public:
 
 protected:
 	// Given the id and the parent, build all of the folder views.
+	// Folders are built with their children pending; those are built
+	// when the folder is opened or a filter needs to look inside.
 	void rebuildViewsFor(const LLUUID& id, U32 mask);
 	void buildNewViews(const LLUUID& id);
+	void buildChildViews(const LLUUID& id);
+	// Makes sure every folder above id has built its children.
+	void buildAncestorViews(const LLUUID& id);
+	static void onPopulateFolder(LLFolderViewFolder* folder, void* user_data);
 
 public:
 	// TomY TODO: Move this elsewhere?
@@ -155,17 +155,15 @@ void LLMapLayerResponder::result(const LLSD& result)
 				// 			llinfos << "Map sim " << name << " image layer " << agent_flags << " ID " << image_id.getString() << llendl;
 			
 				LLSimInfo* siminfo = new LLSimInfo();
-				LLWorldMap::sim_info_map_t::iterator iter = LLWorldMap::getInstance()->mSimInfoMap.find(handle);
-				if (iter != LLWorldMap::getInstance()->mSimInfoMap.end())
+				LLSimInfo* oldinfo = LLWorldMap::getInstance()->simInfoFromHandle(handle);
+				if (oldinfo)
 				{
-					LLSimInfo* oldinfo = iter->second;
 					for (S32 image=0; image<MAP_SIM_IMAGE_TYPES; ++image)
 					{
 						siminfo->mMapImageID[image] = oldinfo->mMapImageID[image];
 					}
-					delete oldinfo;
 				}
-				LLWorldMap::getInstance()->mSimInfoMap[handle] = siminfo;
+				LLWorldMap::getInstance()->addSimInfo(handle, siminfo);
 
 				siminfo->mHandle = handle;
 				siminfo->mName.assign( name );
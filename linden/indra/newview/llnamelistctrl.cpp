@@ -44,6 +44,7 @@ static LLRegisterWidget<LLNameListCtrl> r("name_list");
 
 // statics
 std::set<LLNameListCtrl*> LLNameListCtrl::sInstances;
+LLNameListCtrl::name_map_t LLNameListCtrl::sPendingNames;
 
 LLNameListCtrl::LLNameListCtrl(const std::string& name,
 							   const LLRect& rect,
@@ -273,13 +274,54 @@ void LLNameListCtrl::refresh(const LLUUID& id, const std::string& first,
 void LLNameListCtrl::refreshAll(const LLUUID& id, const std::string& first,
 								const std::string& last, BOOL is_group)
 {
+	if (!is_group)
+	{
+		sPendingNames[id] = first + " " + last;
+	}
+	else
+	{
+		sPendingNames[id] = first;
+	}
+}
+
+// static
+void LLNameListCtrl::flushRefreshAll()
+{
+	if (sPendingNames.empty())
+	{
+		return;
+	}
+
 	std::set<LLNameListCtrl*>::iterator it;
 	for (it = LLNameListCtrl::sInstances.begin();
 		 it != LLNameListCtrl::sInstances.end();
 		 ++it)
 	{
 		LLNameListCtrl* ctrl = *it;
-		ctrl->refresh(id, first, last, is_group);
+		ctrl->refreshNames(sPendingNames);
+	}
+	sPendingNames.clear();
+}
+
+void LLNameListCtrl::refreshNames(const name_map_t& names)
+{
+	BOOL changed = FALSE;
+	item_list::iterator iter;
+	for (iter = getItemList().begin(); iter != getItemList().end(); iter++)
+	{
+		LLScrollListItem* item = *iter;
+		name_map_t::const_iterator found = names.find(item->getUUID());
+		if (found != names.end())
+		{
+			LLScrollListCell* cell = (LLScrollListCell*)item->getColumn(mNameColumnIndex);
+			((LLScrollListText*)cell)->setText(found->second);
+			changed = TRUE;
+		}
+	}
+
+	if (changed)
+	{
+		dirtyColumns();
 	}
 }
 
@@ -36,6 +36,7 @@
 #include <set>
 
 #include "llscrolllistctrl.h"
+#include "lluuidopenhashmap.h"
 
 
 class LLNameListCtrl
@@ -74,8 +75,11 @@ public:
 
 	void refresh(const LLUUID& id, const std::string& first, const std::string& last, BOOL is_group);
 
+	// Queues the name for every list; flushRefreshAll() applies the
+	// queued names with one pass over each list's rows.
 	static void refreshAll(const LLUUID& id, const std::string& firstname,
 						   const std::string& lastname, BOOL is_group);
+	static void flushRefreshAll();
 
 	virtual BOOL	handleDragAndDrop(S32 x, S32 y, MASK mask,
 									  BOOL drop, EDragAndDropType cargo_type, void *cargo_data,
@@ -85,7 +89,11 @@ public:
 	void setAllowCallingCardDrop(BOOL b) { mAllowCallingCardDrop = b; }
 
 private:
+	typedef LLUUIDOpenHashMap<std::string> name_map_t;
+	void refreshNames(const name_map_t& names);
+
 	static std::set<LLNameListCtrl*> sInstances;
+	static name_map_t sPendingNames;
 	S32    	 mNameColumnIndex;
 	BOOL	 mAllowCallingCardDrop;
 };
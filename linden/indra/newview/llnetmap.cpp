@@ -84,24 +84,31 @@ const F32 DOT_SCALE = 0.75f;
 const F32 MIN_PICK_SCALE = 2.f;
 const S32 SLOP = 2;
 const S32 TRACKING_RADIUS = 3;
+const S32 OBJECT_TILE_TEXELS = 64;
+const U32 MIN_OBJECT_TILES = 64;
+const S32 MAX_OBJECT_TILE_UPDATES = 8;	// per frame
 
 LLNetMap::LLNetMap(const std::string& name) :
 	LLPanel(name),
 	mScale(128.f),
 	mObjectMapTPM(1.f),
-	mObjectMapPixels(255.f),
 	mTargetPanX( 0.f ),
 	mTargetPanY( 0.f ),
 	mCurPanX( 0.f ),
 	mCurPanY( 0.f ),
-	mUpdateNow( FALSE )
+	mUpdateNow( FALSE ),
+	mObjectImageSize(0),
+	mObjectTileMeters(0.0),
+	mObjectRefresh(1),
+	mObjectTiles(MIN_OBJECT_TILES)
 {
+	// avatars, objects and the camera move without invalidating us
+	setDrawsLive(TRUE);
+
 	mScale = gSavedSettings.getF32("MiniMapScale");
 	mPixelsPerMeter = mScale / LLWorld::getInstance()->getRegionWidthInMeters();
 	mDotRadius = llmax(DOT_SCALE * mPixelsPerMeter, MIN_DOT_RADIUS);
 
-	mObjectImageCenterGlobal = gAgent.getCameraPositionGlobal();
-	
 	// Register event listeners for popup menu
 	(new LLScaleMap())->registerListener(this, "MiniMap.ZoomLevel");
 	(new LLCenterMap())->registerListener(this, "MiniMap.Center");
@@ -145,16 +152,15 @@ void LLNetMap::setScale( F32 scale )
 	}
 	gSavedSettings.setF32("MiniMapScale", mScale);
 
-	if (mObjectImagep.notNull())
+	if (mObjectImageSize > 0)
 	{
 		F32 width = (F32)(getRect().getWidth());
 		F32 height = (F32)(getRect().getHeight());
 		F32 diameter = sqrt(width * width + height * height);
 		F32 region_widths = diameter / mScale;
 		F32 meters = region_widths * LLWorld::getInstance()->getRegionWidthInMeters();
-		F32 num_pixels = (F32)mObjectImagep->getWidth();
+		F32 num_pixels = (F32)mObjectImageSize;
 		mObjectMapTPM = num_pixels / meters;
-		mObjectMapPixels = diameter;
 	}
 
 	mPixelsPerMeter = mScale / LLWorld::getInstance()->getRegionWidthInMeters();
@@ -176,7 +182,7 @@ void LLNetMap::draw()
 {
  	static LLFrameTimer map_timer;
 
-	if (mObjectImagep.isNull())
+	if (mObjectImageSize == 0)
 	{
 		createObjectImage();
 	}
@@ -286,49 +292,65 @@ void LLNetMap::draw()
 			gGL.setAlphaRejectSettings(LLRender::CF_DEFAULT);
 		}
 
-		// Redraw object layer periodically
-		if (mUpdateNow || (map_timer.getElapsedTimeF32() > 0.5f))
+		// Object layer.  It is cut into squares aligned to the world grid,
+		// so scrolling reuses the squares already drawn and only those where
+		// objects changed are redrawn.
+		F64 tile_meters = (F64)OBJECT_TILE_TEXELS / mObjectMapTPM;
+		if (tile_meters != mObjectTileMeters)
 		{
-			mUpdateNow = FALSE;
-
-			// Locate the centre of the object layer, accounting for panning
-			LLVector3 new_center = globalPosToView(gAgent.getCameraPositionGlobal(), rotate_map);	
-			new_center.mV[0] -= mCurPanX;
-			new_center.mV[1] -= mCurPanY;
-			new_center.mV[2] = 0.f;
-			mObjectImageCenterGlobal = viewPosToGlobal(llround(new_center.mV[0]), llround(new_center.mV[1]), rotate_map);
+			mObjectTileMeters = tile_meters;
+			mObjectTiles.clear();
+		}
 
-			// Create the base texture.
-			U8 *default_texture = mObjectRawImagep->getData();
-			memset( default_texture, 0, mObjectImagep->getWidth() * mObjectImagep->getHeight() * mObjectImagep->getComponents() );
+		// The map may be rotated, so cover the circle through the corners
+		F32 width = (F32)getRect().getWidth();
+		F32 height = (F32)getRect().getHeight();
+		F64 view_radius = 0.5 * sqrt(width * width + height * height) / mPixelsPerMeter;
+		LLVector3d view_center_global = viewPosToGlobal(llround(width / 2), llround(height / 2), rotate_map);
 
-			// Draw objects
-			gObjectList.renderObjectsForMap(*this);
+		S32 min_tile_x = llfloor((view_center_global.mdV[VX] - view_radius) / tile_meters);
+		S32 min_tile_y = llfloor((view_center_global.mdV[VY] - view_radius) / tile_meters);
+		S32 max_tile_x = llfloor((view_center_global.mdV[VX] + view_radius) / tile_meters);
+		S32 max_tile_y = llfloor((view_center_global.mdV[VY] + view_radius) / tile_meters);
 
-			mObjectImagep->setSubImage(mObjectRawImagep, 0, 0, mObjectImagep->getWidth(), mObjectImagep->getHeight());
-			
+		BOOL refresh = mUpdateNow || (map_timer.getElapsedTimeF32() > 0.5f);
+		if (refresh)
+		{
+			mUpdateNow = FALSE;
 			map_timer.reset();
 		}
+		updateObjectTiles(min_tile_x, min_tile_y, max_tile_x, max_tile_y, refresh);
 
-		LLVector3 map_center_agent = gAgent.getPosAgentFromGlobal(mObjectImageCenterGlobal);
-		map_center_agent -= gAgent.getCameraPositionAgent();
-		map_center_agent.mV[VX] *= mScale/region_width;
-		map_center_agent.mV[VY] *= mScale/region_width;
-
-		gGL.getTexUnit(0)->bind(mObjectImagep);
-		F32 image_half_width = 0.5f*mObjectMapPixels;
-		F32 image_half_height = 0.5f*mObjectMapPixels;
-
-		gGL.begin(LLRender::QUADS);
-			gGL.texCoord2f(0.f, 1.f);
-			gGL.vertex2f(map_center_agent.mV[VX] - image_half_width, image_half_height + map_center_agent.mV[VY]);
-			gGL.texCoord2f(0.f, 0.f);
-			gGL.vertex2f(map_center_agent.mV[VX] - image_half_width, map_center_agent.mV[VY] - image_half_height);
-			gGL.texCoord2f(1.f, 0.f);
-			gGL.vertex2f(image_half_width + map_center_agent.mV[VX], map_center_agent.mV[VY] - image_half_height);
-			gGL.texCoord2f(1.f, 1.f);
-			gGL.vertex2f(image_half_width + map_center_agent.mV[VX], image_half_height + map_center_agent.mV[VY]);
-		gGL.end();
+		LLVector3d camera_global = gAgent.getCameraPositionGlobal();
+		F32 tile_pixels = (F32)(tile_meters * mPixelsPerMeter);
+		for (S32 tile_y = min_tile_y; tile_y <= max_tile_y; tile_y++)
+		{
+			for (S32 tile_x = min_tile_x; tile_x <= max_tile_x; tile_x++)
+			{
+				LLObjectTile* tile = mObjectTiles.find(objectTileKey(tile_x, tile_y));
+				if (!tile || tile->mImagep.isNull())
+				{
+					continue;
+				}
+
+				F32 left = (F32)((tile_x * tile_meters - camera_global.mdV[VX]) * mPixelsPerMeter);
+				F32 bottom = (F32)((tile_y * tile_meters - camera_global.mdV[VY]) * mPixelsPerMeter);
+				F32 right = left + tile_pixels;
+				F32 top = bottom + tile_pixels;
+
+				gGL.getTexUnit(0)->bind(tile->mImagep);
+				gGL.begin(LLRender::QUADS);
+					gGL.texCoord2f(0.f, 1.f);
+					gGL.vertex2f(left, top);
+					gGL.texCoord2f(0.f, 0.f);
+					gGL.vertex2f(left, bottom);
+					gGL.texCoord2f(1.f, 0.f);
+					gGL.vertex2f(right, bottom);
+					gGL.texCoord2f(1.f, 1.f);
+					gGL.vertex2f(right, top);
+				gGL.end();
+			}
+		}
 
 		gGL.popMatrix();
 
@@ -354,7 +376,7 @@ void LLNetMap::draw()
 
 		std::vector<LLUUID> avatar_ids;
 		std::vector<LLVector3d> positions;
-		LLWorld::getInstance()->getAvatars(&avatar_ids, &positions);
+		LLWorld::getInstance()->getAvatarsInSquare(view_center_global, view_radius, &avatar_ids, &positions);
 		for(U32 i=0; i<avatar_ids.size(); i++)
 		{
 			// TODO: it'd be very cool to draw these in sorted order from lowest Z to highest.
@@ -700,97 +722,153 @@ void LLNetMap::updateMinorDirections()
 	getChild<LLTextBox>("se_label")->setVisible(show_minors);
 }
 
-void LLNetMap::renderScaledPointGlobal( const LLVector3d& pos, const LLColor4U &color, F32 radius_meters )
+U64 LLNetMap::objectTileKey(S32 tile_x, S32 tile_y)
 {
-	LLVector3 local_pos;
-	local_pos.setVec( pos - mObjectImageCenterGlobal );
-
-	S32 diameter_pixels = llround(2 * radius_meters * mObjectMapTPM);
-	renderPoint( local_pos, color, diameter_pixels );
+	return ((U64)(U32)tile_x << 32) | (U64)(U32)tile_y;
 }
 
-
-void LLNetMap::renderPoint(const LLVector3 &pos_local, const LLColor4U &color, 
-						   S32 diameter, S32 relative_height)
+void LLNetMap::updateObjectTiles(S32 min_x, S32 min_y, S32 max_x, S32 max_y, BOOL refresh)
 {
-	if (diameter <= 0)
-	{
-		return;
-	}
-
-	const S32 image_width = (S32)mObjectImagep->getWidth();
-	const S32 image_height = (S32)mObjectImagep->getHeight();
+	const S32 tiles_x = max_x - min_x + 1;
+	const S32 tiles_y = max_y - min_y + 1;
 
-	S32 x_offset = llround(pos_local.mV[VX] * mObjectMapTPM + image_width / 2);
-	S32 y_offset = llround(pos_local.mV[VY] * mObjectMapTPM + image_height / 2);
-
-	if ((x_offset < 0) || (x_offset >= image_width))
-	{
-		return;
-	}
-	if ((y_offset < 0) || (y_offset >= image_height))
+	// Keep the tiles around the view as well, for scrolling back
+	U32 max_tiles = llmax(MIN_OBJECT_TILES, (U32)(tiles_x * tiles_y * 2));
+	if (mObjectTiles.getMaxSize() != max_tiles)
 	{
-		return;
+		mObjectTiles.setMaxSize(max_tiles);
 	}
 
-	U8 *datap = mObjectRawImagep->getData();
-
-	S32 neg_radius = diameter / 2;
-	S32 pos_radius = diameter - neg_radius;
-	S32 x, y;
-
-	if (relative_height > 0)
+	if (refresh)
 	{
-		// ...point above agent
-		S32 px, py;
-
-		// vertical line
-		px = x_offset;
-		for (y = -neg_radius; y < pos_radius; y++)
+		// Find the tiles in view that objects changed in since the last
+		// refresh.  If too much changed to track, that is all of them.
+		std::vector<LLMapFootprint> damage;
+		BOOL tracked = gObjectList.popMapDamage(damage);
+		std::vector<U8> damaged(tiles_x * tiles_y, tracked ? 0 : 1);
+		for (U32 i = 0; i < damage.size(); i++)
 		{
-			py = y_offset + y;
-			if ((py < 0) || (py >= image_height))
+			const LLMapFootprint& footprint = damage[i];
+			S32 x0 = llmax(min_x, llfloor((footprint.mPosGlobal.mdV[VX] - footprint.mRadius) / mObjectTileMeters));
+			S32 y0 = llmax(min_y, llfloor((footprint.mPosGlobal.mdV[VY] - footprint.mRadius) / mObjectTileMeters));
+			S32 x1 = llmin(max_x, llfloor((footprint.mPosGlobal.mdV[VX] + footprint.mRadius) / mObjectTileMeters));
+			S32 y1 = llmin(max_y, llfloor((footprint.mPosGlobal.mdV[VY] + footprint.mRadius) / mObjectTileMeters));
+			for (S32 y = y0; y <= y1; y++)
 			{
-				continue;
+				for (S32 x = x0; x <= x1; x++)
+				{
+					damaged[(y - min_y) * tiles_x + (x - min_x)] = 1;
+				}
 			}
-			S32 offset = px + py * image_width;
-			((U32*)datap)[offset] = color.mAll;
 		}
 
-		// top line
-		py = y_offset + pos_radius - 1;
-		for (x = -neg_radius; x < pos_radius; x++)
+		// Up to date tiles that nothing touched stay up to date.  The rest,
+		// including tiles out of view just now, are redrawn when needed.
+		for (S32 y = min_y; y <= max_y; y++)
 		{
-			px = x_offset + x;
-			if ((px < 0) || (px >= image_width))
+			for (S32 x = min_x; x <= max_x; x++)
 			{
-				continue;
+				LLObjectTile* tile = mObjectTiles.find(objectTileKey(x, y));
+				if (tile && tile->mRefresh == mObjectRefresh &&
+					!damaged[(y - min_y) * tiles_x + (x - min_x)])
+				{
+					tile->mRefresh = mObjectRefresh + 1;
+				}
 			}
-			S32 offset = px + py * image_width;
-			((U32*)datap)[offset] = color.mAll;
 		}
+		mObjectRefresh++;
 	}
-	else
+
+	// Draw missing and out of date tiles, a few per frame
+	S32 budget = MAX_OBJECT_TILE_UPDATES;
+	for (S32 y = min_y; y <= max_y && budget > 0; y++)
 	{
-		// ...point level with agent
-		for (x = -neg_radius; x < pos_radius; x++)
+		for (S32 x = min_x; x <= max_x && budget > 0; x++)
 		{
-			S32 p_x = x_offset + x;
-			if ((p_x < 0) || (p_x >= image_width))
+			U64 key = objectTileKey(x, y);
+			LLObjectTile* tile = mObjectTiles.find(key);
+			if (tile && tile->mRefresh == mObjectRefresh)
 			{
 				continue;
 			}
-
-			for (y = -neg_radius; y < pos_radius; y++)
+			if (!tile)
 			{
-				S32 p_y = y_offset + y;
-				if ((p_y < 0) || (p_y >= image_height))
-				{
-					continue;
-				}
-				S32 offset = p_x + p_y * image_width;
-				((U32*)datap)[offset] = color.mAll;
+				LLObjectTile new_tile;
+				new_tile.mRawImagep = new LLImageRaw(OBJECT_TILE_TEXELS, OBJECT_TILE_TEXELS, 4);
+				tile = &mObjectTiles.insert(key, new_tile);
 			}
+			renderObjectTile(*tile, x, y);
+			budget--;
+		}
+	}
+}
+
+void LLNetMap::renderObjectTile(LLObjectTile& tile, S32 tile_x, S32 tile_y)
+{
+	LLColor4U colors[LLMapFootprint::COLOR_COUNT];
+	colors[LLMapFootprint::OTHER_ABOVE_WATER] = gColors.getColor( "NetMapOtherOwnAboveWater" );
+	colors[LLMapFootprint::OTHER_BELOW_WATER] = gColors.getColor( "NetMapOtherOwnBelowWater" );
+	colors[LLMapFootprint::YOU_OWN_ABOVE_WATER] = gColors.getColor( "NetMapYouOwnAboveWater" );
+	colors[LLMapFootprint::YOU_OWN_BELOW_WATER] = gColors.getColor( "NetMapYouOwnBelowWater" );
+	colors[LLMapFootprint::GROUP_OWN_ABOVE_WATER] = gColors.getColor( "NetMapGroupOwnAboveWater" );
+	colors[LLMapFootprint::GROUP_OWN_BELOW_WATER] = gColors.getColor( "NetMapGroupOwnBelowWater" );
+
+	LLVector3d min_global(tile_x * mObjectTileMeters, tile_y * mObjectTileMeters, 0.0);
+	LLVector3d max_global(min_global.mdV[VX] + mObjectTileMeters, min_global.mdV[VY] + mObjectTileMeters, 0.0);
+
+	U8 *datap = tile.mRawImagep->getData();
+	memset( datap, 0, OBJECT_TILE_TEXELS * OBJECT_TILE_TEXELS * 4 );
+
+	std::vector<const LLMapFootprint*> footprints;
+	gObjectList.getMapFootprints(min_global, max_global, footprints);
+	for (U32 i = 0; i < footprints.size(); i++)
+	{
+		const LLMapFootprint* footprint = footprints[i];
+		S32 x_offset = llround((F32)(footprint->mPosGlobal.mdV[VX] - min_global.mdV[VX]) * mObjectMapTPM);
+		S32 y_offset = llround((F32)(footprint->mPosGlobal.mdV[VY] - min_global.mdV[VY]) * mObjectMapTPM);
+		S32 diameter_pixels = llround(2 * footprint->mRadius * mObjectMapTPM);
+		renderPoint(tile.mRawImagep, x_offset, y_offset, colors[footprint->mColor], diameter_pixels);
+	}
+
+	if (tile.mImagep.isNull())
+	{
+		tile.mImagep = new LLImageGL(tile.mRawImagep, FALSE);
+		tile.mImagep->setAddressMode(LLTexUnit::TAM_CLAMP);
+	}
+	else
+	{
+		tile.mImagep->setSubImage(tile.mRawImagep, 0, 0, OBJECT_TILE_TEXELS, OBJECT_TILE_TEXELS);
+	}
+	tile.mRefresh = mObjectRefresh;
+}
+
+// Fills the part of the square around (x_offset, y_offset) that lies in
+// the image; the centre may be outside it.
+void LLNetMap::renderPoint(LLImageRaw* rawp, S32 x_offset, S32 y_offset,
+						   const LLColor4U &color, S32 diameter)
+{
+	if (diameter <= 0)
+	{
+		return;
+	}
+
+	const S32 image_width = (S32)rawp->getWidth();
+	const S32 image_height = (S32)rawp->getHeight();
+
+	S32 neg_radius = diameter / 2;
+	S32 pos_radius = diameter - neg_radius;
+	S32 min_x = llmax(x_offset - neg_radius, 0);
+	S32 min_y = llmax(y_offset - neg_radius, 0);
+	S32 max_x = llmin(x_offset + pos_radius, image_width);
+	S32 max_y = llmin(y_offset + pos_radius, image_height);
+
+	U32 *datap = (U32*)rawp->getData();
+	for (S32 y = min_y; y < max_y; y++)
+	{
+		U32 *rowp = datap + y * image_width;
+		for (S32 x = min_x; x < max_x; x++)
+		{
+			rowp[x] = color.mAll;
 		}
 	}
 }
@@ -812,14 +890,9 @@ void LLNetMap::createObjectImage()
 		img_size <<= 1;
 	}
 
-	if( mObjectImagep.isNull() ||
-		(mObjectImagep->getWidth() != img_size) ||
-		(mObjectImagep->getHeight() != img_size) )
+	if (img_size != mObjectImageSize)
 	{
-		mObjectRawImagep = new LLImageRaw(img_size, img_size, 4);
-		U8* data = mObjectRawImagep->getData();
-		memset( data, 0, img_size * img_size * 4 );
-		mObjectImagep = new LLImageGL( mObjectRawImagep, FALSE);
+		mObjectImageSize = img_size;
 		setScale(mScale);
 	}
 	mUpdateNow = TRUE;
@@ -40,6 +40,7 @@
 #include "v4color.h"
 #include "llimage.h"
 #include "llimagegl.h"
+#include "lllrucache.h"
 
 class LLTextBox;
 
@@ -67,9 +68,17 @@ public:
 	virtual BOOL	handleScrollWheel(S32 x, S32 y, S32 clicks);
 	virtual BOOL	handleToolTip( S32 x, S32 y, std::string& msg, LLRect* sticky_rect_screen );
 
-	void			renderScaledPointGlobal( const LLVector3d& pos, const LLColor4U &color, F32 radius );
-
 private:
+	// A square of the object layer, aligned to the world grid
+	struct LLObjectTile
+	{
+		LLObjectTile() : mRefresh(0) {}
+
+		LLPointer<LLImageRaw>	mRawImagep;
+		LLPointer<LLImageGL>	mImagep;
+		U32						mRefresh;	// last refresh it is known to be up to date for
+	};
+	typedef LLLRUCache<U64, LLObjectTile> object_tile_cache_t;
 
 	void			setScale( F32 scale );
 
@@ -77,8 +86,11 @@ private:
 	void			translatePan( F32 delta_x, F32 delta_y );
 	void			setPan( F32 x, F32 y )			{ mTargetPanX = x; mTargetPanY = y; }
 
-	void renderPoint(const LLVector3 &pos, const LLColor4U &color, 
-					 S32 diameter, S32 relative_height = 0);
+	void renderPoint(LLImageRaw* rawp, S32 x_offset, S32 y_offset,
+					 const LLColor4U &color, S32 diameter);
+	void			updateObjectTiles(S32 min_x, S32 min_y, S32 max_x, S32 max_y, BOOL refresh);
+	void			renderObjectTile(LLObjectTile& tile, S32 tile_x, S32 tile_y);
+	static U64		objectTileKey(S32 tile_x, S32 tile_y);
 	LLVector3		globalPosToView(const LLVector3d& global_pos, BOOL rotated);
 	LLVector3d		viewPosToGlobal(S32 x,S32 y, BOOL rotated);
 
@@ -96,7 +108,6 @@ private:
 	F32				mScale;					// Size of a region in pixels
 	F32				mPixelsPerMeter;		// world meters to map pixels
 	F32				mObjectMapTPM;			// texels per meter on map
-	F32				mObjectMapPixels;		// Width of object map in pixels
 	F32				mDotRadius;				// Size of avatar markers
 	F32				mTargetPanX;
 	F32				mTargetPanY;
@@ -110,9 +121,10 @@ private:
 	S32				mMouseDownY;
 
 	BOOL			mUpdateNow;
-	LLVector3d		mObjectImageCenterGlobal;
-	LLPointer<LLImageRaw> mObjectRawImagep;
-	LLPointer<LLImageGL>	mObjectImagep;
+	S32				mObjectImageSize;		// Texels across the object layer
+	F64				mObjectTileMeters;		// World width of an object layer tile
+	U32				mObjectRefresh;			// Counts object layer refreshes
+	object_tile_cache_t	mObjectTiles;
 
 private:
 	LLUUID				mClosestAgentToCursor;
@@ -93,7 +93,10 @@ LLPanelGroupGeneral::LLPanelGroupGeneral(const std::string& name,
 	mCtrlReceiveChat(NULL),
 	mCtrlListGroup(NULL),
 	mActiveTitleLabel(NULL),
-	mComboActiveTitle(NULL)
+	mComboActiveTitle(NULL),
+	mMemberProgress(0),
+	mMemberGeneration(0),
+	mMemberProgressRow(NULL)
 {
 
 }
@@ -811,28 +814,26 @@ void LLPanelGroupGeneral::update(LLGroupChange gc)
 	
 	if (mListVisibleMembers)
 	{
-		mListVisibleMembers->deleteAllItems();
-
-		if (gdatap->isMemberDataComplete())
+		// Members are appended as reply packets arrive, so the rows we
+		// already have stay valid unless the member list was reset.
+		if (mMemberGeneration != gdatap->mMembers.getGeneration())
 		{
-			mMemberProgress = gdatap->mMembers.begin();
-			mPendingMemberUpdate = TRUE;
+			mListVisibleMembers->deleteAllItems();
+			mMemberProgressRow = NULL;
+			mMemberProgress = 0;
+			mMemberGeneration = gdatap->mMembers.getGeneration();
 
 			sSDTime = 0.0f;
 			sElementTime = 0.0f;
 			sAllTime = 0.0f;
 		}
-		else
-		{
-			std::stringstream pending;
-			pending << "Retrieving member list (" << gdatap->mMembers.size() << "\\" << gdatap->mMemberCount  << ")";
-
-			LLSD row;
-			row["columns"][0]["value"] = pending.str();
 
+		if (!gdatap->isMemberDataComplete())
+		{
 			mListVisibleMembers->setEnabled(FALSE);
-			mListVisibleMembers->addElement(row);
 		}
+		updateMemberProgressRow(gdatap);
+		mPendingMemberUpdate = TRUE;
 	}
 }
 
@@ -842,24 +843,40 @@ void LLPanelGroupGeneral::updateMembers()
 
 	LLGroupMgrGroupData* gdatap = LLGroupMgr::getInstance()->getGroupData(mGroupID);
 
-	if (!mListVisibleMembers || !gdatap 
-		|| !gdatap->isMemberDataComplete())
+	if (!mListVisibleMembers || !gdatap)
 	{
 		return;
 	}
 
+	if (mMemberGeneration != gdatap->mMembers.getGeneration())
+	{
+		// The list was reset under us; start again from the top.
+		mListVisibleMembers->deleteAllItems();
+		mMemberProgressRow = NULL;
+		mMemberProgress = 0;
+		mMemberGeneration = gdatap->mMembers.getGeneration();
+	}
+
 	static LLTimer all_timer;
 	static LLTimer sd_timer;
 	static LLTimer element_timer;
 
 	all_timer.reset();
 	S32 i = 0;
+	S32 member_count = (S32)gdatap->mMembers.size();
+
+	// keep the progress row below the members added here
+	if (mMemberProgressRow && mMemberProgress < member_count)
+	{
+		mListVisibleMembers->deleteSingleItem(mListVisibleMembers->getItemIndex(mMemberProgressRow));
+		mMemberProgressRow = NULL;
+	}
 
-	for( ; mMemberProgress != gdatap->mMembers.end() && i<UPDATE_MEMBERS_PER_FRAME; 
+	for( ; mMemberProgress < member_count && i<UPDATE_MEMBERS_PER_FRAME; 
 			++mMemberProgress, ++i)
 	{
 		//llinfos << "Adding " << iter->first << ", " << iter->second->getTitle() << llendl;
-		LLGroupMemberData* member = mMemberProgress->second;
+		LLGroupMemberData* member = gdatap->mMembers.at(mMemberProgress).second;
 		if (!member)
 		{
 			continue;
@@ -894,10 +911,16 @@ void LLPanelGroupGeneral::updateMembers()
 		sElementTime += element_timer.getElapsedTimeF32();
 	}
 	sAllTime += all_timer.getElapsedTimeF32();
+	updateMemberProgressRow(gdatap);
 
 	llinfos << "Updated " << i << " of " << UPDATE_MEMBERS_PER_FRAME << "members in the list." << llendl;
-	if (mMemberProgress == gdatap->mMembers.end())
+	if (mMemberProgress == member_count)
 	{
+		if (!gdatap->isMemberDataComplete())
+		{
+			// Caught up; update() picks up the next reply packet.
+			return;
+		}
 		llinfos << "   member list completed." << llendl;
 		mListVisibleMembers->setEnabled(TRUE);
 
@@ -912,6 +935,26 @@ void LLPanelGroupGeneral::updateMembers()
 	}
 }
 
+void LLPanelGroupGeneral::updateMemberProgressRow(LLGroupMgrGroupData* gdatap)
+{
+	if (mMemberProgressRow)
+	{
+		mListVisibleMembers->deleteSingleItem(mListVisibleMembers->getItemIndex(mMemberProgressRow));
+		mMemberProgressRow = NULL;
+	}
+
+	if (!gdatap->isMemberDataComplete())
+	{
+		std::stringstream pending;
+		pending << "Retrieving member list (" << gdatap->mMembers.size() << "\\" << gdatap->mMemberCount  << ")";
+
+		LLSD row;
+		row["columns"][0]["value"] = pending.str();
+
+		mMemberProgressRow = mListVisibleMembers->addElement(row);
+	}
+}
+
 void LLPanelGroupGeneral::updateChanged()
 {
 	// List all the controls we want to check for changes...
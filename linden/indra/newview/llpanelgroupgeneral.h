@@ -45,6 +45,8 @@ class LLCheckBoxCtrl;
 class LLComboBox;
 class LLNameBox;
 class LLSpinCtrl;
+class LLScrollListItem;
+class LLGroupMgrGroupData;
 
 class LLPanelGroupGeneral : public LLPanelGroupTab
 {
@@ -80,6 +82,7 @@ private:
     static bool joinDlgCB(const LLSD& notification, const LLSD& response);
 
 	void updateMembers();
+	void updateMemberProgressRow(LLGroupMgrGroupData* gdatap);
 	void updateChanged();
 	bool confirmMatureApply(const LLSD& notification, const LLSD& response);
 
@@ -113,7 +116,12 @@ private:
 	LLComboBox		*mComboActiveTitle;
 	LLComboBox		*mComboMature;
 
-	LLGroupMgrGroupData::member_list_t::iterator mMemberProgress;
+	// Members already in mListVisibleMembers, in arrival order, and the
+	// member list generation they came from.
+	S32				mMemberProgress;
+	U32				mMemberGeneration;
+	// "Retrieving member list" row kept below them until the list is complete
+	LLScrollListItem* mMemberProgressRow;
 };
 
 #endif
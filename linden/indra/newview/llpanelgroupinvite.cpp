@@ -353,10 +353,12 @@ void LLPanelGroupInvite::impl::callbackAddUsers(const std::vector<std::string>&
 
 LLPanelGroupInvite::LLPanelGroupInvite(const std::string& name,
 									   const LLUUID& group_id)
-	: LLPanel(name)
+	: LLPanel(name),
+	  LLGroupMgrObserver(group_id)
 {
 	mImplementation = new impl(group_id);
 	mPendingUpdate = FALSE;
+	mObserving = FALSE;
 	mStoreSelected = LLUUID::null;
 
 	std::string panel_def_file;
@@ -367,6 +369,10 @@ LLPanelGroupInvite::LLPanelGroupInvite(const std::string& name,
 
 LLPanelGroupInvite::~LLPanelGroupInvite()
 {
+	if (mObserving)
+	{
+		LLGroupMgr::getInstance()->removeObserver(this);
+	}
 	delete mImplementation;
 }
 
@@ -489,6 +495,11 @@ void LLPanelGroupInvite::updateLists()
 
 	if (waiting) 
 	{
+		if (!mObserving)
+		{
+			LLGroupMgr::getInstance()->addObserver(this);
+			mObserving = TRUE;
+		}
 		if (!mPendingUpdate) 
 		{
 			LLGroupMgr::getInstance()->sendGroupPropertiesRequest(mImplementation->mGroupID);
@@ -499,6 +510,11 @@ void LLPanelGroupInvite::updateLists()
 	} 
 	else
 	{
+		if (mObserving)
+		{
+			LLGroupMgr::getInstance()->removeObserver(this);
+			mObserving = FALSE;
+		}
 		mPendingUpdate = FALSE;
 		if (mImplementation->mOKButton && mImplementation->mRoleNames->getItemCount()) 
 		{
@@ -34,9 +34,10 @@
 
 #include "llpanel.h"
 #include "lluuid.h"
+#include "llgroupmgr.h"
 
 class LLPanelGroupInvite
-: public LLPanel
+: public LLPanel, public LLGroupMgrObserver
 {
 public:
 	LLPanelGroupInvite(const std::string& name, const LLUUID& group_id);
@@ -50,11 +51,16 @@ public:
 
 	virtual void draw();
 	virtual BOOL postBuild();
+
+	// LLGroupMgrObserver, registered only while waiting for group data so
+	// that the data isn't released before it arrives
+	virtual void changed(LLGroupChange gc) {}
 protected:
 	class impl;
 	impl* mImplementation;
 
 	BOOL mPendingUpdate;
+	BOOL mObserving;
 	LLUUID mStoreSelected;
 	void updateLists();
 };
@@ -875,7 +875,9 @@ LLPanelGroupMembersSubTab::LLPanelGroupMembersSubTab(const std::string& name, co
 	mChanged(FALSE),
 	mPendingMemberUpdate(FALSE),
 	mHasMatch(FALSE),
-	mNumOwnerAdditions(0)
+	mNumOwnerAdditions(0),
+	mMemberProgress(0),
+	mMemberGeneration(0)
 {
 }
 
@@ -1481,7 +1483,8 @@ U64 LLPanelGroupMembersSubTab::getAgentPowersBasedOnRoleChanges(const LLUUID& ag
 		return GP_NO_POWERS;
 	}
 
-	LLGroupMemberData* member_data = gdatap->mMembers[agent_id];
+	LLGroupMgrGroupData::member_list_t::iterator mi = gdatap->mMembers.find(agent_id);
+	LLGroupMemberData* member_data = (mi != gdatap->mMembers.end()) ? mi->second : NULL;
 	if ( !member_data )
 	{
 		llwarns << "LLPanelGroupMembersSubTab::getAgentPowersBasedOnRoleChanges() -- No member data for member with UUID " << agent_id << llendl;
@@ -1602,7 +1605,8 @@ void LLPanelGroupMembersSubTab::update(LLGroupChange gc)
 		&& gdatap->isRoleDataComplete()
 		&& gdatap->isRoleMemberDataComplete())
 	{
-		mMemberProgress = gdatap->mMembers.begin();
+		mMemberProgress = 0;
+		mMemberGeneration = gdatap->mMembers.getGeneration();
 		mPendingMemberUpdate = TRUE;
 		mHasMatch = FALSE;
 	}
@@ -1653,20 +1657,32 @@ void LLPanelGroupMembersSubTab::updateMembers()
 	{
 		return;
 	}
+
+	if (mMemberGeneration != gdatap->mMembers.getGeneration())
+	{
+		// Members were removed or reordered since we started paging, so
+		// the indices we hold are stale; start again from the top.
+		mMembersList->deleteAllItems();
+		mMemberProgress = 0;
+		mMemberGeneration = gdatap->mMembers.getGeneration();
+		mHasMatch = FALSE;
+	}
 		
-	LLGroupMgrGroupData::member_list_t::iterator end = gdatap->mMembers.end();
+	S32 end = (S32)gdatap->mMembers.size();
 
 	S32 i = 0;
-	for( ; mMemberProgress != end && i<UPDATE_MEMBERS_PER_FRAME; 
+	for( ; mMemberProgress < end && i<UPDATE_MEMBERS_PER_FRAME; 
 			++mMemberProgress, ++i)
 	{
-		if (!mMemberProgress->second)
+		const LLGroupMgrGroupData::member_list_t::value_type& member =
+			gdatap->mMembers.at(mMemberProgress);
+		if (!member.second)
 			continue;
 		// Do filtering on name if it is already in the cache.
 		bool add_member = true;
 
 		std::string fullname;
-		if (gCacheName->getFullName(mMemberProgress->first, fullname))
+		if (gCacheName->getFullName(member.first, fullname))
 		{
 			if ( !matchesSearchFilter(fullname) )
 			{
@@ -1678,10 +1694,10 @@ void LLPanelGroupMembersSubTab::updateMembers()
 		{
 			// Build the donated tier string.
 			std::ostringstream donated;
-			donated << mMemberProgress->second->getContribution() << " sq. m.";
+			donated << member.second->getContribution() << " sq. m.";
 
 			LLSD row;
-			row["id"] = (*mMemberProgress).first;
+			row["id"] = member.first;
 
 			row["columns"][0]["column"] = "name";
 			// value is filled in by name list control
@@ -1690,7 +1706,7 @@ void LLPanelGroupMembersSubTab::updateMembers()
 			row["columns"][1]["value"] = donated.str();
 
 			row["columns"][2]["column"] = "online";
-			row["columns"][2]["value"] = mMemberProgress->second->getOnlineStatus();
+			row["columns"][2]["value"] = member.second->getOnlineStatus();
 			row["columns"][2]["font"] = "SANSSERIFSMALL";
 
 			mMembersList->addElement(row);//, ADD_SORTED);
@@ -1698,7 +1714,7 @@ void LLPanelGroupMembersSubTab::updateMembers()
 		}
 	}
 
-	if (mMemberProgress == end)
+	if (mMemberProgress >= end)
 	{
 		if (mHasMatch)
 		{
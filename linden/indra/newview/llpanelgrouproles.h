@@ -223,7 +223,10 @@ protected:
 	member_role_changes_map_t mMemberRoleChangeData;
 	U32 mNumOwnerAdditions;
 
-	LLGroupMgrGroupData::member_list_t::iterator mMemberProgress;
+	// Index of the next member to add, in arrival order.
+	S32 mMemberProgress;
+	// Generation of the member list mMemberProgress indexes into.
+	U32 mMemberGeneration;
 };
 
 class LLPanelGroupRolesSubTab : public LLPanelGroupSubTab
@@ -1304,13 +1304,12 @@ void LLPreviewLSL::uploadAssetLegacy(const std::string& filename,
 	std::string dst_filename = llformat("%s.lso", filepath.c_str());
 	std::string err_filename = llformat("%s.out", filepath.c_str());
 
-	const BOOL compile_to_mono = FALSE;
-	if(!lscript_compile(filename.c_str(),
-						dst_filename.c_str(),
-						err_filename.c_str(),
-						compile_to_mono,
-						asset_id.asString().c_str(),
-						gAgent.isGodlike()))
+	std::string cache_prefix = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "lslc_");
+	if(!lscript_compile_cached(filename.c_str(),
+							   dst_filename.c_str(),
+							   err_filename.c_str(),
+							   gSavedSettings.getBOOL("LSLCompileCache") ? cache_prefix.c_str() : NULL,
+							   gAgent.isGodlike()))
 	{
 		llinfos << "Compile failed!" << llendl;
 		//char command[256];
@@ -2168,13 +2167,12 @@ void LLLiveLSLEditor::uploadAssetLegacy(const std::string& filename,
 	std::string err_filename = llformat("%s.out", filepath.c_str());
 
 	LLFILE *fp;
-	const BOOL compile_to_mono = FALSE;
-	if(!lscript_compile(filename.c_str(),
-						dst_filename.c_str(),
-						err_filename.c_str(),
-						compile_to_mono,
-						asset_id.asString().c_str(),
-						gAgent.isGodlike()))
+	std::string cache_prefix = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "lslc_");
+	if(!lscript_compile_cached(filename.c_str(),
+							   dst_filename.c_str(),
+							   err_filename.c_str(),
+							   gSavedSettings.getBOOL("LSLCompileCache") ? cache_prefix.c_str() : NULL,
+							   gAgent.isGodlike()))
 	{
 		// load the error file into the error scrolllist
 		llinfos << "Compile failed!" << llendl;
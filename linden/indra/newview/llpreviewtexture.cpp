@@ -194,6 +194,9 @@ LLPreviewTexture::~LLPreviewTexture()
 
 void LLPreviewTexture::init()
 {	
+	// the image streams in with nothing to invalidate us
+	setDrawsLive(TRUE);
+
 	if (mCopyToInv) 
 	{
 		LLUICtrlFactory::getInstance()->buildFloater(this,"floater_preview_embedded_texture.xml");
@@ -48,6 +48,7 @@
 #include "llrender.h"
 #include "lloctree.h"
 #include "llvoavatar.h"
+#include "lltaskscheduler.h"
 
 const F32 SG_OCCLUSION_FUDGE = 0.25f;
 #define SG_DISCARD_TOLERANCE 0.01f
@@ -87,6 +88,7 @@ protected:
 static LLOcclusionQueryPool sQueryPool;
 
 BOOL LLSpatialPartition::sFreezeState = FALSE;
+U32 LLSpatialPartition::sCullPass = 0;
 
 //static counter for frame to switch LOD on
 
@@ -968,6 +970,10 @@ LLSpatialGroup::LLSpatialGroup(OctreeNode* node, LLSpatialPartition* part) :
 
 	mRadius = 1;
 	mPixelArea = 1024.f;
+
+	mCullRes[0] = mCullRes[1] = -1;
+	mCullPass = 0;
+	mGeometryJob = 0;
 }
 
 void LLSpatialGroup::updateDistance(LLCamera &camera)
@@ -1160,6 +1166,8 @@ void LLSpatialGroup::destroyGL()
 	mLastUpdateTime = gFrameTimeSeconds;
 	mVertexBuffer = NULL;
 	mBufferMap.clear();
+	mGeometryJob++;
+	clearState(LLSpatialGroup::GEOM_PENDING);
 
 	clearDrawMap();
 
@@ -1353,6 +1361,9 @@ LLSpatialPartition::LLSpatialPartition(U32 data_mask, U32 buffer_usage)
 	mSlopRatio = 0.25f;
 	mRenderByGroup = TRUE;
 	mInfiniteFarClip = FALSE;
+	mPrecullPass = 0;
+	mPrecullTime = 0.f;
+	mCullTime = 0.f;
 
 	LLGLNamePool::registerPool(&sQueryPool);
 
@@ -1480,8 +1491,8 @@ void LLSpatialPartition::shift(const LLVector3 &offset)
 class LLOctreeCull : public LLSpatialGroup::OctreeTraveler
 {
 public:
-	LLOctreeCull(LLCamera* camera)
-		: mCamera(camera), mRes(0) { }
+	LLOctreeCull(LLCamera* camera, U32 precull_pass = 0)
+		: mCamera(camera), mRes(0), mPrecullPass(precull_pass) { }
 
 	virtual bool earlyFail(LLSpatialGroup* group)
 	{
@@ -1492,8 +1503,20 @@ public:
 			group->isState(LLSpatialGroup::OCCLUDED))
 		{
 			gPipeline.markOccluder(group);
+			gPipeline.mQueryOcclusionCulled++;
 			return true;
 		}
+
+		if (group->mOctreeNode->getParent() &&
+			group->mSpatialPartition->isOcclusionEnabled() &&
+			!group->mSpatialPartition->isBridge()) //bridge groups are in object space
+		{
+			LLVector3 size = group->mBounds[1] + LLVector3(SG_OCCLUSION_FUDGE, SG_OCCLUSION_FUDGE, SG_OCCLUSION_FUDGE);
+			if (gPipeline.isSoftwareOccluded(group->mBounds[0], size))
+			{
+				return true;
+			}
+		}
 		
 		return false;
 	}
@@ -1514,7 +1537,7 @@ public:
 		}
 		else
 		{
-			mRes = frustumCheck(group);
+			mRes = cachedFrustumCheck(group);
 				
 			if (mRes)
 			{ //at least partially in, run on down
@@ -1525,6 +1548,25 @@ public:
 		}
 	}
 	
+	// Use the result worked out by the precull if there is one
+	S32 cachedFrustumCheck(const LLSpatialGroup* group)
+	{
+		if (mPrecullPass && group->mCullPass == mPrecullPass && group->mCullRes[0] >= 0)
+		{
+			return group->mCullRes[0];
+		}
+		return frustumCheck(group);
+	}
+
+	S32 cachedFrustumCheckObjects(const LLSpatialGroup* group)
+	{
+		if (mPrecullPass && group->mCullPass == mPrecullPass && group->mCullRes[1] >= 0)
+		{
+			return group->mCullRes[1];
+		}
+		return frustumCheckObjects(group);
+	}
+
 	virtual S32 frustumCheck(const LLSpatialGroup* group)
 	{
 		S32 res = mCamera->AABBInFrustumNoFarClip(group->mBounds[0], group->mBounds[1]);
@@ -1555,7 +1597,7 @@ public:
 		{
 			return true;
 		}
-		else if (mRes == 1 && !frustumCheckObjects(group)) //no objects in frustum
+		else if (mRes == 1 && !cachedFrustumCheckObjects(group)) //no objects in frustum
 		{
 			return false;
 		}
@@ -1592,13 +1634,14 @@ public:
 
 	LLCamera *mCamera;
 	S32 mRes;
+	U32 mPrecullPass;
 };
 
 class LLOctreeCullNoFarClip : public LLOctreeCull
 {
 public: 
-	LLOctreeCullNoFarClip(LLCamera* camera) 
-		: LLOctreeCull(camera) { }
+	LLOctreeCullNoFarClip(LLCamera* camera, U32 precull_pass = 0) 
+		: LLOctreeCull(camera, precull_pass) { }
 
 	virtual S32 frustumCheck(const LLSpatialGroup* group)
 	{
@@ -1615,8 +1658,8 @@ public:
 class LLOctreeCullShadow : public LLOctreeCull
 {
 public:
-	LLOctreeCullShadow(LLCamera* camera)
-		: LLOctreeCull(camera) { }
+	LLOctreeCullShadow(LLCamera* camera, U32 precull_pass = 0)
+		: LLOctreeCull(camera, precull_pass) { }
 
 	virtual S32 frustumCheck(const LLSpatialGroup* group)
 	{
@@ -1867,9 +1910,20 @@ BOOL LLSpatialPartition::visibleObjectsInFrustum(LLCamera& camera)
 S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* results, BOOL for_select)
 {
 	LLMemType mt(LLMemType::MTYPE_SPACE_PARTITION);
+	LLTimer cull_timer;
+
+	// The precull already rebounded the octree and ran the frustum tests
+	U32 pass = for_select ? 0 : mPrecullPass;
+	mPrecullPass = 0;
+	if (!pass)
+	{
+		mPrecullTime = 0.f;
+	}
+
 #if LL_OCTREE_PARANOIA_CHECK
 	((LLSpatialGroup*)mOctree->getListener(0))->checkStates();
 #endif
+	if (!pass)
 	{
 		BOOL temp = sFreezeState;
 		sFreezeState = FALSE;
@@ -1892,25 +1946,235 @@ S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* result
 	else if (LLPipeline::sShadowRender)
 	{
 		LLFastTimer ftm(LLFastTimer::FTM_FRUSTUM_CULL);
-		LLOctreeCullShadow culler(&camera);
+		LLOctreeCullShadow culler(&camera, pass);
 		culler.traverse(mOctree);
 	}
 	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
 	{
 		LLFastTimer ftm(LLFastTimer::FTM_FRUSTUM_CULL);		
-		LLOctreeCullNoFarClip culler(&camera);
+		LLOctreeCullNoFarClip culler(&camera, pass);
 		culler.traverse(mOctree);
 	}
 	else
 	{
 		LLFastTimer ftm(LLFastTimer::FTM_FRUSTUM_CULL);		
-		LLOctreeCull culler(&camera);
+		LLOctreeCull culler(&camera, pass);
 		culler.traverse(mOctree);
 	}
 	
+	mCullTime = cull_timer.getElapsedTimeF32();
 	return 0;
 }
 
+//============================================================================
+// Parallel precull
+//
+// Fills in LLSpatialGroup::mCullRes for the groups the next cull() is likely
+// to test, using the same culler class cull() will pick.  Workers only read
+// octree bounds and state until precull() returns, and cull() falls back
+// to testing a group itself on a miss, so the cull result never changes.
+// Workers only ever help: the main thread works through the branches itself
+// and never blocks on a worker that is busy with something else.
+
+static LLOctreeCull* create_precull_culler(LLSpatialPartition* part, LLCamera* camera)
+{
+	if (LLPipeline::sShadowRender)
+	{
+		return new LLOctreeCullShadow(camera);
+	}
+	else if (part->mInfiniteFarClip || !LLPipeline::sUseFarClip)
+	{
+		return new LLOctreeCullNoFarClip(camera);
+	}
+	return new LLOctreeCull(camera);
+}
+
+// Tests one group, returns TRUE if its children may need testing too
+static BOOL precull_group(LLOctreeCull* culler, const LLSpatialGroup::OctreeNode* node, U32 pass)
+{
+	LLSpatialGroup* group = (LLSpatialGroup*) node->getListener(0);
+
+	if (node->getParent() &&
+		LLPipeline::sUseOcclusion &&
+		group->isState(LLSpatialGroup::OCCLUDED))
+	{ //the cull will most likely skip this branch
+		return FALSE;
+	}
+
+	S32 res = culler->frustumCheck(group);
+	group->mCullRes[0] = res;
+	group->mCullRes[1] = -1;
+	if (res == 1 && node->getChildCount() > 0 && node->getElementCount() > 0)
+	{
+		group->mCullRes[1] = culler->frustumCheckObjects(group);
+	}
+	group->mCullPass = pass;
+
+	// fully outside groups aren't entered, fully inside ones skip their children's tests
+	return res == 1;
+}
+
+static void precull_branch(LLOctreeCull* culler, const LLSpatialGroup::OctreeNode* node, U32 pass)
+{
+	if (precull_group(culler, node, pass))
+	{
+		for (U32 i = 0; i < node->getChildCount(); i++)
+		{
+			precull_branch(culler, node->getChild(i), pass);
+		}
+	}
+}
+
+// One frame's precull, shared by the main thread and the workers helping it.
+// Whoever gets to it first claims the next branch, so the main thread never
+// waits for a worker to become free; it only waits for branches a worker has
+// already started, which is bounded by the cost of one branch.
+class LLSpatialPrecullJob : public LLThreadSafeRefCount
+{
+public:
+	LLSpatialPrecullJob(U32 pass) : mPass(pass), mCount(0), mNext(0), mActive(0) { }
+
+	void addBranch(LLOctreeCull* culler, const LLSpatialGroup::OctreeNode* node, S32 part)
+	{
+		mCullers.push_back(culler);
+		mNodes.push_back(node);
+		mParts.push_back(part);
+		mTimes.push_back(0.f);
+		mCount = (U32) mNodes.size();
+	}
+
+	// MAIN THREAD OR WORKER, runs branches until none are left unclaimed
+	void work()
+	{
+		while (1)
+		{
+			// announce ourselves before claiming, so finish() can't miss us
+			mActive++;
+			U32 index = mNext++;
+			if (index >= mCount)
+			{
+				mActive -= 1;
+				return;
+			}
+			LLTimer timer;
+			precull_branch(mCullers[index], mNodes[index], mPass);
+			mTimes[index] = timer.getElapsedTimeF32();
+			mActive -= 1;
+		}
+	}
+
+	// MAIN THREAD, helps until every branch is claimed, then waits for
+	// the ones still running
+	void finish()
+	{
+		work();
+		while (mActive > 0)
+		{
+			LLThread::yield();
+		}
+	}
+
+	U32 mPass;
+	U32 mCount;
+	std::vector<LLOctreeCull*> mCullers;
+	std::vector<const LLSpatialGroup::OctreeNode*> mNodes;
+	std::vector<S32> mParts;
+	std::vector<F32> mTimes;
+
+private:
+	LLAtomicU32 mNext;
+	LLAtomicU32 mActive;
+};
+
+class LLSpatialPrecullTask : public LLTaskScheduler::Task
+{
+public:
+	LLSpatialPrecullTask(LLSpatialPrecullJob* job) : mJob(job) { }
+
+	// A helper that starts after the frame has moved on finds nothing left
+	// to claim, and only touches the job it holds a reference to.
+	/*virtual*/ void run()
+	{
+		mJob->work();
+	}
+
+private:
+	LLPointer<LLSpatialPrecullJob> mJob;
+};
+
+//static
+void LLSpatialPartition::precull(const std::vector<LLSpatialPartition*>& parts, const std::vector<LLCamera*>& cameras)
+{
+	LLTaskScheduler* scheduler = LLTaskScheduler::getInstance();
+	if (!scheduler || parts.empty())
+	{
+		return;
+	}
+
+	U32 pass = ++sCullPass;
+	if (!pass)
+	{ //0 means no precull
+		pass = ++sCullPass;
+	}
+
+	std::vector<LLOctreeCull*> cullers(parts.size(), (LLOctreeCull*) NULL);
+	LLPointer<LLSpatialPrecullJob> job = new LLSpatialPrecullJob(pass);
+
+	for (U32 i = 0; i < parts.size(); i++)
+	{
+		LLSpatialPartition* part = parts[i];
+
+		{ //rebound on the main thread, exactly as cull() would
+			BOOL temp = sFreezeState;
+			sFreezeState = FALSE;
+			LLFastTimer ftm(LLFastTimer::FTM_CULL_REBOUND);
+			LLSpatialGroup* group = (LLSpatialGroup*) part->mOctree->getListener(0);
+			group->rebound();
+			sFreezeState = temp;
+		}
+
+		part->mPrecullPass = pass;
+		part->mPrecullTime = 0.f;
+		cullers[i] = create_precull_culler(part, cameras[i]);
+
+		// test the top two levels here and share out the grandchildren,
+		// which keeps any one branch small
+		const LLSpatialGroup::OctreeNode* root = part->mOctree;
+		if (precull_group(cullers[i], root, pass))
+		{
+			for (U32 j = 0; j < root->getChildCount(); j++)
+			{
+				const LLSpatialGroup::OctreeNode* child = root->getChild(j);
+				if (precull_group(cullers[i], child, pass))
+				{
+					for (U32 k = 0; k < child->getChildCount(); k++)
+					{
+						job->addBranch(cullers[i], child->getChild(k), i);
+					}
+				}
+			}
+		}
+	}
+
+	U32 helpers = llmin(scheduler->getNumWorkers(), job->mCount);
+	for (U32 i = 0; i < helpers; i++)
+	{
+		scheduler->schedule(new LLSpatialPrecullTask(job), LLTaskScheduler::LANE_URGENT);
+	}
+
+	job->finish();
+
+	for (U32 i = 0; i < job->mCount; i++)
+	{
+		parts[job->mParts[i]]->mPrecullTime += job->mTimes[i];
+	}
+
+	for (U32 i = 0; i < cullers.size(); i++)
+	{
+		delete cullers[i];
+	}
+}
+
 BOOL earlyFail(LLCamera* camera, LLSpatialGroup* group)
 {
 	const F32 vel = SG_OCCLUSION_FUDGE*2.f;
@@ -2930,6 +3194,25 @@ LLDrawInfo::LLDrawInfo(U16 start, U16 end, U32 count, U32 offset,
 	}
 }
 
+BOOL LLDrawInfo::canMerge(const LLDrawInfo& next) const
+{
+	return mVertexBuffer.get() == next.mVertexBuffer.get() &&
+		next.mOffset == mOffset + mCount &&
+		mTexture.get() == next.mTexture.get() &&
+		mTextureMatrix == next.mTextureMatrix &&
+		mModelMatrix == next.mModelMatrix &&
+		mGlowColor == next.mGlowColor &&
+		mFullbright == next.mFullbright &&
+		mBump == next.mBump &&
+		!mParticle && !next.mParticle &&
+		mGroup == next.mGroup &&
+#if LL_DARWIN
+		(U32) (llmax(mEnd, next.mEnd) - llmin(mStart, next.mStart)) <= (U32) gGLManager.mGLMaxVertexRange &&
+		mCount + next.mCount <= (U32) gGLManager.mGLMaxIndexRange &&
+#endif
+		mFace == NULL && next.mFace == NULL;
+}
+
 LLDrawInfo::~LLDrawInfo()	
 {
 	if (LLSpatialGroup::sNoDelete)
@@ -2950,6 +3233,7 @@ LLVertexBuffer* LLGeometryManager::createVertexBuffer(U32 type_mask, U32 usage)
 
 LLCullResult::LLCullResult() 
 {
+	mMergedDrawInfoSize = 0;
 	clear();
 }
 
@@ -2970,6 +3254,14 @@ void LLCullResult::clear()
 		}
 		mRenderMapSize[i] = 0;
 	}
+
+	for (U32 i = 0; i < mMergedDrawInfoSize; i++)
+	{ //don't hold on to buffers and textures until the next merge
+		mMergedDrawInfo[i]->mVertexBuffer = NULL;
+		mMergedDrawInfo[i]->mTexture = NULL;
+		mMergedDrawInfo[i]->mGroup = NULL;
+	}
+	mMergedDrawInfoSize = 0;
 }
 
 LLCullResult::sg_list_t::iterator LLCullResult::beginVisibleGroups()
@@ -3134,6 +3426,86 @@ void LLCullResult::pushDrawInfo(U32 type, LLDrawInfo* draw_info)
 }
 
 
+U32 LLCullResult::mergeRenderMap(U32 type)
+{
+	drawinfo_list_t& render_map = mRenderMap[type];
+	U32 size = mRenderMapSize[type];
+	U32 out = 0;
+	U32 i = 0;
+
+	while (i < size)
+	{
+		LLDrawInfo* first = render_map[i];
+		U32 run_end = i+1;
+		while (run_end < size && render_map[run_end-1]->canMerge(*render_map[run_end]))
+		{
+			++run_end;
+		}
+
+		if (run_end - i == 1)
+		{
+			render_map[out++] = first;
+			++i;
+			continue;
+		}
+
+		LLDrawInfo* merged;
+		if (mMergedDrawInfoSize < mMergedDrawInfo.size())
+		{
+			merged = mMergedDrawInfo[mMergedDrawInfoSize];
+			merged->mVertexBuffer = first->mVertexBuffer;
+			merged->mTexture = first->mTexture;
+		}
+		else
+		{
+			merged = new LLDrawInfo(first->mStart, first->mEnd, first->mCount, first->mOffset,
+									first->mTexture, first->mVertexBuffer);
+			mMergedDrawInfo.push_back(merged);
+		}
+		++mMergedDrawInfoSize;
+
+		merged->mGlowColor = first->mGlowColor;
+		merged->mTextureMatrix = first->mTextureMatrix;
+		merged->mModelMatrix = first->mModelMatrix;
+		merged->mFullbright = first->mFullbright;
+		merged->mBump = first->mBump;
+		merged->mParticle = first->mParticle;
+		merged->mPartSize = first->mPartSize;
+		merged->mGroup = first->mGroup;
+		merged->mFace = NULL;
+		merged->mDistance = first->mDistance;
+		merged->mStart = first->mStart;
+		merged->mEnd = first->mEnd;
+		merged->mOffset = first->mOffset;
+		merged->mCount = 0;
+		merged->mVSize = 0.f;
+		merged->mExtents[0] = first->mExtents[0];
+		merged->mExtents[1] = first->mExtents[1];
+
+		for (U32 j = i; j < run_end; j++)
+		{
+			LLDrawInfo* params = render_map[j];
+			merged->mStart = llmin(merged->mStart, params->mStart);
+			merged->mEnd = llmax(merged->mEnd, params->mEnd);
+			merged->mCount += params->mCount;
+			merged->mVSize = llmax(merged->mVSize, params->mVSize);
+			update_min_max(merged->mExtents[0], merged->mExtents[1], params->mExtents[0]);
+			update_min_max(merged->mExtents[0], merged->mExtents[1], params->mExtents[1]);
+		}
+
+		render_map[out++] = merged;
+		i = run_end;
+	}
+
+	for (U32 j = out; j < size; j++)
+	{
+		render_map[j] = NULL;
+	}
+	mRenderMapSize[type] = out;
+
+	return size - out;
+}
+
 void LLCullResult::assertDrawMapsEmpty()
 {
 	for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; i++)
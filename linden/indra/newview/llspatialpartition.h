@@ -129,6 +129,49 @@ public:
 
 	};
 
+	struct CompareTextureMatrixBuffer
+	{ //sort by texture and model matrix, then by vertex buffer and index offset so contiguous draws line up
+		bool operator()(const LLDrawInfo* lhs, const LLDrawInfo* rhs) const
+		{
+			if (lhs == rhs || !rhs)
+			{
+				return false;
+			}
+			if (!lhs)
+			{
+				return true;
+			}
+			if (lhs->mTexture.get() != rhs->mTexture.get())
+			{
+				return lhs->mTexture.get() > rhs->mTexture.get();
+			}
+			if (lhs->mModelMatrix != rhs->mModelMatrix)
+			{
+				return lhs->mModelMatrix > rhs->mModelMatrix;
+			}
+			if (lhs->mVertexBuffer.get() != rhs->mVertexBuffer.get())
+			{
+				return lhs->mVertexBuffer.get() > rhs->mVertexBuffer.get();
+			}
+			return lhs->mOffset < rhs->mOffset;
+		}
+	};
+
+	struct CompareBumpTextureBuffer
+	{ //sort by mBump value, then as CompareTextureMatrixBuffer
+		bool operator()(const LLDrawInfo* lhs, const LLDrawInfo* rhs) const
+		{
+			if (lhs && rhs && lhs->mBump != rhs->mBump)
+			{
+				return lhs->mBump > rhs->mBump;
+			}
+			return CompareTextureMatrixBuffer()(lhs, rhs);
+		}
+	};
+
+	// TRUE if next can be drawn in the same call as this one
+	BOOL canMerge(const LLDrawInfo& next) const;
+
 	struct CompareBump
 	{
 		bool operator()(const LLPointer<LLDrawInfo>& lhs, const LLPointer<LLDrawInfo>& rhs) 
@@ -209,6 +252,7 @@ public:
 		IMAGE_DIRTY				= 0x00004000,
 		OCCLUSION_DIRTY			= 0x00008000,
 		MESH_DIRTY				= 0x00010000,
+		GEOM_PENDING			= 0x00020000, //new vertex data is being filled on a worker thread
 	} eSpatialState;
 
 	typedef enum
@@ -295,6 +339,7 @@ public:
 
 	U32 mBufferUsage;
 	draw_map_t mDrawMap;
+	U32 mGeometryJob;	//id of the latest async vertex data fill, bumped to drop pending ones
 	
 	S32 mVisible;
 	F32 mDistance;
@@ -307,6 +352,11 @@ public:
 	
 	F32 mPixelArea;
 	F32 mRadius;
+
+	// Frustum test results filled in ahead of the cull by worker threads,
+	// valid while mCullPass matches the cull pass (-1 = not computed)
+	S32 mCullRes[2];
+	U32 mCullPass;
 };
 
 class LLGeometryManager
@@ -355,6 +405,12 @@ public:
 
 	BOOL visibleObjectsInFrustum(LLCamera& camera);
 	S32 cull(LLCamera &camera, std::vector<LLDrawable *>* results = NULL, BOOL for_select = FALSE); // Cull on arbitrary frustum
+
+	// Run the frustum tests for the next cull() of each partition, with idle
+	// workers of the shared pool helping the main thread.  cameras[i] must be set up exactly as the camera
+	// parts[i] will be culled with.  The cull itself stays on the main thread,
+	// so the results are the same as without the precull.
+	static void precull(const std::vector<LLSpatialPartition*>& parts, const std::vector<LLCamera*>& cameras);
 	
 	BOOL isVisible(const LLVector3& v);
 	
@@ -381,6 +437,13 @@ public:
 	BOOL mDepthMask; //if TRUE, objects in this partition will be written to depth during alpha rendering
 	U32 mDrawableType;
 	U32 mPartitionType;
+
+	U32 mPrecullPass;	//cull pass the group frustum results were filled in for, cleared by cull()
+	F32 mPrecullTime;	//main thread and worker time spent on the last precull, in seconds
+	F32 mCullTime;		//main thread time spent in the last cull, in seconds
+
+protected:
+	static U32 sCullPass;
 };
 
 // class for creating bridges between spatial partitions
@@ -463,6 +526,11 @@ public:
 
 	void assertDrawMapsEmpty();
 
+	// Fold runs of draw info that share all render state and continue each
+	// other's index range into one draw info each.  The render map must be
+	// sorted so these runs are adjacent.  Returns how many draw calls were saved.
+	U32 mergeRenderMap(U32 type);
+
 private:
 	U32					mVisibleGroupsSize;
 	U32					mAlphaGroupsSize;
@@ -479,6 +547,11 @@ private:
 	drawable_list_t		mVisibleList;
 	bridge_list_t		mVisibleBridge;
 	drawinfo_list_t		mRenderMap[LLRenderPass::NUM_RENDER_TYPES];
+
+	// draw info made by mergeRenderMap, reused from frame to frame since
+	// draw info may not be deleted while rendering
+	std::vector<LLPointer<LLDrawInfo> > mMergedDrawInfo;
+	U32					mMergedDrawInfoSize;
 };
 
 
@@ -553,6 +626,16 @@ public:
 	void genDrawInfo(LLSpatialGroup* group, U32 mask, std::vector<LLFace*>& faces, BOOL distance_sort = FALSE);
 	void registerFace(LLSpatialGroup* group, LLFace* facep, U32 type);
 
+	// Fill any vertex data no worker has started on yet, wait for the rest
+	// and swap the finished buffers into their groups.  Must run before anything can
+	// change the volumes being read, and before vertex buffers are reset.
+	static void finishAsyncGeometry();
+
+protected:
+	// Queue the vertex data fill for the faces just laid out in draw_map and
+	// buffer_map; the group keeps drawing its current buffers until then.
+	void scheduleAsyncGeometry(LLSpatialGroup* group, std::vector<LLFace*>* face_lists[], U32 list_count,
+							   LLSpatialGroup::draw_map_t& draw_map, LLSpatialGroup::buffer_map_t& buffer_map);
 };
 
 //spatial partition that uses volume geometry manager (implemented in LLVOVolume.cpp)
@@ -80,6 +80,7 @@
 
 #include "llagent.h"
 #include "llagentpilot.h"
+#include "llviewerbenchmark.h"
 #include "llfloateravatarpicker.h"
 #include "llcallbacklist.h"
 #include "llcallingcard.h"
@@ -269,9 +270,14 @@ void callback_cache_name(const LLUUID& id, const std::string& firstname, const s
 	LLNameListCtrl::refreshAll(id, firstname, lastname, is_group);
 	LLNameBox::refreshAll(id, firstname, lastname, is_group);
 	LLNameEditor::refreshAll(id, firstname, lastname, is_group);
-	
+}
+
+void callback_cache_names_batch(const std::vector<LLUUID>& ids)
+{
+	LLNameListCtrl::flushRefreshAll();
+
 	// TODO: Actually be intelligent about the refresh.
-	// For now, just brute force refresh the dialogs.
+	// For now, just brute force refresh the dialogs, once per batch.
 	dialog_refresh_all();
 }
 
@@ -1967,6 +1973,7 @@ bool idle_startup()
 		{
 			gCacheName = new LLCacheName(gMessageSystem);
 			gCacheName->addObserver(callback_cache_name);
+			gCacheName->addBatchObserver(callback_cache_names_batch);
 	
 			// Load stored cache if possible
             LLAppViewer::instance()->loadNameCache();
@@ -2766,6 +2773,13 @@ bool idle_startup()
 			gAgentPilot.startPlayback();
 		}
 
+		// Start the camera path benchmark if the flag is set.
+		if (gSavedSettings.getBOOL("BenchmarkAutoRun"))
+		{
+			LL_DEBUGS("AppInit") << "Starting automatic benchmark" << LL_ENDL;
+			gViewerBenchmark.startBenchmark(TRUE);
+		}
+
 		// If we've got a startup URL, dispatch it
 		LLStartUp::dispatchURL();
 
@@ -48,6 +48,9 @@ LLStatBar::LLStatBar(const std::string& name, const LLRect& rect, const std::str
 	:	LLView(name, rect, TRUE),
 		mSetting(setting)
 {
+	// stats are sampled in draw()
+	setDrawsLive(TRUE);
+
 	mMinBar = 0.f;
 	mMaxBar = 50.f;
 	mStatp = NULL;
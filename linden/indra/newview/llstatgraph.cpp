@@ -47,6 +47,9 @@
 LLStatGraph::LLStatGraph(const std::string& name, const LLRect& rect)
 		:	LLView(name, rect, TRUE)
 {
+	// stats are sampled in draw()
+	setDrawsLive(TRUE);
+
 	mStatp = NULL;
 	setToolTip(name);
 	mNumThresholds = 3;
@@ -941,6 +941,9 @@ LLTextureCtrl::LLTextureCtrl(
 	mDirty( FALSE ),
 	mShowLoadingPlaceholder( TRUE )
 {
+	// the image streams in with nothing to invalidate us
+	setDrawsLive(TRUE);
+
 	mCaption = new LLTextBox( label, 
 		LLRect( 0, BTN_HEIGHT_SMALL, getRect().getWidth(), 0 ),
 		label,
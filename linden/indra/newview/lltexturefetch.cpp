@@ -1364,7 +1364,7 @@ bool LLTextureFetchWorker::writeToCacheComplete()
 // public
 
 LLTextureFetch::LLTextureFetch(LLTextureCache* cache, LLImageDecodeThread* imagedecodethread, bool threaded)
-	: LLWorkerThread("TextureFetch", threaded),
+	: LLWorkerThread("TextureFetch", threaded, true), // curl must stay on one thread
 	  mDebugCount(0),
 	  mDebugPause(FALSE),
 	  mPacketCount(0),
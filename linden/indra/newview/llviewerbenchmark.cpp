@@ -0,0 +1,379 @@
+/** 
+ * @file llviewerbenchmark.cpp
+ * @brief LLViewerBenchmark class implementation
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include <iomanip>
+
+#include "llviewerbenchmark.h"
+#include "llagent.h"
+#include "llappviewer.h"
+#include "llfasttimerview.h"
+#include "llviewercontrol.h"
+
+LLViewerBenchmark gViewerBenchmark;
+
+// seconds of wall clock between recorded camera keys
+static const F32 BENCHMARK_RECORD_INTERVAL = 0.25f;
+
+LLViewerBenchmark::LLViewerBenchmark() :
+	mRecording(FALSE),
+	mLastRecordTime(0.f),
+	mPlaying(FALSE),
+	mQuitWhenDone(FALSE),
+	mPathTime(0.0),
+	mFrameStep(1.0 / 30.0),
+	mFrame(0),
+	mFramePending(FALSE),
+	mPendingTime(0.0),
+	mLog(NULL)
+{
+}
+
+LLViewerBenchmark::~LLViewerBenchmark()
+{
+	closeLog();
+}
+
+void LLViewerBenchmark::load(const std::string& filename)
+{
+	mKeys.clear();
+
+	if (filename.empty())
+	{
+		return;
+	}
+
+	llifstream file(filename);
+	if (!file)
+	{
+		llwarns << "Couldn't open benchmark camera path " << filename << llendl;
+		return;
+	}
+
+	S32 num_keys = 0;
+	file >> num_keys;
+
+	for (S32 i = 0; i < num_keys && file.good(); i++)
+	{
+		Key key;
+		file >> key.mTime;
+		file >> key.mCameraPos.mdV[VX] >> key.mCameraPos.mdV[VY] >> key.mCameraPos.mdV[VZ];
+		file >> key.mFocusPos.mdV[VX] >> key.mFocusPos.mdV[VY] >> key.mFocusPos.mdV[VZ];
+		if (file.fail())
+		{
+			llwarns << "Truncated benchmark camera path " << filename << " at key " << i << llendl;
+			break;
+		}
+		if (!mKeys.empty() && key.mTime < mKeys.back().mTime)
+		{
+			llwarns << "Benchmark camera path " << filename << " goes back in time at key " << i << llendl;
+			break;
+		}
+		mKeys.push_back(key);
+	}
+
+	file.close();
+
+	llinfos << "Loaded " << mKeys.size() << " benchmark camera keys from " << filename << llendl;
+}
+
+void LLViewerBenchmark::save(const std::string& filename)
+{
+	llofstream file;
+	file.open(filename);
+
+	if (!file)
+	{
+		llwarns << "Couldn't open " << filename << ", aborting benchmark camera path save!" << llendl;
+		return;
+	}
+
+	file << mKeys.size() << '\n';
+
+	for (U32 i = 0; i < mKeys.size(); i++)
+	{
+		const Key& key = mKeys[i];
+		file << std::setprecision(6) << key.mTime << "\t";
+		file << std::setprecision(32) << key.mCameraPos.mdV[VX] << "\t" << key.mCameraPos.mdV[VY] << "\t" << key.mCameraPos.mdV[VZ] << "\t";
+		file << key.mFocusPos.mdV[VX] << "\t" << key.mFocusPos.mdV[VY] << "\t" << key.mFocusPos.mdV[VZ] << '\n';
+	}
+
+	file.close();
+}
+
+void LLViewerBenchmark::startRecord()
+{
+	stopBenchmark();
+
+	mKeys.clear();
+	mTimer.reset();
+	mRecording = TRUE;
+	addKey();
+}
+
+void LLViewerBenchmark::stopRecord()
+{
+	if (!mRecording)
+	{
+		return;
+	}
+
+	addKey();
+	mRecording = FALSE;
+	save(gSavedSettings.getString("BenchmarkCameraPath"));
+}
+
+void LLViewerBenchmark::addKey()
+{
+	Key key;
+	key.mTime = mTimer.getElapsedTimeF32();
+	key.mCameraPos = gAgent.getCameraPositionGlobal();
+	key.mFocusPos = gAgent.getFocusGlobal();
+	mLastRecordTime = (F32)key.mTime;
+	mKeys.push_back(key);
+}
+
+void LLViewerBenchmark::startBenchmark(BOOL quit_when_done)
+{
+	if (mPlaying)
+	{
+		return;
+	}
+
+	if (mRecording)
+	{
+		stopRecord();
+	}
+
+	load(gSavedSettings.getString("BenchmarkCameraPath"));
+	if (mKeys.empty())
+	{
+		llwarns << "No benchmark camera path, cancelling benchmark!" << llendl;
+		if (quit_when_done)
+		{
+			LLAppViewer::instance()->forceQuit();
+		}
+		return;
+	}
+
+	mFrameStep = llmax(gSavedSettings.getF32("BenchmarkFrameStep"), 0.001f);
+	mQuitWhenDone = quit_when_done;
+	mPathTime = mKeys.front().mTime;
+	mFrame = 0;
+	mFramePending = FALSE;
+
+	openLog();
+
+	// detach the camera from the avatar so the path owns it
+	gAgent.setFocusOnAvatar(FALSE, FALSE);
+	mPlaying = TRUE;
+
+	llinfos << "Starting benchmark over " << mKeys.back().mTime - mKeys.front().mTime
+			<< " seconds of camera path at " << mFrameStep << " seconds per frame" << llendl;
+}
+
+void LLViewerBenchmark::stopBenchmark()
+{
+	if (!mPlaying)
+	{
+		return;
+	}
+
+	mPlaying = FALSE;
+	if (!mFramePending)
+	{
+		finishBenchmark();
+	}
+	// otherwise logFrame() writes the frame in flight, then finishes
+}
+
+void LLViewerBenchmark::finishBenchmark()
+{
+	closeLog();
+
+	llinfos << "Benchmark finished after " << mFrame << " frames" << llendl;
+
+	if (mQuitWhenDone)
+	{
+		llinfos << "Benchmark done, quitting viewer!" << llendl;
+		LLAppViewer::instance()->forceQuit();
+	}
+}
+
+void LLViewerBenchmark::updateCamera()
+{
+	if (mRecording)
+	{
+		if (mTimer.getElapsedTimeF32() - mLastRecordTime > BENCHMARK_RECORD_INTERVAL)
+		{
+			addKey();
+		}
+		return;
+	}
+
+	if (!mPlaying)
+	{
+		return;
+	}
+
+	if (mPathTime > mKeys.back().mTime)
+	{
+		stopBenchmark();
+		return;
+	}
+
+	// find the key segment containing the current path time
+	U32 next = 1;
+	while (next < mKeys.size() && mKeys[next].mTime < mPathTime)
+	{
+		next++;
+	}
+
+	LLVector3d camera_pos;
+	LLVector3d focus_pos;
+	if (next >= mKeys.size())
+	{
+		camera_pos = mKeys.back().mCameraPos;
+		focus_pos = mKeys.back().mFocusPos;
+	}
+	else
+	{
+		const Key& a = mKeys[next - 1];
+		const Key& b = mKeys[next];
+		F64 span = b.mTime - a.mTime;
+		F64 u = span > 0.0 ? llclamp((mPathTime - a.mTime) / span, 0.0, 1.0) : 1.0;
+		camera_pos = lerp(a.mCameraPos, b.mCameraPos, u);
+		focus_pos = lerp(a.mFocusPos, b.mFocusPos, u);
+	}
+
+	gAgent.setCameraPosAndFocusGlobal(camera_pos, focus_pos, LLUUID::null);
+	// snap instead of easing, easing runs on wall clock
+	gAgent.setCameraAnimating(FALSE);
+
+	mFramePending = TRUE;
+	mPendingTime = mPathTime;
+	mPathTime += mFrameStep;
+}
+
+void LLViewerBenchmark::logFrame()
+{
+	if (!mFramePending)
+	{
+		return;
+	}
+	mFramePending = FALSE;
+
+	if (mLog)
+	{
+		// Read the counters themselves rather than the history, which
+		// doesn't advance while the fast timer view is paused.
+		const U64* counts = LLFastTimer::sCounter;
+		const F64 ms_per_count = 1000.0 / (F64)LLFastTimer::countsPerSecond();
+
+		*mLog << mFrame << "," << std::fixed << std::setprecision(4) << mPendingTime;
+		for (U32 i = 0; i < mTimers.size(); i++)
+		{
+			*mLog << "," << std::setprecision(3) << (F64)counts[mTimers[i].first] * ms_per_count;
+		}
+		*mLog << '\n';
+
+		mFrame++;
+	}
+
+	if (!mPlaying)
+	{
+		// stopBenchmark() was waiting for this frame
+		finishBenchmark();
+	}
+}
+
+void LLViewerBenchmark::openLog()
+{
+	closeLog();
+
+	std::string filename = gSavedSettings.getString("BenchmarkCSVFile");
+	mLog = new llofstream(filename);
+	if (!mLog->is_open())
+	{
+		llwarns << "Couldn't open benchmark log " << filename << llendl;
+		delete mLog;
+		mLog = NULL;
+		return;
+	}
+
+	mTimers.clear();
+	LLFastTimerView::getTimerNames(mTimers);
+
+	*mLog << "frame,path_time";
+	for (U32 i = 0; i < mTimers.size(); i++)
+	{
+		*mLog << "," << mTimers[i].second;
+	}
+	*mLog << '\n';
+
+	llinfos << "Logging benchmark frames to " << filename << llendl;
+}
+
+void LLViewerBenchmark::closeLog()
+{
+	if (mLog)
+	{
+		mLog->close();
+		delete mLog;
+		mLog = NULL;
+	}
+}
+
+// static
+void LLViewerBenchmark::startRecord(void *)
+{
+	gViewerBenchmark.startRecord();
+}
+
+// static
+void LLViewerBenchmark::stopRecord(void *)
+{
+	gViewerBenchmark.stopRecord();
+}
+
+// static
+void LLViewerBenchmark::startPlayback(void *)
+{
+	gViewerBenchmark.startBenchmark(FALSE);
+}
+
+// static
+void LLViewerBenchmark::stopPlayback(void *)
+{
+	gViewerBenchmark.stopBenchmark();
+}
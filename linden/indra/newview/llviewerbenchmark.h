@@ -0,0 +1,120 @@
+/** 
+ * @file llviewerbenchmark.h
+ * @brief LLViewerBenchmark class definition
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVIEWERBENCHMARK_H
+#define LL_LLVIEWERBENCHMARK_H
+
+#include <vector>
+
+#include "stdtypes.h"
+#include "llfile.h"
+#include "lltimer.h"
+#include "v3dmath.h"
+#include "llfasttimer.h"
+
+// Flies the camera along a recorded path at a fixed time step per frame
+// and writes each frame's fast timer breakdown to a CSV file.  Stepping
+// the path by frame rather than by wall clock means every run renders
+// the same sequence of views.
+//
+// This is an interactive capture tool, not a headless or deterministic
+// benchmark: it runs in a normal logged in viewer with a GL window, and
+// the scene is whatever the region streams in, so compare runs taken on
+// the same region with warm caches.
+
+class LLViewerBenchmark
+{
+public:
+	LLViewerBenchmark();
+	~LLViewerBenchmark();
+
+	void load(const std::string& filename);
+	void save(const std::string& filename);
+
+	void startRecord();
+	void stopRecord();
+	void addKey();
+
+	void startBenchmark(BOOL quit_when_done);
+	void stopBenchmark();
+
+	BOOL isRecording() const	{ return mRecording; }
+	BOOL isPlaying() const		{ return mPlaying; }
+
+	// Called from idle, before the agent camera is updated.
+	void updateCamera();
+
+	// Called at the top of the main loop, right before LLFastTimer::reset(),
+	// to log the frame that just finished.
+	void logFrame();
+
+	static void startRecord(void *);
+	static void stopRecord(void *);
+	static void startPlayback(void *);
+	static void stopPlayback(void *);
+
+private:
+	void finishBenchmark();
+	void openLog();
+	void closeLog();
+
+	class Key
+	{
+	public:
+		F64			mTime;
+		LLVector3d	mCameraPos;
+		LLVector3d	mFocusPos;
+	};
+
+	std::vector<Key>	mKeys;
+	LLTimer				mTimer;
+
+	BOOL	mRecording;
+	F32		mLastRecordTime;
+
+	BOOL	mPlaying;
+	BOOL	mQuitWhenDone;
+	F64		mPathTime;
+	F64		mFrameStep;
+	S32		mFrame;
+
+	// path time of the frame whose timers are waiting to be logged
+	BOOL	mFramePending;
+	F64		mPendingTime;
+
+	llofstream*	mLog;
+	std::vector<std::pair<LLFastTimer::EFastTimerType, std::string> > mTimers;
+};
+
+extern LLViewerBenchmark gViewerBenchmark;
+
+#endif // LL_LLVIEWERBENCHMARK_H
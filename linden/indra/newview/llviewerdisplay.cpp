@@ -635,6 +635,9 @@ void display(BOOL rebuild, F32 zoom_factor, int subfield, BOOL for_snapshot)
 		LLPipeline::sUseFarClip = gSavedSettings.getBOOL("RenderUseFarClip");
 		LLVOAvatar::sMaxVisible = gSavedSettings.getS32("RenderAvatarMaxVisible");
 		LLPipeline::sDelayVBUpdate = gSavedSettings.getBOOL("RenderDelayVBUpdate");
+		LLPipeline::sAsyncVBUpdate = gSavedSettings.getBOOL("RenderAsyncVBUpdate");
+		LLPipeline::sMergeBatches = gSavedSettings.getBOOL("RenderMergeBatches");
+		LLPipeline::sSoftwareOcclusion = gSavedSettings.getBOOL("RenderSoftwareOcclusion");
 
 		S32 occlusion = LLPipeline::sUseOcclusion;
 		if (gDepthDirty)
@@ -913,6 +916,10 @@ void display(BOOL rebuild, F32 zoom_factor, int subfield, BOOL for_snapshot)
 		}
 
 		LLSpatialGroup::sNoDelete = FALSE;
+
+		// swap in this frame's asynchronously built geometry (freeing the old
+		// draw info) before idle processing can modify the volumes it reads
+		LLVolumeGeometryManager::finishAsyncGeometry();
 	}
 	
 	LLAppViewer::instance()->pingMainloopTimeout("Display:FrameStats");
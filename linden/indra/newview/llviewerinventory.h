@@ -164,6 +164,7 @@ public:
 	virtual void updateServer(BOOL is_new) const;
 
 	const LLUUID& getOwnerID() const { return mOwnerID; }
+	void setOwnerID(const LLUUID& owner_id) { mOwnerID = owner_id; }
 
 	// Version handling
 	enum { VERSION_UNKNOWN = -1, VERSION_INITIAL = 1 };
@@ -68,6 +68,7 @@
 #include "jcfloaterareasearch.h"
 
 #include "llagentpilot.h"
+#include "llviewerbenchmark.h"
 #include "llbox.h"
 #include "llcallingcard.h"
 #include "llclipboard.h"
@@ -927,6 +928,11 @@ void init_client_menu(LLMenuGL* menu)
 		sub->append(new LLMenuItemToggleGL("Loop Playback", &LLAgentPilot::sLoop) );
 		sub->append(new LLMenuItemCallGL("Start Record",	&LLAgentPilot::startRecord, NULL));
 		sub->append(new LLMenuItemCallGL("Stop Record",	&LLAgentPilot::saveRecord, NULL));
+		sub->appendSeparator();
+		sub->append(new LLMenuItemCallGL("Start Benchmark", &LLViewerBenchmark::startPlayback, NULL));
+		sub->append(new LLMenuItemCallGL("Stop Benchmark", &LLViewerBenchmark::stopPlayback, NULL));
+		sub->append(new LLMenuItemCallGL("Start Camera Record", &LLViewerBenchmark::startRecord, NULL));
+		sub->append(new LLMenuItemCallGL("Stop Camera Record", &LLViewerBenchmark::stopRecord, NULL));
 
 		menu->appendMenu( sub );
 		sub->createJumpKeys();
@@ -10626,6 +10632,39 @@ class LLAdvancedAgentPilot : public view_listener_t
 
 
 
+///////////////
+// BENCHMARK //
+///////////////
+
+
+class LLAdvancedBenchmark : public view_listener_t
+{
+	bool handleEvent(LLPointer<LLEvent> event, const LLSD& userdata)
+	{
+		std::string command = userdata.asString();
+		if ("start playback" == command)
+		{
+			LLViewerBenchmark::startPlayback(NULL);
+		}
+		else if ("stop playback" == command)
+		{
+			LLViewerBenchmark::stopPlayback(NULL);
+		}
+		else if ("start record" == command)
+		{
+			LLViewerBenchmark::startRecord(NULL);
+		}
+		else if ("stop record" == command)
+		{
+			LLViewerBenchmark::stopRecord(NULL);
+		}
+
+		return true;
+	}
+};
+
+
+
 //////////////////////
 // AGENT PILOT LOOP //
 //////////////////////
@@ -11277,6 +11316,7 @@ void initialize_menus()
 	addMenu(new LLAdvancedAgentPilot(), "Advanced.AgentPilot");
 	addMenu(new LLAdvancedToggleAgentPilotLoop(), "Advanced.ToggleAgentPilotLoop");
 	addMenu(new LLAdvancedCheckAgentPilotLoop(), "Advanced.CheckAgentPilotLoop");
+	addMenu(new LLAdvancedBenchmark(), "Advanced.Benchmark");
 
 	// Advanced (toplevel)
 	addMenu(new LLAdvancedToggleShowObjectUpdates(), "Advanced.ToggleShowObjectUpdates");
@@ -194,6 +194,7 @@ LLViewerObject::LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRe
 	mUserSelected(FALSE),
 	mOnActiveList(FALSE),
 	mOnMap(FALSE),
+	mMapFootprintDirty(FALSE),
 	mStatic(FALSE),
 	mNumFaces(0),
 	mTimeDilation(1.f),
@@ -936,6 +937,11 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				// clear all but local flags
 				mFlags &= FLAGS_LOCAL;
 				mFlags |= flags;
+				if (mOnMap)
+				{
+					// ownership picks the map colour
+					gObjectList.dirtyMapFootprint(this);
+				}
 
 				U8 state;
 				mesgsys->getU8Fast(_PREHASH_ObjectData, _PREHASH_State, state, block_num );
@@ -1531,6 +1537,10 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, block_num);
 				// keep local flags and overwrite remote-controlled flags
 				mFlags = (mFlags & FLAGS_LOCAL) | flags;
+				if (mOnMap)
+				{
+					gObjectList.dirtyMapFootprint(this);
+				}
 
 					// ...new objects that should come in selected need to be added to the selected list
 				mCreateSelected = ((flags & FLAGS_CREATE_SELECTED) != 0);
@@ -2815,6 +2825,10 @@ void LLViewerObject::setScale(const LLVector3 &scale, BOOL damped)
 				gObjectList.addToMap(this);
 				mOnMap = TRUE;
 			}
+			else
+			{
+				gObjectList.dirtyMapFootprint(this);
+			}
 		}
 		else
 		{
@@ -3263,6 +3277,11 @@ void LLViewerObject::setPosition(const LLVector3 &pos, BOOL damped)
 	if (getPosition() != pos)
 	{
 		setChanged(TRANSLATED | SILHOUETTE);
+		if (mOnMap || (!mChildList.empty() && !isAvatar()))
+		{
+			// children on the map move with us
+			gObjectList.dirtyMapFootprint(this);
+		}
 	}
 		
 	LLXform::setPosition(pos);
@@ -3274,6 +3293,33 @@ void LLViewerObject::setPosition(const LLVector3 &pos, BOOL damped)
 	}
 }
 
+void LLViewerObject::setRotation(const LLQuaternion& quat, BOOL damped)
+{
+	LLQuaternion old_rot = getRotation();
+	LLPrimitive::setRotation(quat);
+	setChanged(ROTATED | SILHOUETTE);
+	updateDrawable(damped);
+	dirtyChildMapFootprints(old_rot);
+}
+
+void LLViewerObject::setRotation(const F32 x, const F32 y, const F32 z, BOOL damped)
+{
+	LLQuaternion old_rot = getRotation();
+	LLPrimitive::setRotation(x, y, z);
+	setChanged(ROTATED | SILHOUETTE);
+	updateDrawable(damped);
+	dirtyChildMapFootprints(old_rot);
+}
+
+void LLViewerObject::dirtyChildMapFootprints(const LLQuaternion& old_rot)
+{
+	if (getRotation() != old_rot && !mChildList.empty() && !isAvatar())
+	{
+		// children on the map swing round with us
+		gObjectList.dirtyMapFootprint(this);
+	}
+}
+
 void LLViewerObject::setPositionGlobal(const LLVector3d &pos_global, BOOL damped)
 {
 	if (isAttachment())
@@ -4878,6 +4924,10 @@ void LLViewerObject::setRegion(LLViewerRegion *regionp)
 	llassert(regionp);
 	mLatestRecvPacketID = 0;
 	mRegionp = regionp;
+	if (mOnMap)
+	{
+		gObjectList.dirtyMapFootprint(this);
+	}
 
 	for (child_list_t::iterator i = mChildList.begin(); i != mChildList.end(); ++i)
 	{
@@ -286,8 +286,8 @@ public:
 
 	virtual const LLMatrix4& getWorldMatrix(LLXformMatrix* xform) const		{ return xform->getWorldMatrix(); }
 
-	inline void setRotation(const F32 x, const F32 y, const F32 z, BOOL damped = FALSE);
-	inline void setRotation(const LLQuaternion& quat, BOOL damped = FALSE);
+	void setRotation(const F32 x, const F32 y, const F32 z, BOOL damped = FALSE);
+	void setRotation(const LLQuaternion& quat, BOOL damped = FALSE);
 	void sendRotationUpdate() const;
 
 	/*virtual*/	void	setNumTEs(const U8 num_tes);
@@ -590,6 +590,7 @@ protected:
 private:
 	void setNameValueList(const std::string& list);		// clears nv pairs and then individually adds \n separated NV pairs from \0 terminated string
 	void deleteTEImages(); // correctly deletes list of images
+	void dirtyChildMapFootprints(const LLQuaternion& old_rot);
 	
 protected:
 	typedef std::map<char *, LLNameValue *> name_value_map_t;
@@ -631,6 +632,7 @@ protected:
 	BOOL			mUserSelected;				// Cached user select information
 	BOOL			mOnActiveList;
 	BOOL			mOnMap;						// On the map.
+	BOOL			mMapFootprintDirty;			// Map footprint needs updating.
 	BOOL			mStatic;					// Object doesn't move.
 	S32				mNumFaces;
 
@@ -667,20 +669,6 @@ private:
 //
 //
 
-inline void LLViewerObject::setRotation(const LLQuaternion& quat, BOOL damped)
-{
-	LLPrimitive::setRotation(quat);
-	setChanged(ROTATED | SILHOUETTE);
-	updateDrawable(damped);
-}
-
-inline void LLViewerObject::setRotation(const F32 x, const F32 y, const F32 z, BOOL damped)
-{
-	LLPrimitive::setRotation(x, y, z);
-	setChanged(ROTATED | SILHOUETTE);
-	updateDrawable(damped);
-}
-
 class LLViewerObjectMedia
 {
 public:
@@ -98,7 +98,11 @@ LLMap<U64, U32>			LLViewerObjectList::sIPAndPortToIndex;
 std::map<U64, LLUUID>	LLViewerObjectList::sIndexAndLocalIDToUUID;
 
 
+// 32 m map footprint cells spanning the whole U32 range of global meters
+const U32 MAP_FOOTPRINT_INDEX_BITS = 27;
+
 LLViewerObjectList::LLViewerObjectList()
+:	mMapFootprintIndex(MAP_FOOTPRINT_INDEX_BITS)
 {
 	mNumVisCulled = 0;
 	mNumSizeCulled = 0;
@@ -111,6 +115,8 @@ LLViewerObjectList::LLViewerObjectList()
 	mNumDeadObjectUpdates = 0;
 	mNumUnknownKills = 0;
 	mNumUnknownUpdates = 0;
+	mMapDamageOverflow = FALSE;
+	mMapMaxRadius = 0.f;
 }
 
 LLViewerObjectList::~LLViewerObjectList()
@@ -126,6 +132,10 @@ void LLViewerObjectList::destroy()
 	mActiveObjects.clear();
 	mDeadObjects.clear();
 	mMapObjects.clear();
+	mMapFootprints.clear();
+	mMapFootprintIndex.clear();
+	mDirtyMapObjects.clear();
+	mMapDamage.clear();
 	mUUIDObjectMap.clear();
 }
 
@@ -794,6 +804,8 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 	}
 	*/
 
+	updateDirtyMapFootprints();
+
 	mNumObjectsStat.addValue(mObjects.count());
 	mNumActiveObjectsStat.addValue(num_active_objects);
 	mNumSizeCulledStat.addValue(mNumSizeCulled);
@@ -836,6 +848,7 @@ void LLViewerObjectList::cleanupReferences(LLViewerObject *objectp)
 	if (objectp->isOnMap())
 	{
 		mMapObjects.removeObj(objectp);
+		removeMapFootprint(objectp);
 	}
 
 	// Don't clean up mObject references, these will be cleaned up more efficiently later!
@@ -1040,39 +1053,61 @@ void LLViewerObjectList::shiftObjects(const LLVector3 &offset)
 	LLWorld::getInstance()->shiftRegions(offset);
 }
 
-void LLViewerObjectList::renderObjectsForMap(LLNetMap &netmap)
-{
-	LLColor4 above_water_color = gColors.getColor( "NetMapOtherOwnAboveWater" );
-	LLColor4 below_water_color = gColors.getColor( "NetMapOtherOwnBelowWater" );
-	LLColor4 you_own_above_water_color = 
-						gColors.getColor( "NetMapYouOwnAboveWater" );
-	LLColor4 you_own_below_water_color = 
-						gColors.getColor( "NetMapYouOwnBelowWater" );
-	LLColor4 group_own_above_water_color = 
-						gColors.getColor( "NetMapGroupOwnAboveWater" );
-	LLColor4 group_own_below_water_color = 
-						gColors.getColor( "NetMapGroupOwnBelowWater" );
+// Footprints are indexed by the cells of this grid that they cover
+const F64 MAP_FOOTPRINT_CELL_METERS = 32.0;
+// Smaller moves leave the footprint where it was drawn
+const F64 MIN_MAP_FOOTPRINT_MOVE = 0.5;
+// Past this many changes between redraws, redraw everything
+const U32 MAX_MAP_DAMAGE = 4096;
 
+void LLViewerObjectList::updateDirtyMapFootprints()
+{
 	F32 max_radius = gSavedSettings.getF32("MiniMapPrimMaxRadius");
-
-	for (S32 i = 0; i < mMapObjects.count(); i++)
+	if (max_radius != mMapMaxRadius)
 	{
-		LLViewerObject* objectp = mMapObjects[i];
-		if (!objectp->getRegion() || objectp->isOrphaned() || objectp->isAttachment())
+		mMapMaxRadius = max_radius;
+		for (S32 i = 0; i < mMapObjects.count(); i++)
 		{
-			continue;
+			dirtyMapFootprint(mMapObjects[i]);
 		}
+	}
+
+	if (mDirtyMapObjects.empty())
+	{
+		return;
+	}
+
+	std::vector<LLPointer<LLViewerObject> > dirty_objects;
+	dirty_objects.swap(mDirtyMapObjects);
+	for (U32 i = 0; i < dirty_objects.size(); i++)
+	{
+		LLViewerObject* objectp = dirty_objects[i];
+		objectp->mMapFootprintDirty = FALSE;
+		updateMapFootprint(objectp);
+	}
+}
+
+void LLViewerObjectList::updateMapFootprint(LLViewerObject *objectp)
+{
+	if (!objectp->isOnMap() || objectp->isDead() || !objectp->getRegion() ||
+		objectp->isOrphaned() || objectp->isAttachment())
+	{
+		removeMapFootprint(objectp);
+	}
+	else
+	{
 		const LLVector3& scale = objectp->getScale();
-		const LLVector3d pos = objectp->getPositionGlobal();
+		LLMapFootprint footprint;
+		footprint.mPosGlobal = objectp->getPositionGlobal();
 		const F64 water_height = F64( objectp->getRegion()->getWaterHeight() );
-		// LLWorld::getInstance()->getWaterHeight();
+		BOOL above_water = footprint.mPosGlobal.mdV[VZ] >= water_height;
 
 		F32 approx_radius = (scale.mV[VX] + scale.mV[VY]) * 0.5f * 0.5f * 1.3f;  // 1.3 is a fudge
 
 		// DEV-17370 - megaprims of size > 4096 cause lag.  (go figger.)
-		approx_radius = llmin(approx_radius, max_radius);
+		approx_radius = llmin(approx_radius, mMapMaxRadius);
 
-		LLColor4U color = above_water_color;
+		footprint.mColor = above_water ? LLMapFootprint::OTHER_ABOVE_WATER : LLMapFootprint::OTHER_BELOW_WATER;
 		if( objectp->permYouOwner() )
 		{
 			const F32 MIN_RADIUS_FOR_OWNED_OBJECTS = 2.f;
@@ -1081,40 +1116,137 @@ void LLViewerObjectList::renderObjectsForMap(LLNetMap &netmap)
 				approx_radius = MIN_RADIUS_FOR_OWNED_OBJECTS;
 			}
 
-			if( pos.mdV[VZ] >= water_height )
+			if ( objectp->permGroupOwner() )
 			{
-				if ( objectp->permGroupOwner() )
-				{
-					color = group_own_above_water_color;
-				}
-				else
-				{
-				color = you_own_above_water_color;
-			}
+				footprint.mColor = above_water ? LLMapFootprint::GROUP_OWN_ABOVE_WATER : LLMapFootprint::GROUP_OWN_BELOW_WATER;
 			}
 			else
 			{
-				if ( objectp->permGroupOwner() )
-				{
-					color = group_own_below_water_color;
-				}
-			else
-			{
-				color = you_own_below_water_color;
+				footprint.mColor = above_water ? LLMapFootprint::YOU_OWN_ABOVE_WATER : LLMapFootprint::YOU_OWN_BELOW_WATER;
 			}
 		}
+		footprint.mRadius = approx_radius;
+
+		map_footprint_map_t::iterator it = mMapFootprints.find(objectp->mID);
+		if (it == mMapFootprints.end())
+		{
+			mMapFootprints[objectp->mID] = footprint;
+			indexMapFootprint(objectp->mID, footprint, true);
+			addMapDamage(footprint);
 		}
 		else
-		if( pos.mdV[VZ] < water_height )
 		{
-			color = below_water_color;
+			LLMapFootprint& old_footprint = it->second;
+			if (dist_vec_squared(old_footprint.mPosGlobal, footprint.mPosGlobal) >= MIN_MAP_FOOTPRINT_MOVE * MIN_MAP_FOOTPRINT_MOVE ||
+				old_footprint.mRadius != footprint.mRadius ||
+				old_footprint.mColor != footprint.mColor)
+			{
+				indexMapFootprint(objectp->mID, old_footprint, false);
+				addMapDamage(old_footprint);
+				old_footprint = footprint;
+				indexMapFootprint(objectp->mID, footprint, true);
+				addMapDamage(footprint);
+			}
+		}
+	}
+
+	// Children are positioned relative to us
+	LLViewerObject::const_child_list_t& children = objectp->getChildren();
+	for (LLViewerObject::child_list_t::const_iterator iter = children.begin();
+		 iter != children.end(); ++iter)
+	{
+		LLViewerObject* childp = *iter;
+		if (childp->isOnMap() || !childp->getChildren().empty())
+		{
+			updateMapFootprint(childp);
+		}
+	}
+}
+
+void LLViewerObjectList::removeMapFootprint(LLViewerObject *objectp)
+{
+	map_footprint_map_t::iterator it = mMapFootprints.find(objectp->mID);
+	if (it != mMapFootprints.end())
+	{
+		indexMapFootprint(objectp->mID, it->second, false);
+		addMapDamage(it->second);
+		mMapFootprints.erase(it);
+	}
+}
+
+void LLViewerObjectList::indexMapFootprint(const LLUUID& id, const LLMapFootprint& footprint, bool insert)
+{
+	F64 radius = footprint.mRadius;
+	S32 min_x = llmax(0, llfloor((footprint.mPosGlobal.mdV[VX] - radius) / MAP_FOOTPRINT_CELL_METERS));
+	S32 min_y = llmax(0, llfloor((footprint.mPosGlobal.mdV[VY] - radius) / MAP_FOOTPRINT_CELL_METERS));
+	S32 max_x = llfloor((footprint.mPosGlobal.mdV[VX] + radius) / MAP_FOOTPRINT_CELL_METERS);
+	S32 max_y = llfloor((footprint.mPosGlobal.mdV[VY] + radius) / MAP_FOOTPRINT_CELL_METERS);
+	for (S32 x = min_x; x <= max_x; x++)
+	{
+		for (S32 y = min_y; y <= max_y; y++)
+		{
+			if (insert)
+			{
+				mMapFootprintIndex.insert(x, y, id);
+			}
+			else
+			{
+				mMapFootprintIndex.remove(x, y, id);
+			}
 		}
+	}
+}
 
-		netmap.renderScaledPointGlobal( 
-			pos, 
-			color,
-			approx_radius );
+void LLViewerObjectList::addMapDamage(const LLMapFootprint& footprint)
+{
+	if (mMapDamageOverflow)
+	{
+		return;
+	}
+	if (mMapDamage.size() >= MAX_MAP_DAMAGE)
+	{
+		mMapDamageOverflow = TRUE;
+		mMapDamage.clear();
+		return;
+	}
+	mMapDamage.push_back(footprint);
+}
+
+void LLViewerObjectList::getMapFootprints(const LLVector3d& min_global, const LLVector3d& max_global,
+										  std::vector<const LLMapFootprint*>& footprints) const
+{
+	S32 max_x = llfloor(max_global.mdV[VX] / MAP_FOOTPRINT_CELL_METERS);
+	S32 max_y = llfloor(max_global.mdV[VY] / MAP_FOOTPRINT_CELL_METERS);
+	if (max_x < 0 || max_y < 0)
+	{
+		return;
 	}
+	S32 min_x = llmax(0, llfloor(min_global.mdV[VX] / MAP_FOOTPRINT_CELL_METERS));
+	S32 min_y = llmax(0, llfloor(min_global.mdV[VY] / MAP_FOOTPRINT_CELL_METERS));
+
+	// Footprints that cover several cells are found once per cell
+	std::vector<LLUUID> ids;
+	mMapFootprintIndex.query(min_x, min_y, max_x, max_y, ids);
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+	for (U32 i = 0; i < ids.size(); i++)
+	{
+		map_footprint_map_t::const_iterator it = mMapFootprints.find(ids[i]);
+		if (it != mMapFootprints.end())
+		{
+			footprints.push_back(&(it->second));
+		}
+	}
+}
+
+BOOL LLViewerObjectList::popMapDamage(std::vector<LLMapFootprint>& damage)
+{
+	BOOL tracked = !mMapDamageOverflow;
+	damage.clear();
+	damage.swap(mMapDamage);
+	mMapDamageOverflow = FALSE;
+	return tracked;
 }
 
 void LLViewerObjectList::renderObjectBounds(const LLVector3 &center)
@@ -35,11 +35,14 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 // common includes
 #include "llstat.h"
 #include "lldarrayptr.h"
+#include "llgridquadtree.h"
 #include "llstring.h"
+#include "lluuidopenhashmap.h"
 
 // project includes
 #include "llviewerobject.h"
@@ -58,6 +61,26 @@ const U32 GL_NAME_PARCEL_WALL = 1;
 
 const U32 GL_NAME_INDEX_OFFSET = 10;
 
+// What the mini map draws for an object: a square of ground around its
+// position, coloured by who owns it and whether it is under water.
+struct LLMapFootprint
+{
+	enum EColor
+	{
+		OTHER_ABOVE_WATER,
+		OTHER_BELOW_WATER,
+		YOU_OWN_ABOVE_WATER,
+		YOU_OWN_BELOW_WATER,
+		GROUP_OWN_ABOVE_WATER,
+		GROUP_OWN_BELOW_WATER,
+		COLOR_COUNT
+	};
+
+	LLVector3d	mPosGlobal;
+	F32			mRadius;
+	U8			mColor;
+};
+
 class LLViewerObjectList
 {
 public:
@@ -94,7 +117,6 @@ public:
 
 	void shiftObjects(const LLVector3 &offset);
 
-	void renderObjectsForMap(LLNetMap &netmap);
 	void renderObjectBounds(const LLVector3 &center);
 
 	void addDebugBeacon(const LLVector3 &pos_agent, const std::string &string,
@@ -121,6 +143,17 @@ public:
 	void addToMap(LLViewerObject *objectp);
 	void removeFromMap(LLViewerObject *objectp);
 
+	// Objects on the map keep a footprint that follows them as they are
+	// added, moved, scaled and killed.  Each change is also recorded as
+	// damage, so the mini map only redraws the areas that changed.
+	void dirtyMapFootprint(LLViewerObject *objectp);
+	void getMapFootprints(const LLVector3d& min_global, const LLVector3d& max_global,
+						  std::vector<const LLMapFootprint*>& footprints) const;
+	// Moves the footprints changed since the last call into damage, both
+	// where they were and where they are now.  Returns FALSE if too much
+	// changed to track, in which case redraw everything.
+	BOOL popMapDamage(std::vector<LLMapFootprint>& damage);
+
 	void clearDebugText();
 
 	////////////////////////////////////////////
@@ -130,6 +163,15 @@ public:
 
 	S32 findReferences(LLDrawable *drawablep) const; // Find references to drawable in all objects, and return value.
 
+private:
+	void updateDirtyMapFootprints();
+	void updateMapFootprint(LLViewerObject *objectp);
+	void removeMapFootprint(LLViewerObject *objectp);
+	void indexMapFootprint(const LLUUID& id, const LLMapFootprint& footprint, bool insert);
+	void addMapDamage(const LLMapFootprint& footprint);
+
+public:
+
 	S32 getOrphanParentCount() const { return mOrphanParents.count(); }
 	S32 getOrphanCount() const { return mNumOrphans; }
 	void orphanize(LLViewerObject *childp, U32 parent_id, U32 ip, U32 port);
@@ -198,6 +240,14 @@ protected:
 
 	LLDynamicArrayPtr<LLPointer<LLViewerObject> > mMapObjects;
 
+	typedef LLUUIDOpenHashMap<LLMapFootprint> map_footprint_map_t;
+	map_footprint_map_t mMapFootprints;
+	LLGridQuadTree<LLUUID> mMapFootprintIndex;	// object ids by the cells their footprints cover
+	std::vector<LLPointer<LLViewerObject> > mDirtyMapObjects;
+	std::vector<LLMapFootprint> mMapDamage;
+	BOOL mMapDamageOverflow;
+	F32 mMapMaxRadius;
+
 	typedef std::map<LLUUID, LLPointer<LLViewerObject> > vo_map;
 	vo_map mDeadObjects;	// Need to keep multiple entries per UUID
 
@@ -271,11 +321,22 @@ inline LLViewerObject *LLViewerObjectList::getObject(const S32 index)
 inline void LLViewerObjectList::addToMap(LLViewerObject *objectp)
 {
 	mMapObjects.put(objectp);
+	dirtyMapFootprint(objectp);
 }
 
 inline void LLViewerObjectList::removeFromMap(LLViewerObject *objectp)
 {
 	mMapObjects.removeObj(objectp);
+	removeMapFootprint(objectp);
+}
+
+inline void LLViewerObjectList::dirtyMapFootprint(LLViewerObject *objectp)
+{
+	if (!objectp->mMapFootprintDirty)
+	{
+		objectp->mMapFootprintDirty = TRUE;
+		mDirtyMapObjects.push_back(objectp);
+	}
 }
 
 
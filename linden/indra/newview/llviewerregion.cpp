@@ -150,7 +150,8 @@ LLViewerRegion::LLViewerRegion(const U64 &handle,
 							   const U32 grids_per_region_edge, 
 							   const U32 grids_per_patch_edge, 
 							   const F32 region_width_meters)
-:	mCenterGlobal(),
+:	mMapAvatarIndex(8),
+	mCenterGlobal(),
 	mHandle(handle),
 	mHost( host ),
 	mTimeDilation(1.0f),
@@ -995,6 +996,7 @@ public:
 				agents_it++;
 			}
 		}
+		region->indexMapAvatars();
 	}
 };
 
@@ -1066,6 +1068,19 @@ void LLViewerRegion::updateCoarseLocations(LLMessageSystem* msg)
 			}
 		}
 	}
+	indexMapAvatars();
+}
+
+// Every update replaces the whole list, so the index is simply rebuilt.
+void LLViewerRegion::indexMapAvatars()
+{
+	mMapAvatarIndex.clear();
+	S32 count = mMapAvatars.count();
+	for (S32 i = 0; i < count; i++)
+	{
+		U32 pos = mMapAvatars.get(i);
+		mMapAvatarIndex.insert((pos >> 16) & 0xFF, (pos >> 8) & 0xFF, i);
+	}
 }
 
 void LLViewerRegion::getInfo(LLSD& info)
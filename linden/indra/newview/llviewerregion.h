@@ -38,6 +38,7 @@
 #include <string>
 
 #include "lldarray.h"
+#include "llgridquadtree.h"
 #include "llwind.h"
 #include "llcloud.h"
 #include "llstat.h"
@@ -255,6 +256,14 @@ public:
 
 	// deal with map object updates in the world.
 	void updateCoarseLocations(LLMessageSystem* msg);
+	// Rebuilds mMapAvatarIndex, after mMapAvatars has been refilled.
+	void indexMapAvatars();
+	// Appends the mMapAvatars indices of avatars whose region local x and y
+	// lie in [min_x, max_x] by [min_y, max_y], in whole meters.
+	void getMapAvatarsInRect(U32 min_x, U32 min_y, U32 max_x, U32 max_y, std::vector<S32>& out) const
+	{
+		mMapAvatarIndex.query(min_x, min_y, max_x, max_y, out);
+	}
 
 	F32 getLandHeightRegion(const LLVector3& region_pos);
 
@@ -313,6 +322,8 @@ public:
 	// we stop supporting the old CoarseLocationUpdate message.
 	LLDynamicArray<U32> mMapAvatars;
 	LLDynamicArray<LLUUID> mMapAvatarIDs;
+	// mMapAvatars indices by coarse x and y
+	LLGridQuadTree<S32> mMapAvatarIndex;
 
 private:
 	// The surfaces and other layers
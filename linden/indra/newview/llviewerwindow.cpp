@@ -58,6 +58,7 @@
 #include "indra_constants.h"
 #include "llassetstorage.h"
 #include "llfontgl.h"
+#include "llfontbitmapcache.h"
 #include "llmousehandler.h"
 #include "llrect.h"
 #include "llsky.h"
@@ -434,6 +435,13 @@ public:
 			addText(xpos, ypos, llformat("%d Render Calls", gPipeline.mBatchCount));
             ypos += y_inc;
 
+			addText(xpos, ypos, llformat("%d Batches Merged", gPipeline.mBatchesMerged));
+			ypos += y_inc;
+
+			addText(xpos, ypos, llformat("Occlusion: %d/%d groups culled in software, %d by queries",
+				gPipeline.mSoftwareOcclusionCulled, gPipeline.mSoftwareOcclusionTests, gPipeline.mQueryOcclusionCulled));
+			ypos += y_inc;
+
 			addText(xpos, ypos, llformat("%d Matrix Ops", gPipeline.mMatrixOpCount));
 			ypos += y_inc;
 
@@ -442,6 +450,10 @@ public:
 
 			gPipeline.mTextureMatrixOps = 0;
 			gPipeline.mMatrixOpCount = 0;
+			gPipeline.mBatchesMerged = 0;
+			gPipeline.mSoftwareOcclusionTests = 0;
+			gPipeline.mSoftwareOcclusionCulled = 0;
+			gPipeline.mQueryOcclusionCulled = 0;
 
 			if (gPipeline.mBatchCount > 0)
 			{
@@ -1293,6 +1305,7 @@ LLViewerWindow::LLViewerWindow(
 		gSavedSettings.setBOOL("RenderVBOEnable", FALSE);
 	}
 	LLVertexBuffer::initClass(gSavedSettings.getBOOL("RenderVBOEnable"));
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 
 	if (LLFeatureManager::getInstance()->isSafe()
 		|| (gSavedSettings.getS32("LastFeatureVersion") != LLFeatureManager::getInstance()->getVersion())
@@ -4401,6 +4414,9 @@ void LLViewerWindow::stopGL(BOOL save_state)
 		LLFontGL::destroyAllGL();
 		stop_glerror();
 
+		LLFloater::releaseRetainedTargets();
+		stop_glerror();
+
 		LLVOAvatar::destroyGL();
 		stop_glerror();
 
@@ -4486,6 +4502,7 @@ void LLViewerWindow::restoreGL(const std::string& progress_message)
 void LLViewerWindow::initFonts(F32 zoom_factor)
 {
 	LLFontGL::destroyAllGL();
+	LLFontBitmapCache::sMaxBitmaps = gSavedSettings.getS32("FontMaxBitmaps");
 	LLFontGL::initDefaultFonts( gSavedSettings.getF32("FontScreenDPI"),
 								mDisplayScale.mV[VX] * zoom_factor,
 								mDisplayScale.mV[VY] * zoom_factor,
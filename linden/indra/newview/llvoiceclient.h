@@ -33,7 +33,6 @@
 #define LL_VOICE_CLIENT_H
 
 class LLVOAvatar;
-class LLVivoxProtocolParser;
 
 #include "lliopipe.h"
 #include "llpumpio.h"
@@ -43,6 +42,7 @@ class LLVivoxProtocolParser;
 #include "llframetimer.h"
 #include "llviewerregion.h"
 #include "llcallingcard.h"   // for LLFriendObserver
+#include "llvivoxprotocolparser.h"
 
 class LLVoiceClientParticipantObserver
 {
@@ -77,7 +77,7 @@ public:
 	static std::string status2string(EStatusType inStatus);
 };
 
-class LLVoiceClient: public LLSingleton<LLVoiceClient>
+class LLVoiceClient: public LLSingleton<LLVoiceClient>, public LLVivoxProtocolSink
 {
 	LOG_CLASS(LLVoiceClient);
 	public:
@@ -581,11 +581,11 @@ static	void updatePosition(void);
 		LLHost mDaemonHost;
 		LLSocket::ptr_t mSocket;
 		bool mConnected;
+		/*virtual*/ bool isDaemonConnected() { return mConnected; }
 		
 		void closeSocket(void);
 		
 		LLPumpIO *mPump;
-		friend class LLVivoxProtocolParser;
 		
 		std::string mAccountName;
 		std::string mAccountPassword;
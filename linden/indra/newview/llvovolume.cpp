@@ -62,6 +62,7 @@
 #include "llviewertextureanim.h"
 #include "llworld.h"
 #include "llselectmgr.h"
+#include "lltaskscheduler.h"
 #include "pipeline.h"
 
 const S32 MIN_QUIET_FRAMES_COALESCE = 30;
@@ -2189,6 +2190,59 @@ void LLVolumeGeometryManager::getGeometry(LLSpatialGroup* group)
 
 }
 
+// Fill vertex data on the worker pool (see finishAsyncGeometry())
+static BOOL use_async_geometry()
+{
+	return LLPipeline::sAsyncVBUpdate && LLTaskScheduler::getInstance() != NULL;
+}
+
+// Where a face's geometry lives in its vertex buffer.  An async rebuild lays
+// the faces out in new buffers, then puts their old layout back so selection,
+// highlights and picking keep drawing filled data until the switch.
+class LLFaceLayout
+{
+public:
+	LLFaceLayout(LLDrawable* drawablep, S32 index) :
+		mDrawable(drawablep),
+		mIndex(index)
+	{
+		LLFace* facep = drawablep->getFace(index);
+		mVertexBuffer = facep->mVertexBuffer;
+		mLastVertexBuffer = facep->mLastVertexBuffer;
+		mGeomCount = facep->getGeomCount();
+		mGeomIndex = facep->getGeomIndex();
+		mIndicesCount = facep->getIndicesCount();
+		mIndicesIndex = facep->getIndicesStart();
+	}
+
+	void apply() const
+	{
+		if (mDrawable->isDead() || mIndex >= mDrawable->getNumFaces())
+		{
+			return;
+		}
+		LLFace* facep = mDrawable->getFace(mIndex);
+		facep->setSize(mGeomCount, mIndicesCount);
+		facep->setGeomIndex(mGeomIndex);
+		facep->setIndicesIndex(mIndicesIndex);
+		facep->mVertexBuffer = mVertexBuffer;
+		facep->mLastVertexBuffer = mLastVertexBuffer;
+	}
+
+	LLPointer<LLDrawable> mDrawable;
+	S32 mIndex;
+
+private:
+	LLPointer<LLVertexBuffer> mVertexBuffer;
+	LLPointer<LLVertexBuffer> mLastVertexBuffer;
+	U16 mGeomCount;
+	U16 mGeomIndex;
+	U32 mIndicesCount;
+	U32 mIndicesIndex;
+};
+
+static void defer_face_layouts(const std::vector<LLFaceLayout>& old_layouts);
+
 void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 {
 	if (LLPipeline::sSkipUpdate)
@@ -2220,7 +2274,21 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 
 	LLFastTimer ftm2(LLFastTimer::FTM_REBUILD_VOLUME_VB);
 
-	group->clearDrawMap();
+	BOOL async = use_async_geometry();
+	LLSpatialGroup::draw_map_t old_draw_map;
+	LLSpatialGroup::buffer_map_t old_buffer_map;
+	std::vector<LLFaceLayout> old_layouts;
+
+	if (async)
+	{ //keep the current buffers drawing, lay the new geometry out in fresh ones
+		group->mDrawMap.swap(old_draw_map);
+		group->mBufferMap.swap(old_buffer_map);
+		group->clearState(LLSpatialGroup::MESH_DIRTY);
+	}
+	else
+	{
+		group->clearDrawMap();
+	}
 
 	mFaceList.clear();
 
@@ -2260,6 +2328,11 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 		//for each face
 		for (S32 i = 0; i < drawablep->getNumFaces(); i++)
 		{
+			if (async)
+			{
+				old_layouts.push_back(LLFaceLayout(drawablep, i));
+			}
+
 			//sum up face verts and indices
 			drawablep->updateFaceSize(i);
 			LLFace* facep = drawablep->getFace(i);
@@ -2397,7 +2470,15 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 	genDrawInfo(group, fullbright_mask, fullbright_faces);
 	genDrawInfo(group, alpha_mask, alpha_faces, TRUE);
 
-	if (!LLPipeline::sDelayVBUpdate)
+	if (async)
+	{
+		std::vector<LLFace*>* face_lists[] = { &simple_faces, &bump_faces, &fullbright_faces, &alpha_faces };
+		scheduleAsyncGeometry(group, face_lists, 4, group->mDrawMap, group->mBufferMap);
+		group->mDrawMap.swap(old_draw_map);
+		group->mBufferMap.swap(old_buffer_map);
+		defer_face_layouts(old_layouts);
+	}
+	else if (!LLPipeline::sDelayVBUpdate)
 	{
 		//drawables have been rebuilt, clear rebuild status
 		for (LLSpatialGroup::element_iter drawable_iter = group->getData().begin(); drawable_iter != group->getData().end(); ++drawable_iter)
@@ -2411,7 +2492,7 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 	group->mBuilt = 1.f;
 	group->clearState(LLSpatialGroup::GEOM_DIRTY | LLSpatialGroup::ALPHA_DIRTY);
 
-	if (LLPipeline::sDelayVBUpdate)
+	if (LLPipeline::sDelayVBUpdate && !async)
 	{
 		group->setState(LLSpatialGroup::MESH_DIRTY);
 	}
@@ -2419,8 +2500,351 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 	mFaceList.clear();
 }
 
+//============================================================================
+// Asynchronous vertex data fill
+//
+// rebuildGeom() lays a group's geometry out in new vertex buffers on the main
+// thread, then the per-vertex work of getGeometryVolume() runs on the worker
+// pool into plain staging memory.  The group keeps its old draw map and its
+// faces keep their old buffers until finishAsyncGeometry() copies the staging
+// data in and switches both over.  Workers only ever help: a fill nobody has
+// started by then runs on the main thread, which never waits behind whatever
+// else the pool is busy with.
+
+class LLAsyncGeometry
+{
+public:
+	struct Buffer
+	{
+		LLPointer<LLVertexBuffer> mBuffer;
+		std::vector<U8> mVertexData;
+		std::vector<U8> mIndexData;
+		S32 mStride;
+		S32 mOffsets[LLVertexBuffer::TYPE_MAX];
+		BOOL mHasType[LLVertexBuffer::TYPE_MAX];
+	};
+
+	struct Face
+	{
+		LLFace::VolumeGeometryParams mParams;
+		U32 mBuffer;
+		S32 mGeomIndex;
+		S32 mIndicesIndex;
+	};
+
+	template <class T> static void getStrider(Buffer& buffer, LLStrider<T>& strider, S32 type, S32 index)
+	{
+		if (buffer.mHasType[type] && !buffer.mVertexData.empty())
+		{
+			strider = (T*) (&buffer.mVertexData[0] + buffer.mOffsets[type] + index*buffer.mStride);
+			strider.setStride(buffer.mStride);
+		}
+	}
+
+	// Whoever claims a job first fills it, so a fill runs exactly once,
+	// on a worker or on the main thread.  Tasks hold the claim by reference,
+	// so one that starts after the main thread took its job over touches
+	// nothing else.
+	class Claim : public LLThreadSafeRefCount
+	{
+	public:
+		Claim() : mCount(0) { }
+		bool claim() { return mCount++ == 0; }
+	private:
+		LLAtomicU32 mCount;
+	};
+
+	LLAsyncGeometry() : mFilled(FALSE), mClaim(new Claim) { }
+
+	// WORKER THREAD
+	void fill()
+	{
+		for (U32 i = 0; i < mFaces.size(); i++)
+		{
+			Face& face = mFaces[i];
+			Buffer& buffer = mBuffers[face.mBuffer];
+			const LLFace::VolumeGeometryParams& params = face.mParams;
+
+			LLStrider<LLVector3> vertices;
+			LLStrider<LLVector2> tex_coords;
+			LLStrider<LLVector2> tex_coords2;
+			LLStrider<LLVector3> normals;
+			LLStrider<LLColor4U> colors;
+			LLStrider<LLVector3> binormals;
+			LLStrider<U16> indicesp;
+
+			getStrider(buffer, vertices, LLVertexBuffer::TYPE_VERTEX, face.mGeomIndex);
+			getStrider(buffer, normals, LLVertexBuffer::TYPE_NORMAL, face.mGeomIndex);
+			getStrider(buffer, binormals, LLVertexBuffer::TYPE_BINORMAL, face.mGeomIndex);
+			getStrider(buffer, tex_coords, LLVertexBuffer::TYPE_TEXCOORD0, face.mGeomIndex);
+			getStrider(buffer, tex_coords2, LLVertexBuffer::TYPE_TEXCOORD1, face.mGeomIndex);
+			getStrider(buffer, colors, LLVertexBuffer::TYPE_COLOR, face.mGeomIndex);
+			if (!buffer.mIndexData.empty())
+			{
+				indicesp = (U16*) (&buffer.mIndexData[0] + face.mIndicesIndex*sizeof(U16));
+			}
+
+			LLFace::fillGeometryVolume(params, vertices, normals, binormals, tex_coords, tex_coords2, colors, indicesp);
+		}
+		mFilled = TRUE;
+	}
+
+	// copy the staging data into the real buffers and start drawing them
+	void apply()
+	{
+		LLSpatialGroup* group = mGroup;
+		if (group->isDead() || group->mGeometryJob != mJobID)
+		{ //rebuilt or destroyed since, just drop the new buffers
+			return;
+		}
+
+		group->clearState(LLSpatialGroup::GEOM_PENDING);
+		if (!mFilled)
+		{ //the worker pool shut down first, the group still draws its old
+		  //buffers, so queue the rebuild scheduleAsyncGeometry() took over
+			group->setState(LLSpatialGroup::GEOM_DIRTY);
+			for (LLSpatialGroup::element_iter drawable_iter = group->getData().begin(); drawable_iter != group->getData().end(); ++drawable_iter)
+			{
+				LLDrawable* drawablep = *drawable_iter;
+				if (!drawablep->isDead())
+				{
+					gPipeline.markRebuild(drawablep, LLDrawable::REBUILD_ALL, TRUE);
+				}
+			}
+			return;
+		}
+
+		for (U32 i = 0; i < mBuffers.size(); i++)
+		{
+			Buffer& buffer = mBuffers[i];
+			LLVertexBuffer* vb = buffer.mBuffer;
+			if (vb->mapBuffer() == NULL)
+			{
+				llwarns << "mapBuffer failed!" << llendl;
+				continue;
+			}
+
+			if (!buffer.mVertexData.empty())
+			{
+				memcpy(vb->getMappedData(), &buffer.mVertexData[0], buffer.mVertexData.size());
+			}
+			if (!buffer.mIndexData.empty())
+			{
+				memcpy(vb->getMappedIndices(), &buffer.mIndexData[0], buffer.mIndexData.size());
+			}
+			vb->setBuffer(0);
+		}
+
+		group->mDrawMap.swap(mDrawMap);
+		group->mBufferMap.swap(mBufferMap);
+		for (U32 i = 0; i < mLayouts.size(); i++)
+		{
+			mLayouts[i].apply();
+		}
+		group->mLastUpdateTime = gFrameTimeSeconds;
+	}
+
+	LLPointer<LLSpatialGroup> mGroup;
+	U32 mJobID;
+	LLSpatialGroup::draw_map_t mDrawMap;
+	LLSpatialGroup::buffer_map_t mBufferMap;
+	std::vector<LLPointer<LLVolume> > mVolumes; //keeps the volume faces being read alive
+	std::vector<Buffer> mBuffers;
+	std::vector<Face> mFaces;
+	std::vector<LLFaceLayout> mLayouts; //where apply() moves the faces
+	BOOL mFilled;
+	LLPointer<Claim> mClaim;
+};
+
+static std::vector<LLAsyncGeometry*> sAsyncGeometry;
+static LLCondition* sAsyncGeometryDone = NULL;
+static S32 sAsyncGeometryPending = 0;
+
+// WORKER THREAD OR MAIN THREAD, called once per job after its claim
+static void finish_async_geometry_job()
+{
+	sAsyncGeometryDone->lock();
+	if (--sAsyncGeometryPending == 0)
+	{
+		sAsyncGeometryDone->signal();
+	}
+	sAsyncGeometryDone->unlock();
+}
+
+// Hand the new face layouts to the geometry job just scheduled and put the
+// old ones back until it lands
+static void defer_face_layouts(const std::vector<LLFaceLayout>& old_layouts)
+{
+	LLAsyncGeometry* geometry = sAsyncGeometry.back();
+	geometry->mLayouts.reserve(old_layouts.size());
+	for (std::vector<LLFaceLayout>::const_iterator iter = old_layouts.begin(); iter != old_layouts.end(); ++iter)
+	{
+		geometry->mLayouts.push_back(LLFaceLayout(iter->mDrawable, iter->mIndex));
+		iter->apply();
+	}
+}
+
+class LLAsyncGeometryTask : public LLTaskScheduler::Task
+{
+public:
+	LLAsyncGeometryTask(LLAsyncGeometry* geometry) : mGeometry(geometry), mClaim(geometry->mClaim) { }
+
+	// mGeometry is only valid while our claim stands; the main thread may
+	// have filled and freed it already otherwise.
+	/*virtual*/ void run()
+	{
+		if (mClaim->claim())
+		{
+			mGeometry->fill();
+			finish_async_geometry_job();
+		}
+	}
+
+	/*virtual*/ void cancelled()
+	{
+		if (mClaim->claim())
+		{ //left unfilled, apply() queues the rebuild again
+			finish_async_geometry_job();
+		}
+	}
+
+private:
+	LLAsyncGeometry* mGeometry;
+	LLPointer<LLAsyncGeometry::Claim> mClaim;
+};
+
+void LLVolumeGeometryManager::scheduleAsyncGeometry(LLSpatialGroup* group, std::vector<LLFace*>* face_lists[], U32 list_count,
+													LLSpatialGroup::draw_map_t& draw_map, LLSpatialGroup::buffer_map_t& buffer_map)
+{
+	if (!sAsyncGeometryDone)
+	{
+		sAsyncGeometryDone = new LLCondition(NULL);
+	}
+
+	LLAsyncGeometry* geometry = new LLAsyncGeometry;
+	geometry->mGroup = group;
+	geometry->mJobID = ++group->mGeometryJob;
+	group->setState(LLSpatialGroup::GEOM_PENDING);
+	geometry->mDrawMap.swap(draw_map);
+	geometry->mBufferMap.swap(buffer_map);
+
+	std::map<LLVertexBuffer*, U32> buffer_index;
+
+	for (U32 l = 0; l < list_count; l++)
+	{
+		std::vector<LLFace*>& faces = *face_lists[l];
+		for (std::vector<LLFace*>::iterator iter = faces.begin(); iter != faces.end(); ++iter)
+		{
+			LLFace* facep = *iter;
+			LLVertexBuffer* vb = facep->mVertexBuffer;
+			if (!vb)
+			{
+				continue;
+			}
+
+			std::map<LLVertexBuffer*, U32>::iterator found = buffer_index.find(vb);
+			U32 index;
+			if (found == buffer_index.end())
+			{
+				index = geometry->mBuffers.size();
+				buffer_index[vb] = index;
+				geometry->mBuffers.push_back(LLAsyncGeometry::Buffer());
+				LLAsyncGeometry::Buffer& buffer = geometry->mBuffers.back();
+				buffer.mBuffer = vb;
+				buffer.mVertexData.resize(vb->getSize());
+				buffer.mIndexData.resize(vb->getIndicesSize());
+				buffer.mStride = vb->getStride();
+				for (S32 type = 0; type < LLVertexBuffer::TYPE_MAX; type++)
+				{
+					buffer.mHasType[type] = vb->hasDataType(type);
+					buffer.mOffsets[type] = vb->getOffset(type);
+				}
+			}
+			else
+			{
+				index = found->second;
+			}
+
+			LLDrawable* drawablep = facep->getDrawable();
+			LLVOVolume* vobj = drawablep->getVOVolume();
+			LLVolume* volume = vobj->getVolume();
+
+			LLAsyncGeometry::Face face;
+			if (facep->prepareGeometryVolume(*volume, facep->getTEOffset(),
+				vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), facep->getGeomIndex(), face.mParams, TRUE))
+			{
+				face.mBuffer = index;
+				face.mGeomIndex = facep->getGeomIndex();
+				face.mIndicesIndex = facep->getIndicesStart();
+				geometry->mFaces.push_back(face);
+				if (geometry->mVolumes.empty() || geometry->mVolumes.back() != volume)
+				{
+					geometry->mVolumes.push_back(volume);
+				}
+			}
+		}
+	}
+
+	for (LLSpatialGroup::element_iter drawable_iter = group->getData().begin(); drawable_iter != group->getData().end(); ++drawable_iter)
+	{
+		LLDrawable* drawablep = *drawable_iter;
+		drawablep->clearState(LLDrawable::REBUILD_ALL);
+	}
+
+	sAsyncGeometry.push_back(geometry);
+
+	sAsyncGeometryDone->lock();
+	sAsyncGeometryPending++;
+	sAsyncGeometryDone->unlock();
+
+	LLTaskScheduler::getInstance()->schedule(new LLAsyncGeometryTask(geometry), LLTaskScheduler::LANE_HIGH);
+}
+
+//static
+void LLVolumeGeometryManager::finishAsyncGeometry()
+{
+	if (sAsyncGeometry.empty())
+	{
+		return;
+	}
+
+	LLFastTimer ftm(LLFastTimer::FTM_REBUILD_VBO);
+
+	// fill whatever no worker has started yet, then wait only for the
+	// fills already running
+	for (U32 i = 0; i < sAsyncGeometry.size(); i++)
+	{
+		LLAsyncGeometry* geometry = sAsyncGeometry[i];
+		if (geometry->mClaim->claim())
+		{
+			geometry->fill();
+			finish_async_geometry_job();
+		}
+	}
+
+	sAsyncGeometryDone->lock();
+	while (sAsyncGeometryPending > 0)
+	{
+		sAsyncGeometryDone->wait();
+	}
+	sAsyncGeometryDone->unlock();
+
+	for (U32 i = 0; i < sAsyncGeometry.size(); i++)
+	{
+		LLAsyncGeometry* geometry = sAsyncGeometry[i];
+		geometry->apply();
+		delete geometry;
+	}
+	sAsyncGeometry.clear();
+}
+
 void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 {
+	if (group->isState(LLSpatialGroup::GEOM_PENDING))
+	{ //the faces point at buffers still being filled, update them once they're in
+		return;
+	}
+
 	if (group->isState(LLSpatialGroup::MESH_DIRTY))
 	{
 		S32 num_mapped_veretx_buffer = LLVertexBuffer::sMappedCount ;
@@ -2622,7 +3046,7 @@ void LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, std::
 			facep->mVertexBuffer = buffer;
 			{
 				facep->updateRebuildFlags();
-				if (!LLPipeline::sDelayVBUpdate)
+				if (!LLPipeline::sDelayVBUpdate && !use_async_geometry())
 				{
 					LLDrawable* drawablep = facep->getDrawable();
 					LLVOVolume* vobj = drawablep->getVOVolume();
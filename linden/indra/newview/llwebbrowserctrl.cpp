@@ -79,6 +79,9 @@ LLWebBrowserCtrl::LLWebBrowserCtrl( const std::string& name, const LLRect& rect
 	mTakeFocusOnClick( true ),
 	mCurrentNavUrl( "about:blank" )
 {
+	// media frames arrive without invalidating us
+	setDrawsLive(TRUE);
+
 	S32 screen_width = mIgnoreUIScale ? 
 		llround((F32)getRect().getWidth() * LLUI::sGLScaleFactor.mV[VX]) : getRect().getWidth();
 	S32 screen_height = mIgnoreUIScale ? 
@@ -1224,6 +1224,15 @@ void LLWorld::getAvatars(std::vector<LLUUID>* avatar_ids, std::vector<LLVector3d
 	{
 		LLViewerRegion* regionp = *iter;
 		const LLVector3d& origin_global = regionp->getOriginGlobal();
+		F64 region_width = regionp->getWidth();
+		if (origin_global.mdV[VX] - radius > relative_to.mdV[VX] ||
+			origin_global.mdV[VX] + region_width + radius < relative_to.mdV[VX] ||
+			origin_global.mdV[VY] - radius > relative_to.mdV[VY] ||
+			origin_global.mdV[VY] + region_width + radius < relative_to.mdV[VY])
+		{
+			// nobody in this region is close enough
+			continue;
+		}
 		S32 count = regionp->mMapAvatars.count();
 		for (S32 i = 0; i < count; i++)
 		{
@@ -1244,6 +1253,59 @@ void LLWorld::getAvatars(std::vector<LLUUID>* avatar_ids, std::vector<LLVector3d
 }
 
 
+void LLWorld::getAvatarsInSquare(const LLVector3d& center, F64 half_width,
+	std::vector<LLUUID>* avatar_ids, std::vector<LLVector3d>* positions) const
+{
+	if(avatar_ids != NULL)
+	{
+		avatar_ids->clear();
+	}
+	if(positions != NULL)
+	{
+		positions->clear();
+	}
+	std::vector<S32> found;
+	for (LLWorld::region_list_t::const_iterator iter = mActiveRegionList.begin();
+		iter != mActiveRegionList.end(); ++iter)
+	{
+		LLViewerRegion* regionp = *iter;
+		const LLVector3d& origin_global = regionp->getOriginGlobal();
+		F64 region_width = regionp->getWidth();
+		if (origin_global.mdV[VX] > center.mdV[VX] + half_width ||
+			origin_global.mdV[VX] + region_width < center.mdV[VX] - half_width ||
+			origin_global.mdV[VY] > center.mdV[VY] + half_width ||
+			origin_global.mdV[VY] + region_width < center.mdV[VY] - half_width)
+		{
+			continue;
+		}
+
+		// coarse locations are whole meters within the region
+		F64 min_x = ceil(center.mdV[VX] - half_width - origin_global.mdV[VX]);
+		F64 max_x = floor(center.mdV[VX] + half_width - origin_global.mdV[VX]);
+		F64 min_y = ceil(center.mdV[VY] - half_width - origin_global.mdV[VY]);
+		F64 max_y = floor(center.mdV[VY] + half_width - origin_global.mdV[VY]);
+		if (max_x < 0.0 || max_y < 0.0 || min_x > 255.0 || min_y > 255.0)
+		{
+			continue;
+		}
+		found.clear();
+		regionp->getMapAvatarsInRect((U32)llmax(min_x, 0.0), (U32)llmax(min_y, 0.0),
+									 (U32)llmin(max_x, 255.0), (U32)llmin(max_y, 255.0), found);
+		for (std::vector<S32>::const_iterator it = found.begin(); it != found.end(); ++it)
+		{
+			if(positions != NULL)
+			{
+				positions->push_back(unpackLocalToGlobalPosition(regionp->mMapAvatars.get(*it), origin_global));
+			}
+			if(avatar_ids != NULL)
+			{
+				avatar_ids->push_back(regionp->mMapAvatarIDs.get(*it));
+			}
+		}
+	}
+}
+
+
 LLHTTPRegistration<LLEstablishAgentCommunication>
 	gHTTPRegistrationEstablishAgentCommunication(
 							"/message/EstablishAgentCommunication");
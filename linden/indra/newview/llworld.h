@@ -161,6 +161,13 @@ public:
 		std::vector<LLVector3d>* positions = NULL, 
 		const LLVector3d& relative_to = LLVector3d(), F32 radius = FLT_MAX) const;
 
+	// Like getAvatars(), but for the square of half width half_width
+	// around center, ignoring height.  Only regions overlapping the
+	// square are looked at, and each answers from its coarse location
+	// index (LLViewerRegion::getMapAvatarsInRect()).
+	void getAvatarsInSquare(const LLVector3d& center, F64 half_width,
+		std::vector<LLUUID>* avatar_ids, std::vector<LLVector3d>* positions) const;
+
 private:
 	region_list_t	mActiveRegionList;
 	region_list_t	mRegionList;
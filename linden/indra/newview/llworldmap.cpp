@@ -47,6 +47,7 @@
 #include "llviewerimagelist.h"
 #include "llviewerregion.h"
 #include "llregionflags.h"
+#include "lllrucache.h"
  #include "hippoGridManager.h"
 bool LLWorldMap::sGotMapURL =  false;
 const F32 REQUEST_ITEMS_TIMER =  10.f * 60.f; // 10 minutes
@@ -100,6 +101,42 @@ LLVector3d LLSimInfo::getGlobalPos(LLVector3 local_pos) const
 	return pos;
 }
 
+void LLSimInfo::clearImages()
+{
+	if (mCurrentImage)
+	{
+		mCurrentImage->setBoostLevel(0);
+		mCurrentImage = NULL;
+	}
+	if (mOverlayImage)
+	{
+		mOverlayImage->setBoostLevel(0);
+		mOverlayImage = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Map tile cache
+//---------------------------------------------------------------------------
+
+// Regions whose tiles are held, most recently drawn first.  Evicted
+// regions drop their image references so the image list can free them.
+class LLWorldMapTileCache : public LLLRUCache<U64, bool>
+{
+public:
+	LLWorldMapTileCache(U32 max_size) : LLLRUCache<U64, bool>(max_size) {}
+
+protected:
+	virtual void evicted(const U64& handle, bool& value)
+	{
+		LLSimInfo* info = LLWorldMap::getInstance()->simInfoFromHandle(handle);
+		if (info)
+		{
+			info->clearImages();
+		}
+	}
+};
+
 
 //---------------------------------------------------------------------------
 // World Map
@@ -125,7 +162,8 @@ LLWorldMap::LLWorldMap() :
 	mSLURLRegionHandle(0),
 	mSLURL(),
 	mSLURLCallback(0),
-	mSLURLTeleport(false)
+	mSLURLTeleport(false),
+	mTileCache(new LLWorldMapTileCache(256))
 {
 	for (S32 map=0; map<MAP_SIM_IMAGE_TYPES; ++map)
 	{
@@ -146,6 +184,7 @@ LLWorldMap::~LLWorldMap()
 	{
 		delete[] mMapBlockLoaded[map];
 	}
+	delete mTileCache;
 }
 
 
@@ -153,6 +192,8 @@ void LLWorldMap::reset()
 {
 	for_each(mSimInfoMap.begin(), mSimInfoMap.end(), DeletePairedPointer());
 	mSimInfoMap.clear();
+	mSimIndex.clear();
+	mTileCache->clear();
 
 	for (S32 m=0; m<MAP_SIM_IMAGE_TYPES; ++m)
 	{
@@ -205,18 +246,9 @@ void LLWorldMap::clearImageRefs()
 {
 	for (sim_info_map_t::iterator it = mSimInfoMap.begin(); it != mSimInfoMap.end(); ++it)
 	{
-		LLSimInfo* info = (*it).second;
-		if (info->mCurrentImage)
-		{
-			info->mCurrentImage->setBoostLevel(0);
-			info->mCurrentImage = NULL;
-		}
-		if (info->mOverlayImage)
-		{
-			info->mOverlayImage->setBoostLevel(0);
-			info->mOverlayImage = NULL;
-		}
+		(*it).second->clearImages();
 	}
+	mTileCache->clear();
 }
 
 // Doesn't clear the already-loaded sim infos, just re-requests them
@@ -237,6 +269,40 @@ LLSimInfo* LLWorldMap::simInfoFromPosGlobal(const LLVector3d& pos_global)
 	return simInfoFromHandle(handle);
 }
 
+void LLWorldMap::addSimInfo(U64 handle, LLSimInfo* info)
+{
+	sim_info_map_t::iterator it = mSimInfoMap.find(handle);
+	if (it != mSimInfoMap.end())
+	{
+		delete it->second;
+		it->second = info;
+		return;
+	}
+	mSimInfoMap[handle] = info;
+
+	U32 x_meters, y_meters;
+	from_region_handle(handle, &x_meters, &y_meters);
+	mSimIndex.insert(x_meters / REGION_WIDTH_UNITS, y_meters / REGION_WIDTH_UNITS, handle);
+}
+
+void LLWorldMap::getSimHandlesInGrid(U32 min_x, U32 min_y, U32 max_x, U32 max_y,
+									 std::vector<U64>& handles) const
+{
+	mSimIndex.query(min_x, min_y, max_x, max_y, handles);
+}
+
+void LLWorldMap::touchSimTiles(U64 handle, U32 max_tiles)
+{
+	if (mTileCache->getMaxSize() != max_tiles)
+	{
+		mTileCache->setMaxSize(max_tiles);
+	}
+	if (!mTileCache->find(handle))
+	{
+		mTileCache->insert(handle, true);
+	}
+}
+
 LLSimInfo* LLWorldMap::simInfoFromHandle(const U64 handle)
 {
 	sim_info_map_t::iterator it = mSimInfoMap.find(handle);
@@ -652,17 +718,15 @@ void LLWorldMap::processMapBlockReply(LLMessageSystem* msg, void**)
 // 			llinfos << "Map sim " << name << " image layer " << agent_flags << " ID " << image_id.getString() << llendl;
 			
 			LLSimInfo* siminfo = new LLSimInfo();
-			sim_info_map_t::iterator iter = LLWorldMap::getInstance()->mSimInfoMap.find(handle);
-			if (iter != LLWorldMap::getInstance()->mSimInfoMap.end())
+			LLSimInfo* oldinfo = LLWorldMap::getInstance()->simInfoFromHandle(handle);
+			if (oldinfo)
 			{
-				LLSimInfo* oldinfo = iter->second;
 				for (S32 image=0; image<MAP_SIM_IMAGE_TYPES; ++image)
 				{
 					siminfo->mMapImageID[image] = oldinfo->mMapImageID[image];
 				}
-				delete oldinfo;
 			}
-			LLWorldMap::getInstance()->mSimInfoMap[handle] = siminfo;
+			LLWorldMap::getInstance()->addSimInfo(handle, siminfo);
 
 			siminfo->mHandle = handle;
 			siminfo->mName.assign( name );
@@ -40,6 +40,7 @@
 #include "v3math.h"
 #include "v3dmath.h"
 #include "llframetimer.h"
+#include "llgridquadtree.h"
 #include "llmapimagetype.h"
 #include "lluuid.h"
 #include "llmemory.h"
@@ -48,6 +49,7 @@
 #include "v3color.h"
 
 class LLMessageSystem;
+class LLWorldMapTileCache;
 
 
 class LLItemInfo
@@ -79,6 +81,9 @@ public:
 	// Get the world coordinates of the SW corner of that region
 	LLVector3d getGlobalOrigin() const;
 
+	// Drops the references to the map tile images.
+	void clearImages();
+
 public:
 	U64 mHandle;
 	std::string mName;
@@ -143,6 +148,20 @@ public:
 	// Returns simulator information for named sim, or NULL if non-existent
 	LLSimInfo* simInfoFromName(const std::string& sim_name);
 
+	// Adds or replaces the information for a region and takes ownership
+	// of it.  Use this rather than writing to mSimInfoMap.
+	void addSimInfo(U64 handle, LLSimInfo* info);
+
+	// Appends the handles of known regions whose grid position (origin
+	// in region widths) lies in the given inclusive range.
+	void getSimHandlesInGrid(U32 min_x, U32 min_y, U32 max_x, U32 max_y,
+							 std::vector<U64>& handles) const;
+
+	// Marks a region's map tiles as just drawn.  Once more than max_tiles
+	// regions hold tiles, the least recently drawn ones let theirs go;
+	// they are fetched again, usually from the texture cache, if needed.
+	void touchSimTiles(U64 handle, U32 max_tiles);
+
 	// Gets simulator name for a global position, returns true if it was found
 	bool simNameFromPosGlobal(const LLVector3d& pos_global, std::string& outSimName );
 
@@ -233,6 +252,10 @@ private:
 	url_callback_t mSLURLCallback;
 	bool mSLURLTeleport;
 
+	// Region handles by grid position, for finding the regions in view
+	LLGridQuadTree<U64> mSimIndex;
+	LLWorldMapTileCache* mTileCache;
+
 	static bool sGotMapURL;
 };
 
@@ -179,6 +179,9 @@ LLWorldMapView::LLWorldMapView(const std::string& name, const LLRect& rect )
 	mMouseDownY( 0 ),
 	mSelectIDStart(0)
 {
+	// tiles, avatars and the tracking beacon change without invalidating us
+	setDrawsLive(TRUE);
+
 	sPixelsPerMeter = sMapScale / REGION_WIDTH_METERS;
 	clearLastClick();
 
@@ -301,7 +304,8 @@ void LLWorldMapView::draw()
 
 	F64 current_time = LLTimer::getElapsedSeconds();
 
-	mVisibleRegions.clear();
+	handle_list_t previous_regions;
+	previous_regions.swap(mVisibleRegions);
 	
 	// animate pan if necessary
 	sPanX = lerp(sPanX, sTargetPanX, LLCriticalDamp::getInterpolant(0.1f));
@@ -441,24 +445,41 @@ void LLWorldMapView::draw()
 
 	bool use_web_map_tiles = LLWorldMap::useWebMapTiles();
 
-	for (LLWorldMap::sim_info_map_t::iterator it = LLWorldMap::getInstance()->mSimInfoMap.begin();
-		 it != LLWorldMap::getInstance()->mSimInfoMap.end(); ++it)
+	// Only visit the regions under the view, looked up in the map's grid
+	// index.  A region is drawn from its south west corner, so reach one
+	// region further on that side.
+	std::vector<U64> region_handles;
+	if (sMapScale >= SIM_MAP_SCALE)
 	{
-		U64 handle = (*it).first;
-		LLSimInfo* info = (*it).second;
+		F64 meters_per_pixel = REGION_WIDTH_METERS / sMapScale;
+		S32 min_x = llfloor((camera_global.mdV[VX] - (half_width + sPanX) * meters_per_pixel) / REGION_WIDTH_METERS) - 1;
+		S32 min_y = llfloor((camera_global.mdV[VY] - (half_height + sPanY) * meters_per_pixel) / REGION_WIDTH_METERS) - 1;
+		S32 max_x = llfloor((camera_global.mdV[VX] + (half_width - sPanX) * meters_per_pixel) / REGION_WIDTH_METERS);
+		S32 max_y = llfloor((camera_global.mdV[VY] + (half_height - sPanY) * meters_per_pixel) / REGION_WIDTH_METERS);
+		if (max_x >= 0 && max_y >= 0)
+		{
+			LLWorldMap::getInstance()->getSimHandlesInGrid(llmax(min_x, 0), llmax(min_y, 0),
+														   max_x, max_y, region_handles);
+		}
+	}
 
-		LLViewerImage* simimage = info->mCurrentImage;
-		LLViewerImage* overlayimage = info->mOverlayImage;
+	// Keep tiles for at least twice the regions in view, so that panning
+	// back and forth does not refetch them.
+	U32 max_tiles = llmax(gSavedSettings.getU32("MapTileCacheSize"), (U32)region_handles.size() * 2);
 
-		if (sMapScale < SIM_MAP_SCALE)
+	for (std::vector<U64>::iterator it = region_handles.begin(); it != region_handles.end(); ++it)
+	{
+		U64 handle = *it;
+		LLSimInfo* info = LLWorldMap::getInstance()->simInfoFromHandle(handle);
+		if (!info)
 		{
-			if (simimage != NULL) simimage->setBoostLevel(0);
-			if (overlayimage != NULL) overlayimage->setBoostLevel(0);
 			continue;
 		}
-		
+
+		LLViewerImage* simimage = info->mCurrentImage;
+		LLViewerImage* overlayimage = info->mOverlayImage;
+
 		LLVector3d origin_global = from_region_handle(handle);
-		LLVector3d camera_global = gAgent.getCameraPositionGlobal();
 
 		// Find x and y position relative to camera's center.
 		LLVector3d rel_region_pos = origin_global - camera_global;
@@ -551,6 +572,11 @@ void LLWorldMapView::draw()
 			}
 		}
 
+		if (simimage != NULL || overlayimage != NULL)
+		{
+			LLWorldMap::getInstance()->touchSimTiles(handle, max_tiles);
+		}
+
 		mVisibleRegions.push_back(handle);
 		// See if the agents need updating
 		if (current_time - info->mAgentsUpdateTime > AGENTS_UPDATE_TIME)
@@ -766,6 +792,23 @@ void LLWorldMapView::draw()
 	}
 	// #endif used to be here
 
+	// Regions that left the view since the last frame are not visited
+	// above, so drop the boost on their tiles here.
+	std::sort(mVisibleRegions.begin(), mVisibleRegions.end());
+	for (handle_list_t::iterator it = previous_regions.begin(); it != previous_regions.end(); ++it)
+	{
+		if (std::binary_search(mVisibleRegions.begin(), mVisibleRegions.end(), *it))
+		{
+			continue;
+		}
+		LLSimInfo* info = LLWorldMap::getInstance()->simInfoFromHandle(*it);
+		if (info)
+		{
+			if (info->mCurrentImage.notNull()) info->mCurrentImage->setBoostLevel(0);
+			if (info->mOverlayImage.notNull()) info->mOverlayImage->setBoostLevel(0);
+		}
+	}
+
 
 	// there used to be an #if 1 here, but it was uncommented; perhaps marking a block of code?
 	// Draw background rectangle
@@ -101,6 +101,9 @@
 #include "llwaterparammanager.h"
 #include "llspatialpartition.h"
 #include "llmutelist.h"
+#include "llsurface.h"
+#include "llsurfacepatch.h"
+#include "lltaskscheduler.h"
 
 #ifdef _DEBUG
 // Debug indices is disabled for now for debug performance - djs 4/24/02
@@ -224,6 +227,7 @@ S32		LLPipeline::sCompiles = 0;
 
 BOOL	LLPipeline::sPickAvatar = TRUE;
 BOOL	LLPipeline::sDynamicLOD = TRUE;
+BOOL	LLPipeline::sParallelCull = TRUE;
 BOOL	LLPipeline::sShowHUDAttachments = TRUE;
 BOOL	LLPipeline::sRenderPhysicalBeacons = TRUE;
 BOOL	LLPipeline::sRenderScriptedBeacons = FALSE;
@@ -235,6 +239,9 @@ BOOL	LLPipeline::sRenderHighlight = TRUE;
 BOOL	LLPipeline::sForceOldBakedUpload = FALSE;
 S32		LLPipeline::sUseOcclusion = 0;
 BOOL	LLPipeline::sDelayVBUpdate = TRUE;
+BOOL	LLPipeline::sAsyncVBUpdate = TRUE;
+BOOL	LLPipeline::sMergeBatches = TRUE;
+BOOL	LLPipeline::sSoftwareOcclusion = FALSE;
 BOOL	LLPipeline::sFastAlpha = TRUE;
 BOOL	LLPipeline::sDisableShaders = FALSE;
 BOOL	LLPipeline::sRenderBump = TRUE;
@@ -277,6 +284,10 @@ void addDeferredAttachments(LLRenderTarget& target)
 LLPipeline::LLPipeline() :
 	mBackfaceCull(FALSE),
 	mBatchCount(0),
+	mBatchesMerged(0),
+	mSoftwareOcclusionTests(0),
+	mSoftwareOcclusionCulled(0),
+	mQueryOcclusionCulled(0),
 	mMatrixOpCount(0),
 	mTextureMatrixOps(0),
 	mMaxBatchSize(0),
@@ -320,6 +331,7 @@ void LLPipeline::init()
 	LLMemType mt(LLMemType::MTYPE_PIPELINE);
 
 	sDynamicLOD = gSavedSettings.getBOOL("RenderDynamicLOD");
+	sParallelCull = gSavedSettings.getBOOL("RenderParallelCull");
 	sRenderBump = gSavedSettings.getBOOL("RenderObjectBump");
 	sRenderAttachedLights = gSavedSettings.getBOOL("RenderAttachedLights");
 	sRenderAttachedParticles = gSavedSettings.getBOOL("RenderAttachedParticles");
@@ -373,6 +385,11 @@ void LLPipeline::cleanup()
 {
 	assertInitialized();
 
+	LLVolumeGeometryManager::finishAsyncGeometry();
+
+	mBoxOccluders.clear();
+	mOcclusionBuffer.invalidate();
+
 	for(pool_set_t::iterator iter = mPools.begin();
 		iter != mPools.end(); )
 	{
@@ -1388,6 +1405,60 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 
 	LLGLDepthTest depth(GL_TRUE, GL_FALSE);
 
+	BOOL software_occlusion = sSoftwareOcclusion &&
+							  !hasRenderType(LLPipeline::RENDER_TYPE_HUD) &&
+							  !sReflectionRender &&
+							  !sShadowRender;
+	if (software_occlusion)
+	{
+		updateSoftwareOcclusion(camera);
+	}
+	else if (!sSoftwareOcclusion)
+	{ //don't hold on to occluders while switched off
+		mBoxOccluders.clear();
+	}
+
+	if (sParallelCull && LLTaskScheduler::getInstance())
+	{ //run the frustum tests of every partition on the worker pool first
+		LLFastTimer ftm(LLFastTimer::FTM_CULL_PRECULL);
+
+		const LLWorld::region_list_t& regions = LLWorld::getInstance()->getRegionList();
+		std::vector<LLCamera> region_cameras;
+		region_cameras.reserve(regions.size());
+		std::vector<LLSpatialPartition*> parts;
+		std::vector<LLCamera*> cameras;
+
+		for (LLWorld::region_list_t::const_iterator iter = regions.begin(); iter != regions.end(); ++iter)
+		{
+			LLViewerRegion* region = *iter;
+			region_cameras.push_back(camera);
+			LLCamera& region_camera = region_cameras.back();
+			if (water_clip != 0)
+			{
+				LLPlane plane(LLVector3(0,0, (F32) -water_clip), (F32) water_clip*region->getWaterHeight());
+				region_camera.setUserClipPlane(plane);
+			}
+			else
+			{
+				region_camera.disableUserClipPlane();
+			}
+
+			for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
+			{
+				LLSpatialPartition* part = region->getSpatialPartition(i);
+				if (part && hasRenderType(part->mDrawableType))
+				{
+					parts.push_back(part);
+					cameras.push_back(&region_camera);
+				}
+			}
+		}
+
+		LLSpatialPartition::precull(parts, cameras);
+	}
+
+	mPartitionCullTime.assign(LLViewerRegion::NUM_PARTITIONS, 0.f);
+
 	for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin(); 
 			iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
 	{
@@ -1410,6 +1481,7 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 				if (hasRenderType(part->mDrawableType))
 				{
 					part->cull(camera);
+					mPartitionCullTime[i] += part->mCullTime + part->mPrecullTime;
 				}
 			}
 		}
@@ -1417,6 +1489,19 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 
 	camera.disableUserClipPlane();
 
+	if (software_occlusion)
+	{
+		mOcclusionBuffer.invalidate();
+		gatherBoxOccluders(camera);
+	}
+
+	LL_DEBUGS("CullTiming") << "partition cull times (ms):";
+	for (U32 i = 0; i < mPartitionCullTime.size(); i++)
+	{
+		LL_CONT << " " << i << "=" << mPartitionCullTime[i] * 1000.f;
+	}
+	LL_CONT << LL_ENDL;
+
 	// Render non-windlight sky.
 	if (hasRenderType(LLPipeline::RENDER_TYPE_SKY) &&
 	    gSky.mVOSkyp.notNull() &&
@@ -1544,6 +1629,263 @@ void LLPipeline::doOcclusion(LLCamera& camera)
 	gGL.setColorMask(true, false);
 	glFlush();
 }
+
+// Terrain is drawn into the software occlusion buffer as one flat cell per
+// surface patch at the patch's lowest height, joined by vertical walls.  Any
+// terrain LOD only interpolates between the patch's own height samples (its
+// stitched edges included), so the real surface never dips below that.  Cells
+// any smaller would not hold, since a coarse LOD triangle spans samples from
+// well outside them.  The margin covers height data that has arrived but not
+// been rebuilt into the drawn patch yet.
+static const F32 TERRAIN_OCCLUDER_MARGIN = 0.5f;
+
+// box prims smaller than this on either of their two longest sides hide too
+// little to be worth drawing
+static const F32 MIN_BOX_OCCLUDER_SIZE = 2.f;
+static const U32 MAX_BOX_OCCLUDERS = 128;
+
+static void add_terrain_occluders(LLOcclusionBuffer& buffer, LLViewerRegion* region, LLCamera& camera)
+{
+	const LLSurface& land = region->getLand();
+	S32 cells = land.getPatchesPerEdge();
+	if (cells < 1)
+	{
+		return;
+	}
+
+	const F32 cell_width = land.getMetersPerGrid() * land.getGridsPerPatchEdge();
+	const LLVector3 origin = land.getOriginAgent();
+	const LLVector3& cam_pos = camera.getOrigin();
+	const LLVector3& cam_at = camera.getAtAxis();
+	const F32 far_clip = camera.getFar();
+
+	std::vector<F32> heights(cells * cells);
+	for (S32 j = 0; j < cells; j++)
+	{
+		for (S32 i = 0; i < cells; i++)
+		{
+			LLSurfacePatch* patchp = land.resolvePatchRegion((i + 0.5f) * cell_width, (j + 0.5f) * cell_width);
+			heights[j * cells + i] = patchp->getMinZ() + origin.mV[VZ] - TERRAIN_OCCLUDER_MARGIN;
+		}
+	}
+
+	for (S32 j = 0; j < cells; j++)
+	{
+		for (S32 i = 0; i < cells; i++)
+		{
+			F32 x0 = origin.mV[VX] + i * cell_width;
+			F32 y0 = origin.mV[VY] + j * cell_width;
+			F32 x1 = x0 + cell_width;
+			F32 y1 = y0 + cell_width;
+			F32 h = heights[j * cells + i];
+
+			LLVector3 center(x0 + cell_width * 0.5f, y0 + cell_width * 0.5f, h);
+			LLVector3 to_cell = center - cam_pos;
+			if (to_cell * cam_at < -cell_width ||
+				to_cell.magVec() > far_clip + cell_width)
+			{ //behind the camera or past the draw distance
+				continue;
+			}
+
+			buffer.addQuad(LLVector3(x0, y0, h), LLVector3(x1, y0, h), LLVector3(x1, y1, h), LLVector3(x0, y1, h));
+
+			if (i + 1 < cells)
+			{
+				F32 h2 = heights[j * cells + i + 1];
+				if (h2 != h)
+				{
+					F32 lo = llmin(h, h2), hi = llmax(h, h2);
+					buffer.addQuad(LLVector3(x1, y0, lo), LLVector3(x1, y1, lo), LLVector3(x1, y1, hi), LLVector3(x1, y0, hi));
+				}
+			}
+			if (j + 1 < cells)
+			{
+				F32 h2 = heights[(j + 1) * cells + i];
+				if (h2 != h)
+				{
+					F32 lo = llmin(h, h2), hi = llmax(h, h2);
+					buffer.addQuad(LLVector3(x0, y1, lo), LLVector3(x1, y1, lo), LLVector3(x1, y1, hi), LLVector3(x0, y1, hi));
+				}
+			}
+		}
+	}
+}
+
+// TRUE if drawable is a static, opaque, uncut box prim, which fills its
+// scaled transform exactly and so can be drawn as an occluder.
+static BOOL is_box_occluder(LLDrawable* drawable)
+{
+	if (drawable->isDead() || drawable->isActive())
+	{
+		return FALSE;
+	}
+
+	LLVOVolume* vobj = drawable->getVOVolume();
+	if (!vobj || vobj->isFlexible() || vobj->isSculpted() || vobj->isAttachment() || !vobj->getVolume())
+	{
+		return FALSE;
+	}
+
+	LLVector3 scale = vobj->getScale();
+	F32 dims[3] = { scale.mV[VX], scale.mV[VY], scale.mV[VZ] };
+	std::sort(dims, dims + 3);
+	if (dims[1] < MIN_BOX_OCCLUDER_SIZE)
+	{
+		return FALSE;
+	}
+
+	const LLVolumeParams& params = vobj->getVolume()->getParams();
+	const LLProfileParams& profile = params.getProfileParams();
+	const LLPathParams& path = params.getPathParams();
+
+	if ((profile.getCurveType() & LL_PCODE_PROFILE_MASK) != LL_PCODE_PROFILE_SQUARE ||
+		profile.getBegin() != 0.f || profile.getEnd() != 1.f || profile.getHollow() != 0.f)
+	{
+		return FALSE;
+	}
+
+	if (path.getCurveType() != LL_PCODE_PATH_LINE ||
+		path.getBegin() != 0.f || path.getEnd() != 1.f ||
+		path.getScaleX() != 1.f || path.getScaleY() != 1.f ||
+		path.getShearX() != 0.f || path.getShearY() != 0.f ||
+		path.getTwistBegin() != 0.f || path.getTwist() != 0.f ||
+		path.getTaperX() != 0.f || path.getTaperY() != 0.f)
+	{
+		return FALSE;
+	}
+
+	for (S32 i = 0; i < drawable->getNumFaces(); i++)
+	{
+		LLFace* face = drawable->getFace(i);
+		if (!face ||
+			face->getPoolType() == LLDrawPool::POOL_ALPHA ||
+			face->getPoolType() == LLDrawPool::POOL_INVISIBLE)
+		{
+			return FALSE;
+		}
+
+		const LLTextureEntry* te = face->getTextureEntry();
+		if (!te || te->getColor().mV[3] < 1.f)
+		{
+			return FALSE;
+		}
+
+		LLViewerImage* image = face->getTexture();
+		if (image && image->getComponents() == 4)
+		{ //may have alpha masked holes
+			return FALSE;
+		}
+	}
+
+	return drawable->getNumFaces() > 0;
+}
+
+static void add_box_occluder(LLOcclusionBuffer& buffer, LLDrawable* drawable)
+{
+	LLVector3 half = drawable->getVObj()->getScale() * 0.5f;
+	const LLMatrix4& mat = drawable->getWorldMatrix();
+
+	LLVector3 v[8];
+	for (S32 i = 0; i < 8; i++)
+	{
+		LLVector3 corner((i & 1) ? half.mV[VX] : -half.mV[VX],
+						 (i & 2) ? half.mV[VY] : -half.mV[VY],
+						 (i & 4) ? half.mV[VZ] : -half.mV[VZ]);
+		v[i] = corner * mat;
+	}
+
+	buffer.addQuad(v[0], v[1], v[3], v[2]); // -z
+	buffer.addQuad(v[4], v[5], v[7], v[6]); // +z
+	buffer.addQuad(v[0], v[1], v[5], v[4]); // -y
+	buffer.addQuad(v[2], v[3], v[7], v[6]); // +y
+	buffer.addQuad(v[0], v[2], v[6], v[4]); // -x
+	buffer.addQuad(v[1], v[3], v[7], v[5]); // +x
+}
+
+void LLPipeline::updateSoftwareOcclusion(LLCamera& camera)
+{
+	LLFastTimer t(LLFastTimer::FTM_CULL_OCCLUDERS);
+
+	mOcclusionBuffer.begin(camera);
+
+	if (hasRenderType(LLPipeline::RENDER_TYPE_TERRAIN))
+	{
+		for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin(); 
+			 iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
+		{
+			add_terrain_occluders(mOcclusionBuffer, *iter, camera);
+		}
+	}
+
+	if (hasRenderType(LLPipeline::RENDER_TYPE_VOLUME))
+	{
+		for (U32 i = 0; i < mBoxOccluders.size(); i++)
+		{
+			LLDrawable* drawable = mBoxOccluders[i];
+			if (!drawable->isDead() && !drawable->isActive() && drawable->getVObj().notNull())
+			{
+				add_box_occluder(mOcclusionBuffer, drawable);
+			}
+		}
+	}
+
+	mOcclusionBuffer.rasterize(LLTaskScheduler::getInstance());
+}
+
+void LLPipeline::gatherBoxOccluders(LLCamera& camera)
+{
+	LLFastTimer t(LLFastTimer::FTM_CULL_OCCLUDERS);
+
+	std::vector<std::pair<F32, LLDrawable*> > candidates;
+
+	for (LLCullResult::sg_list_t::iterator iter = sCull->beginVisibleGroups(); iter != sCull->endVisibleGroups(); ++iter)
+	{
+		LLSpatialGroup* group = *iter;
+		if (group->mSpatialPartition->mPartitionType != LLViewerRegion::PARTITION_VOLUME)
+		{
+			continue;
+		}
+
+		for (LLSpatialGroup::element_iter i = group->getData().begin(); i != group->getData().end(); ++i)
+		{
+			LLDrawable* drawable = *i;
+			if (is_box_occluder(drawable))
+			{
+				// rank by roughly how much of the screen the box can cover
+				LLVector3 scale = drawable->getVObj()->getScale();
+				F32 dist_sq = llmax(dist_vec_squared(drawable->getPositionAgent(), camera.getOrigin()), 1.f);
+				F32 area = scale.mV[VX] * scale.mV[VY] + scale.mV[VY] * scale.mV[VZ] + scale.mV[VX] * scale.mV[VZ];
+				candidates.push_back(std::make_pair(area / dist_sq, drawable));
+			}
+		}
+	}
+
+	U32 count = llmin((U32) candidates.size(), MAX_BOX_OCCLUDERS);
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+					  std::greater<std::pair<F32, LLDrawable*> >());
+
+	mBoxOccluders.clear();
+	for (U32 i = 0; i < count; i++)
+	{
+		mBoxOccluders.push_back(candidates[i].second);
+	}
+}
+
+BOOL LLPipeline::isSoftwareOccluded(const LLVector3& center, const LLVector3& size)
+{
+	if (!mOcclusionBuffer.isReady())
+	{
+		return FALSE;
+	}
+
+	mSoftwareOcclusionTests++;
+	if (mOcclusionBuffer.isOccluded(center, size))
+	{
+		mSoftwareOcclusionCulled++;
+		return TRUE;
+	}
+	return FALSE;
+}
 	
 BOOL LLPipeline::updateDrawableGeom(LLDrawable* drawablep, BOOL priority)
 {
@@ -1566,6 +1908,9 @@ void LLPipeline::updateGeom(F32 max_dtime)
 
 	assertInitialized();
 
+	// normally done at the end of the last frame, the volumes are about to change
+	LLVolumeGeometryManager::finishAsyncGeometry();
+
 	if (sDelayedVBOEnable > 0)
 	{
 		if (--sDelayedVBOEnable <= 0)
@@ -2278,17 +2623,39 @@ void LLPipeline::postSort(LLCamera& camera)
 		
 	if (!sShadowRender)
 	{
-		//sort by texture or bump map
+		//sort by texture or bump map, then by vertex buffer so batches from the
+		//same buffer end up next to each other and can be merged
 		for (U32 i = 0; i < LLRenderPass::NUM_RENDER_TYPES; ++i)
 		{
 			if (i == LLRenderPass::PASS_BUMP)
 			{
-				std::sort(sCull->beginRenderMap(i), sCull->endRenderMap(i), LLDrawInfo::CompareBump());
+				std::sort(sCull->beginRenderMap(i), sCull->endRenderMap(i), LLDrawInfo::CompareBumpTextureBuffer());
 			}
 			else 
 			{
-				std::sort(sCull->beginRenderMap(i), sCull->endRenderMap(i), LLDrawInfo::CompareTexturePtrMatrix());
+				std::sort(sCull->beginRenderMap(i), sCull->endRenderMap(i), LLDrawInfo::CompareTextureMatrixBuffer());
 			}	
+
+			if (sMergeBatches)
+			{
+				switch (i)
+				{
+				case LLRenderPass::PASS_SIMPLE:
+				case LLRenderPass::PASS_FULLBRIGHT:
+				case LLRenderPass::PASS_INVISIBLE:
+				case LLRenderPass::PASS_INVISI_SHINY:
+				case LLRenderPass::PASS_FULLBRIGHT_SHINY:
+				case LLRenderPass::PASS_SHINY:
+				case LLRenderPass::PASS_BUMP:
+				case LLRenderPass::PASS_GLOW:
+				case LLRenderPass::PASS_ALPHA_MASK:
+				case LLRenderPass::PASS_FULLBRIGHT_ALPHA_MASK:
+					mBatchesMerged += sCull->mergeRenderMap(i);
+					break;
+				default: //grass and alpha draw order matters
+					break;
+				}
+			}
 		}
 
 		std::sort(sCull->beginAlphaGroups(), sCull->endAlphaGroups(), LLSpatialGroup::CompareDepthGreater());
@@ -4844,6 +5211,8 @@ void LLPipeline::resetVertexBuffers(LLDrawable* drawable)
 
 void LLPipeline::resetVertexBuffers()
 {
+	LLVolumeGeometryManager::finishAsyncGeometry();
+
 	sRenderBump = gSavedSettings.getBOOL("RenderObjectBump");
 
 	for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin(); 
@@ -45,6 +45,7 @@
 #include "llgl.h"
 #include "lldrawable.h"
 #include "llrendertarget.h"
+#include "llocclusionbuffer.h"
 
 class LLViewerImage;
 class LLEdge;
@@ -125,6 +126,9 @@ public:
 	void        markVisible(LLDrawable *drawablep, LLCamera& camera);
 	void		markOccluder(LLSpatialGroup* group);
 	void		doOcclusion(LLCamera& camera);
+	void		updateSoftwareOcclusion(LLCamera& camera); // draw occluders into the software depth buffer
+	void		gatherBoxOccluders(LLCamera& camera); // pick visible box prims to occlude with next frame
+	BOOL		isSoftwareOccluded(const LLVector3& center, const LLVector3& size);
 	void		markNotCulled(LLSpatialGroup* group, LLCamera &camera);
 	void        markMoved(LLDrawable *drawablep, BOOL damped_motion = FALSE);
 	void        markShift(LLDrawable *drawablep);
@@ -376,6 +380,10 @@ public:
 
 	BOOL					 mBackfaceCull;
 	S32						 mBatchCount;
+	S32						 mBatchesMerged;
+	S32						 mSoftwareOcclusionTests;
+	S32						 mSoftwareOcclusionCulled;
+	S32						 mQueryOcclusionCulled;
 	S32						 mMatrixOpCount;
 	S32						 mTextureMatrixOps;
 	S32						 mMaxBatchSize;
@@ -383,6 +391,7 @@ public:
 	S32						 mMeanBatchSize;
 	S32						 mTrianglesDrawn;
 	S32						 mNumVisibleNodes;
+	std::vector<F32>		 mPartitionCullTime; // seconds spent culling each partition type last updateCull
 	LLStat                   mTrianglesDrawnStat;
 	S32						 mVerticesRelit;
 
@@ -397,6 +406,9 @@ public:
 	static BOOL				sForceOldBakedUpload; // If true will not use capabilities to upload baked textures.
 	static S32				sUseOcclusion;  // 0 = no occlusion, 1 = read only, 2 = read/write
 	static BOOL				sDelayVBUpdate;
+	static BOOL				sAsyncVBUpdate;
+	static BOOL				sMergeBatches;
+	static BOOL				sSoftwareOcclusion;
 	static BOOL				sFastAlpha;
 	static BOOL				sDisableShaders; // if TRUE, rendering will be done without shaders
 	static BOOL				sRenderBump;
@@ -406,6 +418,7 @@ public:
 	static BOOL				sSkipUpdate; //skip lod updates
 	static BOOL				sWaterReflections;
 	static BOOL				sDynamicLOD;
+	static BOOL				sParallelCull;
 	static BOOL				sPickAvatar;
 	static BOOL				sReflectionRender;
 	static BOOL				sImpostorRender;
@@ -562,6 +575,9 @@ public:
 protected:
 	std::vector<LLFace*>		mSelectedFaces;
 
+	LLOcclusionBuffer			mOcclusionBuffer;
+	std::vector<LLPointer<LLDrawable> > mBoxOccluders;
+
 	LLPointer<LLViewerImage>	mFaceSelectImagep;
 	LLPointer<LLViewerImage>	mBloomImagep;
 	LLPointer<LLViewerImage>	mBloomImage2p;
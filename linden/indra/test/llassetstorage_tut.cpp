@@ -0,0 +1,231 @@
+/** 
+ * @file llassetstorage_tut.cpp
+ * @brief LLAssetStorage download coalescing and prefetch tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+#include "linden_common.h"
+#include "lltut.h"
+
+#include "llapr.h"
+#include "llassetstorage.h"
+#include "lltimer.h"
+#include "llvfs.h"
+
+namespace tut
+{
+	// Records transfers instead of sending them upstream
+	class TestAssetStorage : public LLAssetStorage
+	{
+	public:
+		TestAssetStorage(LLVFS* vfs) : LLAssetStorage(NULL, NULL, vfs) {}
+
+		/*virtual*/ void _queueDataRequest(const LLUUID& uuid, LLAssetType::EType type,
+										   LLGetAssetCallback callback,
+										   void *user_data, BOOL duplicate,
+										   BOOL is_priority)
+		{
+			LLAssetRequest *req = new LLAssetRequest(uuid, type);
+			req->mDownCallback = callback;
+			req->mUserData = user_data;
+			req->mIsPriority = is_priority;
+			addPendingRequest(RT_DOWNLOAD, req);
+			if (!duplicate)
+			{
+				mTransfers.push_back(std::make_pair(uuid, req));
+			}
+		}
+
+		// finishes the transfer started for uuid, as the transfer manager would
+		void complete(const LLUUID& uuid, LLAssetType::EType type, S32 result)
+		{
+			for (std::vector<std::pair<LLUUID, LLAssetRequest*> >::iterator iter = mTransfers.begin();
+				 iter != mTransfers.end(); ++iter)
+			{
+				if (iter->first == uuid && iter->second->getType() == type)
+				{
+					LLAssetRequest* req = iter->second;
+					mTransfers.erase(iter);
+					downloadCompleteCallback(result, uuid, type, req, LL_EXSTAT_NONE);
+					return;
+				}
+			}
+		}
+
+		S32 getNumPending() const { return (S32)mPendingDownloads.size(); }
+
+		std::vector<std::pair<LLUUID, LLAssetRequest*> > mTransfers;
+	};
+
+	struct AssetStorageTestData
+	{
+		AssetStorageTestData()
+		{
+			static bool init = false;
+			if (!init)
+			{
+				ll_init_apr();
+				init = true;
+			}
+
+			LLUUID random;
+			random.generate();
+			std::ostringstream oStr;
+#if LL_WINDOWS 
+			oStr << "llassetstorage-test-" << random;
+#else
+			oStr << "/tmp/llassetstorage-test-" << random;
+#endif
+			mVFSName = oStr.str();
+			mVFS = new LLVFS(mVFSName + ".index", mVFSName + ".data", FALSE, 0, FALSE);
+			mStorage = new TestAssetStorage(mVFS);
+			mOldStorage = gAssetStorage;
+			gAssetStorage = mStorage;
+		}
+
+		~AssetStorageTestData()
+		{
+			gAssetStorage = mOldStorage;
+			delete mStorage;
+			delete mVFS;
+			LLFile::remove(mVFSName + ".index");
+			LLFile::remove(mVFSName + ".data");
+		}
+
+		struct Callback
+		{
+			Callback() : mCount(0), mStatus(LL_ERR_NOERR) {}
+			S32 mCount;
+			S32 mStatus;
+		};
+
+		static void onAsset(LLVFS *vfs, const LLUUID &asset_id, LLAssetType::EType asset_type,
+							void *user_data, S32 status, LLExtStat ext_status)
+		{
+			Callback* callback = (Callback*)user_data;
+			callback->mCount++;
+			callback->mStatus = status;
+		}
+
+		std::string mVFSName;
+		LLVFS* mVFS;
+		TestAssetStorage* mStorage;
+		LLAssetStorage* mOldStorage;
+	};
+
+	typedef test_group<AssetStorageTestData> AssetStorageTestGroup;
+	typedef AssetStorageTestGroup::object AssetStorageTestObject;
+	AssetStorageTestGroup assetStorageTestGroup("LLAssetStorage");
+
+	template<> template<>
+	void AssetStorageTestObject::test<1>()
+		// requests for an asset already in flight share its transfer
+	{
+		LLUUID id;
+		id.generate();
+		Callback a, b, c;
+		mStorage->getAssetData(id, LLAssetType::AT_NOTECARD, onAsset, &a);
+		mStorage->getAssetData(id, LLAssetType::AT_NOTECARD, onAsset, &b);
+		mStorage->getAssetData(id, LLAssetType::AT_NOTECARD, onAsset, &c);
+
+		ensure_equals("one transfer", mStorage->mTransfers.size(), 1U);
+		ensure_equals("three pending", mStorage->getNumPending(), 3);
+		ensure_equals("coalesced", mStorage->getCoalescedRequests(), 2U);
+		ensure_equals("one miss", mStorage->getCacheMisses(), 1U);
+
+		mStorage->complete(id, LLAssetType::AT_NOTECARD, LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("a called", a.mCount, 1);
+		ensure_equals("b called", b.mCount, 1);
+		ensure_equals("c called", c.mCount, 1);
+		ensure_equals("status passed on", c.mStatus, (S32)LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("nothing pending", mStorage->getNumPending(), 0);
+	}
+
+	template<> template<>
+	void AssetStorageTestObject::test<2>()
+		// exact repeats are dropped, other types of the same id are not shared
+	{
+		LLUUID id;
+		id.generate();
+		Callback a, b;
+		mStorage->getAssetData(id, LLAssetType::AT_NOTECARD, onAsset, &a);
+		mStorage->getAssetData(id, LLAssetType::AT_NOTECARD, onAsset, &a);
+		mStorage->getAssetData(id, LLAssetType::AT_LSL_TEXT, onAsset, &b);
+
+		ensure_equals("two transfers", mStorage->mTransfers.size(), 2U);
+		ensure_equals("repeat dropped", mStorage->getNumPending(), 2);
+		ensure_equals("nothing coalesced", mStorage->getCoalescedRequests(), 0U);
+
+		mStorage->complete(id, LLAssetType::AT_NOTECARD, LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("a called once", a.mCount, 1);
+		ensure_equals("b still waiting", b.mCount, 0);
+		mStorage->complete(id, LLAssetType::AT_LSL_TEXT, LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("b called", b.mCount, 1);
+	}
+
+	template<> template<>
+	void AssetStorageTestObject::test<3>()
+		// prefetches go out by priority, skip pending assets and are
+		// shared by later requests
+	{
+		LLUUID low, high, pending;
+		low.generate();
+		high.generate();
+		pending.generate();
+
+		Callback p;
+		mStorage->getAssetData(pending, LLAssetType::AT_GESTURE, onAsset, &p);
+
+		// let the prefetch credit build up
+		ms_sleep(10);
+		asset_prefetch_list_t prefetches;
+		prefetches.push_back(LLAssetPrefetch(low, LLAssetType::AT_SOUND, 1.f));
+		prefetches.push_back(LLAssetPrefetch(pending, LLAssetType::AT_GESTURE, 3.f));
+		prefetches.push_back(LLAssetPrefetch(high, LLAssetType::AT_ANIMATION, 2.f));
+		mStorage->prefetchAssets(prefetches);
+
+		ensure_equals("two prefetches added", mStorage->mTransfers.size(), 3U);
+		ensure("higher priority first", mStorage->mTransfers[1].first == high);
+		ensure("lower priority next", mStorage->mTransfers[2].first == low);
+		ensure_equals("queue drained", mStorage->getNumQueuedPrefetches(), 0);
+		ensure_equals("prefetches aren't misses", mStorage->getCacheMisses(), 1U);
+
+		Callback l;
+		mStorage->getAssetData(low, LLAssetType::AT_SOUND, onAsset, &l);
+		ensure_equals("joined the prefetch", mStorage->mTransfers.size(), 3U);
+		mStorage->complete(low, LLAssetType::AT_SOUND, LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("requester called", l.mCount, 1);
+
+		mStorage->complete(high, LLAssetType::AT_ANIMATION, LL_ERR_ASSET_REQUEST_FAILED);
+		mStorage->complete(pending, LLAssetType::AT_GESTURE, LL_ERR_ASSET_REQUEST_FAILED);
+		ensure_equals("pending requester called once", p.mCount, 1);
+		ensure_equals("nothing pending", mStorage->getNumPending(), 0);
+	}
+}
@@ -0,0 +1,204 @@
+/** 
+ * @file llcachename_tut.cpp
+ * @brief LLCacheName packed file tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llcachename.h"
+#include "lluuid.h"
+#include "lltut.h"
+
+#include <sstream>
+
+
+namespace tut
+{
+	struct LLCacheNameTestData
+	{
+		// the packed format, as described in llcachename.cpp
+		static void appendU32(std::string& out, U32 value)
+		{
+			for (S32 i = 0; i < 4; i++)
+			{
+				out += (char)((value >> (8 * i)) & 0xff);
+			}
+		}
+
+		static std::string record(const LLUUID& id, bool is_group, const std::string& first, const std::string& second)
+		{
+			std::string out((const char*)id.mData, UUID_BYTES);
+			appendU32(out, (U32)time(NULL));
+			out += (char)(is_group ? 1 : 0);
+			out += (char)first.size();
+			out += first;
+			out += (char)second.size();
+			out += second;
+			return out;
+		}
+
+		static std::string file(const std::string& records, U32 count)
+		{
+			std::string out("LLNC");
+			appendU32(out, 1);
+			appendU32(out, count);
+			return out + records;
+		}
+
+		static bool import(LLCacheName& cache, const std::string& data)
+		{
+			std::istringstream istr(data);
+			return cache.importFile(istr);
+		}
+
+		static std::string exportData(LLCacheName& cache)
+		{
+			std::ostringstream ostr;
+			cache.exportFile(ostr);
+			return ostr.str();
+		}
+	};
+
+	typedef test_group<LLCacheNameTestData> LLCacheNameTestGroup;
+	typedef LLCacheNameTestGroup::object LLCacheNameTestObject;
+
+	LLCacheNameTestGroup cacheNameTestGroup("LLCacheName");
+
+	// names survive an export and import
+	template<> template<>
+		void LLCacheNameTestObject::test<1>()
+		{
+			LLUUID agent_id, group_id;
+			agent_id.generate();
+			group_id.generate();
+
+			LLCacheName cache(NULL);
+			ensure("import", import(cache, file(record(agent_id, false, "Ima", "Resident") +
+												record(group_id, true, "Builders", ""), 2)));
+
+			std::string first, last, group;
+			ensure("agent", cache.getName(agent_id, first, last));
+			ensure_equals("first", first, std::string("Ima"));
+			ensure_equals("last", last, std::string("Resident"));
+			ensure("group", cache.getGroupName(group_id, group));
+			ensure_equals("group name", group, std::string("Builders"));
+
+			LLCacheName reloaded(NULL);
+			ensure("reimport", import(reloaded, exportData(cache)));
+			ensure("agent reloaded", reloaded.getName(agent_id, first, last));
+			ensure_equals("first reloaded", first, std::string("Ima"));
+			ensure_equals("last reloaded", last, std::string("Resident"));
+			ensure("group reloaded", reloaded.getGroupName(group_id, group));
+			ensure_equals("group name reloaded", group, std::string("Builders"));
+
+			LLUUID unknown_id;
+			unknown_id.generate();
+			ensure("unknown", !reloaded.getName(unknown_id, first, last));
+		}
+
+	// records are only decoded when looked up.  A decoded group is written
+	// back with an empty second string, so a record that carries one shows
+	// whether it went through decoding.
+	template<> template<>
+		void LLCacheNameTestObject::test<2>()
+		{
+			LLUUID looked_up_id, untouched_id;
+			looked_up_id.generate();
+			untouched_id.generate();
+			std::string looked_up = record(looked_up_id, true, "Looked Up", "extra");
+			std::string untouched = record(untouched_id, true, "Untouched", "extra");
+
+			LLCacheName cache(NULL);
+			ensure("import", import(cache, file(looked_up + untouched, 2)));
+			std::string group;
+			ensure("lookup", cache.getGroupName(looked_up_id, group));
+			ensure_equals("looked up name", group, std::string("Looked Up"));
+
+			std::string exported = exportData(cache);
+			ensure("looked up record decoded", exported.find(looked_up) == std::string::npos);
+			ensure("looked up record written again", exported.find(record(looked_up_id, true, "Looked Up", "")) != std::string::npos);
+			ensure("other record left alone", exported.find(untouched) != std::string::npos);
+		}
+
+	// records nobody looked up are copied through to the export unchanged
+	template<> template<>
+		void LLCacheNameTestObject::test<3>()
+		{
+			std::string records;
+			std::vector<std::string> each;
+			for (S32 i = 0; i < 20; i++)
+			{
+				LLUUID id;
+				id.generate();
+				each.push_back(record(id, false, llformat("First%d", i), llformat("Last%d", i)));
+				records += each.back();
+			}
+			std::string data = file(records, each.size());
+
+			LLCacheName cache(NULL);
+			ensure("import", import(cache, data));
+			std::string exported = exportData(cache);
+			ensure_equals("same size", exported.size(), data.size());
+			ensure("same header", exported.compare(0, 12, data, 0, 12) == 0);
+			for (U32 i = 0; i < each.size(); i++)
+			{
+				ensure("record copied through", exported.find(each[i]) != std::string::npos);
+			}
+		}
+
+	// truncated files keep what is whole and reject the rest
+	template<> template<>
+		void LLCacheNameTestObject::test<4>()
+		{
+			LLUUID whole_id, cut_id;
+			whole_id.generate();
+			cut_id.generate();
+			std::string whole = record(whole_id, false, "Whole", "Record");
+			std::string cut = record(cut_id, false, "Cut", "Record");
+			std::string data = file(whole + cut, 2);
+
+			LLCacheName short_header(NULL);
+			ensure("truncated header rejected", !import(short_header, data.substr(0, 10)));
+
+			LLCacheName cache(NULL);
+			ensure("import", import(cache, data.substr(0, data.size() - 3)));
+			std::string first, last;
+			ensure("whole record", cache.getName(whole_id, first, last));
+			ensure_equals("whole first", first, std::string("Whole"));
+			ensure("cut record rejected", !cache.getName(cut_id, first, last));
+
+			// a record count far beyond what the data holds is only a hint
+			LLCacheName bad_count(NULL);
+			ensure("import with bad count", import(bad_count, file(whole, 0xffffffff)));
+			ensure("record with bad count", bad_count.getName(whole_id, first, last));
+			ensure("export with bad count", exportData(bad_count).find(whole) != std::string::npos);
+		}
+}
@@ -0,0 +1,169 @@
+/** 
+ * @file llgridquadtree_tut.cpp
+ * @brief LLGridQuadTree tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llgridquadtree.h"
+#include "lltut.h"
+
+#include <algorithm>
+
+
+namespace tut
+{
+	struct LLGridQuadTreeTestData
+	{
+	};
+
+	typedef test_group<LLGridQuadTreeTestData> LLGridQuadTreeTestGroup;
+	typedef LLGridQuadTreeTestGroup::object LLGridQuadTreeTestObject;
+
+	LLGridQuadTreeTestGroup gridQuadTreeTestGroup("LLGridQuadTree");
+
+	// Range queries match a brute force scan
+	template<> template<>
+		void LLGridQuadTreeTestObject::test<1>()
+		{
+			LLGridQuadTree<S32> tree(12);
+			std::vector<U32> xs, ys;
+			for (S32 i = 0; i < 2000; i++)
+			{
+				U32 x = (i * 7919) % 700 + 1000;
+				U32 y = (i * 104729) % 500 + 1000;
+				xs.push_back(x);
+				ys.push_back(y);
+				ensure("inserted", tree.insert(x, y, i));
+			}
+			ensure_equals("size", tree.size(), (size_t)2000);
+
+			U32 min_x = 1100, max_x = 1250, min_y = 1300, max_y = 1420;
+			std::vector<S32> found;
+			tree.query(min_x, min_y, max_x, max_y, found);
+			std::sort(found.begin(), found.end());
+
+			std::vector<S32> expected;
+			for (S32 i = 0; i < 2000; i++)
+			{
+				if (xs[i] >= min_x && xs[i] <= max_x && ys[i] >= min_y && ys[i] <= max_y)
+				{
+					expected.push_back(i);
+				}
+			}
+			ensure("some matches", !expected.empty());
+			ensure("query matches scan", found == expected);
+
+			found.clear();
+			tree.query(0, 0, 999, 999, found);
+			ensure("empty corner", found.empty());
+		}
+
+	// Out of range positions, shared positions and removal
+	template<> template<>
+		void LLGridQuadTreeTestObject::test<2>()
+		{
+			LLGridQuadTree<S32> tree(8);
+			ensure("x out of range", !tree.insert(256, 0, 1));
+			ensure("y out of range", !tree.insert(0, 256, 1));
+
+			// More values at one cell than a leaf holds
+			for (S32 i = 0; i < 20; i++)
+			{
+				tree.insert(5, 5, i);
+			}
+			std::vector<S32> found;
+			tree.query(5, 5, 5, 5, found);
+			ensure_equals("all at one cell", found.size(), (size_t)20);
+
+			ensure("removed", tree.remove(5, 5, 7));
+			ensure("not removed twice", !tree.remove(5, 5, 7));
+			ensure("wrong position", !tree.remove(6, 5, 8));
+			found.clear();
+			tree.query(0, 0, 255, 255, found);
+			ensure_equals("one fewer", found.size(), (size_t)19);
+			ensure("7 gone", std::find(found.begin(), found.end(), 7) == found.end());
+
+			tree.clear();
+			ensure_equals("cleared", tree.size(), (size_t)0);
+			found.clear();
+			tree.query(0, 0, 255, 255, found);
+			ensure("nothing left", found.empty());
+		}
+
+	// Removals free the leaves they empty, and queries stay right as
+	// the tree splits and merges
+	template<> template<>
+		void LLGridQuadTreeTestObject::test<3>()
+		{
+			LLGridQuadTree<S32> tree(12);
+			const S32 COUNT = 1000;
+			std::vector<U32> xs, ys;
+			for (S32 i = 0; i < COUNT; i++)
+			{
+				xs.push_back((i * 7919) % 4096);
+				ys.push_back((i * 104729) % 4096);
+				tree.insert(xs[i], ys[i], i);
+			}
+			ensure("split", tree.getNodeCount() > 100);
+
+			// remove every other value and check a query against a scan
+			for (S32 i = 0; i < COUNT; i += 2)
+			{
+				ensure("removed", tree.remove(xs[i], ys[i], i));
+			}
+			std::vector<S32> found;
+			tree.query(500, 700, 2600, 3100, found);
+			std::sort(found.begin(), found.end());
+			std::vector<S32> expected;
+			for (S32 i = 1; i < COUNT; i += 2)
+			{
+				if (xs[i] >= 500 && xs[i] <= 2600 && ys[i] >= 700 && ys[i] <= 3100)
+				{
+					expected.push_back(i);
+				}
+			}
+			ensure("query after removals matches scan", found == expected);
+
+			for (S32 i = 1; i < COUNT; i += 2)
+			{
+				ensure("removed rest", tree.remove(xs[i], ys[i], i));
+			}
+			ensure_equals("empty", tree.size(), (size_t)0);
+			ensure_equals("only the root left", tree.getNodeCount(), (size_t)1);
+
+			// and it still works afterwards
+			ensure("insert again", tree.insert(xs[3], ys[3], 3));
+			found.clear();
+			tree.query(0, 0, 4095, 4095, found);
+			ensure_equals("found again", found.size(), (size_t)1);
+		}
+}
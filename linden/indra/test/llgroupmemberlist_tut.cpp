@@ -0,0 +1,185 @@
+/** 
+ * @file llgroupmemberlist_tut.cpp
+ * @brief LLGroupMemberList tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llgroupmemberlist.h"
+#include "lltut.h"
+
+#include <set>
+
+
+namespace tut
+{
+	struct LLGroupMemberListTestData
+	{
+		static LLGroupMemberData* add(LLGroupMemberList& members, const LLUUID& id, S32 contribution)
+		{
+			return members.add(id, contribution, 0, "Member", "Online", FALSE);
+		}
+	};
+
+	typedef test_group<LLGroupMemberListTestData> LLGroupMemberListTestGroup;
+	typedef LLGroupMemberListTestGroup::object LLGroupMemberListTestObject;
+
+	LLGroupMemberListTestGroup groupMemberListTestGroup("LLGroupMemberList");
+
+	// members arriving over several packets are all found by id, and keep
+	// their arrival order
+	template<> template<>
+		void LLGroupMemberListTestObject::test<1>()
+		{
+			LLGroupMemberList members;
+			std::vector<LLUUID> ids;
+			for (S32 i = 0; i < 300; i++)
+			{
+				LLUUID id;
+				id.generate();
+				ids.push_back(id);
+				add(members, id, i);
+				if (i % 50 == 49)
+				{
+					// one packet's worth
+					members.updateIndex();
+				}
+			}
+			ensure_equals("size", members.size(), (size_t)300);
+
+			for (S32 i = 0; i < 300; i++)
+			{
+				ensure("arrival order", members.at(i).first == ids[i]);
+				LLGroupMemberList::iterator it = members.find(ids[i]);
+				ensure("found", it != members.end());
+				ensure_equals("data", it->second->getContribution(), i);
+			}
+
+			LLUUID missing;
+			missing.generate();
+			ensure("not found", members.find(missing) == members.end());
+			ensure("memory counted", members.getMemoryUsage() > 300 * sizeof(LLGroupMemberData));
+		}
+
+	// a later entry for the same id replaces the earlier one once indexed
+	template<> template<>
+		void LLGroupMemberListTestObject::test<2>()
+		{
+			LLGroupMemberList members;
+			LLUUID a, b;
+			a.generate();
+			b.generate();
+			add(members, a, 1);
+			add(members, b, 2);
+			members.updateIndex();
+			U32 generation = members.getGeneration();
+
+			add(members, a, 3);
+			ensure_equals("newest entry found before indexing", members.find(a)->second->getContribution(), 3);
+			members.updateIndex();
+			ensure_equals("duplicate dropped", members.size(), (size_t)2);
+			ensure_equals("newest entry kept", members.find(a)->second->getContribution(), 3);
+			ensure_equals("other entry kept", members.find(b)->second->getContribution(), 2);
+			ensure("reordering changes the generation", members.getGeneration() != generation);
+		}
+
+	// appending keeps the generation, so paging can carry on; removing
+	// changes it, so paging knows to start over
+	template<> template<>
+		void LLGroupMemberListTestObject::test<3>()
+		{
+			LLGroupMemberList members;
+			std::vector<LLUUID> ids;
+			for (S32 i = 0; i < 100; i++)
+			{
+				LLUUID id;
+				id.generate();
+				ids.push_back(id);
+				add(members, id, i);
+			}
+			members.updateIndex();
+
+			// page through in steps of 30 while more members arrive
+			std::set<LLUUID> seen;
+			U32 generation = members.getGeneration();
+			size_t progress = 0;
+			S32 next = 100;
+			while (progress < members.size())
+			{
+				for (S32 i = 0; i < 30 && progress < members.size(); i++, progress++)
+				{
+					seen.insert(members.at(progress).first);
+				}
+				if (next < 160)
+				{
+					for (S32 i = 0; i < 20; i++, next++)
+					{
+						LLUUID id;
+						id.generate();
+						ids.push_back(id);
+						add(members, id, next);
+					}
+					members.updateIndex();
+				}
+				ensure_equals("appends keep the generation", members.getGeneration(), generation);
+			}
+			ensure_equals("every member paged once", seen.size(), ids.size());
+
+			members.erase(ids[10]);
+			ensure("erase changes the generation", members.getGeneration() != generation);
+			ensure("erased", members.find(ids[10]) == members.end());
+			ensure_equals("shifted member still found", members.find(ids[11])->second->getContribution(), 11);
+			ensure_equals("indices shifted", members.at(10).first, ids[11]);
+
+			generation = members.getGeneration();
+			members.clear();
+			ensure("clear changes the generation", members.getGeneration() != generation);
+			ensure("empty", members.empty());
+
+			LLGroupMemberList other;
+			ensure("generations are unique across lists", other.getGeneration() != members.getGeneration());
+		}
+
+	// freed member data is reused for later arrivals
+	template<> template<>
+		void LLGroupMemberListTestObject::test<4>()
+		{
+			LLGroupMemberList members;
+			LLUUID a, b;
+			a.generate();
+			b.generate();
+			LLGroupMemberData* data = add(members, a, 1);
+			members.erase(a);
+			ensure("reused", add(members, b, 2) == data);
+			ensure_equals("reused data reset", members.find(b)->second->getContribution(), 2);
+			ensure("reused id", members.find(b)->second->getID() == b);
+		}
+}
@@ -0,0 +1,149 @@
+/** 
+ * @file llinventorycache_tut.cpp
+ * @brief LLInventoryCacheWriter and LLInventoryCacheReader tests.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llinventorycache.h"
+#include "llinventory.h"
+#include "lltut.h"
+
+
+namespace tut
+{
+	struct LLInventoryCacheTestData
+	{
+		LLPointer<LLInventoryItem> makeItem(const std::string& name)
+		{
+			LLUUID id, parent_id, asset_id, creator_id, group_id;
+			id.generate();
+			parent_id.generate();
+			asset_id.generate();
+			creator_id.generate();
+			group_id.generate();
+			LLPermissions perm;
+			perm.init(creator_id, creator_id, LLUUID::null, group_id);
+			perm.initMasks(PERM_ALL, PERM_ALL, PERM_NONE, PERM_COPY, PERM_MOVE | PERM_TRANSFER);
+			return new LLInventoryItem(id, parent_id, perm, asset_id,
+									   LLAssetType::AT_NOTECARD, LLInventoryType::IT_NOTECARD,
+									   name, "a description",
+									   LLSaleInfo(LLSaleInfo::FS_COPY, 25), 0x10, 1234567);
+		}
+	};
+
+	typedef test_group<LLInventoryCacheTestData> LLInventoryCacheTestGroup;
+	typedef LLInventoryCacheTestGroup::object LLInventoryCacheTestObject;
+
+	LLInventoryCacheTestGroup inventoryCacheTestGroup("LLInventoryCache");
+
+	// Items survive a round trip
+	template<> template<>
+		void LLInventoryCacheTestObject::test<1>()
+		{
+			LLPointer<LLInventoryItem> src = makeItem("Some notecard");
+			LLInventoryCacheWriter writer;
+			writer.addItem(src);
+			writer.addItem(makeItem("Another"));
+			std::vector<U8> buffer;
+			writer.finish(buffer);
+
+			LLInventoryCacheReader reader;
+			ensure("opens", reader.open(&buffer[0], buffer.size()));
+			ensure_equals("item count", reader.getItemCount(), 2);
+			ensure_equals("category count", reader.getCategoryCount(), 0);
+
+			LLPointer<LLInventoryItem> dst = new LLInventoryItem;
+			ensure("reads", reader.readItem(0, dst));
+			ensure_equals("id", dst->getUUID(), src->getUUID());
+			ensure_equals("parent", dst->getParentUUID(), src->getParentUUID());
+			ensure_equals("asset", dst->getAssetUUID(), src->getAssetUUID());
+			ensure_equals("name", dst->getName(), src->getName());
+			ensure_equals("description", dst->getDescription(), src->getDescription());
+			ensure_equals("type", dst->getType(), src->getType());
+			ensure_equals("inventory type", dst->getInventoryType(), src->getInventoryType());
+			ensure_equals("flags", dst->getFlags(), src->getFlags());
+			ensure_equals("creation date", dst->getCreationDate(), src->getCreationDate());
+			ensure_equals("sale price", dst->getSaleInfo().getSalePrice(), 25);
+			ensure("permissions", dst->getPermissions() == src->getPermissions());
+			ensure("out of range", !reader.readItem(2, dst));
+		}
+
+	// Categories keep their version and descendent count
+	template<> template<>
+		void LLInventoryCacheTestObject::test<2>()
+		{
+			LLUUID id, parent_id, owner_id;
+			id.generate();
+			parent_id.generate();
+			owner_id.generate();
+			LLPointer<LLInventoryCategory> src = new LLInventoryCategory(id, parent_id, LLAssetType::AT_TEXTURE, "Textures");
+			LLInventoryCacheWriter writer;
+			writer.addCategory(src, owner_id, 42, 7);
+			std::vector<U8> buffer;
+			writer.finish(buffer);
+
+			LLInventoryCacheReader reader;
+			ensure("opens", reader.open(&buffer[0], buffer.size()));
+			LLPointer<LLInventoryCategory> dst = new LLInventoryCategory;
+			LLUUID read_owner_id;
+			S32 version = 0;
+			S32 descendents = 0;
+			ensure("reads", reader.readCategory(0, dst, read_owner_id, version, descendents));
+			ensure_equals("id", dst->getUUID(), id);
+			ensure_equals("parent", dst->getParentUUID(), parent_id);
+			ensure_equals("owner", read_owner_id, owner_id);
+			ensure_equals("name", dst->getName(), std::string("Textures"));
+			ensure_equals("preferred type", dst->getPreferredType(), LLAssetType::AT_TEXTURE);
+			ensure_equals("version", version, 42);
+			ensure_equals("descendents", descendents, 7);
+		}
+
+	// Truncated or foreign files are rejected
+	template<> template<>
+		void LLInventoryCacheTestObject::test<3>()
+		{
+			LLInventoryCacheWriter writer;
+			writer.addItem(makeItem("Some notecard"));
+			std::vector<U8> buffer;
+			writer.finish(buffer);
+
+			LLInventoryCacheReader reader;
+			ensure("truncated", !reader.open(&buffer[0], buffer.size() - 1));
+			ensure("empty after failure", reader.getItemCount() == 0);
+
+			std::vector<U8> bad_version(buffer);
+			bad_version[4] ^= 0xff;
+			ensure("wrong version", !reader.open(&bad_version[0], bad_version.size()));
+
+			ensure("intact", reader.open(&buffer[0], buffer.size()));
+		}
+}
@@ -0,0 +1,194 @@
+/** 
+ * @file llinventorysearchindex_tut.cpp
+ * @brief LLInventorySearchIndex test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llinventorysearchindex.h"
+#include "llinventorytype.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct LLInventorySearchIndexTestData
+	{
+		LLInventorySearchIndex mIndex;
+		LLUUID mRoot, mClothes, mShirts, mScripts;
+		LLUUID mRedShirt, mBlueShirt, mDoorScript;
+
+		LLInventorySearchIndexTestData()
+		{
+			mRoot.generate();
+			mClothes.generate();
+			mShirts.generate();
+			mScripts.generate();
+			mRedShirt.generate();
+			mBlueShirt.generate();
+			mDoorScript.generate();
+
+			U32 folder = LLInventoryType::NIT_FOLDER;
+			mIndex.update(mRoot, LLUUID::null, "My Inventory", folder);
+			mIndex.update(mClothes, mRoot, "Clothing", folder);
+			mIndex.update(mShirts, mClothes, "Shirts", folder);
+			mIndex.update(mScripts, mRoot, "Scripts", folder);
+			mIndex.update(mRedShirt, mShirts, "Red Shirt", LLInventoryType::NIT_SHIRT);
+			mIndex.update(mBlueShirt, mShirts, "blue shirt", LLInventoryType::NIT_SHIRT);
+			mIndex.update(mDoorScript, mScripts, "Door script", LLInventoryType::NIT_SCRIPT_LSL2);
+		}
+
+		bool matched(const LLInventorySearchIndex::match_map_t& matches, const LLUUID& id)
+		{
+			LLInventorySearchIndex::match_map_t::const_iterator it = matches.find(id);
+			return it != matches.end() && it->second;
+		}
+
+		bool ancestor(const LLInventorySearchIndex::match_map_t& matches, const LLUUID& id)
+		{
+			LLInventorySearchIndex::match_map_t::const_iterator it = matches.find(id);
+			return it != matches.end() && !it->second;
+		}
+	};
+
+	typedef test_group<LLInventorySearchIndexTestData> LLInventorySearchIndexTestGroup;
+	typedef LLInventorySearchIndexTestGroup::object LLInventorySearchIndexTestObject;
+
+	LLInventorySearchIndexTestGroup inventorySearchIndexTestGroup("LLInventorySearchIndex");
+
+	// Case insensitive substring matches, with their ancestors
+	template<> template<>
+		void LLInventorySearchIndexTestObject::test<1>()
+		{
+			LLInventorySearchIndex::match_map_t matches;
+			mIndex.find("shirt", LLInventoryType::NIT_ALL, matches);
+			ensure("red shirt", matched(matches, mRedShirt));
+			ensure("blue shirt", matched(matches, mBlueShirt));
+			ensure("shirts folder", matched(matches, mShirts));
+			ensure("clothing is an ancestor", ancestor(matches, mClothes));
+			ensure("root is an ancestor", ancestor(matches, mRoot));
+			ensure("scripts not touched", matches.find(mScripts) == matches.end());
+			ensure_equals("match count", matches.size(), 5U);
+
+			// Needles that span words and short needles
+			mIndex.find("D SH", LLInventoryType::NIT_ALL, matches);
+			ensure("spanning match", matched(matches, mRedShirt));
+			ensure("no blue", matches.find(mBlueShirt) == matches.end());
+			mIndex.find("oo", LLInventoryType::NIT_ALL, matches);
+			ensure("short needle", matched(matches, mDoorScript));
+			ensure_equals("short needle count", matches.size(), 3U);
+
+			mIndex.find("xyzzy", LLInventoryType::NIT_ALL, matches);
+			ensure("nothing", matches.empty());
+		}
+
+	// Type filtering
+	template<> template<>
+		void LLInventorySearchIndexTestObject::test<2>()
+		{
+			LLInventorySearchIndex::match_map_t matches;
+			mIndex.find("s", LLInventoryType::NIT_SCRIPT_LSL2, matches);
+			ensure("script", matched(matches, mDoorScript));
+			ensure("no shirts", !matched(matches, mRedShirt));
+			ensure("scripts folder is only an ancestor", ancestor(matches, mScripts));
+		}
+
+	// Rename, move and remove
+	template<> template<>
+		void LLInventorySearchIndexTestObject::test<3>()
+		{
+			LLInventorySearchIndex::match_map_t matches;
+			U32 version = mIndex.getVersion();
+			mIndex.update(mRedShirt, mShirts, "Red Shirt", LLInventoryType::NIT_SHIRT);
+			ensure_equals("no-op update", mIndex.getVersion(), version);
+
+			mIndex.update(mRedShirt, mScripts, "Crimson Tee", LLInventoryType::NIT_SHIRT);
+			ensure("version bumped", mIndex.getVersion() != version);
+			mIndex.find("red sh", LLInventoryType::NIT_ALL, matches);
+			ensure("old name gone", matches.empty());
+			mIndex.find("crimson", LLInventoryType::NIT_ALL, matches);
+			ensure("new name", matched(matches, mRedShirt));
+			ensure("new parent", ancestor(matches, mScripts));
+			ensure("old parent", matches.find(mShirts) == matches.end());
+
+			mIndex.remove(mRedShirt);
+			ensure("removed", !mIndex.contains(mRedShirt));
+			mIndex.find("crimson", LLInventoryType::NIT_ALL, matches);
+			ensure("removed not found", matches.empty());
+			ensure_equals("size", mIndex.size(), 6);
+
+			// Reusing the slot must not resurrect the old name
+			LLUUID hat;
+			hat.generate();
+			mIndex.update(hat, mClothes, "Hat", LLInventoryType::NIT_CLOTHING);
+			mIndex.find("crimson", LLInventoryType::NIT_ALL, matches);
+			ensure("slot reuse", matches.empty());
+			mIndex.find("hat", LLInventoryType::NIT_ALL, matches);
+			ensure("hat", matched(matches, hat));
+		}
+
+	// Many renames force a posting rebuild; results stay correct
+	template<> template<>
+		void LLInventorySearchIndexTestObject::test<4>()
+		{
+			std::vector<LLUUID> ids;
+			for (S32 i = 0; i < 2000; ++i)
+			{
+				LLUUID id;
+				id.generate();
+				ids.push_back(id);
+				mIndex.update(id, mRoot, llformat("object number %d", i), LLInventoryType::NIT_OBJECT);
+			}
+			for (S32 i = 0; i < 2000; ++i)
+			{
+				mIndex.update(ids[i], mRoot, llformat("renamed thing %d", i), LLInventoryType::NIT_OBJECT);
+			}
+			LLInventorySearchIndex::match_map_t matches;
+			mIndex.find("object number", LLInventoryType::NIT_ALL, matches);
+			ensure("old names gone", matches.empty());
+			mIndex.find("thing 1999", LLInventoryType::NIT_ALL, matches);
+			ensure("new name", matched(matches, ids[1999]));
+			ensure_equals("one match plus root", matches.size(), 2U);
+		}
+
+	// Matches found elsewhere pull in their ancestors too
+	template<> template<>
+		void LLInventorySearchIndexTestObject::test<5>()
+		{
+			LLInventorySearchIndex::match_map_t matches;
+			mIndex.find("door", LLInventoryType::NIT_ALL, matches);
+			mIndex.addMatch(mBlueShirt, matches);
+			ensure("door", matched(matches, mDoorScript));
+			ensure("added", matched(matches, mBlueShirt));
+			ensure("shirts folder", ancestor(matches, mShirts));
+			ensure("clothing", ancestor(matches, mClothes));
+			ensure_equals("count", matches.size(), 6U);
+		}
+}
@@ -0,0 +1,137 @@
+/** 
+ * @file lllrucache_tut.cpp
+ * @brief Tests for the LLLRUCache container.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "lllrucache.h"
+#include "lltut.h"
+
+
+namespace tut
+{
+	struct LLLRUCacheTestData
+	{
+	};
+
+	class LLEvictionRecorder : public LLLRUCache<S32, S32>
+	{
+	public:
+		LLEvictionRecorder(U32 max_size) : LLLRUCache<S32, S32>(max_size) {}
+		std::vector<S32> mEvicted;
+	protected:
+		virtual void evicted(const S32& key, S32& value) { mEvicted.push_back(key); }
+	};
+
+	typedef test_group<LLLRUCacheTestData> LLLRUCacheTestGroup;
+	typedef LLLRUCacheTestGroup::object LLLRUCacheTestObject;
+
+	LLLRUCacheTestGroup lruCacheTestGroup("LLLRUCache");
+
+	// Insert and find
+	template<> template<>
+		void LLLRUCacheTestObject::test<1>()
+		{
+			LLLRUCache<std::string, S32> cache(4);
+			ensure("starts empty", cache.empty());
+			cache.insert("one", 1);
+			cache.insert("two", 2);
+			ensure_equals("size is 2", cache.size(), 2U);
+			ensure("finds one", cache.find("one") && *cache.find("one") == 1);
+			ensure("misses three", cache.find("three") == NULL);
+
+			// Re-inserting replaces the value without growing
+			cache.insert("one", 11);
+			ensure_equals("still size 2", cache.size(), 2U);
+			ensure_equals("replaced value", *cache.find("one"), 11);
+		}
+
+	// Least recently used entry is evicted first
+	template<> template<>
+		void LLLRUCacheTestObject::test<2>()
+		{
+			LLLRUCache<S32, S32> cache(3);
+			cache.insert(1, 10);
+			cache.insert(2, 20);
+			cache.insert(3, 30);
+			// Touch 1 so that 2 becomes the oldest
+			ensure("finds 1", cache.find(1) != NULL);
+			cache.insert(4, 40);
+			ensure_equals("size capped", cache.size(), 3U);
+			ensure("2 evicted", cache.find(2) == NULL);
+			ensure("1 kept", cache.find(1) != NULL);
+			ensure("3 kept", cache.find(3) != NULL);
+			ensure("4 kept", cache.find(4) != NULL);
+
+			// Shrinking drops the oldest entries
+			cache.setMaxSize(1);
+			ensure_equals("shrunk", cache.size(), 1U);
+			ensure("most recent kept", cache.find(4) != NULL);
+		}
+
+	// Erase and clear
+	template<> template<>
+		void LLLRUCacheTestObject::test<3>()
+		{
+			LLLRUCache<S32, S32> cache(8);
+			for (S32 i = 0; i < 8; i++)
+			{
+				cache.insert(i, i * i);
+			}
+			cache.erase(3);
+			ensure("3 erased", cache.find(3) == NULL);
+			ensure_equals("size after erase", cache.size(), 7U);
+			cache.clear();
+			ensure("cleared", cache.empty());
+			ensure("nothing found", cache.find(5) == NULL);
+		}
+
+	// Subclasses hear about evictions but not explicit removals
+	template<> template<>
+		void LLLRUCacheTestObject::test<4>()
+		{
+			LLEvictionRecorder cache(2);
+			cache.insert(1, 1);
+			cache.insert(2, 2);
+			cache.insert(3, 3);
+			ensure_equals("one eviction", cache.mEvicted.size(), (size_t)1);
+			ensure_equals("oldest evicted", cache.mEvicted[0], 1);
+			cache.erase(2);
+			cache.insert(4, 4);
+			ensure_equals("erase is not an eviction", cache.mEvicted.size(), (size_t)1);
+			cache.setMaxSize(1);
+			ensure_equals("shrinking evicts", cache.mEvicted.size(), (size_t)2);
+			ensure_equals("3 evicted", cache.mEvicted[1], 3);
+			cache.clear();
+			ensure_equals("clear is not an eviction", cache.mEvicted.size(), (size_t)2);
+		}
+}
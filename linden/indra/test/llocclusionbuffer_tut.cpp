@@ -0,0 +1,153 @@
+/** 
+ * @file llocclusionbuffer_tut.cpp
+ * @brief LLOcclusionBuffer test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llocclusionbuffer.h"
+#include "llcamera.h"
+#include "lltaskscheduler.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct occlusionbuffer_data
+	{
+		occlusionbuffer_data()
+		{
+			// looking down +x from the origin, z up
+			mCamera.setView(F_PI_BY_TWO);
+			mCamera.setAspect(2.f);
+			mCamera.setNear(0.5f);
+			mCamera.setOriginAndLookAt(LLVector3(0.f, 0.f, 0.f), LLVector3(0.f, 0.f, 1.f), LLVector3(10.f, 0.f, 0.f));
+		}
+
+		// a wall facing the camera at distance x, split into cells x cells quads
+		void addWall(LLOcclusionBuffer& buffer, F32 x, F32 half_width, F32 half_height, S32 cells = 1)
+		{
+			F32 w = half_width * 2.f / cells;
+			F32 h = half_height * 2.f / cells;
+			for (S32 i = 0; i < cells; i++)
+			{
+				for (S32 j = 0; j < cells; j++)
+				{
+					F32 y0 = -half_width + w * i;
+					F32 z0 = -half_height + h * j;
+					buffer.addQuad(LLVector3(x, y0, z0), LLVector3(x, y0 + w, z0),
+								   LLVector3(x, y0 + w, z0 + h), LLVector3(x, y0, z0 + h));
+				}
+			}
+		}
+
+		LLCamera mCamera;
+	};
+	typedef test_group<occlusionbuffer_data> occlusionbuffer_test;
+	typedef occlusionbuffer_test::object occlusionbuffer_object;
+	tut::occlusionbuffer_test occlusionbuffer_testcase("occlusionbuffer");
+
+	template<> template<>
+	void occlusionbuffer_object::test<1>()
+	{
+		LLOcclusionBuffer buffer;
+		buffer.begin(mCamera);
+		ensure("not ready before rasterize", !buffer.isReady());
+		ensure("nothing occluded before rasterize", !buffer.isOccluded(LLVector3(50.f, 0.f, 0.f), LLVector3(1.f, 1.f, 1.f)));
+
+		buffer.rasterize();
+		ensure("ready after rasterize", buffer.isReady());
+		ensure("nothing occluded by an empty buffer", !buffer.isOccluded(LLVector3(50.f, 0.f, 0.f), LLVector3(1.f, 1.f, 1.f)));
+	}
+
+	template<> template<>
+	void occlusionbuffer_object::test<2>()
+	{
+		LLOcclusionBuffer buffer;
+		buffer.begin(mCamera);
+		addWall(buffer, 10.f, 20.f, 5.f);
+		buffer.rasterize();
+
+		ensure("box behind wall is occluded", buffer.isOccluded(LLVector3(30.f, 0.f, 0.f), LLVector3(2.f, 2.f, 2.f)));
+		ensure("box in front of wall is visible", !buffer.isOccluded(LLVector3(5.f, 0.f, 0.f), LLVector3(1.f, 1.f, 1.f)));
+		ensure("box through wall is visible", !buffer.isOccluded(LLVector3(10.f, 0.f, 0.f), LLVector3(1.f, 1.f, 1.f)));
+		ensure("box past wall edge is visible", !buffer.isOccluded(LLVector3(30.f, 0.f, 30.f), LLVector3(2.f, 2.f, 2.f)));
+		ensure("box straddling wall edge is visible", !buffer.isOccluded(LLVector3(30.f, 0.f, 16.f), LLVector3(2.f, 2.f, 2.f)));
+		ensure("box around camera is visible", !buffer.isOccluded(LLVector3(0.f, 0.f, 0.f), LLVector3(1.f, 1.f, 1.f)));
+	}
+
+	template<> template<>
+	void occlusionbuffer_object::test<3>()
+	{
+		// a wall passing through the near plane is clipped, not dropped
+		LLOcclusionBuffer buffer;
+		buffer.begin(mCamera);
+		buffer.addQuad(LLVector3(-5.f, -20.f, -1.f), LLVector3(40.f, -20.f, -1.f),
+					   LLVector3(40.f, 20.f, -1.f), LLVector3(-5.f, 20.f, -1.f));
+		buffer.rasterize();
+
+		ensure("box below the floor is occluded", buffer.isOccluded(LLVector3(20.f, 0.f, -5.f), LLVector3(1.f, 1.f, 1.f)));
+		ensure("box above the floor is visible", !buffer.isOccluded(LLVector3(20.f, 0.f, 2.f), LLVector3(1.f, 1.f, 1.f)));
+	}
+
+	template<> template<>
+	void occlusionbuffer_object::test<4>()
+	{
+		// banded rasterization on workers must match a single thread exactly
+		LLOcclusionBuffer serial;
+		serial.begin(mCamera);
+		addWall(serial, 10.f, 20.f, 10.f, 24);
+		addWall(serial, 6.f, 3.f, 12.f, 4);
+		ensure("enough triangles to band", serial.getTriangleCount() >= 256);
+		serial.rasterize();
+
+		LLTaskScheduler scheduler("OcclusionTest", 3);
+		LLOcclusionBuffer banded;
+		banded.begin(mCamera);
+		addWall(banded, 10.f, 20.f, 10.f, 24);
+		addWall(banded, 6.f, 3.f, 12.f, 4);
+		banded.rasterize(&scheduler);
+
+		S32 covered = 0;
+		for (S32 y = 0; y < LLOcclusionBuffer::HEIGHT; y++)
+		{
+			for (S32 x = 0; x < LLOcclusionBuffer::WIDTH; x++)
+			{
+				ensure_equals("banded depth", banded.getDepth(x, y), serial.getDepth(x, y));
+				if (serial.getDepth(x, y) > 0.f)
+				{
+					covered++;
+				}
+			}
+		}
+		ensure("walls were drawn", covered > 0);
+		ensure("nearer wall wins", serial.getDepth(LLOcclusionBuffer::WIDTH / 2, LLOcclusionBuffer::HEIGHT / 2) > 1.f / 8.f);
+	}
+}
@@ -0,0 +1,257 @@
+/** 
+ * @file llscrolllistdatasource_tut.cpp
+ * @brief Scroll list data source sort and paging tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "../llui/llscrolllistdatasource.h"
+#include "lltut.h"
+
+#include <algorithm>
+
+
+namespace tut
+{
+	// two text columns: a name and a group
+	class TestRowSource : public LLScrollListDataSource
+	{
+	public:
+		void add(const std::string& name, const std::string& group)
+		{
+			mNames.push_back(name);
+			mGroups.push_back(group);
+		}
+
+		/*virtual*/ S32 getRowCount() const { return mNames.size(); }
+		/*virtual*/ LLSD getRowValue(S32 row) const { return row; }
+		/*virtual*/ std::string getCellText(S32 row, S32 column) const
+		{
+			return column == 0 ? mNames[row] : mGroups[row];
+		}
+		/*virtual*/ LLSD getRowElement(S32 row) const { return LLSD(); }
+
+	private:
+		std::vector<std::string> mNames;
+		std::vector<std::string> mGroups;
+	};
+
+	struct LLScrollListDataSourceTestData
+	{
+		TestRowSource mSource;
+		LLScrollListRowOrder::sort_order_t mSortOrders;
+
+		std::vector<S32> allRows() const
+		{
+			std::vector<S32> rows;
+			for (S32 row = 0; row < mSource.getRowCount(); row++)
+			{
+				rows.push_back(row);
+			}
+			return rows;
+		}
+	};
+
+	typedef test_group<LLScrollListDataSourceTestData> LLScrollListDataSourceTestGroup;
+	typedef LLScrollListDataSourceTestGroup::object LLScrollListDataSourceTestObject;
+
+	LLScrollListDataSourceTestGroup scrollListDataSourceTestGroup("LLScrollListDataSource");
+
+	// rows sort on the source's text, ascending or descending
+	template<> template<>
+		void LLScrollListDataSourceTestObject::test<1>()
+		{
+			mSource.add("cube", "");
+			mSource.add("Apple", "");
+			mSource.add("box 10", "");
+			mSource.add("box 9", "");
+			mSortOrders.push_back(std::make_pair(0, TRUE));
+
+			std::vector<S32> rows = allRows();
+			std::stable_sort(rows.begin(), rows.end(), LLScrollListRowOrder(mSortOrders, mSource));
+			ensure_equals("first", rows[0], 1);
+			ensure_equals("dictionary order of numbers", rows[1], 3);
+			ensure_equals("third", rows[2], 2);
+			ensure_equals("last", rows[3], 0);
+
+			mSortOrders[0].second = FALSE;
+			std::stable_sort(rows.begin(), rows.end(), LLScrollListRowOrder(mSortOrders, mSource));
+			ensure_equals("descending first", rows[0], 0);
+			ensure_equals("descending last", rows[3], 1);
+		}
+
+	// the last sort column is primary, earlier ones break ties
+	template<> template<>
+		void LLScrollListDataSourceTestObject::test<2>()
+		{
+			mSource.add("b", "one");
+			mSource.add("a", "two");
+			mSource.add("c", "one");
+			mSource.add("a", "one");
+			mSortOrders.push_back(std::make_pair(0, TRUE));
+			mSortOrders.push_back(std::make_pair(1, FALSE));
+
+			LLScrollListRowOrder order(mSortOrders, mSource);
+			ensure("group decides", order.compare(1, 0) < 0);
+			ensure("name breaks the tie", order.compare(3, 0) < 0);
+			ensure_equals("equal rows", order.compare(3, 3), 0);
+
+			std::vector<S32> rows = allRows();
+			std::stable_sort(rows.begin(), rows.end(), order);
+			ensure_equals("two first", rows[0], 1);
+			ensure_equals("then a", rows[1], 3);
+			ensure_equals("then b", rows[2], 0);
+			ensure_equals("then c", rows[3], 2);
+		}
+
+	// sorting only appended rows and merging them in, as the list does when
+	// rows are appended, gives the same order as sorting everything
+	template<> template<>
+		void LLScrollListDataSourceTestObject::test<3>()
+		{
+			for (S32 i = 0; i < 500; i++)
+			{
+				mSource.add(llformat("object %d", (i * 7919) % 97), llformat("group %d", i % 5));
+			}
+			mSortOrders.push_back(std::make_pair(1, TRUE));
+			mSortOrders.push_back(std::make_pair(0, TRUE));
+			LLScrollListRowOrder order(mSortOrders, mSource);
+
+			std::vector<S32> rows;
+			for (S32 row = 0; row < 300; row++)
+			{
+				rows.push_back(row);
+			}
+			std::stable_sort(rows.begin(), rows.end(), order);
+
+			for (S32 row = 300; row < 500; row++)
+			{
+				rows.push_back(row);
+			}
+			std::vector<S32>::iterator middle = rows.begin() + 300;
+			std::stable_sort(middle, rows.end(), order);
+			std::inplace_merge(rows.begin(), middle, rows.end(), order);
+
+			std::vector<S32> expected = allRows();
+			std::stable_sort(expected.begin(), expected.end(), order);
+			ensure("merged order matches a full sort", rows == expected);
+		}
+
+	// rows keep cells for a few pages, then only the drawn ones keep theirs
+	template<> template<>
+		void LLScrollListDataSourceTestObject::test<4>()
+		{
+			ensure_equals("small lists keep the minimum",
+				LLScrollListPaging::getMaxMaterialized(5), (S32)LLScrollListPaging::MIN_MATERIALIZED_ROWS);
+			ensure_equals("tall lists keep four pages", LLScrollListPaging::getMaxMaterialized(40), 164);
+			ensure("under budget", !LLScrollListPaging::needsTrim(64, 10));
+			ensure("over budget", LLScrollListPaging::needsTrim(65, 10));
+
+			// page through 1000 rows, 20 at a time, one page per frame
+			const S32 ROWS = 1000;
+			const S32 PAGE = 20;
+			std::vector<U32> last_drawn(ROWS, 0);
+			std::vector<bool> materialized(ROWS, false);
+			S32 num_materialized = 0;
+			S32 most_materialized = 0;
+			for (U32 frame = 1; frame <= ROWS / PAGE; frame++)
+			{
+				S32 first = (frame - 1) * PAGE;
+				for (S32 row = first; row < first + PAGE; row++)
+				{
+					if (!materialized[row])
+					{
+						materialized[row] = true;
+						num_materialized++;
+					}
+					last_drawn[row] = frame;
+				}
+				most_materialized = llmax(most_materialized, num_materialized);
+
+				if (LLScrollListPaging::needsTrim(num_materialized, PAGE))
+				{
+					num_materialized = 0;
+					for (S32 row = 0; row < ROWS; row++)
+					{
+						if (!materialized[row])
+						{
+							continue;
+						}
+						if (LLScrollListPaging::keepCells(last_drawn[row], frame))
+						{
+							num_materialized++;
+						}
+						else
+						{
+							materialized[row] = false;
+						}
+					}
+					ensure_equals("only the page on screen keeps cells", num_materialized, PAGE);
+				}
+			}
+			ensure("cells stay bounded", most_materialized <= LLScrollListPaging::getMaxMaterialized(PAGE) + PAGE);
+			ensure("visible rows have cells", materialized[ROWS - 1] && materialized[ROWS - PAGE]);
+		}
+
+	// deleting rows moves the rows after them up, in step with the source
+	template<> template<>
+		void LLScrollListDataSourceTestObject::test<5>()
+		{
+			const S32 ROWS = 10;
+			std::vector<S32> source;
+			for (S32 row = 0; row < ROWS; row++)
+			{
+				source.push_back(row);
+			}
+
+			std::vector<S32> removed;
+			removed.push_back(0);
+			removed.push_back(4);
+			removed.push_back(5);
+			removed.push_back(9);
+			for (S32 i = (S32)removed.size() - 1; i >= 0; i--)
+			{
+				source.erase(source.begin() + removed[i]);
+			}
+
+			for (S32 row = 0; row < ROWS; row++)
+			{
+				if (std::find(removed.begin(), removed.end(), row) != removed.end())
+				{
+					continue;
+				}
+				S32 shifted = LLScrollListPaging::shiftRow(row, removed);
+				ensure("shifted row in range", shifted >= 0 && shifted < (S32)source.size());
+				ensure_equals("shifted row holds the same data", source[shifted], row);
+			}
+			ensure_equals("nothing removed", LLScrollListPaging::shiftRow(3, std::vector<S32>()), 3);
+		}
+}
@@ -37,6 +37,7 @@
 
 #include "llsdtraits.h"
 #include "llstring.h"
+#include "lltimer.h"
 
 namespace tut
 {
@@ -759,6 +760,113 @@ namespace tut
 		ensure("type is a string", v.isString());
 	}
 
+	template<> template<>
+	void SDTestObject::test<15>()
+		// booleans and empty containers use the shared, pinned impls
+	{
+		SDCleanupCheck check;
+		
+		{
+			SDAllocationCheck check("booleans are shared", 0);
+			LLSD v = true;
+			LLSD w = false;
+			v = false;
+			w = v;
+			w = true;
+			ensureTypeAndValue("shared true", w, true);
+			ensureTypeAndValue("shared false", v, false);
+		}
+
+		{
+			SDAllocationCheck check("empty map and array are shared", 0);
+			LLSD m = LLSD::emptyMap();
+			LLSD a = LLSD::emptyArray();
+			LLSD n = m;
+			ensure("empty map", m.isMap() && m.size() == 0);
+			ensure("empty array", a.isArray() && a.size() == 0);
+		}
+
+		{
+			SDAllocationCheck check("empty map copied on write", 2);
+			LLSD m = LLSD::emptyMap();
+			LLSD n = LLSD::emptyMap();
+			n["alpha"] = true;
+			n["beta"] = 3;
+			ensure_equals("original untouched", m.size(), 0);
+			ensure_equals("copy modified", n.size(), 2);
+			ensure_equals("fresh empty map", LLSD::emptyMap().size(), 0);
+		}
+	}
+
+	template<> template<>
+	void SDTestObject::test<16>()
+		// memory and traversal benchmark over an inventory shaped document;
+		// the allocation count is checked, the timings are only logged
+	{
+		SDCleanupCheck check;
+
+		const S32 RECORD_COUNT = 20000;
+		// per record: the map, the string, the integer and the real;
+		// the two booleans and both empty containers are shared
+		const U32 ALLOCATIONS_PER_RECORD = 4;
+		const U32 SHARED_PER_RECORD = 4;
+
+		LLTimer timer;
+		U32 start = LLSD::allocationCount();
+		{
+			LLSD doc;
+			for (S32 i = 0; i < RECORD_COUNT; ++i)
+			{
+				LLSD record;
+				record["name"] = std::string("object");
+				record["id"] = i;
+				record["weight"] = F64(i) * 0.5;
+				record["active"] = (i % 2 == 0);
+				record["hidden"] = false;
+				record["children"] = LLSD::emptyArray();
+				record["meta"] = LLSD::emptyMap();
+				doc.append(record);
+			}
+			F64 build_time = timer.getElapsedTimeF64();
+			U32 allocations = LLSD::allocationCount() - start;
+			ensure_equals("document allocations", allocations,
+				1 + RECORD_COUNT * ALLOCATIONS_PER_RECORD);
+
+			S64 id_sum = 0;
+			S32 active = 0;
+			S32 empty = 0;
+			timer.reset();
+			for (LLSD::array_const_iterator it = doc.beginArray(); it != doc.endArray(); ++it)
+			{
+				for (LLSD::map_const_iterator field = it->beginMap(); field != it->endMap(); ++field)
+				{
+					const LLSD& value = field->second;
+					if (value.isInteger())
+					{
+						id_sum += value.asInteger();
+					}
+					else if (value.isBoolean())
+					{
+						active += value.asBoolean() ? 1 : 0;
+					}
+					else if ((value.isArray() || value.isMap()) && value.size() == 0)
+					{
+						++empty;
+					}
+				}
+			}
+			F64 traverse_time = timer.getElapsedTimeF64();
+			ensure_equals("id sum", id_sum, S64(RECORD_COUNT) * (RECORD_COUNT - 1) / 2);
+			ensure_equals("active count", active, RECORD_COUNT / 2);
+			ensure_equals("empty count", empty, RECORD_COUNT * 2);
+
+			llinfos << RECORD_COUNT << " records: " << allocations
+				<< " impls allocated (" << RECORD_COUNT * SHARED_PER_RECORD
+				<< " more without shared impls), build " << build_time
+				<< "s, traverse " << traverse_time << "s" << llendl;
+		}
+	}
+
 	/* TO DO:
 		conversion of undefined to UUID, Date, URI and Binary
 		conversion of undefined to map and array
@@ -771,7 +879,6 @@ namespace tut
 		test iteration over array
 		test iteration over scalar
 
-		test empty map and empty array are indeed shared
 		test serializations
 	*/
 }
@@ -0,0 +1,226 @@
+/** 
+ * @file lltaskscheduler_tut.cpp
+ * @brief LLTaskScheduler test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llqueuedthread.h"
+#include "lltaskscheduler.h"
+#include "lltimer.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct taskscheduler_data
+	{
+		taskscheduler_data() : mRunCount(0), mCancelCount(0) {}
+
+		class CountTask : public LLTaskScheduler::Task
+		{
+		public:
+			CountTask(taskscheduler_data* data, LLTaskScheduler::CancelToken* token = NULL)
+				: LLTaskScheduler::Task(token), mData(data) {}
+			/*virtual*/ void run() { mData->mRunCount += 1; }
+			/*virtual*/ void cancelled() { mData->mCancelCount += 1; }
+		private:
+			taskscheduler_data* mData;
+		};
+
+		// Spin until expected tasks have finished, or give up after a few seconds.
+		void waitFor(U32 expected)
+		{
+			for (S32 i = 0; i < 500 && (U32)mRunCount + (U32)mCancelCount < expected; ++i)
+			{
+				ms_sleep(10);
+			}
+		}
+
+		LLAtomicU32 mRunCount;
+		LLAtomicU32 mCancelCount;
+	};
+	// A queue whose requests record how many of them run at once
+	class CountQueue : public LLQueuedThread
+	{
+	public:
+		class CountRequest : public QueuedRequest
+		{
+		public:
+			CountRequest(handle_t handle, U32 priority, CountQueue* queue)
+				: QueuedRequest(handle, priority, FLAG_AUTO_COMPLETE), mQueue(queue) {}
+		protected:
+			/*virtual*/ bool processRequest()
+			{
+				U32 running = mQueue->mRunning++ + 1;
+				if (running > 1)
+				{
+					mQueue->mOverlapped = 1;
+				}
+				ms_sleep(mQueue->mDelay);
+				mQueue->mRunning -= 1;
+				mQueue->mProcessed++;
+				return true;
+			}
+		private:
+			CountQueue* mQueue;
+		};
+
+		CountQueue(bool dedicated_thread)
+			: LLQueuedThread("CountQueue", true, dedicated_thread),
+			  mRunning(0), mOverlapped(0), mProcessed(0), mDelay(1) {}
+
+		void add(U32 priority)
+		{
+			addRequest(new CountRequest(generateHandle(), priority, this));
+		}
+
+		void waitFor(U32 expected)
+		{
+			for (S32 i = 0; i < 500 && (U32)mProcessed < expected; ++i)
+			{
+				update(0);
+				ms_sleep(10);
+			}
+		}
+
+		LLAtomicU32 mRunning;
+		LLAtomicU32 mOverlapped;
+		LLAtomicU32 mProcessed;
+		U32 mDelay;
+	};
+
+	typedef test_group<taskscheduler_data> taskscheduler_test;
+	typedef taskscheduler_test::object taskscheduler_object;
+	tut::taskscheduler_test taskscheduler_testcase("taskscheduler");
+
+	template<> template<>
+	void taskscheduler_object::test<1>()
+	{
+		LLTaskScheduler scheduler("TestScheduler", 3);
+		ensure_equals("worker count", scheduler.getNumWorkers(), 3U);
+
+		const U32 count = 1000;
+		for (U32 i = 0; i < count; ++i)
+		{
+			scheduler.schedule(new CountTask(this), (LLTaskScheduler::lane_t)(i % LLTaskScheduler::LANE_COUNT));
+		}
+		waitFor(count);
+		ensure_equals("all tasks ran", (U32)mRunCount, count);
+		ensure_equals("none cancelled", (U32)mCancelCount, 0U);
+		ensure_equals("nothing pending", scheduler.getPending(), 0);
+	}
+
+	template<> template<>
+	void taskscheduler_object::test<2>()
+	{
+		LLTaskScheduler::cancel_token_t token = new LLTaskScheduler::CancelToken;
+		token->cancel();
+
+		LLTaskScheduler scheduler("TestScheduler", 2);
+		const U32 count = 100;
+		for (U32 i = 0; i < count; ++i)
+		{
+			scheduler.schedule(new CountTask(this, token));
+			scheduler.schedule(new CountTask(this));
+		}
+		waitFor(count * 2);
+		ensure_equals("uncancelled tasks ran", (U32)mRunCount, count);
+		ensure_equals("cancelled tasks skipped", (U32)mCancelCount, count);
+	}
+
+	template<> template<>
+	void taskscheduler_object::test<3>()
+		// LLQueuedThread drains through the shared pool, one request at a time
+	{
+		LLTaskScheduler::initClass(3);
+		{
+			CountQueue queue(false);
+			ensure("uses the pool", queue.getUsesScheduler());
+
+			const U32 count = 200;
+			const U32 priorities[] = {
+				LLQueuedThread::PRIORITY_URGENT, LLQueuedThread::PRIORITY_HIGH,
+				LLQueuedThread::PRIORITY_NORMAL, LLQueuedThread::PRIORITY_LOW };
+			for (U32 i = 0; i < count; ++i)
+			{
+				queue.add(priorities[i % 4]);
+			}
+			queue.waitFor(count);
+			ensure_equals("all requests processed", (U32)queue.mProcessed, count);
+			ensure("never processed concurrently", (U32)queue.mOverlapped == 0);
+			ensure_equals("queue empty", queue.getPending(), 0);
+		}
+		LLTaskScheduler::cleanupClass();
+	}
+
+	template<> template<>
+	void taskscheduler_object::test<4>()
+		// queues that ask for their own thread keep it, and a queue still
+		// holding requests shuts down cleanly before the pool does
+	{
+		LLTaskScheduler::initClass(2);
+		{
+			CountQueue dedicated(true);
+			ensure("own thread", !dedicated.getUsesScheduler());
+			dedicated.add(LLQueuedThread::PRIORITY_NORMAL);
+			dedicated.waitFor(1);
+			ensure_equals("dedicated processed", (U32)dedicated.mProcessed, 1U);
+
+			CountQueue pooled(false);
+			for (U32 i = 0; i < 500; ++i)
+			{
+				pooled.add(LLQueuedThread::PRIORITY_LOW);
+			}
+		}
+		LLTaskScheduler::cleanupClass();
+		ensure("pool gone", LLTaskScheduler::getInstance() == NULL);
+	}
+
+	template<> template<>
+	void taskscheduler_object::test<5>()
+		// shutting a queue down waits for the drain task that is running
+		// its request, however slow the request is
+	{
+		LLTaskScheduler::initClass(2);
+		CountQueue* queue = new CountQueue(false);
+		queue->mDelay = 500;
+		queue->add(LLQueuedThread::PRIORITY_NORMAL);
+		for (S32 i = 0; i < 500 && (U32)queue->mRunning == 0; ++i)
+		{
+			ms_sleep(1);
+		}
+		ensure("request started", (U32)queue->mRunning == 1);
+		queue->shutdown();
+		ensure_equals("request finished before shutdown returned", (U32)queue->mProcessed, 1U);
+		delete queue;
+		LLTaskScheduler::cleanupClass();
+	}
+}
@@ -0,0 +1,224 @@
+/** 
+ * @file lltransfermanager_tut.cpp
+ * @brief LLTransferManager channel scheduling test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "lltransfermanager.h"
+#include "lltut.h"
+
+namespace tut
+{
+	// Loopback harness: sources hand out fixed size payloads and the
+	// channel delivers every packet straight back into the test instead
+	// of onto the wire.
+	struct transfermanager_data
+	{
+		struct Received
+		{
+			Received() : mBytes(0), mPackets(0), mLastPacketID(-1), mInOrder(true), mStatus(LLTS_OK) {}
+			S32 mBytes;
+			S32 mPackets;
+			S32 mLastPacketID;
+			bool mInOrder;
+			LLTSCode mStatus;
+		};
+		typedef std::map<LLUUID, Received> received_map_t;
+
+		class LoopbackSource : public LLTransferSource
+		{
+		public:
+			LoopbackSource(const LLUUID &id, const F32 priority, const S32 size, received_map_t *received)
+				: LLTransferSource(LLTST_UNKNOWN, id, priority), mStalled(false), mRemaining(size), mReceived(received)
+			{
+				mSize = size;
+			}
+
+			bool mStalled;
+
+		protected:
+			/*virtual*/ void initTransfer() {}
+			/*virtual*/ F32 updatePriority() { return 0.f; }
+			/*virtual*/ LLTSCode dataCallback(const S32 packet_id, const S32 max_bytes,
+											  U8 **datap, S32 &returned_bytes, BOOL &delete_returned)
+			{
+				static U8 sPayload[MAX_PAYLOAD];
+				if (mStalled)
+				{
+					return LLTS_SKIP;
+				}
+				returned_bytes = llmin(max_bytes, mRemaining);
+				mRemaining -= returned_bytes;
+				*datap = sPayload;
+				delete_returned = FALSE;
+				return mRemaining ? LLTS_OK : LLTS_DONE;
+			}
+			/*virtual*/ void completionCallback(const LLTSCode status) { (*mReceived)[getID()].mStatus = status; }
+			/*virtual*/ void abortTransfer() { completionCallback(LLTS_ABORT); }
+			/*virtual*/ void packParams(LLDataPacker& dp) const {}
+			/*virtual*/ BOOL unpackParams(LLDataPacker& dp) { return TRUE; }
+
+		private:
+			enum { MAX_PAYLOAD = 4096 };
+			S32 mRemaining;
+			received_map_t *mReceived;
+		};
+
+		class LoopbackChannel : public LLTransferSourceChannel
+		{
+		public:
+			LoopbackChannel(received_map_t *received)
+				: LLTransferSourceChannel(LLTCT_MISC, LLHost()), mReceived(received) {}
+
+		protected:
+			/*virtual*/ S32 sendTransferPacket(LLTransferSource *tsp, const S32 packet_id,
+											   const LLTSCode status, U8 *datap, const S32 data_size)
+			{
+				Received &recv = (*mReceived)[tsp->getID()];
+				recv.mInOrder = recv.mInOrder && (packet_id == recv.mLastPacketID + 1);
+				recv.mLastPacketID = packet_id;
+				recv.mBytes += data_size;
+				recv.mPackets++;
+				return data_size + PACKET_OVERHEAD;
+			}
+
+		private:
+			enum { PACKET_OVERHEAD = 50 };
+			received_map_t *mReceived;
+		};
+
+		transfermanager_data() : mChannel(&mReceived)
+		{
+			gTransferManager.resetSourceStats(LLTCT_MISC);
+		}
+
+		LLUUID addSource(const F32 priority, const S32 size)
+		{
+			LLUUID id;
+			id.generate();
+			mLastSource = new LoopbackSource(id, priority, size, &mReceived);
+			mChannel.addTransferSource(mLastSource);
+			return id;
+		}
+
+		// One frame's worth of sending against a fresh throttle of bps bits.
+		void sendFrame(F32 bps)
+		{
+			F32 throttle[TC_EOF];
+			for (S32 i = 0; i < TC_EOF; i++)
+			{
+				throttle[i] = bps;
+			}
+			LLThrottleGroup tg;
+			tg.setNominalBPS(throttle);
+			mChannel.sendTransfers(tg);
+		}
+
+		received_map_t mReceived;
+		LoopbackChannel mChannel;
+		LoopbackSource *mLastSource;
+	};
+	typedef test_group<transfermanager_data> transfermanager_test;
+	typedef transfermanager_test::object transfermanager_object;
+	tut::transfermanager_test transfermanager_testcase("transfermanager");
+
+	template<> template<>
+	void transfermanager_object::test<1>()
+	{
+		// Every transfer is delivered in full and in order.
+		LLUUID id1 = addSource(100.f, 5000);
+		LLUUID id2 = addSource(101.f, 3500);
+		LLUUID id3 = addSource(100.f, 1);
+
+		for (S32 frame = 0; (frame < 100) && mChannel.getNumTransfers(); frame++)
+		{
+			sendFrame(40000.f);
+		}
+		ensure_equals("all transfers finished", mChannel.getNumTransfers(), 0);
+		ensure_equals("bytes 1", mReceived[id1].mBytes, 5000);
+		ensure_equals("bytes 2", mReceived[id2].mBytes, 3500);
+		ensure_equals("bytes 3", mReceived[id3].mBytes, 1);
+		ensure("in order 1", mReceived[id1].mInOrder);
+		ensure("in order 2", mReceived[id2].mInOrder);
+		ensure_equals("status", mReceived[id1].mStatus, LLTS_DONE);
+
+		const LLTransferStats &stats = gTransferManager.getSourceStats(LLTCT_MISC);
+		ensure_equals("stats completed", stats.mCompleted, 3U);
+		ensure_equals("stats failed", stats.mFailed, 0U);
+		ensure_equals("stats bytes", (S32)stats.mBytesSent, 8501);
+	}
+
+	template<> template<>
+	void transfermanager_object::test<2>()
+	{
+		// The higher priority transfer gets the larger share of a tight
+		// throttle, but the lower one is not starved.
+		LLUUID low = addSource(100.f, 100000);
+		LLUUID high = addSource(101.f, 100000);
+
+		sendFrame(80000.f);
+		S32 high_bytes = mReceived[high].mBytes;
+		S32 low_bytes = mReceived[low].mBytes;
+		ensure("high priority sent", high_bytes > 0);
+		ensure("low priority not starved", low_bytes > 0);
+		ensure("high priority favoured", high_bytes > low_bytes);
+
+		// Nothing goes out once the throttle is used up.
+		S32 total = high_bytes + low_bytes;
+		ensure("throttle respected", total * 8 <= 80000 + 8 * 1050);
+	}
+
+	template<> template<>
+	void transfermanager_object::test<3>()
+	{
+		// A stalled transfer neither blocks the others nor banks credit.
+		LLUUID stalled = addSource(200.f, 5000);
+		LoopbackSource *stalled_source = mLastSource;
+		stalled_source->mStalled = true;
+		LLUUID other = addSource(100.f, 5000);
+
+		for (S32 frame = 0; (frame < 100) && (mChannel.getNumTransfers() > 1); frame++)
+		{
+			sendFrame(40000.f);
+		}
+		ensure_equals("other finished", mReceived[other].mBytes, 5000);
+		ensure_equals("stalled sent nothing", mReceived[stalled].mBytes, 0);
+		ensure("stalled still queued", mChannel.findTransferSource(stalled) == stalled_source);
+
+		stalled_source->mStalled = false;
+		for (S32 frame = 0; (frame < 100) && mChannel.getNumTransfers(); frame++)
+		{
+			sendFrame(40000.f);
+		}
+		ensure_equals("stalled finished", mReceived[stalled].mBytes, 5000);
+	}
+}
@@ -0,0 +1,211 @@
+/** 
+ * @file lluuidopenhashmap_tut.cpp
+ * @brief LLUUIDOpenHashMap test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "lluuidopenhashmap.h"
+#include "llstl.h"
+#include "lltimer.h"
+#include "lltut.h"
+
+#include <map>
+
+namespace tut
+{
+	struct LLUUIDOpenHashMapTestData
+	{
+		typedef LLUUIDOpenHashMap<S32> map_t;
+
+		// Rough size of a large resident's inventory
+		enum { BENCH_COUNT = 100000 };
+
+		std::vector<LLUUID> makeIDs(S32 count)
+		{
+			std::vector<LLUUID> ids;
+			ids.reserve(count);
+			for (S32 i = 0; i < count; ++i)
+			{
+				LLUUID id;
+				id.generate();
+				ids.push_back(id);
+			}
+			return ids;
+		}
+	};
+
+	typedef test_group<LLUUIDOpenHashMapTestData> LLUUIDOpenHashMapTestGroup;
+	typedef LLUUIDOpenHashMapTestGroup::object LLUUIDOpenHashMapTestObject;
+
+	LLUUIDOpenHashMapTestGroup uuidOpenHashMapTestGroup("LLUUIDOpenHashMap");
+
+	// Insert, find and overwrite
+	template<> template<>
+		void LLUUIDOpenHashMapTestObject::test<1>()
+		{
+			map_t map;
+			ensure("starts empty", map.empty());
+			ensure("miss on empty map", map.find(LLUUID::null) == map.end());
+			ensure_equals("erase on empty map", map.erase(LLUUID::null), 0U);
+
+			std::vector<LLUUID> ids = makeIDs(1000);
+			for (S32 i = 0; i < 1000; ++i)
+			{
+				map[ids[i]] = i;
+			}
+			ensure_equals("size", map.size(), 1000U);
+			for (S32 i = 0; i < 1000; ++i)
+			{
+				map_t::iterator it = map.find(ids[i]);
+				ensure("found", it != map.end());
+				ensure_equals("key", it->first, ids[i]);
+				ensure_equals("value", it->second, i);
+			}
+
+			std::pair<map_t::iterator, bool> result = map.insert(std::make_pair(ids[5], 99));
+			ensure("insert of existing key fails", !result.second);
+			ensure_equals("insert keeps old value", result.first->second, 5);
+			map[ids[5]] = 99;
+			ensure_equals("operator[] replaces", map.find(ids[5])->second, 99);
+			ensure_equals("size unchanged", map.size(), 1000U);
+			ensure("miss", map.find(LLUUID::null) == map.end());
+			ensure_equals("count", map.count(ids[7]), 1U);
+		}
+
+	// Erase keeps every other entry reachable, matched against std::map
+	template<> template<>
+		void LLUUIDOpenHashMapTestObject::test<2>()
+		{
+			map_t map;
+			std::map<LLUUID, S32> reference;
+			std::vector<LLUUID> ids = makeIDs(5000);
+			for (S32 i = 0; i < 5000; ++i)
+			{
+				map[ids[i]] = i;
+				reference[ids[i]] = i;
+			}
+			for (S32 i = 0; i < 5000; i += 3)
+			{
+				ensure_equals("erased", map.erase(ids[i]), 1U);
+				reference.erase(ids[i]);
+			}
+			ensure_equals("second erase misses", map.erase(ids[0]), 0U);
+			ensure_equals("size", map.size(), reference.size());
+			for (S32 i = 0; i < 5000; ++i)
+			{
+				bool expected = (i % 3) != 0;
+				ensure_equals("present", map.count(ids[i]) == 1, expected);
+				if (expected)
+				{
+					ensure_equals("value", map.find(ids[i])->second, i);
+				}
+			}
+
+			// Iteration visits each entry exactly once
+			S32 visited = 0;
+			for (map_t::const_iterator it = map.begin(); it != map.end(); ++it)
+			{
+				ensure_equals("iterated value", reference[it->first], it->second);
+				++visited;
+			}
+			ensure_equals("visited all", (size_t)visited, reference.size());
+
+			map.clear();
+			ensure("cleared", map.empty());
+			ensure("miss after clear", map.find(ids[1]) == map.end());
+		}
+
+	// Pointer helpers from llstl.h
+	template<> template<>
+		void LLUUIDOpenHashMapTestObject::test<3>()
+		{
+			LLUUIDOpenHashMap<S32*> map;
+			LLUUID id;
+			id.generate();
+			S32 value = 7;
+			ensure("no pointer yet", get_ptr_in_map(map, id) == NULL);
+			map[id] = &value;
+			ensure("pointer", get_ptr_in_map(map, id) == &value);
+			ensure("is_in_map", is_in_map(map, id));
+			ensure("not in map", !is_in_map(map, LLUUID::null));
+		}
+
+	// Lookup benchmark against std::map on a large synthetic inventory.
+	// Only logs timings; correctness is covered above.
+	template<> template<>
+		void LLUUIDOpenHashMapTestObject::test<4>()
+		{
+			std::vector<LLUUID> ids = makeIDs(BENCH_COUNT);
+			std::map<LLUUID, S32> tree;
+			map_t hash;
+			LLTimer timer;
+
+			timer.reset();
+			for (S32 i = 0; i < BENCH_COUNT; ++i)
+			{
+				tree[ids[i]] = i;
+			}
+			F64 tree_insert = timer.getElapsedTimeF64();
+			timer.reset();
+			for (S32 i = 0; i < BENCH_COUNT; ++i)
+			{
+				hash[ids[i]] = i;
+			}
+			F64 hash_insert = timer.getElapsedTimeF64();
+
+			S64 tree_sum = 0;
+			S64 hash_sum = 0;
+			timer.reset();
+			for (S32 pass = 0; pass < 4; ++pass)
+			{
+				for (S32 i = BENCH_COUNT - 1; i >= 0; --i)
+				{
+					tree_sum += tree.find(ids[i])->second;
+				}
+			}
+			F64 tree_find = timer.getElapsedTimeF64();
+			timer.reset();
+			for (S32 pass = 0; pass < 4; ++pass)
+			{
+				for (S32 i = BENCH_COUNT - 1; i >= 0; --i)
+				{
+					hash_sum += hash.find(ids[i])->second;
+				}
+			}
+			F64 hash_find = timer.getElapsedTimeF64();
+			ensure_equals("same lookups", hash_sum, tree_sum);
+
+			llinfos << BENCH_COUNT << " uuids, std::map insert " << tree_insert
+				<< "s find " << tree_find << "s; LLUUIDOpenHashMap insert "
+				<< hash_insert << "s find " << hash_find << "s" << llendl;
+		}
+}
@@ -0,0 +1,227 @@
+/** 
+ * @file llvivoxprotocolparser_tut.cpp
+ * @brief LLVivoxProtocolParser test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llvivoxprotocolparser.h"
+#include "llbuffer.h"
+#include "llsd.h"
+#include "lltimer.h"
+#include "lltut.h"
+
+namespace tut
+{
+	// Records what the parser delivers, one line per call
+	class LLVivoxTestSink : public LLVivoxProtocolSink
+	{
+	public:
+		LLVivoxTestSink() : mConnected(true) {}
+
+		/*virtual*/ bool isDaemonConnected() { return mConnected; }
+
+		/*virtual*/ void connectorCreateResponse(int statusCode, std::string &statusString, std::string &connectorHandle, std::string &versionID)
+		{
+			mCalls.push_back(llformat("connector %d %s %s", statusCode, connectorHandle.c_str(), versionID.c_str()));
+		}
+
+		/*virtual*/ void participantAddedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, std::string &uriString, std::string &alias, std::string &nameString, std::string &displayNameString, int participantType)
+		{
+			mCalls.push_back(llformat("added %s %s", sessionHandle.c_str(), uriString.c_str()));
+		}
+
+		/*virtual*/ void participantUpdatedEvent(std::string &sessionHandle, std::string &sessionGroupHandle, std::string &uriString, std::string &alias, bool isModeratorMuted, bool isSpeaking, int volume, F32 energy)
+		{
+			mCalls.push_back(llformat("updated %s %s %d %d", sessionHandle.c_str(), uriString.c_str(), (S32)isSpeaking, volume));
+		}
+
+		std::vector<std::string> mCalls;
+		bool mConnected;
+	};
+
+	struct LLVivoxProtocolParserTestData
+	{
+		LLVivoxProtocolParserTestData()
+		:	mParser(new LLVivoxProtocolParser(&mSink)),
+			mBuffer(new LLBufferArray),
+			mChannels(mBuffer->nextChannel())
+		{
+		}
+
+		// Delivers one read from the daemon socket
+		LLIOPipe::EStatus read(const std::string& data)
+		{
+			mBuffer->append(mChannels.in(), (const U8*)data.data(), (S32)data.size());
+			bool eos = false;
+			LLSD context;
+			return mParser->process(mChannels, mBuffer, eos, context, NULL);
+		}
+
+		static std::string updated(const std::string& session, const std::string& uri, bool speaking, S32 volume)
+		{
+			return llformat(
+				"<Event type=\"ParticipantUpdatedEvent\">"
+				"<SessionGroupHandle>%s_sg</SessionGroupHandle>"
+				"<SessionHandle>%s</SessionHandle>"
+				"<ParticipantUri>%s</ParticipantUri>"
+				"<IsModeratorMuted>false</IsModeratorMuted>"
+				"<IsSpeaking>%s</IsSpeaking>"
+				"<Volume>%d</Volume>"
+				"<Energy>0.0879437</Energy>"
+				"</Event>\n\n\n",
+				session.c_str(), session.c_str(), uri.c_str(), speaking ? "true" : "false", volume);
+		}
+
+		static std::string added(const std::string& session, const std::string& uri)
+		{
+			return llformat(
+				"<Event type=\"ParticipantAddedEvent\">"
+				"<SessionGroupHandle>%s_sg</SessionGroupHandle>"
+				"<SessionHandle>%s</SessionHandle>"
+				"<ParticipantUri>%s</ParticipantUri>"
+				"<AccountName>x</AccountName>"
+				"<DisplayName />"
+				"<ParticipantType>0</ParticipantType>"
+				"</Event>\n\n\n",
+				session.c_str(), session.c_str(), uri.c_str());
+		}
+
+		LLVivoxTestSink mSink;
+		LLIOPipe::ptr_t mParser;
+		LLIOPipe::buffer_ptr_t mBuffer;
+		LLChannelDescriptors mChannels;
+	};
+	typedef test_group<LLVivoxProtocolParserTestData> LLVivoxProtocolParserTestGroup;
+	typedef LLVivoxProtocolParserTestGroup::object LLVivoxProtocolParserTestObject;
+	LLVivoxProtocolParserTestGroup vivoxProtocolParserTestGroup("LLVivoxProtocolParser");
+
+	// a response is handed over once its delimiter arrives
+	template<> template<>
+		void LLVivoxProtocolParserTestObject::test<1>()
+		{
+			ensure_equals("status", read(
+				"<Response requestId=\"1\" action=\"Connector.Create.1\">"
+				"<ReturnCode>0</ReturnCode>"
+				"<Results><StatusCode>0</StatusCode><StatusString /><VersionID>2.1</VersionID>"
+				"<ConnectorHandle>c1</ConnectorHandle></Results>"
+				"<InputXml><Request><ConnectorHandle>ignored</ConnectorHandle></Request></InputXml>"
+				"</Response>\n\n\n"), LLIOPipe::STATUS_OK);
+			ensure_equals("one call", mSink.mCalls.size(), (size_t)1);
+			ensure_equals("response", mSink.mCalls[0], std::string("connector 0 c1 2.1"));
+
+			mSink.mConnected = false;
+			ensure_equals("stops once disconnected", read(""), LLIOPipe::STATUS_STOP);
+		}
+
+	// messages and their delimiters may be split anywhere across reads
+	template<> template<>
+		void LLVivoxProtocolParserTestObject::test<2>()
+		{
+			std::string message = added("s1", "sip:a") + added("s1", "sip:b");
+			size_t first_end = message.find("\n\n\n");
+
+			// split inside the first delimiter
+			read(message.substr(0, first_end + 1));
+			ensure_equals("first not delivered yet", mSink.mCalls.size(), (size_t)0);
+			read(message.substr(first_end + 1, 1));
+			ensure_equals("still waiting on the last newline", mSink.mCalls.size(), (size_t)0);
+			read(message.substr(first_end + 2, 20));
+			ensure_equals("first delivered", mSink.mCalls.size(), (size_t)1);
+			ensure_equals("first", mSink.mCalls[0], std::string("added s1 sip:a"));
+
+			// then one byte at a time
+			for (size_t i = first_end + 22; i < message.size(); i++)
+			{
+				read(message.substr(i, 1));
+			}
+			ensure_equals("second delivered", mSink.mCalls.size(), (size_t)2);
+			ensure_equals("second", mSink.mCalls[1], std::string("added s1 sip:b"));
+		}
+
+	// participant updates are coalesced per participant within a read but
+	// never reordered past other events
+	template<> template<>
+		void LLVivoxProtocolParserTestObject::test<3>()
+		{
+			read(updated("s1", "sip:a", true, 10) +
+				 updated("s1", "sip:b", false, 20) +
+				 updated("s2", "sip:a", false, 30) +
+				 updated("s1", "sip:a", false, 11) +
+				 added("s1", "sip:c") +
+				 updated("s1", "sip:b", true, 21));
+
+			ensure_equals("calls", mSink.mCalls.size(), (size_t)5);
+			ensure_equals("latest a in s1, in its first place", mSink.mCalls[0], std::string("updated s1 sip:a 0 11"));
+			ensure_equals("b in s1", mSink.mCalls[1], std::string("updated s1 sip:b 0 20"));
+			ensure_equals("a in s2 kept apart", mSink.mCalls[2], std::string("updated s2 sip:a 0 30"));
+			ensure_equals("other events flush first", mSink.mCalls[3], std::string("added s1 sip:c"));
+			ensure_equals("flushed at the end of the read", mSink.mCalls[4], std::string("updated s1 sip:b 1 21"));
+
+			// nothing is held over to the next read
+			read(updated("s1", "sip:b", true, 22));
+			ensure_equals("next read", mSink.mCalls.size(), (size_t)6);
+			ensure_equals("next read update", mSink.mCalls[5], std::string("updated s1 sip:b 1 22"));
+		}
+
+	// Replays a busy channel in socket sized reads, as the daemon sends it.
+	// Only logs timings; correctness is covered above.
+	template<> template<>
+		void LLVivoxProtocolParserTestObject::test<4>()
+		{
+			const S32 SPEAKERS = 40;
+			const S32 ROUNDS = 250;
+			const size_t READ_SIZE = 1400;
+
+			std::string stream;
+			for (S32 round = 0; round < ROUNDS; round++)
+			{
+				for (S32 speaker = 0; speaker < SPEAKERS; speaker++)
+				{
+					stream += updated("s1", llformat("sip:x%d@bhr.vivox.com", speaker), (round + speaker) % 3 == 0, 40 + round % 10);
+				}
+			}
+
+			LLTimer timer;
+			for (size_t pos = 0; pos < stream.size(); pos += READ_SIZE)
+			{
+				read(stream.substr(pos, READ_SIZE));
+			}
+			F64 elapsed = timer.getElapsedTimeF64();
+
+			ensure("updates delivered", mSink.mCalls.size() > 0 && mSink.mCalls.size() <= (size_t)(SPEAKERS * ROUNDS));
+			ensure_equals("last update", mSink.mCalls.back(),
+				llformat("updated s1 sip:x%d@bhr.vivox.com %d %d", SPEAKERS - 1, (S32)((ROUNDS - 1 + SPEAKERS - 1) % 3 == 0), 40 + (ROUNDS - 1) % 10));
+
+			llinfos << SPEAKERS * ROUNDS << " participant updates in " << stream.size() / READ_SIZE + 1
+				<< " reads parsed in " << elapsed << "s, " << mSink.mCalls.size() << " delivered" << llendl;
+		}
+}
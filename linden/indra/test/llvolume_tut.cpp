@@ -0,0 +1,268 @@
+/** 
+ * @file llvolume_tut.cpp
+ * @brief LLVolumeFace vertex cache optimization test cases.
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+#include <algorithm>
+
+#include "linden_common.h"
+#include "llvolume.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct volume_data
+	{
+		typedef std::vector<F32> tri_key_t;
+
+		// Corpus of prim shapes people actually build with.
+		std::vector<LLVolumeParams> makeCorpus()
+		{
+			std::vector<LLVolumeParams> corpus;
+			const U8 profiles[] = { LL_PCODE_PROFILE_SQUARE, LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PROFILE_EQUALTRI, LL_PCODE_PROFILE_CIRCLE_HALF };
+			const U8 paths[] = { LL_PCODE_PATH_LINE, LL_PCODE_PATH_CIRCLE };
+			const F32 hollows[] = { 0.f, 0.5f };
+			const F32 cuts[] = { 0.f, 0.25f };
+
+			for (U32 p = 0; p < LL_ARRAY_SIZE(profiles); p++)
+			{
+				for (U32 c = 0; c < LL_ARRAY_SIZE(paths); c++)
+				{
+					for (U32 h = 0; h < LL_ARRAY_SIZE(hollows); h++)
+					{
+						for (U32 b = 0; b < LL_ARRAY_SIZE(cuts); b++)
+						{
+							LLVolumeParams params;
+							params.setType(profiles[p], paths[c]);
+							params.setBeginAndEndS(cuts[b], 1.f);
+							params.setBeginAndEndT(0.f, 1.f);
+							params.setRatio(1.f, paths[c] == LL_PCODE_PATH_CIRCLE ? 0.25f : 1.f);
+							params.setShear(0.f, 0.f);
+							params.setHollow(hollows[h]);
+							corpus.push_back(params);
+						}
+					}
+				}
+			}
+			return corpus;
+		}
+
+		LLPointer<LLVolume> makeVolume(const LLVolumeParams& params, F32 detail, BOOL optimize)
+		{
+			BOOL old = LLVolumeFace::sOptimizeVertexCache;
+			LLVolumeFace::sOptimizeVertexCache = optimize;
+			LLPointer<LLVolume> volume = new LLVolume(params, detail);
+			LLVolumeFace::sOptimizeVertexCache = old;
+			return volume;
+		}
+
+		// Triangle as its vertex positions, rotated to start at the smallest so
+		// the winding is kept but the starting corner doesn't matter.
+		tri_key_t triKey(const LLVolumeFace& face, S32 tri)
+		{
+			S32 first = 0;
+			for (S32 k = 1; k < 3; k++)
+			{
+				const LLVector3& a = face.mVertices[face.mIndices[tri*3+k]].mPosition;
+				const LLVector3& b = face.mVertices[face.mIndices[tri*3+first]].mPosition;
+				if (a.mV[0] < b.mV[0] ||
+					(a.mV[0] == b.mV[0] && (a.mV[1] < b.mV[1] || (a.mV[1] == b.mV[1] && a.mV[2] < b.mV[2]))))
+				{
+					first = k;
+				}
+			}
+
+			tri_key_t key;
+			for (S32 k = 0; k < 3; k++)
+			{
+				const LLVector3& pos = face.mVertices[face.mIndices[tri*3+(first+k)%3]].mPosition;
+				key.push_back(pos.mV[0]);
+				key.push_back(pos.mV[1]);
+				key.push_back(pos.mV[2]);
+			}
+			return key;
+		}
+
+		std::vector<tri_key_t> triKeys(const LLVolumeFace& face)
+		{
+			std::vector<tri_key_t> keys;
+			for (U32 t = 0; t < face.mIndices.size()/3; t++)
+			{
+				keys.push_back(triKey(face, t));
+			}
+			std::sort(keys.begin(), keys.end());
+			return keys;
+		}
+	};
+	typedef test_group<volume_data> volume_test;
+	typedef volume_test::object volume_object;
+	tut::volume_test volume_testcase("volume");
+
+	template<> template<>
+	void volume_object::test<1>()
+	{
+		// reordering keeps every triangle and its winding
+		std::vector<LLVolumeParams> corpus = makeCorpus();
+		for (U32 i = 0; i < corpus.size(); i++)
+		{
+			LLPointer<LLVolume> plain = makeVolume(corpus[i], 2.f, FALSE);
+			LLPointer<LLVolume> optimized = makeVolume(corpus[i], 2.f, TRUE);
+			ensure_equals("face count", optimized->getNumVolumeFaces(), plain->getNumVolumeFaces());
+
+			for (S32 f = 0; f < plain->getNumVolumeFaces(); f++)
+			{
+				const LLVolumeFace& a = plain->getVolumeFace(f);
+				const LLVolumeFace& b = optimized->getVolumeFace(f);
+				ensure_equals("vertex count", b.mVertices.size(), a.mVertices.size());
+				ensure_equals("index count", b.mIndices.size(), a.mIndices.size());
+				ensure("triangles", triKeys(a) == triKeys(b));
+				for (U32 j = 0; j < b.mIndices.size(); j++)
+				{
+					ensure("index in range", b.mIndices[j] < b.mVertices.size());
+				}
+			}
+		}
+	}
+
+	template<> template<>
+	void volume_object::test<2>()
+	{
+		// neighbor triangles in the edge map follow their triangles
+		std::vector<LLVolumeParams> corpus = makeCorpus();
+		for (U32 i = 0; i < corpus.size(); i++)
+		{
+			LLPointer<LLVolume> plain = makeVolume(corpus[i], 1.f, FALSE);
+			LLPointer<LLVolume> optimized = makeVolume(corpus[i], 1.f, TRUE);
+
+			for (S32 f = 0; f < plain->getNumVolumeFaces(); f++)
+			{
+				const LLVolumeFace& a = plain->getVolumeFace(f);
+				const LLVolumeFace& b = optimized->getVolumeFace(f);
+				if (a.mEdge.size() != a.mIndices.size())
+				{
+					continue;
+				}
+
+				std::vector<std::pair<tri_key_t, tri_key_t> > edges_a, edges_b;
+				for (U32 j = 0; j < a.mEdge.size(); j++)
+				{
+					tri_key_t none;
+					edges_a.push_back(std::make_pair(triKey(a, j/3), a.mEdge[j] >= 0 ? triKey(a, a.mEdge[j]) : none));
+					edges_b.push_back(std::make_pair(triKey(b, j/3), b.mEdge[j] >= 0 ? triKey(b, b.mEdge[j]) : none));
+				}
+				std::sort(edges_a.begin(), edges_a.end());
+				std::sort(edges_b.begin(), edges_b.end());
+				ensure("edge map", edges_a == edges_b);
+			}
+		}
+	}
+
+	template<> template<>
+	void volume_object::test<3>()
+	{
+		// the optimized order misses the cache less on the whole corpus
+		std::vector<LLVolumeParams> corpus = makeCorpus();
+		const F32 details[] = { 1.f, 2.f, 3.f };
+		F32 before = 0.f;
+		F32 after = 0.f;
+		S32 faces = 0;
+
+		for (U32 d = 0; d < LL_ARRAY_SIZE(details); d++)
+		{
+			for (U32 i = 0; i < corpus.size(); i++)
+			{
+				LLPointer<LLVolume> plain = makeVolume(corpus[i], details[d], FALSE);
+				LLPointer<LLVolume> optimized = makeVolume(corpus[i], details[d], TRUE);
+				for (S32 f = 0; f < plain->getNumVolumeFaces(); f++)
+				{
+					before += plain->getVolumeFace(f).calcACMR();
+					after += optimized->getVolumeFace(f).calcACMR();
+					faces++;
+				}
+			}
+		}
+
+		llinfos << "Vertex cache ACMR over " << faces << " faces: " << before/faces
+			<< " strip order, " << after/faces << " optimized" << llendl;
+		ensure("optimized ACMR is lower", after < before);
+	}
+
+	template<> template<>
+	void volume_object::test<4>()
+	{
+		// sculpted faces are optimized too and partial rebuilds of an
+		// optimized face fall back to a full build
+		LLVolumeParams params;
+		params.setType(LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_CIRCLE);
+		params.setSculptID(LLUUID("f5f6d1f8-9d9a-4d3e-9a2d-0b6ab2f2cd3e"), LL_SCULPT_TYPE_SPHERE);
+
+		const U16 size = 32;
+		std::vector<U8> data(size*size*3);
+		for (U16 y = 0; y < size; y++)
+		{
+			for (U16 x = 0; x < size; x++)
+			{
+				F32 u = F_TWO_PI * x / (size-1);
+				F32 v = F_PI * y / (size-1);
+				U8* texel = &data[(y*size+x)*3];
+				texel[0] = (U8) (127.5f + 127.f * sinf(v) * cosf(u));
+				texel[1] = (U8) (127.5f + 127.f * sinf(v) * sinf(u));
+				texel[2] = (U8) (127.5f + 127.f * cosf(v));
+			}
+		}
+
+		// sculpt() reads the flag too, so set it around each build and put
+		// it back before checking anything
+		BOOL old = LLVolumeFace::sOptimizeVertexCache;
+		LLVolumeFace::sOptimizeVertexCache = FALSE;
+		LLPointer<LLVolume> plain = new LLVolume(params, 2.f);
+		plain->sculpt(size, size, 3, &data[0], 0);
+		LLVolumeFace::sOptimizeVertexCache = TRUE;
+		LLPointer<LLVolume> optimized = new LLVolume(params, 2.f);
+		optimized->sculpt(size, size, 3, &data[0], 0);
+		S32 face_count = optimized->getNumVolumeFaces();
+		BOOL cache_optimized = face_count > 0 && optimized->getVolumeFace(0).mCacheOptimized;
+		bool same_triangles = face_count > 0 && triKeys(plain->getVolumeFace(0)) == triKeys(optimized->getVolumeFace(0));
+		bool lower_acmr = face_count > 0 && optimized->getVolumeFace(0).calcACMR() < plain->getVolumeFace(0).calcACMR();
+
+		// same face count, so this would be a partial build
+		optimized->sculpt(size, size, 3, &data[0], 0);
+		bool same_after_rebuild = optimized->getNumVolumeFaces() > 0 &&
+			triKeys(plain->getVolumeFace(0)) == triKeys(optimized->getVolumeFace(0));
+		LLVolumeFace::sOptimizeVertexCache = old;
+
+		ensure_equals("face count", face_count, 1);
+		ensure("optimized", cache_optimized);
+		ensure("triangles", same_triangles);
+		ensure("optimized ACMR is lower", lower_acmr);
+		ensure("triangles after rebuild", same_after_rebuild);
+	}
+}
@@ -0,0 +1,243 @@
+/** 
+ * @file lscript_optimize_tut.cpp
+ * @brief LSL compiler optimization and compile cache tests
+ *
+ * $LicenseInfo:firstyear=2009&license=viewergpl$
+ * 
+ * Copyright (c) 2009, Linden Research, Inc.
+ * 
+ * Second Life Viewer Source Code
+ * The source code in this file ("Source Code") is provided by Linden Lab
+ * to you under the terms of the GNU General Public License, version 2.0
+ * ("GPL"), unless you have obtained a separate licensing agreement
+ * ("Other License"), formally executed by you and Linden Lab.  Terms of
+ * the GPL can be found in doc/GPL-license.txt in this distribution, or
+ * online at http://secondlifegrid.net/programs/open_source/licensing/gplv2
+ * 
+ * There are special exceptions to the terms and conditions of the GPL as
+ * it is applied to this Source Code. View the full text of the exception
+ * in the file doc/FLOSS-exception.txt in this software distribution, or
+ * online at
+ * http://secondlifegrid.net/programs/open_source/licensing/flossexception
+ * 
+ * By copying, modifying or distributing this software, you acknowledge
+ * that you have read and understood your obligations described above,
+ * and agree to abide by those obligations.
+ * 
+ * ALL LINDEN LAB SOURCE CODE IS PROVIDED "AS IS." LINDEN LAB MAKES NO
+ * WARRANTIES, EXPRESS, IMPLIED OR OTHERWISE, REGARDING ITS ACCURACY,
+ * COMPLETENESS OR PERFORMANCE.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lltut.h"
+
+#include "lldir.h"
+#include "lluuid.h"
+#include "lscript_rt_interface.h"
+#include "lscript_optimize.h"
+
+namespace tut
+{
+	struct LScriptOptimizeTestData
+	{
+		std::string mPrefix;
+		std::string mCacheDir;
+
+		LScriptOptimizeTestData()
+		{
+			LLUUID random;
+			random.generate();
+			std::ostringstream oStr;
+#if LL_WINDOWS 
+			oStr << "lscript-optimize-test-" << random;
+#else
+			oStr << "/tmp/lscript-optimize-test-" << random;
+#endif
+			mPrefix = oStr.str();
+			mCacheDir = mPrefix + "-cache";
+			LLFile::mkdir(mCacheDir);
+		}
+
+		~LScriptOptimizeTestData()
+		{
+			LLFile::remove(mPrefix + ".lsl");
+			LLFile::remove(mPrefix + ".lso");
+			LLFile::remove(mPrefix + ".out");
+			gDirUtilp->deleteFilesInDir(mCacheDir, "*");
+			LLFile::rmdir(mCacheDir);
+		}
+
+		void writeSource(const std::string& source)
+		{
+			llofstream file((mPrefix + ".lsl"));
+			file << source;
+			file.close();
+		}
+
+		std::string readFile(const std::string& filename)
+		{
+			std::string contents;
+			LLFILE* fp = LLFile::fopen(filename, "rb");		/* Flawfinder: ignore */
+			if (fp)
+			{
+				char buffer[1024];		/* Flawfinder: ignore */
+				size_t read;
+				while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+				{
+					contents.append(buffer, read);
+				}
+				fclose(fp);
+			}
+			return contents;
+		}
+
+		// returns the LSO bytecode, or an empty string if the compile failed
+		std::string compile(const std::string& source, BOOL optimize)
+		{
+			writeSource(source);
+			if (!lscript_compile((mPrefix + ".lsl").c_str(), (mPrefix + ".lso").c_str(),
+								 (mPrefix + ".out").c_str(), FALSE, "test", FALSE, optimize))
+			{
+				return std::string();
+			}
+			return readFile(mPrefix + ".lso");
+		}
+	};
+
+	typedef test_group<LScriptOptimizeTestData> LScriptOptimizeTestGroup;
+	typedef LScriptOptimizeTestGroup::object LScriptOptimizeTestObject;
+	LScriptOptimizeTestGroup lscriptOptimizeTestGroup("lscriptOptimize");
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<1>()
+		// integer folding matches the VM
+	{
+		S32 result = 0;
+		ensure("add", fold_integer_binary(result, 2, 3, LET_PLUS));
+		ensure_equals("add result", result, 5);
+		ensure("wrapping add", fold_integer_binary(result, S32_MAX, 1, LET_PLUS));
+		ensure_equals("wrapping add result", result, S32_MIN);
+		ensure("divide", fold_integer_binary(result, -7, 2, LET_DIVIDE));
+		ensure_equals("divide result", result, -3);
+		ensure("mod", fold_integer_binary(result, -7, 2, LET_MOD));
+		ensure_equals("mod result", result, -1);
+		ensure("less than", fold_integer_binary(result, 1, 2, LET_LESS_THAN));
+		ensure_equals("less than result", result, 1);
+		ensure("boolean and", fold_integer_binary(result, 4, 0, LET_BOOLEAN_AND));
+		ensure_equals("boolean and result", result, 0);
+		ensure("shift right", fold_integer_binary(result, -8, 1, LET_SHIFT_RIGHT));
+		ensure_equals("shift right result", result, -4);
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<2>()
+		// anything the VM treats specially is left for it
+	{
+		S32 result = 0;
+		ensure("divide by zero", !fold_integer_binary(result, 1, 0, LET_DIVIDE));
+		ensure("mod by zero", !fold_integer_binary(result, 1, 0, LET_MOD));
+		ensure("divide by minus one", !fold_integer_binary(result, S32_MIN, -1, LET_DIVIDE));
+		ensure("oversized shift", !fold_integer_binary(result, 1, 32, LET_SHIFT_LEFT));
+		ensure("negative shift", !fold_integer_binary(result, 1, -1, LET_SHIFT_RIGHT));
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<3>()
+		// unary folding
+	{
+		S32 result = 0;
+		ensure("minus", fold_integer_unary(result, 5, LET_UNARY_MINUS));
+		ensure_equals("minus result", result, -5);
+		ensure("minus min", fold_integer_unary(result, S32_MIN, LET_UNARY_MINUS));
+		ensure_equals("minus min result", result, S32_MIN);
+		ensure("not", fold_integer_unary(result, 3, LET_BOOLEAN_NOT));
+		ensure_equals("not result", result, 0);
+		ensure("bit not", fold_integer_unary(result, 0, LET_BIT_NOT));
+		ensure_equals("bit not result", result, -1);
+
+		F32 fresult = 0.f;
+		ensure("float minus", fold_float_unary(fresult, 1.5f, LET_UNARY_MINUS));
+		ensure_equals("float minus result", fresult, -1.5f);
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<4>()
+		// folded expressions compile to the same bytes as their value
+	{
+		std::string folded = compile("default { state_entry() { integer i = (2 + 3) * -4; llOwnerSay((string)i); } }", TRUE);
+		std::string literal = compile("default { state_entry() { integer i = -20; llOwnerSay((string)i); } }", TRUE);
+		ensure("compiled", !folded.empty());
+		ensure("folded matches literal", folded == literal);
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<5>()
+		// dead branches compile to the same bytes as leaving them out
+	{
+		std::string dead = compile("default { state_entry() { if (FALSE) llOwnerSay(\"x\"); llOwnerSay(\"y\"); } }", TRUE);
+		std::string live = compile("default { state_entry() { llOwnerSay(\"y\"); } }", TRUE);
+		ensure("compiled", !dead.empty());
+		ensure("dead branch dropped", dead == live);
+
+		dead = compile("default { state_entry() { if (1 < 2) llOwnerSay(\"y\"); else llOwnerSay(\"x\"); } }", TRUE);
+		ensure("dead else dropped", dead == live);
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<6>()
+		// scripts with nothing to fold compile exactly as before
+	{
+		const char* sources[] =
+		{
+			"default { state_entry() { integer i; for (i = 0; i < 10; ++i) llOwnerSay((string)(i / 2)); } }",
+			"default { touch_start(integer n) { float f = 1.0 / n; if (f > 0.5) jump done; llOwnerSay((string)f); @done; } }",
+			"integer g = 4; integer f(integer x) { return x << g; } default { state_entry() { while (g) g = f(g) % 3; } }",
+		};
+		for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); ++i)
+		{
+			std::string plain = compile(sources[i], FALSE);
+			std::string optimized = compile(sources[i], TRUE);
+			ensure("compiled", !plain.empty());
+			ensure("unchanged", plain == optimized);
+		}
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<7>()
+		// a jump target inside a constant branch keeps the branch
+	{
+		std::string source = "default { state_entry() { jump in; if (FALSE) { @in; llOwnerSay(\"x\"); } } }";
+		std::string plain = compile(source, FALSE);
+		std::string optimized = compile(source, TRUE);
+		ensure("compiled", !plain.empty());
+		ensure("branch kept", plain == optimized);
+	}
+
+	template<> template<>
+	void LScriptOptimizeTestObject::test<8>()
+		// the cache returns what a fresh compile would
+	{
+		std::string source = "default { state_entry() { llOwnerSay((string)(6 * 7)); } }";
+		std::string expected = compile(source, TRUE);
+		LLFile::remove(mPrefix + ".lso");
+
+		std::string cache_prefix = mCacheDir + gDirUtilp->getDirDelimiter();
+		for (S32 i = 0; i < 2; ++i)
+		{
+			ensure("cached compile", lscript_compile_cached((mPrefix + ".lsl").c_str(), (mPrefix + ".lso").c_str(),
+															(mPrefix + ".out").c_str(), cache_prefix.c_str()));
+			ensure("cached output", readFile(mPrefix + ".lso") == expected);
+			LLFile::remove(mPrefix + ".lso");
+		}
+
+		// failures are not cached
+		writeSource("default { state_entry() { undefined(); } }");
+		ensure("error", !lscript_compile_cached((mPrefix + ".lsl").c_str(), (mPrefix + ".lso").c_str(),
+												(mPrefix + ".out").c_str(), cache_prefix.c_str()));
+		ensure("error again", !lscript_compile_cached((mPrefix + ".lsl").c_str(), (mPrefix + ".lso").c_str(),
+													  (mPrefix + ".out").c_str(), cache_prefix.c_str()));
+	}
+}